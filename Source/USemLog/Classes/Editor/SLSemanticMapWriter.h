@@ -17,6 +17,7 @@ struct USEMLOG_API FSLSemanticMapWriterParams
 	FString Description = TEXT("");
 	FString Level = TEXT("");
 	bool bOverwrite = false;
+	bool bWriteNTriples = false;
 };
 
 /**
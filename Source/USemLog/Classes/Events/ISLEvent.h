@@ -5,6 +5,70 @@
 
 #include "Owl/SLOwlDoc.h"
 
+// Forward declarations
+class USLBaseIndividual;
+
+/**
+* Type of the event (avoids comparing type name strings)
+*/
+enum class ESLEventKind : uint8
+{
+	Contact,
+	SupportedBy,
+	Grasp,
+	Reach,
+	PreGrasp,
+	PickUp,
+	Slide,
+	Transport,
+	PutDown,
+	Container,
+	Slicing,
+	Dummy
+};
+
+/**
+* Role of an individual taking part in the event
+*/
+enum class ESLEventRole : uint8
+{
+	// Symmetric participant (e.g. the individuals in contact)
+	Participant,
+
+	// The supported / supporting individual
+	Supported,
+	Supporter,
+
+	// The acting individual (e.g. hand) and the individual acted on
+	Agent,
+	Patient,
+
+	// Tool used in the event, and the created object
+	Instrument,
+	Output
+};
+
+/**
+* Individual taking part in the event with its role
+*/
+struct FSLEventParticipant
+{
+	// Default ctor
+	FSLEventParticipant() : Individual(nullptr), Role(ESLEventRole::Participant) {};
+
+	// Init ctor
+	FSLEventParticipant(USLBaseIndividual* InIndividual, ESLEventRole InRole) : Individual(InIndividual), Role(InRole) {};
+
+	// The individual
+	USLBaseIndividual* Individual;
+
+	// Its role in the event
+	ESLEventRole Role;
+};
+
+// Participants of an event (all current events have at most four)
+typedef TArray<FSLEventParticipant, TInlineAllocator<4>> FSLEventParticipants;
+
 /**
 * Abstract class ensuring every event can be represented as an Owl Node;
 */
@@ -57,4 +121,60 @@ public:
 
 	// Type name
 	virtual FString TypeName() const = 0;
+
+	// Type of the event
+	virtual ESLEventKind Kind() const = 0;
+
+	// Individuals taking part in the event, in their declaration order
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const = 0;
+
+	// Get the (first) individual with the given role, nullptr if none
+	USLBaseIndividual* GetParticipant(ESLEventRole Role) const
+	{
+		FSLEventParticipants Participants;
+		GetParticipants(Participants);
+		for (const auto& Participant : Participants)
+		{
+			if (Participant.Role == Role)
+			{
+				return Participant.Individual;
+			}
+		}
+		return nullptr;
+	}
+
+	// Name of the event kind
+	static const TCHAR* GetKindName(ESLEventKind InKind)
+	{
+		switch (InKind)
+		{
+		case ESLEventKind::Contact:		return TEXT("Contact");
+		case ESLEventKind::SupportedBy:	return TEXT("SupportedBy");
+		case ESLEventKind::Grasp:		return TEXT("Grasp");
+		case ESLEventKind::Reach:		return TEXT("Reach");
+		case ESLEventKind::PreGrasp:	return TEXT("PreGrasp");
+		case ESLEventKind::PickUp:		return TEXT("PickUp");
+		case ESLEventKind::Slide:		return TEXT("Slide");
+		case ESLEventKind::Transport:	return TEXT("Transport");
+		case ESLEventKind::PutDown:		return TEXT("PutDown");
+		case ESLEventKind::Container:	return TEXT("Container");
+		case ESLEventKind::Slicing:		return TEXT("Slicing");
+		default:						return TEXT("Dummy");
+		}
+	}
+
+	// Name of the participant role
+	static const TCHAR* GetRoleName(ESLEventRole InRole)
+	{
+		switch (InRole)
+		{
+		case ESLEventRole::Supported:	return TEXT("Supported");
+		case ESLEventRole::Supporter:	return TEXT("Supporter");
+		case ESLEventRole::Agent:		return TEXT("Agent");
+		case ESLEventRole::Patient:		return TEXT("Patient");
+		case ESLEventRole::Instrument:	return TEXT("Instrument");
+		case ESLEventRole::Output:		return TEXT("Output");
+		default:						return TEXT("Participant");
+		}
+	}
 };
\ No newline at end of file
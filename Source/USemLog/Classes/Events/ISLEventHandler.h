@@ -47,6 +47,32 @@ public:
 	FSLEventSignature OnSemanticEvent;
 
 protected:
+	// Finish and publish the still open events in one batch (in start time and id order to keep the output deterministic)
+	template<typename KeyType, typename EventType>
+	void FinishOpenEventsBatch(TMap<KeyType, TSharedPtr<EventType>>& OpenEvents, float EndTime,
+		float MinDuration = TNumericLimits<float>::Lowest())
+	{
+		TArray<TSharedPtr<EventType>> Batch;
+		OpenEvents.GenerateValueArray(Batch);
+		OpenEvents.Empty();
+		// The map iteration order is not deterministic, events starting at the same time are ordered by their id
+		Batch.StableSort([](const TSharedPtr<EventType>& A, const TSharedPtr<EventType>& B)
+			{
+				return A->StartTime < B->StartTime
+					|| (A->StartTime == B->StartTime && A->Id < B->Id);
+			});
+		for (const auto& Ev : Batch)
+		{
+			// Ignore short events
+			if ((EndTime - Ev->StartTime) > MinDuration)
+			{
+				// Set end time and publish event
+				Ev->EndTime = EndTime;
+				OnSemanticEvent.ExecuteIfBound(Ev);
+			}
+		}
+	}
+
 	// Set when initialized
 	bool bIsInit = false;
 
@@ -55,5 +55,27 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("Contact")); };
+
+	// Get the event kind
+	virtual ESLEventKind Kind() const override { return ESLEventKind::Contact; };
+
+	// Get the participants with their roles
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const override
+	{
+		OutParticipants.Emplace(Individual1, ESLEventRole::Participant);
+		OutParticipants.Emplace(Individual2, ESLEventRole::Participant);
+	};
 	/* End IEvent interface */
+
+	/* Serialization from plain data (shared with the event snapshots) */
+	// Create the owl representation of the event
+	static FSLOwlNode CreateOwlNode(const FString& InId, float InStart, float InEnd,
+		const FString& Individual1Id, const FString& Individual2Id, const FString& InEpisodeId);
+
+	// Get the context data
+	static FString CreateContext(uint64 InPairId);
+
+	// Get the tooltip data
+	static FString CreateTooltip(const FString& Individual1Class, const FString& Individual1Id,
+		const FString& Individual2Class, const FString& Individual2Id, const FString& InId);
 };
\ No newline at end of file
@@ -59,5 +59,15 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("Container")); };
+
+	// Get the event kind
+	virtual ESLEventKind Kind() const override { return ESLEventKind::Container; };
+
+	// Get the participants with their roles
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const override
+	{
+		OutParticipants.Emplace(Manipulator, ESLEventRole::Agent);
+		OutParticipants.Emplace(Individual, ESLEventRole::Patient);
+	};
 	/* End IEvent interface */
 };
\ No newline at end of file
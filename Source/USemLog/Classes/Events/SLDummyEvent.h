@@ -27,5 +27,11 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("Dummy")); };
+
+	// Get the event kind
+	virtual ESLEventKind Kind() const override { return ESLEventKind::Dummy; };
+
+	// Get the participants with their roles
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const override {};
 	/* End IEvent interface */
 };
\ No newline at end of file
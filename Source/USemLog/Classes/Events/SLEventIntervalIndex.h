@@ -0,0 +1,164 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Events/ISLEvent.h"
+
+// Forward declarations
+class FSLEventStore;
+
+/**
+* Indexed copy of a finished event (independent of the world individuals, can be loaded offline)
+*/
+struct FSLEventIntervalEntry
+{
+	// Unique id of the event
+	FString Id;
+
+	// Event kind
+	ESLEventKind Kind = ESLEventKind::Dummy;
+
+	// Event interval
+	float StartTime = 0.f;
+	float EndTime = 0.f;
+
+	// Ids of the participant individuals and their roles
+	TArray<FString, TInlineAllocator<4>> ParticipantIds;
+	TArray<ESLEventRole, TInlineAllocator<4>> ParticipantRoles;
+};
+
+/**
+* Centered interval tree over [Start, End] intervals,
+* stabbing and overlap queries run in O(log n + k)
+*/
+class USEMLOG_API FSLEventIntervalTree
+{
+public:
+	// Interval with the index of its entry
+	struct FInterval
+	{
+		float Start;
+		float End;
+		int32 Idx;
+	};
+
+	// Build the tree (clears the previous data)
+	void Build(TArray<FInterval> InIntervals);
+
+	// Clear the tree
+	void Reset();
+
+	// Number of intervals
+	int32 Num() const { return SortedByStart.Num(); };
+
+	// Add the indexes of the intervals containing the time (Start <= T <= End)
+	void Stab(float T, TArray<int32>& OutIdxs) const;
+
+	// Add the indexes of the intervals overlapping [T0, T1]
+	void Overlap(float T0, float T1, TArray<int32>& OutIdxs) const;
+
+private:
+	// Tree node, the intervals containing the center are stored twice, sorted by start and by end
+	struct FNode
+	{
+		float Center;
+		int32 Left;
+		int32 Right;
+		int32 First;
+		int32 Count;
+	};
+
+	// Build the subtree of the intervals, returns the node index
+	int32 BuildNode(TArray<FInterval>& InIntervals);
+
+private:
+	// Tree nodes
+	TArray<FNode> Nodes;
+
+	// Node slices (ascending start, descending end)
+	TArray<FInterval> ByStart;
+	TArray<FInterval> ByEnd;
+
+	// All the intervals sorted by start (overlap queries)
+	TArray<FInterval> SortedByStart;
+
+	// Root node index
+	int32 Root = INDEX_NONE;
+};
+
+/**
+* Episode-wide interval index of the finished events,
+* answers temporal and per individual queries without scanning the events (results are unordered)
+*/
+class USEMLOG_API FSLEventIntervalIndex
+{
+public:
+	// Build the index from the finished events (streamed from the store)
+	void Build(const FSLEventStore& InEvents);
+
+	// Build the index from already copied entries
+	void Build(TArray<FSLEventIntervalEntry> InEntries);
+
+	// Load the events of a binary event log (.slev) or of a json lines (.ndjson) output
+	bool Load(const FString& FilePath);
+
+	// Load the events of a binary event log
+	bool LoadFromEventLog(const FString& FilePath);
+
+	// Load the events of a json lines output (event stream or offline converter)
+	bool LoadFromJson(const FString& FilePath);
+
+	// Clear the index
+	void Reset();
+
+	// Number of indexed events
+	int32 Num() const { return Entries.Num(); };
+
+	// Get the indexed events
+	const TArray<FSLEventIntervalEntry>& GetEntries() const { return Entries; };
+
+	// Get the event with the given id (nullptr if not found)
+	const FSLEventIntervalEntry* FindById(const FString& Id) const;
+
+	// Get the events overlapping [T0, T1]
+	void QueryOverlapping(float T0, float T1, TArray<int32>& OutIdxs) const;
+
+	// Get the events active at the given time
+	void QueryAt(float T, TArray<int32>& OutIdxs) const;
+
+	// Get the events of the individual overlapping [T0, T1], optionally of the given kind only
+	void QueryIndividualOverlapping(const FString& IndividualId, float T0, float T1, TArray<int32>& OutIdxs,
+		TOptional<ESLEventKind> Kind = TOptional<ESLEventKind>()) const;
+
+	// Get the events of the individual active at the given time, optionally of the given kind only
+	void QueryIndividualAt(const FString& IndividualId, float T, TArray<int32>& OutIdxs,
+		TOptional<ESLEventKind> Kind = TOptional<ESLEventKind>()) const;
+
+	// Get the individuals sharing an event of the given kind with the individual at the given time (e.g. what it was touching)
+	void QueryPartnersAt(const FString& IndividualId, float T, ESLEventKind Kind, TArray<FString>& OutIndividualIds) const;
+
+	// Get the event kind from its name (as written by ISLEvent::GetKindName)
+	static ESLEventKind GetKindFromName(const FString& InName);
+
+	// Get the event role from its name (as written by ISLEvent::GetRoleName)
+	static ESLEventRole GetRoleFromName(const FString& InName);
+
+private:
+	// Remove the newly added result indexes of other kinds
+	void FilterKind(TArray<int32>& InOutIdxs, int32 FirstNewIdx, TOptional<ESLEventKind> Kind) const;
+
+private:
+	// Indexed events
+	TArray<FSLEventIntervalEntry> Entries;
+
+	// Event id to entry index
+	TMap<FString, int32> IdToIdx;
+
+	// Tree over all events
+	FSLEventIntervalTree Tree;
+
+	// Trees over the events of each individual
+	TMap<FString, FSLEventIntervalTree> IndividualTrees;
+};
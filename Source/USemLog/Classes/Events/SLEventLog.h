@@ -0,0 +1,279 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Events/ISLEvent.h"
+
+// Forward declarations
+class FArchive;
+class USLBaseIndividual;
+
+/**
+* Binary event log layout (little endian):
+*	[Header][Record 0..N-1][String table][Individual table][Index][Footer]
+* the records are appended while the episode runs, the tables, index and footer are written when the log is closed;
+* until then the table entries are also journaled to <log>.journal every JournalInterval records:
+*	[Meta][String|Individual ..][Sync][String|Individual ..][Sync]..
+* the journal is deleted when the log is closed, if present the records up to its last sync can be recovered
+*/
+namespace SLEventLog
+{
+	// "SLEV"
+	static const uint32 Magic = 0x56454C53;
+
+	// Current format version
+	static const uint16 Version = 1;
+
+	// Size of the serialized header
+	static const int64 HeaderSize = 8;
+
+	// Size of a serialized record
+	static const int64 RecordSize = 40;
+
+	// Size of the serialized footer
+	static const int64 FooterSize = 64;
+
+	// Number of records per index block
+	static const uint32 IndexBlockSize = 256;
+
+	// Maximum number of participants in a record
+	static const int32 MaxParticipants = 4;
+
+	// Unused string / individual index
+	static const uint32 None = MAX_uint32;
+
+	// Record flags
+	static const uint16 FlagTaskSuccessful = 1 << 0;
+
+	// Number of records between the journal flushes
+	static const uint32 JournalInterval = 64;
+
+	// Journal entry tags
+	static const uint8 JournalMeta = 0;
+	static const uint8 JournalString = 1;
+	static const uint8 JournalIndividual = 2;
+	static const uint8 JournalSync = 3;
+};
+
+/**
+* Fixed size record of an event
+*/
+struct FSLEventLogRecord
+{
+	// Event kind (ESLEventKind)
+	uint8 Kind = 0;
+
+	// Number of used participant slots
+	uint8 NumParticipants = 0;
+
+	// Kind specific flags (e.g. slicing success)
+	uint16 Flags = 0;
+
+	// Event interval
+	float StartTime = 0.f;
+	float EndTime = 0.f;
+
+	// Unique id of the event (string table index)
+	uint32 IdStr = SLEventLog::None;
+
+	// Kind specific string, e.g. the grasp or container manipulation type (string table index)
+	uint32 ExtraStr = SLEventLog::None;
+
+	// Participant individuals (individual table index) and their roles (ESLEventRole)
+	uint32 Participants[SLEventLog::MaxParticipants];
+	uint8 Roles[SLEventLog::MaxParticipants];
+
+	// Default ctor
+	FSLEventLogRecord()
+	{
+		for (int32 Idx = 0; Idx < SLEventLog::MaxParticipants; ++Idx)
+		{
+			Participants[Idx] = SLEventLog::None;
+			Roles[Idx] = 0;
+		}
+	}
+
+	// Get the event kind
+	ESLEventKind GetKind() const { return (ESLEventKind)Kind; };
+
+	// Get the individual table index of the participant with the given role
+	uint32 GetParticipant(ESLEventRole Role) const
+	{
+		for (int32 Idx = 0; Idx < NumParticipants; ++Idx)
+		{
+			if (Roles[Idx] == (uint8)Role)
+			{
+				return Participants[Idx];
+			}
+		}
+		return SLEventLog::None;
+	}
+
+	// Serialize (fixed size)
+	friend FArchive& operator<<(FArchive& Ar, FSLEventLogRecord& Record);
+};
+
+/**
+* Individual entry of the log (string table indexes)
+*/
+struct FSLEventLogIndividual
+{
+	uint32 IdStr = SLEventLog::None;
+	uint32 ClassStr = SLEventLog::None;
+	uint32 LabelStr = SLEventLog::None;
+};
+
+/**
+* Index block, the interval covered by a block of consecutive records
+*/
+struct FSLEventLogIndexEntry
+{
+	uint32 FirstRecord = 0;
+	float MinStartTime = 0.f;
+	float MaxEndTime = 0.f;
+};
+
+/**
+* Writes the binary event log, the records are appended as the events finish
+*/
+class USEMLOG_API FSLEventLogWriter
+{
+public:
+	// Ctor
+	FSLEventLogWriter();
+
+	// Dtor
+	~FSLEventLogWriter();
+
+	// Open the log file (<Dir><EpisodeId>_ED.slev) and write the header
+	bool Init(const FString& InDirPath, const FString& InEpisodeId, const FString& InTaskId,
+		const FString& InSemanticMapId, bool bOverwrite);
+
+	// Append the event record
+	void Add(const ISLEvent& Event);
+
+	// Write the tables, the index and the footer and close the file
+	void Finish(float EpisodeStartTime, float EpisodeEndTime);
+
+	// Get the path of the log file
+	const FString& GetFilePath() const { return FilePath; };
+
+	// Number of written records
+	int32 Num() const { return (int32)NumRecords; };
+
+	// Get init state
+	bool IsInit() const { return bIsInit; };
+
+private:
+	// Get the string table index of the string
+	uint32 InternString(const FString& Str);
+
+	// Get the individual table index of the individual
+	uint32 GetIndividualIndex(USLBaseIndividual* Individual);
+
+	// Append the new table entries and the number of records to the journal, flush both files
+	void FlushJournal();
+
+private:
+	// True if the log file is open
+	bool bIsInit;
+
+	// Path of the log file
+	FString FilePath;
+
+	// Path of the journal file
+	FString JournalFilePath;
+
+	// Output archive
+	FArchive* Ar;
+
+	// Journal archive
+	FArchive* JournalAr;
+
+	// Number of table entries already in the journal
+	int32 NumJournaledStrings;
+	int32 NumJournaledIndividuals;
+
+	// Number of written records
+	uint32 NumRecords;
+
+	// String table
+	TArray<FString> Strings;
+	TMap<FString, uint32> StringToIdx;
+
+	// Individual table
+	TArray<FSLEventLogIndividual> Individuals;
+	TMap<USLBaseIndividual*, uint32> IndividualToIdx;
+
+	// Index blocks
+	TArray<FSLEventLogIndexEntry> Index;
+
+	// Episode metadata (string table indexes)
+	uint32 EpisodeStr;
+	uint32 TaskStr;
+	uint32 SemanticMapStr;
+};
+
+/**
+* Reads a binary event log into memory
+*/
+class USEMLOG_API FSLEventLogReader
+{
+public:
+	// Load and validate the log file, if it was not closed recover the records from its journal
+	bool Load(const FString& InFilePath);
+
+	// True if the log was not closed and the records were recovered from the journal
+	bool IsRecovered() const { return bRecovered; };
+
+	// Get the records in the written (finish) order
+	const TArray<FSLEventLogRecord>& GetRecords() const { return Records; };
+
+	// Get the individuals table
+	const TArray<FSLEventLogIndividual>& GetIndividuals() const { return Individuals; };
+
+	// Get the index blocks
+	const TArray<FSLEventLogIndexEntry>& GetIndex() const { return Index; };
+
+	// Get the string from the string table (empty if not set)
+	const FString& GetString(uint32 StrIdx) const;
+
+	// Get the id of the individual (empty if not set)
+	const FString& GetIndividualId(uint32 IndividualIdx) const;
+
+	// Get the episode metadata
+	const FString& GetEpisodeId() const { return GetString(EpisodeStr); };
+	const FString& GetTaskId() const { return GetString(TaskStr); };
+	const FString& GetSemanticMapId() const { return GetString(SemanticMapStr); };
+	float GetStartTime() const { return StartTime; };
+	float GetEndTime() const { return EndTime; };
+
+	// Get the path of the loaded file
+	const FString& GetFilePath() const { return FilePath; };
+
+private:
+	// Load the records journaled before the crash (the log has no tables, index or footer)
+	bool Recover(const TArray<uint8>& Data);
+
+private:
+	// Path of the loaded file
+	FString FilePath;
+
+	// True if the records were recovered from the journal
+	bool bRecovered = false;
+
+	// Tables
+	TArray<FSLEventLogRecord> Records;
+	TArray<FString> Strings;
+	TArray<FSLEventLogIndividual> Individuals;
+	TArray<FSLEventLogIndexEntry> Index;
+
+	// Episode metadata
+	uint32 EpisodeStr = SLEventLog::None;
+	uint32 TaskStr = SLEventLog::None;
+	uint32 SemanticMapStr = SLEventLog::None;
+	float StartTime = 0.f;
+	float EndTime = 0.f;
+};
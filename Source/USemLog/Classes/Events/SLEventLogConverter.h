@@ -0,0 +1,54 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Events/SLEventLog.h"
+#include "Owl/SLOwlExperiment.h"
+
+/**
+* Outputs generated from a binary event log
+*/
+enum class ESLEventLogOutput : uint8
+{
+	None		= 0,
+	Owl			= 1 << 0,
+	NTriples	= 1 << 1,
+	Json		= 1 << 2,
+	Timeline	= 1 << 3,
+	All			= Owl | NTriples | Json | Timeline
+};
+ENUM_CLASS_FLAGS(ESLEventLogOutput);
+
+/**
+* Converts binary event logs to the owl, json and timeline outputs offline (without the world individuals)
+*/
+class USEMLOG_API FSLEventLogConverter
+{
+public:
+	// Convert the log to the selected outputs, written next to the log if the output directory is empty
+	static bool Convert(const FString& LogFilePath, const FString& OutDirPath, ESLEventLogOutput Outputs, bool bOverwrite);
+
+	// Convert the logs in parallel, returns the number of successfully converted logs
+	static int32 ConvertAll(const TArray<FString>& LogFilePaths, const FString& OutDirPath, ESLEventLogOutput Outputs, bool bOverwrite);
+
+	// Create the experiment document of the log
+	static TSharedPtr<FSLOwlExperiment> CreateExperimentDoc(const FSLEventLogReader& Log);
+
+	// Write the events as json lines (same layout as the event stream, without the context)
+	static bool WriteJson(const FSLEventLogReader& Log, const FString& FilePath);
+
+	// Write the level-of-detail timeline of the events
+	static bool WriteTimeline(const FSLEventLogReader& Log, const FString& DirPath, bool bOverwrite);
+
+	// Parse a comma separated list of outputs (owl,nt,json,timeline,all)
+	static ESLEventLogOutput ParseOutputs(const FString& InStr);
+
+private:
+	// Create the owl node of the record (same layout as the event classes)
+	static FSLOwlNode CreateEventNode(const FSLEventLogReader& Log, const FSLEventLogRecord& Record);
+
+	// Get the owl class of the event kind
+	static const TCHAR* GetOwlClass(ESLEventKind Kind);
+};
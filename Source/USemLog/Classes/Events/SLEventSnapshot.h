@@ -0,0 +1,102 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Events/ISLEvent.h"
+
+/**
+* Plain copy of the individual data read by the event outputs,
+* taken on the game thread when the first event of the individual is stored
+*/
+struct FSLIndividualSnapshot
+{
+	// Unique id of the individual
+	FString Id;
+
+	// Class of the individual
+	FString Class;
+
+	// Name of the parent actor (empty if none)
+	FString ActorName;
+};
+
+/**
+* Participant of an event snapshot
+*/
+struct FSLEventParticipantSnapshot
+{
+	// The individual data (owned by the event store), nullptr if the event had no individual
+	const FSLIndividualSnapshot* Individual;
+
+	// Its role in the event
+	ESLEventRole Role;
+};
+
+/**
+* Outputs of an event without compact representation, serialized on the game thread when the event is stored
+*/
+struct FSLSerializedEvent
+{
+	// Owl representation
+	FSLOwlNode OwlNode;
+
+	// Timeline context and tooltip
+	FString Context;
+	FString Tooltip;
+};
+
+/**
+* Plain view of a stored event, does not reference the individuals (can be read on any thread);
+* serializes to the same owl node, context and tooltip as the event
+*/
+struct USEMLOG_API FSLEventSnapshot
+{
+	// Unique id of the event
+	FString Id;
+
+	// Id of the episode
+	FString EpisodeId;
+
+	// Event kind
+	ESLEventKind Kind = ESLEventKind::Dummy;
+
+	// Event interval
+	float StartTime = 0.f;
+	float EndTime = 0.f;
+
+	// Participants in their declaration order
+	TArray<FSLEventParticipantSnapshot, TInlineAllocator<4>> Participants;
+
+	// Pair id of the compact events (contact, supported by, grasp)
+	uint64 PairId = 0;
+
+	// Extra data of the compact events (grasp type)
+	FString Extra;
+
+	// Serialized outputs of the events without compact representation (owned by the event store)
+	const FSLSerializedEvent* Serialized = nullptr;
+
+	// Get the (first) participant with the given role, nullptr if none
+	const FSLIndividualSnapshot* GetParticipant(ESLEventRole Role) const;
+
+	// Create the owl representation of the event
+	FSLOwlNode ToOwlNode() const;
+
+	// Add the owl representation of the event to the owl (experiment) document
+	void AddToOwlDoc(FSLOwlDoc* OutDoc) const;
+
+	// Get the timeline context of the event
+	FString Context() const;
+
+	// Get the timeline tooltip of the event
+	FString Tooltip() const;
+
+private:
+	// Id of the participant at the given position, empty if none
+	const FString& GetParticipantId(int32 Index) const;
+
+	// Class of the participant at the given position, empty if none
+	const FString& GetParticipantClass(int32 Index) const;
+};
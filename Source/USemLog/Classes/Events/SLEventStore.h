@@ -0,0 +1,191 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ChunkedArray.h"
+#include "Events/ISLEvent.h"
+#include "Events/SLEventSnapshot.h"
+
+// Forward declarations
+class USLBaseIndividual;
+
+/**
+* Kind of the stored event (the arena it lives in)
+*/
+enum class ESLEventRecordKind : uint8
+{
+	Contact,
+	SupportedBy,
+	Grasp,
+	Other
+};
+
+/**
+* Compact (POD) record of a finished event between two individuals
+*/
+struct FSLPairEventRecord
+{
+	// Offset and length of the unique id in the ids buffer
+	int32 IdOffset;
+	int32 IdLen;
+
+	// Interned episode id
+	int32 EpisodeIdx;
+
+	// Event interval
+	float StartTime;
+	float EndTime;
+
+	// Pair id of the event
+	uint64 PairId;
+
+	// Individual handles
+	int32 Individual1;
+	int32 Individual2;
+
+	// Interned extra string (e.g. the grasp type), INDEX_NONE if not used
+	int32 ExtraIdx;
+};
+
+/**
+* Participant handle and role of an event without compact representation
+*/
+struct FSLParticipantHandle
+{
+	// Individual handle
+	int32 Handle;
+
+	// Its role in the event
+	ESLEventRole Role;
+};
+
+/**
+* Game thread data of an event without compact representation (the event itself is kept for materializing)
+*/
+struct FSLOtherEventRecord
+{
+	// Type of the event
+	ESLEventKind Kind;
+
+	// Participants in their declaration order
+	TArray<FSLParticipantHandle, TInlineAllocator<4>> Participants;
+
+	// Serialized outputs
+	FSLSerializedEvent Serialized;
+};
+
+/**
+* Entry in the insertion order of the events
+*/
+struct FSLEventStoreEntry
+{
+	ESLEventRecordKind Kind;
+	int32 Index;
+};
+
+/**
+* Stores the finished events of an episode, the frequent ones (contact, supported by, grasp) are kept
+* as compact records in typed arenas, the virtual event is only materialized when serializing;
+* the individual data is copied on the game thread when the event is stored, so the snapshots
+* can be serialized on any thread (the materialized events still point to the individual objects)
+*/
+class USEMLOG_API FSLEventStore
+{
+public:
+	// Default ctor
+	FSLEventStore();
+
+	// Store the finished event
+	void Add(TSharedPtr<ISLEvent> Event);
+
+	// Remove all events
+	void Reset();
+
+	// Number of stored events
+	int32 Num() const { return Entries.Num(); };
+
+	// True if there are no events
+	bool IsEmpty() const { return Entries.Num() == 0; };
+
+	// Materialize the event at the given index (insertion order)
+	TSharedPtr<ISLEvent> Materialize(int32 Index) const;
+
+	// Materialize all events in insertion order
+	void MaterializeAll(TArray<TSharedPtr<ISLEvent>>& OutEvents) const;
+
+	// Call the function on every materialized event in insertion order (only one compact event is materialized at a time,
+	// the other events are passed by reference so concurrent readers do not touch their reference counts)
+	void ForEach(TFunctionRef<void(const TSharedPtr<ISLEvent>&)> Func) const;
+
+	// Get the plain snapshot of the event at the given index (insertion order),
+	// it points into the store and is valid until the next Add or Reset
+	FSLEventSnapshot Snapshot(int32 Index) const;
+
+	// Get the snapshots of all events in insertion order
+	void SnapshotAll(TArray<FSLEventSnapshot>& OutSnapshots) const;
+
+	// Call the function on the snapshot of every event in insertion order
+	void ForEachSnapshot(TFunctionRef<void(const FSLEventSnapshot&)> Func) const;
+
+	// Memory used by the store
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	// Create the compact record of the event
+	FSLPairEventRecord MakeRecord(const ISLEvent& Event, uint64 PairId,
+		USLBaseIndividual* Individual1, USLBaseIndividual* Individual2, const FString& Extra = FString());
+
+	// Apply the common record data to the event
+	void FillEvent(const FSLPairEventRecord& Record, ISLEvent& OutEvent) const;
+
+	// Store the id characters, returns the offset in the buffer
+	int32 StoreId(const FString& Id, int32& OutLen);
+
+	// Get the id from the buffer
+	FString GetId(int32 Offset, int32 Len) const;
+
+	// Get the interned index of the string
+	int32 InternString(const FString& Str);
+
+	// Get the handle of the individual
+	int32 GetIndividualHandle(USLBaseIndividual* Individual);
+
+	// Get the individual from its handle
+	USLBaseIndividual* GetIndividual(int32 Handle) const;
+
+	// Get the individual snapshot from its handle
+	const FSLIndividualSnapshot* GetIndividualSnapshot(int32 Handle) const;
+
+	// Apply the common record data to the snapshot
+	void FillSnapshot(const FSLPairEventRecord& Record, ESLEventKind Kind, ESLEventRole Role1, ESLEventRole Role2,
+		FSLEventSnapshot& OutSnapshot) const;
+
+private:
+	// Insertion order of the events
+	TArray<FSLEventStoreEntry> Entries;
+
+	// Typed arenas (chunked, no reallocation of the existing records)
+	TChunkedArray<FSLPairEventRecord> ContactRecords;
+	TChunkedArray<FSLPairEventRecord> SupportedByRecords;
+	TChunkedArray<FSLPairEventRecord> GraspRecords;
+
+	// Events without a compact representation, and their game thread data
+	TArray<TSharedPtr<ISLEvent>> OtherEvents;
+	TChunkedArray<FSLOtherEventRecord> OtherRecords;
+
+	// Characters of the unique event ids (ASCII base64url guids)
+	TArray<ANSICHAR> IdChars;
+
+	// Interned strings (episode ids, grasp types)
+	TArray<FString> Strings;
+	TMap<FString, int32> StringToIdx;
+
+	// Individual handles
+	TArray<USLBaseIndividual*> Individuals;
+	TMap<USLBaseIndividual*, int32> IndividualToHandle;
+
+	// Individual data copied on the game thread (chunked, the snapshots point into it)
+	TChunkedArray<FSLIndividualSnapshot> IndividualSnapshots;
+};
@@ -49,6 +49,6 @@ private:
 	USLBaseIndividual* Parent;
 #endif // SL_WITH_MC_GRASP
 
-	// Array of started events
-	TArray<TSharedPtr<FSLGraspEvent>> StartedEvents;
+	// Started events, keyed by the grasped individual
+	TMap<USLBaseIndividual*, TSharedPtr<FSLGraspEvent>> StartedEvents;
 };
@@ -5,6 +5,8 @@
 
 #include "CoreMinimal.h"
 #include "Events/SLEvents.h"
+#include "Events/SLEventSnapshot.h"
+#include "Events/SLTimelineLODWriter.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 
@@ -37,6 +39,12 @@ struct FSLGoogleChartsParameters
 	// Events selection
 	FLSymbolicEventsSelection EventsSelection;
 
+	// Above this number of events the timeline is written with level-of-detail aggregation (0 to disable)
+	int32 LODEventsThreshold = 5000;
+
+	// Aggregation parameters of the level-of-detail timeline
+	FSLTimelineLODParameters LODParams;
+
 	// Default constructor
 	FSLGoogleChartsParameters() :
 		bLegend(false),
@@ -49,8 +57,8 @@ struct FSLGoogleChartsParameters
  */
 struct FSLGoogleCharts
 {
-	// Write google charts timeline html page from the events
-	static bool WriteTimelines(const TArray<TSharedPtr<ISLEvent>>& InEvents,
+	// Write google charts timeline html page from the events (plain snapshots, can run on any thread)
+	static bool WriteTimelines(const TArray<FSLEventSnapshot>& InEvents,
 		const FString& DirectoryPath,
 		const FString& InEpId,
 		const FSLGoogleChartsParameters& Params = FSLGoogleChartsParameters())
@@ -63,6 +71,29 @@ struct FSLGoogleCharts
 			return false;
 		}
 
+		// Large episodes are aggregated per individual and time bucket, with the levels loaded lazily by the page
+		if (Params.LODEventsThreshold > 0 && InEvents.Num() > Params.LODEventsThreshold)
+		{
+			TArray<FSLEventSnapshot> SelectedEvents;
+			SelectedEvents.Reserve(InEvents.Num());
+			for (const auto& Ev : InEvents)
+			{
+				if (ShouldEventBeWritten(Ev, Params.EventsSelection))
+				{
+					SelectedEvents.Add(Ev);
+				}
+			}
+			if (SelectedEvents.Num() > Params.LODEventsThreshold)
+			{
+				FSLTimelineLODParameters LODParams = Params.LODParams;
+				LODParams.StartTime = Params.StartTime;
+				LODParams.EndTime = Params.EndTime;
+				LODParams.TaskId = Params.TaskId;
+				LODParams.EpisodeId = Params.EpisodeId;
+				return FSLTimelineLODWriter::Write(SelectedEvents, DirectoryPath, InEpId, LODParams, Params.bOverwrite);
+			}
+		}
+
 		// Timeline boilerplate 
 		FString TimelineStr =
 			"<script type=\"text/javascript\" src=\"https://www.gstatic.com/charts/loader.js\"></script>\n"
@@ -116,19 +147,19 @@ struct FSLGoogleCharts
 				continue;
 			}
 
-			const FString StartStr = FString::Printf(TEXT("%.3f"), Ev->StartTime); //FString::SanitizeFloat(Ev->Start);
-			const FString EndStr = FString::Printf(TEXT("%.3f"), Ev->EndTime); //FString::SanitizeFloat(Ev->End);
-			const FString StartMsStr = FString::Printf(TEXT("%.3f"), Ev->StartTime * 1000.f); //FString::SanitizeFloat(Ev->Start * 1000.f);
-			const FString EndMsStr = FString::Printf(TEXT("%.3f"), Ev->EndTime * 1000.f);  //FString::SanitizeFloat(Ev->End * 1000.f);
+			const FString StartStr = FString::Printf(TEXT("%.3f"), Ev.StartTime); //FString::SanitizeFloat(Ev->Start);
+			const FString EndStr = FString::Printf(TEXT("%.3f"), Ev.EndTime); //FString::SanitizeFloat(Ev->End);
+			const FString StartMsStr = FString::Printf(TEXT("%.3f"), Ev.StartTime * 1000.f); //FString::SanitizeFloat(Ev->Start * 1000.f);
+			const FString EndMsStr = FString::Printf(TEXT("%.3f"), Ev.EndTime * 1000.f);  //FString::SanitizeFloat(Ev->End * 1000.f);
 
-			TimelineStr.Append("\t\t [ \'" + Ev->Context() + "\' , \'" + Ev->Id + "\' , " );
+			TimelineStr.Append("\t\t [ \'" + Ev.Context() + "\' , \'" + Ev.Id + "\' , " );
 			if (Params.bTooltips)
 			{
 				TimelineStr.Append(
 					"createTooltipHTMLContent("
 					+ StartStr + ", "
 					+ EndStr + ", "
-					+ Ev->Tooltip() + "), " );
+					+ Ev.Tooltip() + "), " );
 			}
 			TimelineStr.Append(StartMsStr + " , " + EndMsStr + " ],\n");  // google charts needs millisecods
 		}
@@ -188,7 +219,7 @@ struct FSLGoogleCharts
 private:
 
 	// Table showing the legend of the symbols
-	static FString GetLengend(const TArray<TSharedPtr<ISLEvent>>& InEvents)
+	static FString GetLengend(const TArray<FSLEventSnapshot>& InEvents)
 	{
 		FString Legend =
 			"\n"
@@ -197,50 +228,40 @@ private:
 	}
 
 	// Should the event be written
-	static bool ShouldEventBeWritten(TSharedPtr<ISLEvent> Event, const FLSymbolicEventsSelection& EventSelection)
+	static bool ShouldEventBeWritten(const FSLEventSnapshot& Event, const FLSymbolicEventsSelection& EventSelection)
 	{
-		if (!Event.IsValid())
-		{
-			return false;
-		}
 		if (EventSelection.bSelectAll)
 		{
 			return true;
 		}
-		/* Contact */
-		else if (Event.Get()->TypeName().StartsWith("Contact"))
+
+		switch (Event.Kind)
 		{
+		/* Contact */
+		case ESLEventKind::Contact:
 			return EventSelection.bContact || EventSelection.bManipulatorContact;
-		}
 		/* SupportedBy */
-		else if (Event.Get()->TypeName().StartsWith("SupportedBy"))
-		{
+		case ESLEventKind::SupportedBy:
 			return EventSelection.bSupportedBy;
-		}
 		/* Reach + PreGrasp*/
-		else if (Event.Get()->TypeName().StartsWith("Reach")
-			|| Event.Get()->TypeName().StartsWith("PreGrasp")
-			)
-		{
+		case ESLEventKind::Reach:
+		case ESLEventKind::PreGrasp:
 			return EventSelection.bReachAndPreGrasp;
-		}
 		/* Grasp */
-		else if (Event.Get()->TypeName().StartsWith("Grasp"))
-		{
+		case ESLEventKind::Grasp:
 			return EventSelection.bGrasp;
-		}
 		/* PickAndPlace */
-		else if (Event.Get()->TypeName().StartsWith("Slide")
-			|| Event.Get()->TypeName().StartsWith("PickUp")
-			|| Event.Get()->TypeName().StartsWith("Transport")
-			|| Event.Get()->TypeName().StartsWith("PutDown")
-			)
-		{
+		case ESLEventKind::Slide:
+		case ESLEventKind::PickUp:
+		case ESLEventKind::Transport:
+		case ESLEventKind::PutDown:
 			return EventSelection.bPickAndPlace;
+		default:
+			break;
 		}
 		
 		UE_LOG(LogTemp, Error, TEXT("%s::%d Unknown event %s, will be written anyhow.."),
-			*FString(__FUNCTION__), __LINE__, *Event.Get()->ToString());
+			*FString(__FUNCTION__), __LINE__, ISLEvent::GetKindName(Event.Kind));
 		return true;
 
 		//// TODO switch to UPROPERTY pure dynamic_cast does not work without RTTI
@@ -59,5 +59,27 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("Grasp")); };
+
+	// Get the event kind
+	virtual ESLEventKind Kind() const override { return ESLEventKind::Grasp; };
+
+	// Get the participants with their roles
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const override
+	{
+		OutParticipants.Emplace(Manipulator, ESLEventRole::Agent);
+		OutParticipants.Emplace(Individual, ESLEventRole::Patient);
+	};
 	/* End IEvent interface */
+
+	/* Serialization from plain data (shared with the event snapshots) */
+	// Create the owl representation of the event
+	static FSLOwlNode CreateOwlNode(const FString& InId, float InStart, float InEnd,
+		const FString& ManipulatorId, const FString& IndividualId, const FString& InGraspType, const FString& InEpisodeId);
+
+	// Get the context data
+	static FString CreateContext(uint64 InPairId);
+
+	// Get the tooltip data
+	static FString CreateTooltip(const FString& ManipulatorClass, const FString& ManipulatorId,
+		const FString& IndividualClass, const FString& IndividualId, const FString& InId);
 };
\ No newline at end of file
@@ -41,8 +41,8 @@ private:
 	// Parent
 	class USLManipulatorMonitor* Parent;
 
-	// Array of started events
-	TArray<TSharedPtr<FSLGraspEvent>> StartedEvents;
+	// Started events, keyed by the grasped individual
+	TMap<USLBaseIndividual*, TSharedPtr<FSLGraspEvent>> StartedEvents;
 	
 	/* Constant values */
 	constexpr static float GraspEventMin = 0.25f;
@@ -47,6 +47,6 @@ private:
 	// Parent semantic overlap area
 	class USLManipulatorMonitor* Parent = nullptr;
 
-	// Array of started contact events
-	TArray<TSharedPtr<FSLContactEvent>> StartedEvents;
+	// Started contact events, keyed by the other individual
+	TMap<USLBaseIndividual*, TSharedPtr<FSLContactEvent>> StartedEvents;
 };
@@ -55,5 +55,16 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("PreGrasp")); };
+
+	// Get the event kind
+	virtual ESLEventKind Kind() const override { return ESLEventKind::PreGrasp; };
+
+	// Get the participants with their roles, the manipulator (agent) first, then the individual (patient),
+	// the outputs list them in this order (json triples: AgentRole classifies the manipulator, Patient the individual)
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const override
+	{
+		OutParticipants.Emplace(Manipulator, ESLEventRole::Agent);
+		OutParticipants.Emplace(Individual, ESLEventRole::Patient);
+	};
 	/* End IEvent interface */
 };
\ No newline at end of file
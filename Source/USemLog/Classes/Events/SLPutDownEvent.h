@@ -55,5 +55,15 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("PutDown")); };
+
+	// Get the event kind
+	virtual ESLEventKind Kind() const override { return ESLEventKind::PutDown; };
+
+	// Get the participants with their roles
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const override
+	{
+		OutParticipants.Emplace(Manipulator, ESLEventRole::Agent);
+		OutParticipants.Emplace(Individual, ESLEventRole::Patient);
+	};
 	/* End IEvent interface */
 };
\ No newline at end of file
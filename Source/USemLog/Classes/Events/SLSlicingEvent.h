@@ -66,5 +66,20 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("Slicing")); };
+
+	// Get the event kind
+	virtual ESLEventKind Kind() const override { return ESLEventKind::Slicing; };
+
+	// Get the participants with their roles
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const override
+	{
+		OutParticipants.Emplace(PerformedBy, ESLEventRole::Agent);
+		OutParticipants.Emplace(DeviceUsed, ESLEventRole::Instrument);
+		OutParticipants.Emplace(ObjectActedOn, ESLEventRole::Patient);
+		if (bTaskSuccessful && CreatedSlice)
+		{
+			OutParticipants.Emplace(CreatedSlice, ESLEventRole::Output);
+		}
+	};
 	/* End IEvent interface */
 };
\ No newline at end of file
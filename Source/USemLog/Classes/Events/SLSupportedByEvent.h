@@ -55,5 +55,27 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("SupportedBy")); };
+
+	// Get the event kind
+	virtual ESLEventKind Kind() const override { return ESLEventKind::SupportedBy; };
+
+	// Get the participants with their roles
+	virtual void GetParticipants(FSLEventParticipants& OutParticipants) const override
+	{
+		OutParticipants.Emplace(SupportedIndividual, ESLEventRole::Supported);
+		OutParticipants.Emplace(SupportingIndividual, ESLEventRole::Supporter);
+	};
 	/* End IEvent interface */
+
+	/* Serialization from plain data (shared with the event snapshots) */
+	// Create the owl representation of the event
+	static FSLOwlNode CreateOwlNode(const FString& InId, float InStart, float InEnd,
+		const FString& SupportedIndividualId, const FString& SupportingIndividualId, const FString& InEpisodeId);
+
+	// Get the context data
+	static FString CreateContext(uint64 InPairId);
+
+	// Get the tooltip data
+	static FString CreateTooltip(const FString& SupportedIndividualClass, const FString& SupportedIndividualId,
+		const FString& SupportingIndividualClass, const FString& SupportingIndividualId, const FString& InId);
 };
\ No newline at end of file
@@ -0,0 +1,122 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Events/ISLEvent.h"
+#include "Events/SLEventSnapshot.h"
+
+/**
+* Parameters of the level-of-detail timeline export
+*/
+struct FSLTimelineLODParameters
+{
+	// Number of aggregated levels (the raw events are written as an extra last level)
+	int32 NumLevels = 4;
+
+	// Number of buckets of the coarsest level over the episode duration
+	int32 CoarsestBuckets = 64;
+
+	// Each level has this many times more buckets than the previous one
+	int32 BucketsFactor = 4;
+
+	// Write the raw events as the last level
+	bool bWriteRawLevel = true;
+
+	// Episode interval (taken from the events if not set)
+	float StartTime = -1.f;
+	float EndTime = -1.f;
+
+	// Task / episode ids (page title)
+	FString TaskId;
+	FString EpisodeId;
+};
+
+/**
+* Event placed on a timeline row
+*/
+struct FSLTimelineRowEvent
+{
+	// Row (individual) and event kind indexes
+	int32 Row;
+	int32 Kind;
+
+	// Interval in seconds
+	float Start;
+	float End;
+
+	// Index of the event id
+	int32 EventIdx;
+};
+
+/**
+* Aggregated bar of a timeline row (one or more merged events of the same kind)
+*/
+struct FSLTimelineBar
+{
+	// Row (individual) and event kind indexes
+	int32 Row;
+	int32 Kind;
+
+	// Interval in seconds
+	float Start;
+	float End;
+
+	// Number of merged events
+	int32 Count;
+
+	// Event index (raw level only)
+	int32 EventIdx;
+};
+
+/**
+* Writes the timeline of large episodes as an html page with lazily loaded sidecar levels,
+* the events are aggregated per individual, event kind and time bucket at several zoom levels
+*/
+class USEMLOG_API FSLTimelineLODWriter
+{
+public:
+	// Write the page and the level sidecars (<EpId>_TL.html, <EpId>_TL_L<N>.js)
+	static bool Write(const TArray<FSLEventSnapshot>& InEvents,
+		const FString& DirectoryPath,
+		const FString& InEpId,
+		const FSLTimelineLODParameters& Params = FSLTimelineLODParameters(),
+		bool bOverwrite = false);
+
+	// Write the page and the level sidecars from already split row events (e.g. loaded from an offline log)
+	static bool Write(TArray<FString> Rows,
+		TArray<FSLTimelineRowEvent> RowEvents,
+		const TArray<FString>& EventIds,
+		const FString& DirectoryPath,
+		const FString& InEpId,
+		const FSLTimelineLODParameters& Params = FSLTimelineLODParameters(),
+		bool bOverwrite = false);
+
+private:
+	// Get the path of the level sidecar
+	static FString GetLevelFilePath(const FString& DirectoryPath, const FString& InEpId, int32 Level);
+
+	// Split the events per individual row
+	static void CreateRowEvents(const TArray<FSLEventSnapshot>& InEvents,
+		TArray<FString>& OutRows, TArray<FSLTimelineRowEvent>& OutRowEvents);
+
+	// Sort the rows alphabetically and the row events by row, kind and start time
+	static void SortRowEvents(TArray<FString>& InOutRows, TArray<FSLTimelineRowEvent>& InOutRowEvents);
+
+	// Aggregate the sorted row events into bars snapped to the bucket width
+	static void AggregateLevel(const TArray<FSLTimelineRowEvent>& RowEvents, float Origin, float BucketWidth,
+		TArray<FSLTimelineBar>& OutBars);
+
+	// Write the level sidecar (json data wrapped in a callback so it can be loaded from a local file)
+	static bool WriteLevel(const FString& FilePath, int32 Level, float BucketWidth,
+		const TArray<FSLTimelineBar>& Bars, const TArray<FString>& Rows,
+		const TArray<FString>& EventIds);
+
+	// Get the html page
+	static FString GetPage(const FString& InEpId, const FSLTimelineLODParameters& Params,
+		const TArray<float>& BucketWidths, float StartTime, float EndTime);
+
+	// Get the row label of the individual
+	static FString GetRowLabel(const FSLIndividualSnapshot* Individual);
+};
@@ -0,0 +1,116 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/AsyncWork.h"
+#include "Containers/Queue.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Mongo/SLMongoSchema.h"
+
+// Forward declarations
+class FSLMongoEpisodeLoader;
+
+/**
+ * Async task streaming the episode cursor batches into the loader queue
+ */
+class FSLMongoEpisodeLoaderAsyncTask : public FNonAbandonableTask
+{
+public:
+	// Set the loader to stream into
+	void Init(FSLMongoEpisodeLoader* InLoader) { Loader = InLoader; };
+
+	// Do the loading here
+	void DoWork();
+
+	// Needed internally
+	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FSLMongoEpisodeLoaderAsyncTask, STATGROUP_ThreadPoolAsyncTasks); }
+
+private:
+	// Owner of the loaded frames
+	FSLMongoEpisodeLoader* Loader = nullptr;
+};
+
+
+/**
+ * Loads the episode frames in the background with its own server connection,
+ * the decoded frames are handed over in chunks so they can be consumed while the episode is still loading
+ */
+class USEMLOG_API FSLMongoEpisodeLoader
+{
+	friend class FSLMongoEpisodeLoaderAsyncTask;
+
+public:
+	// Episode frame (timestamp, individual id to pose)
+	typedef TPair<float, TMap<FString, FTransform>> FFrame;
+
+	// Ctor
+	FSLMongoEpisodeLoader();
+
+	// Dtor, cancels and waits for the loading
+	~FSLMongoEpisodeLoader();
+
+	// Start loading the collection in the background, BatchSize frames are requested and handed over at a time
+	bool Start(const FString& InUri, const FString& InDBName, const FString& InCollName, const FSLMongoSchema& InSchema, int32 InBatchSize = 256);
+
+	// Request the loading to stop (the already loaded frames can still be consumed)
+	void Cancel() { bCancelRequested = true; };
+
+	// Block until the background loading is done
+	void Wait();
+
+	// Move the frames loaded since the last call to the output (appended, in timestamp order), returns the number of moved frames
+	int32 ConsumeFrames(TArray<FFrame>& OutFrames);
+
+	// True if the loading was started
+	bool IsStarted() const { return bStarted; };
+
+	// True if the background loading finished, was cancelled or failed
+	bool IsDone() const { return bDone; };
+
+	// True if the loading was cancelled before reaching the end of the collection
+	bool WasCancelled() const { return bCancelled; };
+
+	// True if the connection or the query failed
+	bool HasError() const { return bError; };
+
+	// Number of decoded frames
+	int32 NumLoaded() const { return NumLoadedFrames.GetValue(); };
+
+	// Number of frames in the episode (0 until counted)
+	int32 NumTotal() const { return NumTotalFrames.GetValue(); };
+
+	// Loading progress [0, 1]
+	float GetProgress() const;
+
+private:
+	// Connection and collection
+	FString Uri;
+	FString DBName;
+	FString CollName;
+
+	// Layout of the collection documents
+	FSLMongoSchema Schema;
+
+	// Number of frames per cursor batch and handed over chunk
+	int32 BatchSize;
+
+	// Decoded chunks waiting to be consumed (written by the task, read by the owner)
+	TQueue<TArray<FFrame>, EQueueMode::Spsc> Chunks;
+
+	// Progress counters
+	FThreadSafeCounter NumLoadedFrames;
+	FThreadSafeCounter NumTotalFrames;
+
+	// State flags
+	bool bStarted;
+	FThreadSafeBool bCancelRequested;
+	FThreadSafeBool bCancelled;
+	FThreadSafeBool bError;
+	FThreadSafeBool bDone;
+
+	// Background loading
+	FAsyncTask<FSLMongoEpisodeLoaderAsyncTask>* LoaderTask;
+};
@@ -0,0 +1,144 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/AsyncWork.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Mongo/SLMongoQueryDBHandler.h"
+
+// Forward declarations
+class FQueuedThreadPool;
+
+/**
+* Episode (collection) of a task (database)
+*/
+struct FSLMongoEpisodeRef
+{
+	// Ctor
+	FSLMongoEpisodeRef() {};
+	FSLMongoEpisodeRef(const FString& InTaskId, const FString& InEpisodeId) : TaskId(InTaskId), EpisodeId(InEpisodeId) {};
+
+	FString TaskId;
+	FString EpisodeId;
+};
+
+/**
+* Query result of an episode, tagged with the episode it was computed from
+*/
+template<typename ResultType>
+struct TSLMongoEpisodeResult
+{
+	FString TaskId;
+	FString EpisodeId;
+
+	// False if the episode could not be opened (the result is default constructed)
+	bool bSuccess = false;
+
+	ResultType Result;
+};
+
+/**
+* Episodes and query shared by the fan out workers
+*/
+struct FSLMongoFanOutWork
+{
+	const TArray<FSLMongoEpisodeRef>* Episodes = nullptr;
+	TFunctionRef<void(int32 EpisodeIdx, const FSLMongoQueryDBHandler& Handler)>* Query = nullptr;
+	TArray<bool>* Success = nullptr;
+
+	// Next episode to query, every worker pulls episodes until none are left
+	FThreadSafeCounter NextIdx;
+	FThreadSafeCounter NumFailed;
+
+#if SL_WITH_LIBMONGO_C
+	mongoc_client_pool_t* pool = nullptr;
+#endif // SL_WITH_LIBMONGO_C
+};
+
+/**
+ * Async task querying episodes with its own client until no episodes are left
+ */
+class FSLMongoFanOutAsyncTask : public FNonAbandonableTask
+{
+public:
+	// Set the shared work
+	void Init(FSLMongoFanOutWork* InWork) { Work = InWork; };
+
+	// Do the querying here
+	void DoWork();
+
+	// Needed internally
+	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FSLMongoFanOutAsyncTask, STATGROUP_ThreadPoolAsyncTasks); }
+
+private:
+	// Episodes and query shared by the workers
+	FSLMongoFanOutWork* Work = nullptr;
+};
+
+/**
+* Runs the same query over several episodes concurrently, every worker queries with its own client from a bounded client pool;
+* the workers run on a dedicated thread pool, the blocking queries do not occupy the task graph or the global thread pool
+*/
+class USEMLOG_API FSLMongoFanOut
+{
+public:
+	// Ctor, at most MaxConnections episodes are queried at a time (<= 0 uses the number of worker threads)
+	FSLMongoFanOut(const FString& InUri, int32 InMaxConnections = 0);
+
+	// Dtor
+	~FSLMongoFanOut();
+
+	// True if the client pool was created
+	bool IsValid() const;
+
+	// Run the query on every episode, the handler is ready (task and episode set) and only valid during the call;
+	// the query is called concurrently with distinct episode indexes
+	bool RunEach(const TArray<FSLMongoEpisodeRef>& Episodes,
+		TFunctionRef<void(int32 EpisodeIdx, const FSLMongoQueryDBHandler& Handler)> Query, TArray<bool>& OutSuccess);
+
+	// Run the query on every episode and merge the results in the episode order
+	template<typename ResultType>
+	TArray<TSLMongoEpisodeResult<ResultType>> Run(const TArray<FSLMongoEpisodeRef>& Episodes,
+		TFunctionRef<ResultType(const FSLMongoQueryDBHandler& Handler)> Query)
+	{
+		TArray<TSLMongoEpisodeResult<ResultType>> Results;
+		Results.SetNum(Episodes.Num());
+		for (int32 Idx = 0; Idx < Episodes.Num(); ++Idx)
+		{
+			Results[Idx].TaskId = Episodes[Idx].TaskId;
+			Results[Idx].EpisodeId = Episodes[Idx].EpisodeId;
+		}
+
+		TArray<bool> Success;
+		RunEach(Episodes, [&Results, &Query](int32 EpisodeIdx, const FSLMongoQueryDBHandler& Handler)
+		{
+			Results[EpisodeIdx].Result = Query(Handler);
+		}, Success);
+
+		for (int32 Idx = 0; Idx < Success.Num(); ++Idx)
+		{
+			Results[Idx].bSuccess = Success[Idx];
+		}
+		return Results;
+	}
+
+	// Maximal number of concurrent connections
+	int32 GetMaxConnections() const { return MaxConnections; };
+
+private:
+	// Maximal number of concurrent connections
+	int32 MaxConnections;
+
+	// Threads of the workers (one per connection)
+	FQueuedThreadPool* ThreadPool;
+
+#if SL_WITH_LIBMONGO_C
+	// Server uri
+	mongoc_uri_t* uri;
+
+	// Thread safe pool of the worker clients
+	mongoc_client_pool_t* pool;
+#endif // SL_WITH_LIBMONGO_C
+};
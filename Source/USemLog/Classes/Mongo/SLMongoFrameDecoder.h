@@ -0,0 +1,50 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+#if SL_WITH_LIBMONGO_C
+THIRD_PARTY_INCLUDES_START
+#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <mongoc/mongoc.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+#else
+	#include <mongoc/mongoc.h>
+#endif // #if PLATFORM_WINDOWS
+THIRD_PARTY_INCLUDES_END
+
+/**
+ * Single-pass decoding of the world state documents, every document (and sub-document) is walked once
+ * instead of being searched again for each pose field
+ */
+class USEMLOG_API FSLMongoFrameDecoder
+{
+public:
+	// Decode the pose (loc, quat) of the document
+	static bool DecodePose(const bson_t* doc, FTransform& OutPose);
+
+	// Decode the pose (loc, quat) of the sub-document the iterator points to
+	static bool DecodePose(const bson_iter_t* iter, FTransform& OutPose);
+
+	// Decode the id and the pose of the individual sub-document the iterator points to
+	static bool DecodeIndividual(const bson_iter_t* iter, FString& OutId, FTransform& OutPose);
+
+	// Decode the timestamp and the individuals of the given array of a frame document, returns the number of decoded individuals
+	static int32 DecodeFrame(const bson_t* doc, const char* ArrayName, double& OutTs,
+		TFunctionRef<void(FString&& Id, const FTransform& Pose)> OnIndividual);
+
+	// Read a numeric value as double (0 if not numeric)
+	static double GetDouble(const bson_iter_t* iter);
+
+private:
+	// Walk the fields of the pose document once
+	static bool DecodePoseFields(bson_iter_t* fields, FVector& OutLoc, FQuat& OutQuat, FString* OutId);
+
+	// Create the pose from the decoded values
+	static FTransform MakePose(const FVector& Loc, FQuat Quat);
+};
+#endif // SL_WITH_LIBMONGO_C
@@ -0,0 +1,43 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Mongo/SLMongoFrameDecoder.h"
+
+#if SL_WITH_LIBMONGO_C
+/**
+ * Reads the frame documents of a cursor in a pipeline: the calling thread only pulls and copies the raw documents,
+ * the batches are decoded in parallel by task graph workers, and handed back in cursor order
+ */
+class USEMLOG_API FSLMongoPipelinedReader
+{
+public:
+	// Decoded frame (timestamp, individual id to pose)
+	typedef TPair<float, TMap<FString, FTransform>> FFrame;
+
+	// Ctor, MaxBatchesInFlight <= 0 uses the number of worker threads
+	FSLMongoPipelinedReader(int32 InBatchSize = 256, int32 InMaxBatchesInFlight = 0);
+
+	// Read the whole cursor, OnBatch is called on the calling thread with the decoded batches in order,
+	// returns false if the cursor failed or the reading was cancelled
+	bool Read(mongoc_cursor_t* cursor, TFunctionRef<void(TArray<FFrame>&& Frames)> OnBatch,
+		const FThreadSafeBool* bCancel = nullptr);
+
+	// Name of the individuals array in the frame documents
+	void SetArrayName(const char* InArrayName) { ArrayName = InArrayName; };
+
+private:
+	// Number of documents per batch
+	int32 BatchSize;
+
+	// Maximal number of batches being decoded at the same time (bounds the memory of the raw copies)
+	int32 MaxBatchesInFlight;
+
+	// Individuals array name
+	const char* ArrayName = "individuals";
+};
+#endif // SL_WITH_LIBMONGO_C
@@ -0,0 +1,158 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Sorted pose samples of an individual, stored as columns
+*/
+struct FSLMongoPoseTrack
+{
+	// Sample timestamps (ascending)
+	TArray<float> Timestamps;
+
+	// Sample locations
+	TArray<FVector> Locations;
+
+	// Sample rotations
+	TArray<FQuat> Rotations;
+
+	// Number of samples
+	int32 Num() const { return Timestamps.Num(); };
+
+	// Get the sample pose
+	FTransform GetPose(int32 Idx) const { return FTransform(Rotations[Idx], Locations[Idx]); };
+
+	// Append a sample
+	void Add(float Ts, const FTransform& Pose)
+	{
+		Timestamps.Add(Ts);
+		Locations.Add(Pose.GetLocation());
+		Rotations.Add(Pose.GetRotation());
+	};
+
+	// Get the poses as transforms
+	TArray<FTransform> GetPoses() const
+	{
+		TArray<FTransform> Poses;
+		Poses.Reserve(Num());
+		for (int32 Idx = 0; Idx < Num(); ++Idx)
+		{
+			Poses.Add(GetPose(Idx));
+		}
+		return Poses;
+	};
+};
+
+/**
+* Sorted pose samples of a skeletal individual and of its bones, stored as columns
+*/
+struct FSLMongoSkeletalPoseTrack
+{
+	// Actor poses
+	FSLMongoPoseTrack Track;
+
+	// Bone index to bone poses (sampled with the actor)
+	TMap<int32, FSLMongoPoseTrack> BoneTracks;
+
+	// Number of samples
+	int32 Num() const { return Track.Num(); };
+};
+
+/**
+* In-memory pose index of an episode, answers point and range queries with binary searches
+* (same semantics as the server queries: the last pose at or before the given time)
+*/
+class USEMLOG_API FSLMongoPoseIndex
+{
+public:
+	// Set the memory budget in bytes (<= 0 means unlimited)
+	void SetMemoryBudget(int64 InMemoryBudget) { MemoryBudget = InMemoryBudget; };
+
+	// Add a sample, returns false if the memory budget is exceeded
+	bool Add(const FString& Id, float Ts, const FTransform& Pose);
+
+	// Sort the tracks if samples were added out of order, the index can be queried afterwards
+	void Finish();
+
+	// Clear the index
+	void Reset();
+
+	// True if the index can be queried
+	bool IsLoaded() const { return bLoaded; };
+
+	// True if the memory budget was exceeded while adding samples
+	bool IsOverBudget() const { return bOverBudget; };
+
+	// Number of indexed individuals
+	int32 Num() const { return Tracks.Num(); };
+
+	// Total number of indexed samples
+	int64 NumSamples() const { return NumSamplesTotal; };
+
+	// Approximate memory used by the index in bytes
+	int64 GetAllocatedSize() const { return AllocatedSize; };
+
+	// Upper bound of the index memory for the given size of the episode documents
+	// (every stored pose takes at least MinDocumentBytesPerSample bytes: seven doubles, their keys and the two sub-documents)
+	static int64 EstimateAllocatedSize(int64 DocumentsSize) { return DocumentsSize / MinDocumentBytesPerSample * SampleSize; };
+
+	// Check if the individual has samples
+	bool Contains(const FString& Id) const { return Tracks.Contains(Id); };
+
+	// Get the pose of the individual at the given time, optionally interpolated with the next sample
+	bool GetPoseAt(const FString& Id, float Ts, FTransform& OutPose, bool bInterpolate = false) const;
+
+	// Get the poses of all the individuals at the given time (individuals without samples before the time are skipped)
+	void GetFrameAt(float Ts, TMap<FString, FTransform>& OutFrame, bool bInterpolate = false) const;
+
+	// Get the poses of the individual between the given timestamps,
+	// if interpolated and DeltaT > 0 the poses are resampled at every DeltaT instead of thinned
+	bool GetTrajectory(const FString& Id, float StartTs, float EndTs, TArray<FTransform>& OutTrajectory,
+		float DeltaT = -1.f, bool bInterpolate = false) const;
+
+	// Get the samples of the individual between the given timestamps as a track,
+	// if interpolated and DeltaT > 0 the poses are resampled at every DeltaT instead of thinned
+	bool GetTrack(const FString& Id, float StartTs, float EndTs, FSLMongoPoseTrack& OutTrack,
+		float DeltaT = -1.f, bool bInterpolate = false) const;
+
+	// Get the track of the individual (nullptr if not indexed)
+	const FSLMongoPoseTrack* FindTrack(const FString& Id) const { return Tracks.Find(Id); };
+
+private:
+	// Index of the last sample at or before the given time (INDEX_NONE if there is none)
+	static int32 FindLastAtOrBefore(const TArray<float>& Timestamps, float Ts);
+
+	// Pose at the given time interpolated between the sample and the next one
+	static FTransform Interpolate(const FSLMongoPoseTrack& Track, int32 Idx, float Ts);
+
+	// Approximate size of one sample
+	static constexpr int64 SampleSize = sizeof(float) + sizeof(FVector) + sizeof(FQuat);
+
+	// Minimal size of one pose in the episode documents
+	static constexpr int64 MinDocumentBytesPerSample = 96;
+
+private:
+	// Pose tracks of the individuals
+	TMap<FString, FSLMongoPoseTrack> Tracks;
+
+	// Maximal allowed memory usage in bytes
+	int64 MemoryBudget = 0;
+
+	// Approximate memory usage in bytes
+	int64 AllocatedSize = 0;
+
+	// Number of samples of all tracks
+	int64 NumSamplesTotal = 0;
+
+	// At least one track received an out of order sample
+	bool bNeedsSort = false;
+
+	// Index finished and within the budget
+	bool bLoaded = false;
+
+	// Memory budget exceeded
+	bool bOverBudget = false;
+};
@@ -0,0 +1,153 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/List.h"
+
+/**
+* Type of the cached query
+*/
+enum class ESLMongoQueryCacheType : uint8
+{
+	Pose,
+	Trajectory,
+	SkeletalPose,
+	SkeletalTrajectory
+};
+
+/**
+* Cached query parameters (point queries use StartTs only)
+*/
+struct FSLMongoQueryCacheKey
+{
+	// Ctor
+	FSLMongoQueryCacheKey(ESLMongoQueryCacheType InType, const FString& InTaskId, const FString& InEpisodeId,
+		const FString& InIndividualId, float InStartTs, float InEndTs = 0.f, float InDeltaT = 0.f) :
+		Type(InType), TaskId(InTaskId), EpisodeId(InEpisodeId), IndividualId(InIndividualId),
+		StartTs(InStartTs), EndTs(InEndTs), DeltaT(InDeltaT) {};
+
+	ESLMongoQueryCacheType Type;
+	FString TaskId;
+	FString EpisodeId;
+	FString IndividualId;
+	float StartTs;
+	float EndTs;
+	float DeltaT;
+
+	// Compare the query parameters
+	bool operator==(const FSLMongoQueryCacheKey& Other) const
+	{
+		return Type == Other.Type && StartTs == Other.StartTs && EndTs == Other.EndTs && DeltaT == Other.DeltaT
+			&& IndividualId.Equals(Other.IndividualId, ESearchCase::CaseSensitive)
+			&& EpisodeId.Equals(Other.EpisodeId, ESearchCase::CaseSensitive)
+			&& TaskId.Equals(Other.TaskId, ESearchCase::CaseSensitive);
+	};
+
+	// Hash of the query parameters
+	friend uint32 GetTypeHash(const FSLMongoQueryCacheKey& Key)
+	{
+		uint32 Hash = GetTypeHash(uint8(Key.Type));
+		Hash = HashCombine(Hash, GetTypeHash(Key.TaskId));
+		Hash = HashCombine(Hash, GetTypeHash(Key.EpisodeId));
+		Hash = HashCombine(Hash, GetTypeHash(Key.IndividualId));
+		Hash = HashCombine(Hash, GetTypeHash(Key.StartTs));
+		Hash = HashCombine(Hash, GetTypeHash(Key.EndTs));
+		return HashCombine(Hash, GetTypeHash(Key.DeltaT));
+	};
+};
+
+/**
+* Cached query result, a point query is stored as a single pose
+*/
+struct FSLMongoQueryCacheValue
+{
+	// Individual poses
+	TArray<FTransform> Poses;
+
+	// Bone poses of each individual pose (skeletal queries only)
+	TArray<TMap<int32, FTransform>> BonePoses;
+};
+
+/**
+* Query results of the server kept in memory with a byte budget, the least recently used results are evicted first
+*/
+class USEMLOG_API FSLMongoQueryCache
+{
+public:
+	// Set the memory budget in bytes (<= 0 disables the cache)
+	void SetMemoryBudget(int64 InMemoryBudget);
+
+	// Get the cached result, marks it as the most recently used
+	bool Find(const FSLMongoQueryCacheKey& Key, FSLMongoQueryCacheValue& OutValue);
+
+	// Store the result, evicts the least recently used ones if the budget is exceeded
+	void Add(const FSLMongoQueryCacheKey& Key, const FSLMongoQueryCacheValue& Value);
+
+	// Remove the results of the episode
+	void Invalidate(const FString& TaskId, const FString& EpisodeId);
+
+	// Remove the results of all the episodes of the task
+	void Invalidate(const FString& TaskId);
+
+	// Remove all results
+	void Reset();
+
+	// Reset the hit and miss counters
+	void ResetStats() { NumHits = 0; NumMisses = 0; };
+
+	// Number of cached results
+	int32 Num() const { return Entries.Num(); };
+
+	// Approximate memory used by the cached results in bytes
+	int64 GetAllocatedSize() const { return AllocatedSize; };
+
+	// Number of lookups answered from the cache
+	int64 GetNumHits() const { return NumHits; };
+
+	// Number of lookups not found in the cache
+	int64 GetNumMisses() const { return NumMisses; };
+
+	// Ratio of the lookups answered from the cache [0, 1]
+	float GetHitRatio() const { return NumHits + NumMisses > 0 ? float(NumHits) / float(NumHits + NumMisses) : 0.f; };
+
+private:
+	// Least recently used order (head is the most recent)
+	typedef TDoubleLinkedList<FSLMongoQueryCacheKey> FLruList;
+
+	// Cached result with its position in the usage list
+	struct FEntry
+	{
+		FSLMongoQueryCacheValue Value;
+		int64 Size = 0;
+		FLruList::TDoubleLinkedListNode* Node = nullptr;
+	};
+
+	// Remove the entries matching the predicate
+	template<typename PredicateType>
+	void RemoveIf(PredicateType Predicate);
+
+	// Remove the entry and its usage node
+	void Remove(const FSLMongoQueryCacheKey& Key);
+
+	// Approximate size of the result
+	static int64 CalcSize(const FSLMongoQueryCacheKey& Key, const FSLMongoQueryCacheValue& Value);
+
+private:
+	// Cached results
+	TMap<FSLMongoQueryCacheKey, FEntry> Entries;
+
+	// Usage order of the results
+	FLruList LruList;
+
+	// Maximal allowed memory usage in bytes
+	int64 MemoryBudget = 0;
+
+	// Approximate memory usage in bytes
+	int64 AllocatedSize = 0;
+
+	// Lookup counters
+	int64 NumHits = 0;
+	int64 NumMisses = 0;
+};
@@ -4,6 +4,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Mongo/SLMongoPoseIndex.h"
+#include "Mongo/SLMongoEpisodeLoader.h"
+#include "Mongo/SLMongoFrameDecoder.h"
+#include "Mongo/SLMongoSchema.h"
 
 #if SL_WITH_LIBMONGO_C
 class ASLVisionPoseableMeshActor;
@@ -33,6 +37,14 @@ public:
 	// Connect to the server
 	bool Connect(const FString& ServerIp, uint16 ServerPort);
 
+#if SL_WITH_LIBMONGO_C
+	// Use a client owned by the caller (e.g. popped from a client pool), it is not destroyed on disconnect
+	bool SetClient(mongoc_client_t* InClient);
+#endif // SL_WITH_LIBMONGO_C
+
+	// Get the server uri (empty if not connected)
+	FString GetUri() const;
+
 	// Set database
 	bool SetDatabase(const FString& InDBName);
 
@@ -45,6 +57,9 @@ public:
 	// Everything is set in order to query the data
 	bool IsReady() const { return bConnected && bDatabaseSet && bCollectionSet; };
 
+	// Layout of the episode documents (loaded when setting the collection)
+	const FSLMongoSchema& GetSchema() const { return Schema; };
+
 	/* Queries */
 	// Get the pose of the individual at the given time
 	FTransform GetIndividualPoseAt(const FString& Id, float Ts) const;
@@ -58,26 +73,56 @@ public:
 	// Get skeletal individual trajectory
 	TArray<TPair<FTransform, TMap<int32, FTransform>>> GetSkeletalIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT = -1.f) const;
 
+	// Get the trajectories of the individuals between the given timestamps in a single aggregation (column-oriented, one track per found individual)
+	TMap<FString, FSLMongoPoseTrack> GetIndividualsTrajectories(const TArray<FString>& Ids, float StartTs, float EndTs, float DeltaT = -1.f) const;
+
+	// Get the trajectories of the skeletal individuals between the given timestamps in a single aggregation
+	TMap<FString, FSLMongoSkeletalPoseTrack> GetSkeletalIndividualsTrajectories(const TArray<FString>& Ids, float StartTs, float EndTs, float DeltaT = -1.f) const;
+
 	// Get the whole episode data
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData() const;
 
-	// Get the whole episode data in an async thread
-	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeDataAsync() const;
+	// Load the poses of all the individuals of the episode into the index (fails if the index memory budget is exceeded)
+	bool LoadPoseIndex(FSLMongoPoseIndex& OutIndex) const;
 
-	// Get the episode data at the given timestamp (frame)
-	TMap<FString, FTransform> GetFrameData(float Ts);
+	// Get the uncompressed size in bytes of the episode documents (collStats), -1 if unknown
+	int64 GetEpisodeDataSize() const;
+
+	// Start loading the whole episode data in the background (own connection), the frames can be consumed while loading
+	TSharedPtr<FSLMongoEpisodeLoader> GetEpisodeDataAsync(int32 BatchSize = 256) const;
+
+	// Get the episode data at the given timestamp (frame), rebuilt from the previous keyframe and the following sparse documents
+	TMap<FString, FTransform> GetFrameData(float Ts) const;
 
-private:
 #if SL_WITH_LIBMONGO_C
 	/* Helpers */
 	// Get the pose data from bson document
-	FTransform GetPose(const bson_t* doc) const;
+	static FTransform GetPose(const bson_t* doc);
 
 	// Get the pose data from bson iterator
-	FTransform GetPose(const bson_iter_t* iter) const;
+	static FTransform GetPose(const bson_iter_t* iter);
 
 	// Get the timestamp value from document (used for trajectory delta time comparison)
-	double GetTs(const bson_t* doc) const;
+	static double GetTs(const bson_t* doc);
+#endif // SL_WITH_LIBMONGO_C
+
+private:
+#if SL_WITH_LIBMONGO_C
+	// Apply the individual poses of the frame document to the frame data
+	static void ApplyFrameDoc(const bson_t* doc, TMap<FString, FTransform>& OutFrameData);
+
+	// Load the schema of the episode from the meta collection (frames layout if none is stored) and make sure its indexes exist
+	void LoadSchema(const FString& EpisodeId);
+
+	// Append the stages keeping only the first document of every DeltaT interval (resampled on the server), the input pipeline is destroyed
+	static bson_t* AppendDownsampleStages(bson_t* pipeline, float StartTs, float DeltaT);
+
+	// Append the stages keeping only the first entry of every individual of the frames array in every DeltaT interval,
+	// the entries are regrouped into frames (resampled on the server), the input pipeline is destroyed
+	static bson_t* AppendFramesDownsampleStages(bson_t* pipeline, const char* ArrayField, float StartTs, float DeltaT);
+
+	// Copy the stages of the pipeline followed by the given ones, the input pipeline and the stages are destroyed
+	static bson_t* AppendStages(bson_t* pipeline, std::initializer_list<bson_t*> Stages);
 #endif // SL_WITH_LIBMONGO_C
 
 private:
@@ -90,6 +135,12 @@ private:
 	// Connected to a database
 	bool bCollectionSet;
 
+	// The client is destroyed on disconnect (false if borrowed)
+	bool bOwnsClient;
+
+	// Layout of the episode documents
+	FSLMongoSchema Schema;
+
 #if SL_WITH_LIBMONGO_C
 	// Server uri
 	mongoc_uri_t* uri;
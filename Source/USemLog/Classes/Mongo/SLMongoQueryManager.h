@@ -6,6 +6,8 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Info.h"
 #include "Mongo/SLMongoQueryDBHandler.h"
+#include "Mongo/SLMongoQueryCache.h"
+#include "Mongo/SLMongoFanOut.h"
 #include "SLMongoQueryManager.generated.h"
 
 /**
@@ -47,6 +49,18 @@ public:
 	// Check if the episode is selected
 	bool IsEpisodeSet() const { return bEpisodeSet; };
 
+	// Check if the pose queries of the active episode are answered from memory
+	bool IsPoseIndexLoaded() const { return PoseIndex.IsLoaded(); };
+
+	// Get the pose index of the active episode
+	const FSLMongoPoseIndex& GetPoseIndex() const { return PoseIndex; };
+
+	// Get the cache of the server query results
+	const FSLMongoQueryCache& GetQueryCache() const { return QueryCache; };
+
+	// Remove all cached query results
+	void InvalidateQueryCache() { QueryCache.Reset(); };
+
 	/* Queries */
 	// Get the individual pose
 	FTransform GetIndividualPoseAt(const FString& InTaskId, const FString& InEpisodeId, const FString& IndividualId, float Ts);
@@ -68,14 +82,59 @@ public:
 	TArray<TPair<FTransform, TMap<int32, FTransform>>>  GetSkeletalIndividualTrajectory(const FString& InEpisodeId, const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f);
 	TArray<TPair<FTransform, TMap<int32, FTransform>>>  GetSkeletalIndividualTrajectory(const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f) const;
 
+	// Get the trajectories of several individuals with one query (column-oriented, one track per found individual)
+	TMap<FString, FSLMongoPoseTrack> GetIndividualsTrajectories(const FString& InTaskId, const FString& InEpisodeId, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT = -1.f);
+	TMap<FString, FSLMongoPoseTrack> GetIndividualsTrajectories(const FString& InEpisodeId, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT = -1.f);
+	TMap<FString, FSLMongoPoseTrack> GetIndividualsTrajectories(const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT = -1.f) const;
+
+	// Get the trajectories of several skeletal individuals with one query
+	TMap<FString, FSLMongoSkeletalPoseTrack> GetSkeletalIndividualsTrajectories(const FString& InTaskId, const FString& InEpisodeId, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT = -1.f);
+	TMap<FString, FSLMongoSkeletalPoseTrack> GetSkeletalIndividualsTrajectories(const FString& InEpisodeId, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT = -1.f);
+	TMap<FString, FSLMongoSkeletalPoseTrack> GetSkeletalIndividualsTrajectories(const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT = -1.f) const;
+
 	// Get the episode data
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData(const FString& InTaskId, const FString& InEpisodeId);
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData(const FString& InEpisodeId);
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData() const;
 
+	// Get the poses of all the individuals at the given time (frame)
+	TMap<FString, FTransform> GetFrameData(const FString& InTaskId, const FString& InEpisodeId, float Ts);
+	TMap<FString, FTransform> GetFrameData(const FString& InEpisodeId, float Ts);
+	TMap<FString, FTransform> GetFrameData(float Ts) const;
+
+	// Start loading the episode data in the background, the frames can be consumed from the loader while loading
+	TSharedPtr<FSLMongoEpisodeLoader> GetEpisodeDataAsync(const FString& InTaskId, const FString& InEpisodeId, int32 BatchSize = 256);
+	TSharedPtr<FSLMongoEpisodeLoader> GetEpisodeDataAsync(const FString& InEpisodeId, int32 BatchSize = 256);
+	TSharedPtr<FSLMongoEpisodeLoader> GetEpisodeDataAsync(int32 BatchSize = 256) const;
+
+	/* Multi-episode queries (own pooled connections, the active task and episode are not changed) */
+	// Run the same query concurrently over the episodes, the results are tagged with their episode and kept in the given order
+	template<typename ResultType>
+	TArray<TSLMongoEpisodeResult<ResultType>> QueryEpisodes(const TArray<FSLMongoEpisodeRef>& Episodes,
+		TFunctionRef<ResultType(const FSLMongoQueryDBHandler& Handler)> Query) const
+	{
+		if (!bConnected)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Not connected to the server, connect first.."), *FString(__FUNCTION__), __LINE__);
+			return TArray<TSLMongoEpisodeResult<ResultType>>();
+		}
+		FSLMongoFanOut FanOut(DBHandler.GetUri(), MaxFanOutConnections);
+		return FanOut.Run<ResultType>(Episodes, Query);
+	};
+
+	// Get the individual trajectory in every episode
+	TArray<TSLMongoEpisodeResult<TArray<FTransform>>> GetIndividualTrajectory(const TArray<FSLMongoEpisodeRef>& Episodes, const FString& IndividualId, float StartTs, float EndTs, float DeltaT = -1.f) const;
+
+	// Get the trajectories of several individuals in every episode
+	TArray<TSLMongoEpisodeResult<TMap<FString, FSLMongoPoseTrack>>> GetIndividualsTrajectories(const TArray<FSLMongoEpisodeRef>& Episodes, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT = -1.f) const;
+
 	// Spawn or get manager from the world
 	static ASLMongoQueryManager* GetExistingOrSpawnNew(UWorld* World);
 
+private:
+	// True if the pose index of the active episode is estimated to exceed the memory budget (checked before loading it)
+	bool IsPoseIndexOverBudget() const;
+
 protected:
 	// True when successfully connected to the server
 	bool bConnected : 1;
@@ -86,6 +145,32 @@ protected:
 	// Episode set to query from
 	bool bEpisodeSet : 1;
 
+	// Load the poses of the episode in memory when it is set, point and range queries are then answered locally
+	// (the whole episode is transferred when it is set, off by default)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Pose Index")
+	bool bUsePoseIndex = false;
+
+	// Maximal memory usage of the pose index, if exceeded the queries are sent to the server (<= 0 means unlimited),
+	// episodes estimated above the budget from their stored size are not loaded
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Pose Index", meta = (editcondition = "bUsePoseIndex"))
+	int32 PoseIndexMemoryBudgetMB = 512;
+
+	// Interpolate between the indexed samples (instead of returning the last pose before the given time)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Pose Index", meta = (editcondition = "bUsePoseIndex"))
+	bool bInterpolateIndexedPoses = false;
+
+	// Keep the results of the server queries in memory, repeated queries are answered locally
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Query Cache")
+	bool bUseQueryCache = true;
+
+	// Maximal memory usage of the query cache, the least recently used results are evicted first
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Query Cache", meta = (editcondition = "bUseQueryCache"))
+	int32 QueryCacheMemoryBudgetMB = 64;
+
+	// Maximal number of episodes queried at the same time by the multi-episode queries (<= 0 uses the number of worker threads)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Multi-Episode Queries")
+	int32 MaxFanOutConnections = 8;
+
 private:
 	// Current active task
 	FString TaskId;
@@ -96,6 +181,12 @@ private:
 	// Database handler
 	FSLMongoQueryDBHandler DBHandler;
 
+	// In-memory poses of the active episode
+	FSLMongoPoseIndex PoseIndex;
+
+	// Results of the server queries (filled by the const queries)
+	mutable FSLMongoQueryCache QueryCache;
+
 	///* Editor button hacks */
 	//// Server ip to connect to
 	//UPROPERTY(EditAnywhere, Category = "Semantic Logger|Buttons")
@@ -0,0 +1,174 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if SL_WITH_LIBMONGO_C
+THIRD_PARTY_INCLUDES_START
+#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <mongoc/mongoc.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+#else
+	#include <mongoc/mongoc.h>
+#endif // #if PLATFORM_WINDOWS
+THIRD_PARTY_INCLUDES_END
+#endif //SL_WITH_LIBMONGO_C
+
+/**
+* Document layout of the world state collection
+*/
+enum class ESLMongoSchemaLayout : uint8
+{
+	// One document per frame with the individuals as arrays (timestamp, individuals[id, loc, quat])
+	Frames,
+
+	// One tf document per transform (header.stamp, child_frame_id, transform[translation, rotation])
+	Tf
+};
+
+/**
+* Versioned description of the world state documents of an episode, stored in the task meta collection;
+* the query pipelines and the indexes are generated from it, every pipeline outputs the same normalized documents:
+*	poses:  { timestamp, loc, quat [, bones: [{ idx, loc, quat }]] }
+*	frames: { timestamp, individuals: [{ id, loc, quat }] } or { timestamp, skel_individuals: [{ id, loc, quat, bones }] }
+*/
+struct USEMLOG_API FSLMongoSchema
+{
+	// Version of the frames layout (documents written before the schema was stored)
+	static constexpr int32 FramesVersion = 1;
+
+	// Version of the tf layout
+	static constexpr int32 TfVersion = 2;
+
+	// Latest version written by the world state logger
+	static constexpr int32 CurrentVersion = TfVersion;
+
+	// Schema of the episodes without stored schema
+	static FSLMongoSchema Frames();
+
+	// Schema of the tf layout, the timestamps are stored as dates relative to the given episode start (unix ms)
+	static FSLMongoSchema Tf(int64 InTimeOriginMs);
+
+	// Schema version
+	int32 Version = FramesVersion;
+
+	// Document layout
+	ESLMongoSchemaLayout Layout = ESLMongoSchemaLayout::Frames;
+
+	// Time field of the documents
+	FString TimeField;
+
+	// Id field of an individual entry
+	FString IdField;
+
+	// Location and rotation fields of an individual entry
+	FString LocField;
+	FString QuatField;
+
+	// Array of the individual entries of frame (and keyframe) documents
+	FString IndividualsArray;
+
+	// Array of the skeletal individual entries (frames layout)
+	FString SkeletalArray;
+
+	// Array of the bone entries of a skeletal individual (frames layout)
+	FString BonesArray;
+
+	// Field with the skeletal individual id of a bone document (tf layout)
+	FString SkeletonField;
+
+	// Bone index field of a bone entry (or document)
+	FString BoneIndexField;
+
+	// Date of the episode start in unix ms (tf layout)
+	int64 TimeOriginMs = 0;
+
+	// Check if the document times are dates
+	bool HasDateTime() const { return Layout == ESLMongoSchemaLayout::Tf; };
+
+	// Date (unix ms) of the episode time
+	int64 ToDateTime(double Ts) const { return TimeOriginMs + static_cast<int64>(FMath::RoundToDouble(Ts * 1000.0)); };
+
+	// Name of the layout
+	const TCHAR* GetLayoutName() const { return Layout == ESLMongoSchemaLayout::Tf ? TEXT("tf") : TEXT("frames"); };
+
+#if SL_WITH_LIBMONGO_C
+	/* Metadata */
+	// Create the metadata document of the episode
+	bson_t* CreateMetadataDoc(const FString& EpisodeId) const;
+
+	// Create the filter of the metadata document of the episode
+	static bson_t* CreateMetadataFilter(const FString& EpisodeId);
+
+	// Read the schema from the metadata document, false if missing fields or unknown version
+	static bool FromMetadataDoc(const bson_t* doc, FSLMongoSchema& OutSchema);
+
+	/* Documents (written by the world state logger) */
+	// Append the tf header (sequence, stamp as date of the episode time, frame)
+	void AppendTfHeader(bson_t* doc, int32 Seq, double Ts) const;
+
+	// Create the tf document of the transform at the given episode time
+	bson_t* CreateTfDoc(int32 Seq, double Ts, const FString& ChildFrameId, const FTransform& Pose) const;
+
+	// Link the tf document of a bone to its skeletal individual
+	void AppendTfBone(bson_t* doc, const FString& SkelId, int32 BoneIndex) const;
+
+	// Append the transform (translation, rotation) of the pose
+	static void AppendTfPose(bson_t* doc, FTransform Pose);
+
+	/* Indexes */
+	// Create the command building the indexes used by the query pipelines
+	bson_t* CreateIndexesCommand(const char* CollName) const;
+
+	/* Query pipelines */
+	// Last pose of the individual at or before the given time
+	bson_t* CreatePoseAtPipeline(const FString& Id, float Ts) const;
+
+	// Poses of the individual between the given times (ascending)
+	bson_t* CreateTrajectoryPipeline(const FString& Id, float StartTs, float EndTs) const;
+
+	// Last pose of the skeletal individual and of its bones at or before the given time
+	bson_t* CreateSkeletalPoseAtPipeline(const char* CollName, const FString& Id, float Ts) const;
+
+	// Poses of the skeletal individual and of its bones between the given times (ascending)
+	bson_t* CreateSkeletalTrajectoryPipeline(const char* CollName, const FString& Id, float StartTs, float EndTs) const;
+
+	// Frames of the given individuals (all if empty) between the given times (ascending), keyframes excluded
+	bson_t* CreateFramesPipeline(const TArray<FString>& Ids, float StartTs, float EndTs, bool bStartExclusive = false) const;
+
+	// Frames of the given skeletal individuals between the given times (ascending)
+	bson_t* CreateSkeletalFramesPipeline(const char* CollName, const TArray<FString>& Ids, float StartTs, float EndTs) const;
+
+	// All the frames of the episode (ascending), keyframes excluded
+	bson_t* CreateEpisodePipeline() const;
+
+	// Number of frames of the episode (single document with a count field)
+	bson_t* CreateFrameCountPipeline() const;
+
+	// Last keyframe at or before the given time
+	bson_t* CreateKeyframePipeline(float Ts) const;
+
+private:
+	// Append the time value (number or date)
+	void AppendTime(bson_t* doc, const char* key, double Ts) const;
+
+	// Create the time condition document, without bounds it only checks the field existence
+	bson_t* CreateTimeRange(const double* StartTs, bool bStartExclusive, const double* EndTs) const;
+
+	// Create the expression converting the date at the given field path to the episode time in seconds (tf layout)
+	bson_t* CreateTimestampExpr(const char* TimeVar) const;
+
+	// Create the array of the given ids
+	static bson_t* CreateIdsArray(const TArray<FString>& Ids);
+
+	// Frames pipeline with optional time bounds
+	bson_t* CreateFramesPipeline(const TArray<FString>& Ids, const double* StartTs, bool bStartExclusive, const double* EndTs) const;
+
+	// Skeletal pipelines of the tf layout, the bones are looked up by the skeletal individual id and the time of its document
+	bson_t* CreateTfSkeletalPipeline(const char* CollName, const TArray<FString>& Ids, const double* StartTs, const double* EndTs,
+		bool bLastOnly, bool bAsFrames) const;
+#endif //SL_WITH_LIBMONGO_C
+};
@@ -91,6 +91,12 @@ public:
 	// Give access to the group of which the shape belongs to for the grasping detection
 	ESLBoneContactGroup GetGroup() const { return Group;};
 
+	// Set the grasp detection group, call before init
+	void SetGroup(ESLBoneContactGroup NewGroup) { Group = NewGroup; };
+
+	// Set if the owner is a non skeletal finger (no bone to attach to), call before init
+	void SetIsNotSkeletal(bool bNewValue) { bIsNotSkeletal = bNewValue; };
+
 	// Get the bone name attached to
 	FName GetAttachedBoneName() const { return BoneName; };
 
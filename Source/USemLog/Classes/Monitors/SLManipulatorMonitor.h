@@ -105,6 +105,9 @@ public:
 	// Get finished state
 	bool IsFinished() const { return bIsFinished; };
 
+	// Set the children (fingers) of a non skeletal owner (e.g. grippers spawned at runtime), call before init
+	void SetFingers(const TArray<AStaticMeshActor*>& InFingers) { bIsNotSkeletal = true; Fingers = InFingers; };
+
 protected:
 #if WITH_EDITOR
 	// Called when a property is changed in the editor
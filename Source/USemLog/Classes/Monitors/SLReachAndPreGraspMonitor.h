@@ -5,6 +5,7 @@
 
 #include "USemLog.h"
 #include "Components/SphereComponent.h"
+#include "Monitors/SLReachCandidateTracker.h"
 #include "SLReachAndPreGraspMonitor.generated.h"
 
 // Forward declarations
@@ -33,17 +34,6 @@ struct FSLPreGraspEndEvent
 	float Time;
 };
 
-// Convenience enum
-enum ESLTimeAndDist
-{
-	SLTime = 0,
-	SLDist = 1
-};
-
-//typedef TPair<float, float> FSLTimeAndDistance;
-//using FSLTimeAndDistance = TPair<float, float>;
-using FSLTimeAndDist = TTuple<float, float>; // <Time, Distance>
-
 /** Notify when a reaching event happened*/
 DECLARE_MULTICAST_DELEGATE_FiveParams(FSLReachAndPreGraspEventSignature, USLBaseIndividual* /*Self*/, USLBaseIndividual* /*Other*/, float /*ReachStartTime*/, float /*ReachEndTime*/, float /*PreGraspEndTime*/);
 
@@ -107,9 +97,12 @@ private:
 	// Subscribe for hand contact and grasp events
 	bool SubscribeForManipulatorEvents();
 	
-	// Update callback, checks distance to hand, if it increases it resets the start time
+	// Update callback, records the hand motion and updates the candidates near the hand swept volume
 	void UpdateCandidatesData(float DeltaTime);
 
+	// Radius around the hand swept volume in which the candidates are updated (hand reach until the next update)
+	float GetCandidateInfluenceRadius(float DeltaTime) const;
+
 	// Publish currently overlapping components
 	void TriggerInitialOverlaps();
 
@@ -184,6 +177,14 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	float ConcatenateIfSmaller;
 
+	// Cell size of the spatial grid holding the candidates
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	float CandidateGridCellSize;
+
+	// How far back (in seconds) the hand motion is kept for back-tracking the reach start of late candidates
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	float ReachHistoryDuration;
+
 	// Semantic data component of the owner
 	USLIndividualComponent* OwnerIndividualComponent;
 
@@ -191,7 +192,7 @@ private:
 	USLBaseIndividual* OwnerIndividualObject;
 
 	// Individual candidates with information about the possible reaching time and distance form reaching actor
-	TMap<USLBaseIndividual*, FSLTimeAndDist> CandidatesData;
+	FSLReachCandidateTracker CandidatesTracker;
 
 	// Individuals and the start timestamp in contact with the manipulator (hand)
 	TMap<USLBaseIndividual*, float> ManipulatorContactData;
@@ -0,0 +1,164 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations
+class USLBaseIndividual;
+
+/**
+ * Sampled hand location, used for the motion prediction and for back-tracking the reach start
+ */
+struct FSLReachHandSample
+{
+	// Default ctor
+	FSLReachHandSample() = default;
+
+	// Init ctor
+	FSLReachHandSample(float InTime, const FVector& InLocation) :
+		Time(InTime), Location(InLocation) {};
+
+	// Sample timestamp
+	float Time;
+
+	// Hand location at the timestamp
+	FVector Location;
+};
+
+/**
+ * Reach data of a candidate individual
+ */
+struct FSLReachCandidateData
+{
+	// Default ctor
+	FSLReachCandidateData() = default;
+
+	// Init ctor
+	FSLReachCandidateData(float InReachStartTime, float InDist, const FIntVector& InCell, float InLastUpdateTime) :
+		ReachStartTime(InReachStartTime), ResetTime(0.f), Dist(InDist), Cell(InCell), LastUpdateTime(InLastUpdateTime) {};
+
+	// Time since the hand is moving towards the candidate
+	float ReachStartTime;
+
+	// The reach start cannot be back-tracked before this time (e.g. the hand lost contact with the candidate)
+	float ResetTime;
+
+	// Distance to the hand at the last update
+	float Dist;
+
+	// Grid cell the candidate is currently binned in
+	FIntVector Cell;
+
+	// Time of the last update, candidates outside of the hand swept volume are not updated (dormant)
+	float LastUpdateTime;
+};
+
+/**
+ * Keeps the reach candidates in a spatial grid and only updates the ones
+ * in the cells near the (predicted) swept volume of the hand, dormant candidates
+ * get their reach start time back-tracked from the recorded hand motion when woken up
+ */
+class USEMLOG_API FSLReachCandidateTracker
+{
+public:
+	// Default ctor
+	FSLReachCandidateTracker();
+
+	// Set the tracking parameters
+	void Init(float InCellSize, float InHistoryDuration, float InIgnoreMovementsSmallerThan);
+
+	// Remove all candidates and the hand motion history
+	void Reset();
+
+	// Clear the hand motion history (e.g. after a pause)
+	void ResetHandHistory() { HandHistory.Empty(); HandVelocity = FVector::ZeroVector; };
+
+	// Record the hand location and update the candidates around the hand swept volume
+	void Update(float Time, const FVector& HandLocation, float InfluenceRadius);
+
+	// Add candidate, the reach start time is back-tracked from the hand motion history
+	bool AddCandidate(USLBaseIndividual* Individual, float Time, const FVector& HandLocation);
+
+	// Remove candidate, returns false if it was not tracked
+	bool RemoveCandidate(USLBaseIndividual* Individual);
+
+	// Check if the individual is a candidate
+	bool Contains(USLBaseIndividual* Individual) const { return Candidates.Contains(Individual); };
+
+	// Get the reach start time of the candidate (refreshed if the candidate is dormant), returns false if not a candidate
+	bool GetReachStartTime(USLBaseIndividual* Individual, float& OutReachStartTime);
+
+	// Restart the reach of the candidate from the given time (e.g. the hand lost contact with it)
+	bool ResetReachStartTime(USLBaseIndividual* Individual, float Time);
+
+	// Number of tracked candidates
+	int32 Num() const { return Candidates.Num(); };
+
+	// Number of candidates updated during the last call
+	int32 GetLastNumUpdated() const { return LastNumUpdated; };
+
+	// Predicted hand velocity
+	FVector GetHandVelocity() const { return HandVelocity; };
+
+	// Get the candidate names as a string (debug)
+	FString GetCandidatesInfo() const;
+
+private:
+	// Update the reach data of the candidate, returns true if it changed cells
+	bool UpdateCandidate(FSLReachCandidateData& Data, const FVector& CandidateLocation, float Time, const FVector& HandLocation);
+
+	// Earliest time since the hand did not move away from the given location,
+	// bOutHitOldest is set if the walk reached the oldest sample (the reach could have started before the history)
+	float BacktrackReachStartTime(const FVector& CandidateLocation, float Time, const FVector& HandLocation, bool* bOutHitOldest = nullptr) const;
+
+	// Back-track the reach start of the dormant candidate, keeps its earlier start if the history is too short
+	void BacktrackDormantCandidate(FSLReachCandidateData& Data, const FVector& CandidateLocation, float Time, const FVector& HandLocation) const;
+
+	// Move the candidate to its new cell
+	void Rebin(USLBaseIndividual* Individual, FSLReachCandidateData& Data, const FIntVector& NewCell);
+
+	// Get the grid cell of the location
+	FIntVector GetCell(const FVector& Location) const
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X * InvCellSize),
+			FMath::FloorToInt(Location.Y * InvCellSize),
+			FMath::FloorToInt(Location.Z * InvCellSize));
+	};
+
+	// Get the tracked location of the individual
+	static FVector GetCandidateLocation(USLBaseIndividual* Individual);
+
+private:
+	// Candidates with their reach data
+	TMap<USLBaseIndividual*, FSLReachCandidateData> Candidates;
+
+	// Spatial grid of the candidates
+	TMap<FIntVector, TArray<USLBaseIndividual*>> Grid;
+
+	// Recorded hand locations (oldest first)
+	TArray<FSLReachHandSample> HandHistory;
+
+	// Hand velocity estimated from the last two samples
+	FVector HandVelocity;
+
+	// Time of the previous update
+	float PrevUpdateTime;
+
+	// Number of candidates updated during the last call
+	int32 LastNumUpdated;
+
+	// Size of a grid cell
+	float CellSize;
+
+	// Cached inverse of the cell size
+	float InvCellSize;
+
+	// How long to keep the hand motion history
+	float HistoryDuration;
+
+	// Distance changes smaller than this are considered idling
+	float IgnoreMovementsSmallerThan;
+};
@@ -5,6 +5,7 @@
 
 #include "CoreMinimal.h"
 #include "Owl/SLOwlDoc.h"
+#include "Owl/SLOwlTimepointRegistry.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 
 /**
@@ -27,14 +28,17 @@ protected:
 	// Array of timepoint individuals
 	TArray<FSLOwlNode> TimepointIndividuals;
 
-	// Set of registered timepoints (in order to avoid multiple individual declaration)
-	TArray<float> RegisteredTimepoints;
+	// Registered timepoints (in order to avoid multiple individual declaration)
+	FSLOwlTimepointRegistry RegisteredTimepoints;
+
+	// Ids of the timepoints merged into a canonical timepoint (quantized registry), to be remapped in the individuals
+	TMap<FString, FString> TimepointIdAliases;
 
 	// Array of object individuals
 	TArray<FSLOwlNode> ObjectIndividuals;
 
-	// Set of registered objects (in order to avoid multiple individual declaration)
-	TSet<USLBaseIndividual*> RegisteredObjects;
+	// Ids and classes of the registered objects (in order to avoid multiple individual declaration)
+	TMap<FString, FString> RegisteredObjects;
 
 	// Experiment individual
 	FSLOwlNode ExperimentIndividual;
@@ -53,19 +57,43 @@ public:
 	// Destructor
 	~FSLOwlExperiment() {}
 
+	// Set the resolution (in seconds) of the timepoints, closer timepoints share the same individual
+	void SetTimepointResolution(float InResolution)
+	{
+		RegisteredTimepoints.SetResolution(InResolution);
+	}
+
 	// Add timepoint individual value
 	void RegisterTimepoint(const float Timepoint)
 	{
-		RegisteredTimepoints.AddUnique(Timepoint);
+		const float Canonical = RegisteredTimepoints.Register(Timepoint);
+		if (Canonical != Timepoint)
+		{
+			const FString Id = GetTimepointId(Timepoint);
+			const FString CanonicalId = GetTimepointId(Canonical);
+			if (!Id.Equals(CanonicalId))
+			{
+				TimepointIdAliases.Add(Id, CanonicalId);
+			}
+		}
 	}
 
 	// Add individual instalce value
 	bool RegisterObject(USLBaseIndividual* BI)
+	{
+		return RegisterObject(BI->GetIdValue(), BI->GetClassValue());
+	}
+
+	// Add individual instance value from its id and class (does not touch the individual object)
+	bool RegisterObject(const FString& InId, const FString& InClass)
 	{
 		// Avoid logging the same individual multiple times
-		bool* bIsAlreadyInSet = false;
-		RegisteredObjects.Add(BI, bIsAlreadyInSet);
-		return *bIsAlreadyInSet;
+		if (RegisteredObjects.Contains(InId))
+		{
+			return true;
+		}
+		RegisteredObjects.Add(InId, InClass);
+		return false;
 	}
 
 	// Create and add experiment node individual
@@ -97,15 +125,16 @@ public:
 			RdfResource, FSLOwlAttributeValue(Prefix, TaskId))));
 
 		// Add start and end time
-		if (RegisteredTimepoints.Num() > 2)
+		const TArray<float>& SortedTimepoints = RegisteredTimepoints.GetSorted();
+		if (SortedTimepoints.Num() > 2)
 		{
-			float StartTime = RegisteredTimepoints[0];
-			const FString StartTimeId = "timepoint_" + FString::SanitizeFloat(StartTime);
+			float StartTime = SortedTimepoints[0];
+			const FString StartTimeId = GetTimepointId(StartTime);
 			ExperimentIndividual.AddChildNode(FSLOwlNode(KrStartTime,
 				FSLOwlAttribute(RdfResource, FSLOwlAttributeValue("log", StartTimeId))));
 
-			float EndTime = RegisteredTimepoints.Last();
-			const FString EndTimeId = "timepoint_" + FString::SanitizeFloat(EndTime);
+			float EndTime = SortedTimepoints.Last();
+			const FString EndTimeId = GetTimepointId(EndTime);
 			ExperimentIndividual.AddChildNode(FSLOwlNode(KrEndTime,
 				FSLOwlAttribute(RdfResource, FSLOwlAttributeValue("log", EndTimeId))));
 		}
@@ -126,6 +155,7 @@ public:
 	// Add time / object individuals to document
 	void AddTimepointIndividuals()
 	{
+		RemapTimepointReferences();
 		CreateTimepointIndividuals();
 		if (TimepointIndividuals.Num() > 0)
 		{
@@ -156,17 +186,38 @@ private:
 			return;
 		}
 
-		// Sort timestamps
-		//RegisteredTimepoints.Sort([](const float& A, const float& B) { return A < B; });
-		RegisteredTimepoints.StableSort();
-
-		// Create and add time individuals
-		for (float Ts : RegisteredTimepoints)
+		// Create and add time individuals (sorted)
+		const TArray<float>& SortedTimepoints = RegisteredTimepoints.GetSorted();
+		TimepointIndividuals.Reserve(SortedTimepoints.Num());
+		for (float Ts : SortedTimepoints)
 		{
 			TimepointIndividuals.Add(CreateTimepointIndividual("log", Ts));
 		}
 	}
 
+	// Point the references of the merged timepoints to their canonical timepoint individual
+	void RemapTimepointReferences()
+	{
+		if (TimepointIdAliases.Num() == 0)
+		{
+			return;
+		}
+
+		for (auto& Individual : Individuals)
+		{
+			for (auto& Property : Individual.ChildNodes)
+			{
+				for (auto& Attribute : Property.Attributes)
+				{
+					if (const FString* CanonicalId = TimepointIdAliases.Find(Attribute.Value.LocalValue))
+					{
+						Attribute.Value.LocalValue = *CanonicalId;
+					}
+				}
+			}
+		}
+	}
+
 	// Create timepoint individuals from the registered timepoints
 	void CreateObjectIndividuals()
 	{
@@ -178,21 +229,27 @@ private:
 		}
 
 		// Create and add time individuals
-		for (const auto& BI : RegisteredObjects)
+		for (const auto& IdToClass : RegisteredObjects)
 		{
-			ObjectIndividuals.Add(CreateObjectIndividual("log", BI->GetIdValue(), BI->GetClassValue()));
+			ObjectIndividuals.Add(CreateObjectIndividual("log", IdToClass.Key, IdToClass.Value));
 		}
 	}
 
 public:
 	/* Static helper functions */
+	// Get the id of the timepoint individual
+	static FString GetTimepointId(const float Timepoint)
+	{
+		return "timepoint_" + FString::SanitizeFloat(Timepoint);
+	}
+
 	// Create a timepoint individual
 	static FSLOwlNode CreateTimepointIndividual(const FString& InDocPrefix, const float Timepoint)
 	{
 		// Prefix name constants
 		const FSLOwlPrefixName RdfAbout("rdf", "about");
 		const FSLOwlPrefixName OwlNI("owl", "NamedIndividual");
-		const FString Id = "timepoint_" + FString::SanitizeFloat(Timepoint);
+		const FString Id = GetTimepointId(Timepoint);
 		FSLOwlNode Individual(OwlNI, FSLOwlAttribute(RdfAbout, FSLOwlAttributeValue(InDocPrefix, Id)));
 		Individual.AddChildNode(FSLOwlNode::CreateResourceProperty("knowrob", "Timepoint"));
 		return Individual;
@@ -5,6 +5,7 @@
 
 #include "EngineMinimal.h"
 #include "Owl/SLOwlExperiment.h"
+#include "Owl/SLOwlWriter.h"
 
 /**
 * Helper functions for generating owl experiment documents
@@ -24,8 +25,8 @@ struct USEMLOG_API FSLOwlExperimentStatics
 	//	const FString& InDocPrefix = "log",
 	//	const FString& InDocOntologyName = "UE-Experiment");
 	
-	// Write experiment to file
-	static void WriteToFile(TSharedPtr<FSLOwlExperiment> Experiment, const FString& Path, bool bOverwrite);
+	// Write experiment to file (streamed, optionally also as N-Triples)
+	static void WriteToFile(TSharedPtr<FSLOwlExperiment> Experiment, const FString& Path, bool bOverwrite, bool bWriteNTriples = false);
 
 	/* Owl individuals / definitions creation */
 	// Create an event individual
@@ -0,0 +1,108 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Registry of the unique timepoints of a document, keyed by the time quantized to the resolution (O(1) insertion),
+* the first registered timepoint of a key is the canonical one, the timepoints are emitted sorted
+*/
+struct FSLOwlTimepointRegistry
+{
+public:
+	// Default constructor, a resolution of 0 keeps every distinct float value
+	FSLOwlTimepointRegistry(float InResolution = 0.f) :
+		Resolution(FMath::Max(InResolution, 0.f)),
+		bIsSortedDirty(false)
+	{}
+
+	// Set the quantization resolution (in seconds), should be set before registering timepoints
+	void SetResolution(float InResolution)
+	{
+		if (Timepoints.Num() > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Resolution changed with %d registered timepoints, keys are not re-quantized.."),
+				*FString(__FUNCTION__), __LINE__, Timepoints.Num());
+		}
+		Resolution = FMath::Max(InResolution, 0.f);
+	}
+
+	// Get the quantization resolution
+	float GetResolution() const { return Resolution; };
+
+	// Register the timepoint, returns the canonical timepoint of its key
+	float Register(float Timepoint)
+	{
+		const int64 Key = GetKey(Timepoint);
+		if (const float* Canonical = Timepoints.Find(Key))
+		{
+			return *Canonical;
+		}
+		Timepoints.Add(Key, Timepoint);
+		bIsSortedDirty = true;
+		return Timepoint;
+	}
+
+	// True if the timepoint (or one in the same quantization bucket) is registered
+	bool Contains(float Timepoint) const
+	{
+		return Timepoints.Contains(GetKey(Timepoint));
+	}
+
+	// Number of unique timepoints
+	int32 Num() const { return Timepoints.Num(); };
+
+	// Get the canonical timepoints in ascending order (sorted once after new registrations)
+	const TArray<float>& GetSorted() const
+	{
+		if (bIsSortedDirty)
+		{
+			Timepoints.GenerateValueArray(SortedTimepoints);
+			SortedTimepoints.Sort();
+			bIsSortedDirty = false;
+		}
+		return SortedTimepoints;
+	}
+
+	// Remove all timepoints
+	void Empty()
+	{
+		Timepoints.Empty();
+		SortedTimepoints.Empty();
+		bIsSortedDirty = false;
+	}
+
+private:
+	// Get the key of the timepoint
+	int64 GetKey(float Timepoint) const
+	{
+		if (Resolution > 0.f)
+		{
+			return (int64)FMath::FloorToDouble((double)Timepoint / Resolution + 0.5);
+		}
+
+		// Exact value, use the bits of the float (0 and -0 are the same timepoint)
+		if (Timepoint == 0.f)
+		{
+			return 0;
+		}
+		uint32 Bits;
+		FMemory::Memcpy(&Bits, &Timepoint, sizeof(float));
+		return (int64)Bits;
+	}
+
+private:
+	// Quantization resolution in seconds (0 for exact values)
+	float Resolution;
+
+	// Quantized key to the canonical timepoint
+	TMap<int64, float> Timepoints;
+
+	// Cached sorted canonical timepoints
+	mutable TArray<float> SortedTimepoints;
+
+	// True if the sorted timepoints need to be regenerated
+	mutable bool bIsSortedDirty;
+};
@@ -0,0 +1,121 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Owl/SLOwlDoc.h"
+#include "Utils/SLUtf8FileWriter.h"
+
+/**
+* Output format of the owl writer
+*/
+enum class ESLOwlWriterFormat : uint8
+{
+	// Same layout as FSLOwlDoc::ToString()
+	RdfXml,
+
+	// One triple per line with expanded iris (also valid Turtle)
+	NTriples
+};
+
+/**
+* Streams an owl document to a file without building the document string in memory,
+* the output is encoded and escaped once into a fixed size UTF-8 buffer which is flushed to the archive when full
+*/
+class USEMLOG_API FSLOwlWriter
+{
+public:
+	// Ctor
+	FSLOwlWriter(ESLOwlWriterFormat InFormat = ESLOwlWriterFormat::RdfXml, int32 InBufferSize = 64 * 1024);
+
+	// Write the document to the file
+	bool Write(const FSLOwlDoc& Doc, const FString& FilePath);
+
+	// Number of written triples (NTriples format only)
+	int64 NumTriples() const { return TriplesNum; };
+
+	// Write the document to the file in the given format
+	static bool WriteToFile(const FSLOwlDoc& Doc, const FString& FilePath, ESLOwlWriterFormat Format = ESLOwlWriterFormat::RdfXml);
+
+	// Get the file extension of the format (with the dot)
+	static const TCHAR* GetFileExtension(ESLOwlWriterFormat Format);
+
+private:
+	/* RDF/XML */
+	// Write the xml header, the entity definitions and the root node
+	void WriteXmlDoc(const FSLOwlDoc& Doc);
+
+	// Write the node and its children
+	void WriteXmlNode(const FSLOwlNode& Node, int32 Depth);
+
+	// Write the opening tag of the node (without closing it)
+	void WriteXmlOpenTag(const FSLOwlPrefixName& Name, const TArray<FSLOwlAttribute>& Attributes, int32 Depth);
+
+	// Write the attribute value with its quotes ("&Ns;LocalValue")
+	void WriteXmlAttributeValue(const FSLOwlAttributeValue& AttributeValue);
+
+	/* N-Triples */
+	// Cache the namespace and entity expansions of the document
+	void InitPrefixes(const FSLOwlDoc& Doc);
+
+	// Write the triples of the nodes
+	void WriteNodesTriples(const TArray<FSLOwlNode>& Nodes);
+
+	// Write the triples of the node element, returns its subject term
+	FString WriteNodeTriples(const FSLOwlNode& Node);
+
+	// Write the triples of the property element of the subject
+	void WritePropertyTriples(const FString& Subject, const FSLOwlNode& Property);
+
+	// Write a triple with an already formatted object term
+	void WriteTriple(const FString& Subject, const FString& PredicateIri, const FString& ObjectTerm);
+
+	// Write a triple with a literal object
+	void WriteLiteralTriple(const FString& Subject, const FString& PredicateIri, const FString& Literal,
+		const FString& DatatypeIri, const FString& Lang);
+
+	// Expand the prefixed name to an iri (e.g. owl:Class -> http://www.w3.org/2002/07/owl#Class)
+	FString ExpandName(const FSLOwlPrefixName& Name) const;
+
+	// Expand the attribute value to an iri (e.g. &log;abc -> http://knowrob.org/kb/ameva_log.owl#abc)
+	FString ExpandValue(const FSLOwlAttributeValue& AttributeValue) const;
+
+	// Create an iri term (<iri>) with the N-Triples escaping
+	static FString ToIriTerm(const FString& Iri);
+
+	// Find the attribute of the node
+	static const FSLOwlAttribute* FindAttribute(const FSLOwlNode& Node, const TCHAR* Prefix, const TCHAR* LocalName);
+
+	/* Buffer */
+	// Append the string with the xml escaping (&, <, >, ")
+	void AppendXmlEscaped(const FString& Str);
+
+	// Append the string with the N-Triples literal escaping (\, ", \n, \r)
+	void AppendLiteralEscaped(const FString& Str);
+
+	// Append the indentation
+	void AppendIndent(int32 Depth);
+
+private:
+	// Output format
+	ESLOwlWriterFormat Format;
+
+	// Buffered utf8 output file
+	FSLUtf8FileWriter Out;
+
+	// Prefix to iri (from the xmlns namespace declarations)
+	TMap<FString, FString> NamespaceIris;
+
+	// Entity to iri (from the DTD entity definitions)
+	TMap<FString, FString> EntityIris;
+
+	// Base iri for relative values (from xml:base)
+	FString BaseIri;
+
+	// Counter for the blank nodes (nodes without rdf:about)
+	int32 BlankNodesNum;
+
+	// Number of written triples
+	int64 TriplesNum;
+};
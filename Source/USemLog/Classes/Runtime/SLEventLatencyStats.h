@@ -0,0 +1,48 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Events/ISLEvent.h"
+
+/**
+* Detection latency of a detector (event kind) over the episode, in seconds
+*/
+struct FSLEventLatencySummary
+{
+	ESLEventKind Kind = ESLEventKind::Dummy;
+	int32 Num = 0;
+	float Mean = 0.f;
+	float P50 = 0.f;
+	float P95 = 0.f;
+	float Max = 0.f;
+};
+
+/**
+* Collects the delay between the onset of an event (its start, i.e. the first trigger sample, world time)
+* and its broadcast by the handlers, the event duration, the contact merge delays and the supported-by
+* and grasp checks all show up here; the expected values per scenario are checked in Tests/SLEventScenarioTests
+*/
+class USEMLOG_API FSLEventLatencyStats
+{
+public:
+	// Record the broadcast of the finished event at the given world time
+	void Add(const ISLEvent& Event, float BroadcastTime);
+
+	// Clear the recorded latencies
+	void Reset();
+
+	// Get the latency summary of each detector with at least one event
+	void GetSummaries(TArray<FSLEventLatencySummary>& OutSummaries) const;
+
+	// Log the summaries
+	void LogSummaries(const FString& InTitle) const;
+
+	// Write the summaries as csv (kind,num,mean,p50,p95,max)
+	bool WriteToFile(const FString& FilePath, bool bOverwrite) const;
+
+private:
+	// Recorded latencies of every event kind
+	TArray<float> Latencies[(uint8)ESLEventKind::Dummy + 1];
+};
@@ -0,0 +1,100 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/AsyncWork.h"
+
+// Forward declarations
+class ISLEvent;
+class IFileHandle;
+
+/**
+ * Async task appending the serialized events to the stream file
+ */
+class FSLEventStreamWriterAsyncTask : public FNonAbandonableTask
+{
+public:
+	// Set the file to write to
+	void Init(IFileHandle* InFileHandle) { FileHandle = InFileHandle; };
+
+	// Do the file writing here
+	void DoWork();
+
+	// Needed internally
+	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FSLEventStreamWriterAsyncTask, STATGROUP_ThreadPoolAsyncTasks); }
+
+	// Lines to be written (swapped in by the handler, emptied after writing)
+	FString Lines;
+
+private:
+	// File to append to
+	IFileHandle* FileHandle = nullptr;
+};
+
+
+/**
+ * Writes the finished events as they come in (one json object per line, NDJSON), the writing is done in the background,
+ * if the episode does not finish properly the already finished events are still available on disk
+ */
+class FSLEventStreamWriter
+{
+public:
+	// Ctor
+	FSLEventStreamWriter();
+
+	// Dtor
+	~FSLEventStreamWriter();
+
+	// Open the stream file
+	bool Init(const FString& InDirPath, const FString& InEpisodeId, bool bOverwrite);
+
+	// Serialize the event and hand it over to the background writer when it is free
+	void Add(TSharedPtr<ISLEvent> Event);
+
+	// Write the remaining events and the finished footer, and close the file
+	// (if not called, the destructor closes the file with an aborted footer instead)
+	void Finish(float EpisodeEndTime);
+
+	// Get the path of the stream file
+	const FString& GetFilePath() const { return FilePath; };
+
+	// Number of streamed events
+	int32 Num() const { return NumEvents; };
+
+	// Get init state
+	bool IsInit() const { return bIsInit; };
+
+	// Serialize event to a single line json object
+	static FString ToJsonLine(const ISLEvent& Event);
+
+	// Append json escaped string
+	static void AppendEscaped(FString& Out, const FString& In);
+
+private:
+	// Start writing the pending lines if the previous job is done
+	void TryFlush(bool bWait);
+
+	// Write the pending lines followed by the footer line and close the file
+	void Close(const FString& FooterLine);
+
+private:
+	// True if the stream file is open
+	bool bIsInit;
+
+	// Path of the stream file
+	FString FilePath;
+
+	// Open stream file
+	IFileHandle* FileHandle;
+
+	// Serialized events not yet handed to the writer
+	FString PendingLines;
+
+	// Number of streamed events
+	int32 NumEvents;
+
+	// Async writing to the file
+	FAsyncTask<FSLEventStreamWriterAsyncTask>* WriterTask;
+};
@@ -0,0 +1,86 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/SLLoggerStructs.h"
+#if SL_WITH_LIBMONGO_C
+THIRD_PARTY_INCLUDES_START
+#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <mongoc/mongoc.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+#else
+	#include <mongoc/mongoc.h>
+#endif // #if PLATFORM_WINDOWS
+THIRD_PARTY_INCLUDES_END
+#endif //SL_WITH_LIBMONGO_C
+
+// Forward declarations
+class FSLEventStore;
+struct FSLEventSnapshot;
+
+/**
+ * Helper class for bulk writing the finished symbolic events to the database,
+ * one document per event in the <EpisodeId>.events collection of the task database
+ */
+class FSLEventsDBHandler
+{
+public:
+	// Ctor
+	FSLEventsDBHandler();
+
+	// Dtor
+	~FSLEventsDBHandler();
+
+	// Connect to the db
+	bool Init(const FSLLoggerLocationParams& InLocationParameters,
+		const FSLLoggerDBServerParams& InDBServerParameters);
+
+	// Bulk insert the events (unordered, a failing document does not stop the rest), returns the number of inserted events
+	int32 Write(const FSLEventStore& InEvents);
+
+	// Create the indexes and disconnect from db
+	void Finish();
+
+	// Get init state
+	bool IsInit() const { return bIsInit; };
+
+private:
+	// Connect to the database
+	bool Connect(const FString& DBName, const FString& CollName, const FString& ServerIp,
+		uint16 ServerPort, bool bOverwrite);
+
+#if SL_WITH_LIBMONGO_C
+	// Add the event document (id, type, interval, participant ids and roles)
+	void AddEvent(const FSLEventSnapshot& Event, bson_t* doc) const;
+#endif //SL_WITH_LIBMONGO_C
+
+	// Disconnect and clean db connection
+	void Disconnect();
+
+	// Create the (type, start) and (participants, start) indexes
+	bool CreateIndexes() const;
+
+private:
+	// True if connected to the db
+	bool bIsInit;
+
+	// Pointers are reset
+	bool bIsFinished;
+
+#if SL_WITH_LIBMONGO_C
+	// Server uri
+	mongoc_uri_t* uri;
+
+	// MongoC connection client
+	mongoc_client_t* client;
+
+	// Database to access
+	mongoc_database_t* database;
+
+	// Database collection
+	mongoc_collection_t* collection;
+#endif //SL_WITH_LIBMONGO_C
+};
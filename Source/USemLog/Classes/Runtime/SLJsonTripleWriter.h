@@ -0,0 +1,86 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utils/SLUtf8FileWriter.h"
+
+/**
+ * Term of a triple, written as Iri or Iri + Separator + Suffix (avoids concatenating the strings beforehand),
+ * only references the given strings, use it within the write call
+ */
+struct FSLTripleTerm
+{
+	// Plain iri
+	FSLTripleTerm(const TCHAR* InIri) : Iri(InIri), Separator(nullptr), Suffix(nullptr) {};
+	FSLTripleTerm(const FString& InIri) : Iri(*InIri), Separator(nullptr), Suffix(nullptr) {};
+
+	// Iri with a suffix (e.g. SOMA.owl#ContactState + _ + EventId)
+	FSLTripleTerm(const TCHAR* InIri, const FString& InSuffix, const TCHAR* InSeparator = TEXT("_"))
+		: Iri(InIri), Separator(InSeparator), Suffix(*InSuffix) {};
+
+	// Iri part
+	const TCHAR* Iri;
+
+	// Separator between the iri and the suffix
+	const TCHAR* Separator;
+
+	// Suffix part (nullptr if not used)
+	const TCHAR* Suffix;
+};
+
+/**
+ * Writes json triples ({"s", "p", "o", "graph"}) as a json array directly to a file,
+ * the output is encoded as UTF-8 into a fixed size buffer which is flushed to the archive when full
+ */
+class FSLJsonTripleWriter
+{
+public:
+	// Ctor
+	FSLJsonTripleWriter(const FString& InGraph = TEXT("user"), int32 InBufferSize = 64 * 1024);
+
+	// Dtor, closes the file
+	~FSLJsonTripleWriter();
+
+	// Open the file and start the json array
+	bool Open(const FString& FilePath);
+
+	// Write a triple with an iri object
+	void WriteTriple(const FSLTripleTerm& S, const TCHAR* P, const FSLTripleTerm& O);
+
+	// Write a triple with a decimal object ({ "$numberDecimal": "Value" })
+	void WriteDecimalTriple(const FSLTripleTerm& S, const TCHAR* P, float Value);
+
+	// End the json array and close the file
+	void Close();
+
+	// True if the file is open
+	bool IsOpen() const { return Out.IsOpen(); };
+
+	// Number of written triples
+	int64 Num() const { return NumTriples; };
+
+private:
+	// Start a new triple object (adds the separator)
+	void BeginTriple(const FSLTripleTerm& S, const TCHAR* P);
+
+	// End the triple object
+	void EndTriple();
+
+	// Append a json escaped term
+	void AppendTerm(const FSLTripleTerm& Term);
+
+	// Append a json escaped string
+	void AppendEscaped(const TCHAR* Str);
+
+private:
+	// Buffered utf8 output file
+	FSLUtf8FileWriter Out;
+
+	// Graph name of the triples (utf8)
+	TArray<ANSICHAR> Graph;
+
+	// Number of written triples
+	int64 NumTriples;
+};
@@ -112,6 +112,11 @@ struct FSLWorldStateLoggerParams
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	bool bWriteSparse = true;
 
+	// Write a full snapshot of all individuals every N seconds (sparse mode only, <= 0 disables keyframes),
+	// the world state at any time can then be rebuilt from the previous keyframe and the following sparse documents
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bWriteSparse"))
+	float KeyframeInterval = 10.f;
+
 	// Include individuals metadata 
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	bool bIncludeMetadata = true;
@@ -184,6 +189,37 @@ struct FSLSymbolicLoggerParams
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger|Events", meta = (editcondition = "bWriteTimelines"))
 	FLSymbolicEventsSelection TimelineEventsSelection;
 
+	/* Stream the finished events to disk during the episode (NDJSON) */
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bStreamEvents = false;
+
+	/* Write the finished events to a compact binary log (converted offline with the SLEventLogConvert commandlet) */
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bWriteEventLog = false;
+
+	/* Bulk insert the finished events into the <EpisodeId>.events collection of the task database */
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bWriteEventsToDB = false;
+
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bWriteEventsToDB"))
+	FSLLoggerDBServerParams EventsDBServerParams;
+
+	/* Record the delay between the onset of each event and its broadcast, written as <EpisodeId>_EventLatency.csv */
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bReportEventLatency = false;
+
+	/* Keep an interval index of the finished events for temporal queries after the episode */
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bBuildEventIndex = false;
+
+	/* Write the experiment also as N-Triples (cheaper to parse than RDF/XML) */
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bWriteOwlNTriples = false;
+
+	/* Timepoints closer than the resolution (in seconds) share the same owl individual (0 keeps every distinct value) */
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 0))
+	float OwlTimepointResolution = 0.f;
+
 	/* ROS */
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	bool bPublishToROS = false;
@@ -7,6 +7,12 @@
 #include "GameFramework/Info.h"
 #include "Runtime/SLLoggerStructs.h"
 #include "Events/ISLEventHandler.h"
+#include "Events/SLEventStore.h"
+#include "Runtime/SLEventStreamWriter.h"
+#include "Events/SLEventLog.h"
+#include "Runtime/SLEventsDBHandler.h"
+#include "Events/SLEventIntervalIndex.h"
+#include "Runtime/SLEventLatencyStats.h"
 #include "ROSProlog/SLPrologClient.h"
 #include "Owl/SLOwlExperiment.h"
 #include "SLSymbolicLogger.generated.h"
@@ -61,6 +67,15 @@ public:
 	// Check if the manager is running independently
 	bool IsRunningIndependently() const { return bUseIndependently; };
 
+	// Get the interval index of the finished events (built when the logger finishes)
+	const FSLEventIntervalIndex& GetEventIndex() const { return EventIndex; };
+
+	// Get the finished events overlapping [T0, T1]
+	void QueryEvents(float T0, float T1, TArray<const FSLEventIntervalEntry*>& OutEvents) const;
+
+	// Get the finished events of the individual overlapping [T0, T1]
+	void QueryIndividualEvents(const FString& IndividualId, float T0, float T1, TArray<const FSLEventIntervalEntry*>& OutEvents) const;
+
 protected:
 	// Init logger (called when the logger is used independently)
 	void InitImpl();
@@ -80,19 +95,19 @@ protected:
 	// Called when a semantic event is done
 	void SemanticEventFinishedCallback(TSharedPtr<ISLEvent> Event);
 	
-	// Write data to file
-	void WriteToFile();
+	// Get the output directory of the episode
+	FString GetOutputDirPath() const;
+
+	// Create and write the experiment owl doc (finalization task)
+	void WriteExperimentDoc(const FSLEventStore& InFinishedEvents);
+
+	// Write the events timelines (finalization task)
+	void WriteTimelines(const FSLEventStore& InFinishedEvents) const;
 
 	// Create events doc template
 	TSharedPtr<FSLOwlExperiment> CreateEventsDocTemplate(
 		ESLOwlExperimentTemplate TemplateType, const FString& InDocId);
 
-	//retunrs the individuals associated with an event, if they exist.
-	//Ev = EventString
-	//Indiv1 = first Individual
-	//Indiv1Class = Class of first Individual
-	void GetIndividuals(FString Ev, FString &Indiv1, FString &Indiv2, FString &Indiv1Class, FString &Indiv2Class);
-
 private:
 	// Get the reference or spawn a new initialized individual manager
 	bool SetIndividualManager();
@@ -159,8 +174,23 @@ private:
 	ASLIndividualManager* IndividualManager;
 
 
-	// Array of finished events
-	TArray<TSharedPtr<ISLEvent>> FinishedEvents;
+	// Compact store of the finished events (materialized only when serializing)
+	FSLEventStore FinishedEventsStore;
+
+	// Writes the finished events to disk as they come in
+	FSLEventStreamWriter EventStreamWriter;
+
+	// Writes the finished events as fixed size records to the binary event log
+	FSLEventLogWriter EventLogWriter;
+
+	// Bulk writes the finished events to the database
+	FSLEventsDBHandler EventsDBHandler;
+
+	// Interval index of the finished events
+	FSLEventIntervalIndex EventIndex;
+
+	// Detection latency of the finished events
+	FSLEventLatencyStats EventLatencyStats;
 
 	// Owl document of the finished events
 	TSharedPtr<FSLOwlExperiment> ExperimentDoc;
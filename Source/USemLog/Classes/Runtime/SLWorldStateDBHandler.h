@@ -6,6 +6,7 @@
 #include "CoreMinimal.h"
 #include "Runtime/SLLoggerStructs.h"
 #include "Async/AsyncWork.h"
+#include "Mongo/SLMongoSchema.h"
 #if SL_WITH_LIBMONGO_C
 class ASLVisionPoseableMeshActor;
 THIRD_PARTY_INCLUDES_START
@@ -34,7 +35,8 @@ class FSLWorldStateDBWriterAsyncTask : public FNonAbandonableTask
 public:
 #if SL_WITH_LIBMONGO_C
 	// Set the individuals
-	bool Init(mongoc_collection_t* in_collection, ASLIndividualManager* Manager, float PoseTolerance, bool bInWriteSparse);
+	bool Init(mongoc_collection_t* in_collection, ASLIndividualManager* Manager, float PoseTolerance, bool bInWriteSparse, float InKeyframeInterval,
+		const FSLMongoSchema& InSchema);
 #endif //SL_WITH_LIBMONGO_C	
 
 	// Do the db writing here
@@ -56,23 +58,24 @@ private:
 	// Write all individuals (event if they did not move)
 	int32 WriteAll();
 
-#if SL_WITH_LIBMONGO_C
-	// Add timestamp to the bson doc
-	void AddTimestamp(bson_t* doc);
+	// Write a full snapshot of the individuals (keyframe) used as the starting point when rebuilding sparse frames
+	int32 WriteKeyframe();
 
+#if SL_WITH_LIBMONGO_C
 	// Add all individuals (return the number of individuals added)
-	int32 AddAllIndividuals(bson_t* doc);
+	int32 AddAllIndividuals(mongoc_bulk_operation_t* bulk);
 
 	// Add only the individuals that moved (return the number of individuals added)
-	int32 AddIndividualsThatMoved(bson_t* doc);
+	int32 AddIndividualsThatMoved(mongoc_bulk_operation_t* bulk);
 
 	// Add skeletal individuals (return the number of individuals added)
-	int32 AddSkeletalIndividals(bson_t* doc);
+	int32 AddSkeletalIndividals(mongoc_bulk_operation_t* bulk);
 
-	// Add skeletal bones to the document
-	void AddSkeletalBoneIndividuals(const TArray<USLBoneIndividual*>& BoneIndividuals,
+	// Add skeletal bones to the bulk, one tf document per bone linked to its skeletal individual
+	void AddSkeletalBoneIndividuals(const FString& SkelId,
+		const TArray<USLBoneIndividual*>& BoneIndividuals,
 		const TArray<USLVirtualBoneIndividual*>& VirtualBoneIndividuals,
-		bson_t* doc);
+		mongoc_bulk_operation_t* bulk);
 
 	// Add skeletal bone constraints to the document
 	void AddSkeletalConstraintIndividuals(const TArray<USLBoneConstraintIndividual*>& ConstraintIndividuals,
@@ -81,11 +84,11 @@ private:
 	// Add robot individuals (return the number of individuals added)
 	int32 AddRobotIndividuals(bson_t* doc);
 
-	// Add pose document
-	void AddPose(FTransform Pose, bson_t* doc);
-
 	// Write the bson doc to the collection
 	bool UploadDoc(bson_t* doc);
+
+	// Write the bulk documents to the collection
+	bool UploadBulk(mongoc_bulk_operation_t* bulk);
 #endif //SL_WITH_LIBMONGO_C
 
 
@@ -106,6 +109,18 @@ private:
 	// Write mode
 	bool bWriteSparse;
 
+	// Seconds between the keyframes (<= 0 disables keyframes)
+	float KeyframeInterval;
+
+	// Timestamp of the last written keyframe
+	float PrevKeyframeTs;
+
+	// Layout of the written documents
+	FSLMongoSchema Schema;
+
+	// Sequence number of the tf headers
+	int32 Seq;
+
 #if SL_WITH_LIBMONGO_C
 	// Database collection
 	mongoc_collection_t* mongo_collection;
@@ -137,6 +152,9 @@ public:
 	// Delegate job to the async task (true if the previous job was done)
 	bool Write(float Timestamp);
 
+	// Check if the last delegated job is done
+	bool IsWriteDone() const { return DBWriterTask == nullptr || DBWriterTask->IsDone(); };
+
 	// Disconnect from db, clear task
 	void Finish();
 
@@ -148,6 +166,9 @@ private:
 	// Write metadata
 	bool WriteMetadata(ASLIndividualManager* IndividualManager, const FString& MetaCollName, bool bOverwrite);
 
+	// Write the schema of the episode documents (replaces any previous one of the episode)
+	bool WriteSchemaMetadata(const FString& MetaCollName, const FString& EpisodeId);
+
 #if SL_WITH_LIBMONGO_C
 	int32 AddIndividualsMetadata(ASLIndividualManager* IndividualManager, bson_t* doc);
 #endif //SL_WITH_LIBMONGO_C	
@@ -171,6 +192,9 @@ private:
 	// Async writing to the database
 	FAsyncTask<FSLWorldStateDBWriterAsyncTask>* DBWriterTask;
 
+	// Layout of the written documents
+	FSLMongoSchema Schema;
+
 #if SL_WITH_LIBMONGO_C
 	// Server uri
 	mongoc_uri_t* uri;
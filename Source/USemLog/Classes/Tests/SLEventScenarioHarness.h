@@ -0,0 +1,178 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Misc/AutomationTest.h"
+#include "Events/ISLEventHandler.h"
+#include "Runtime/SLEventLatencyStats.h"
+
+// Forward declarations
+class UWorld;
+class AActor;
+class AStaticMeshActor;
+class UPrimitiveComponent;
+class USLBaseIndividual;
+class USLContactMonitorBox;
+class USLManipulatorMonitor;
+class USLBoneContactMonitor;
+
+/**
+* Finished event as seen by the logger, with the world time of its broadcast
+*/
+struct FSLScenarioEvent
+{
+	// The finished event
+	TSharedPtr<ISLEvent> Event;
+
+	// World time of the broadcast
+	float BroadcastTime;
+};
+
+/**
+* Non skeletal gripper, the fingers carry one bone contact monitor each (group A and B)
+*/
+struct FSLScenarioGripper
+{
+	AStaticMeshActor* Hand = nullptr;
+	USLManipulatorMonitor* Monitor = nullptr;
+	USLBoneContactMonitor* FingerA = nullptr;
+	USLBoneContactMonitor* FingerB = nullptr;
+};
+
+/**
+* Headless game world running the real contact and grasp monitors and their event handlers,
+* the overlaps are not simulated, the scenario scripts the trigger samples (overlap begin/end broadcasts)
+* and the kinematic motion of the items at given world times;
+* records the finished events with their broadcast time, the onset latencies and the cpu time of every tick
+*/
+class FSLEventScenarioHarness
+{
+public:
+	// Ctor
+	FSLEventScenarioHarness(float InDeltaTime = 1.f / 60.f);
+
+	// Dtor, finishes the handlers and destroys the world
+	~FSLEventScenarioHarness();
+
+	// Create the world
+	bool Init();
+
+	// Spawn a semantically annotated cube (movable), optionally with a contact monitor box
+	AStaticMeshActor* SpawnItem(const FString& Name, const FVector& Location, bool bWithContactMonitor = true);
+
+	// Spawn a non skeletal gripper with two fingers
+	FSLScenarioGripper SpawnGripper(const FString& Name, const FVector& Location);
+
+	// Init and start the monitors and their handlers
+	bool Start();
+
+	// Run the step at the given world time
+	void At(float Time, TFunction<void()> Step);
+
+	// Script a contact begin/end between the monitor boxes of the two items (both sides are triggered, as the physics would)
+	void AtContact(float Time, AStaticMeshActor* A, AStaticMeshActor* B, bool bBegin);
+
+	// Script a grasp overlap begin/end between the finger and the item mesh
+	void AtFingerContact(float Time, USLBoneContactMonitor* Finger, AStaticMeshActor* Item, bool bBegin);
+
+	// Set the (kinematic) velocity of the item, the location is integrated every tick
+	void AtVelocity(float Time, AStaticMeshActor* Item, const FVector& Velocity);
+
+	// Tick the world until the given time, running the due steps before each tick
+	void RunUntil(float Time);
+
+	// Finish the handlers (publishes the still open events at the current time)
+	void Finish();
+
+	// Get the world time
+	float GetTime() const;
+
+	// Get the world
+	UWorld* GetWorld() const { return World; };
+
+	// Get the individual of the actor
+	static USLBaseIndividual* GetIndividual(AActor* Actor);
+
+	// Get the recorded events
+	const TArray<FSLScenarioEvent>& GetEvents() const { return Events; };
+
+	// Get the recorded events of the given kind between the two individuals (in any role)
+	TArray<FSLScenarioEvent> FindEvents(ESLEventKind Kind, AActor* A, AActor* B) const;
+
+	// Get the onset to broadcast latencies
+	const FSLEventLatencyStats& GetLatencyStats() const { return LatencyStats; };
+
+	// Mean cpu time of a tick (including the scripted steps) in milliseconds
+	double GetMeanTickMs() const { return NumTicks > 0 ? TickSeconds * 1000.0 / NumTicks : 0.0; };
+
+	// Max cpu time of a tick in milliseconds
+	double GetMaxTickMs() const { return MaxTickSeconds * 1000.0; };
+
+	// Fixed tick delta time
+	float GetDeltaTime() const { return DeltaTime; };
+
+private:
+	// Record the finished event
+	void OnSemanticEvent(TSharedPtr<ISLEvent> Event);
+
+	// Broadcast the overlap begin/end on the component
+	static void BroadcastOverlap(UPrimitiveComponent* Comp, UPrimitiveComponent* OtherComp, bool bBegin);
+
+	// Scheduled step
+	struct FStep
+	{
+		float Time;
+		TFunction<void()> Fn;
+	};
+
+	// Fixed tick delta time
+	float DeltaTime;
+
+	// The world
+	UWorld* World;
+
+	// Spawned contact monitors and grippers
+	TArray<USLContactMonitorBox*> ContactMonitors;
+	TArray<FSLScenarioGripper> Grippers;
+
+	// Kinematic velocities of the items
+	TMap<AStaticMeshActor*, FVector> Velocities;
+
+	// Event handlers of the monitors
+	TArray<TSharedPtr<ISLEventHandler>> Handlers;
+
+	// Pending steps (sorted by time)
+	TArray<FStep> Steps;
+
+	// Recorded events
+	TArray<FSLScenarioEvent> Events;
+
+	// Onset latencies
+	FSLEventLatencyStats LatencyStats;
+
+	// Tick timings
+	int32 NumTicks;
+	double TickSeconds;
+	double MaxTickSeconds;
+
+	// True if the handlers are finished
+	bool bIsFinished;
+};
+
+/**
+* Scenario tests base, the monitors log errors/warnings for the missing input bindings (no player controller)
+*/
+class FSLEventScenarioTestBase : public FAutomationTestBase
+{
+public:
+	FSLEventScenarioTestBase(const FString& InName, const bool bInComplexTask)
+		: FAutomationTestBase(InName, bInComplexTask) {};
+
+	virtual bool SuppressLogErrors() override { return true; };
+	virtual bool SuppressLogWarnings() override { return true; };
+};
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,60 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * Runtime cost of the monitors and event handlers, use `stat SemLog` in the console,
+ * or the CPU channel in Unreal Insights (`-trace=cpu`)
+ */
+DECLARE_STATS_GROUP(TEXT("SemLog"), STATGROUP_SemLog, STATCAT_Advanced);
+
+/* Monitors */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Contact Monitor Overlap"), STAT_SL_ContactMonitorOverlap, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Contact Monitor Delayed End"), STAT_SL_ContactMonitorDelayedEnd, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Contact Monitor SupportedBy Check"), STAT_SL_ContactMonitorSupportedBy, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bone Contact Monitor Overlap"), STAT_SL_BoneContactMonitorOverlap, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bone Contact Monitor Delayed End"), STAT_SL_BoneContactMonitorDelayedEnd, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Manipulator Monitor Contact"), STAT_SL_ManipulatorMonitorContact, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Manipulator Monitor Grasp"), STAT_SL_ManipulatorMonitorGrasp, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Manipulator Monitor Delayed End"), STAT_SL_ManipulatorMonitorDelayedEnd, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reach Monitor Update"), STAT_SL_ReachMonitorUpdate, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reach Monitor Overlap"), STAT_SL_ReachMonitorOverlap, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reach Monitor Manipulator Callbacks"), STAT_SL_ReachMonitorCallbacks, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PickAndPlace Monitor Update"), STAT_SL_PickAndPlaceMonitorUpdate, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PickAndPlace Monitor Grasp Callbacks"), STAT_SL_PickAndPlaceMonitorCallbacks, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Container Monitor Callbacks"), STAT_SL_ContainerMonitorCallbacks, STATGROUP_SemLog, USEMLOG_API);
+
+/* Event handlers */
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Contact Event Handler"), STAT_SL_ContactEventHandler, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Manipulator Contact Event Handler"), STAT_SL_ManipulatorContactEventHandler, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Grasp Event Handler"), STAT_SL_GraspEventHandler, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fixation Grasp Event Handler"), STAT_SL_FixationGraspEventHandler, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Reach And PreGrasp Event Handler"), STAT_SL_ReachAndPreGraspEventHandler, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PickAndPlace Events Handler"), STAT_SL_PickAndPlaceEventsHandler, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Container Event Handler"), STAT_SL_ContainerEventHandler, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Slicing Event Handler"), STAT_SL_SlicingEventHandler, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Symbolic Logger Event Finished"), STAT_SL_SymbolicLoggerEventFinished, STATGROUP_SemLog, USEMLOG_API);
+
+/* Counters (per frame) */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlap Callbacks"), STAT_SL_NumOverlapCallbacks, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Timers Armed"), STAT_SL_NumTimersArmed, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Reach Candidates Updated"), STAT_SL_NumReachCandidatesUpdated, STATGROUP_SemLog, USEMLOG_API);
+
+/* Accumulators (episode wide) */
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Reach Candidates Tracked"), STAT_SL_NumReachCandidates, STATGROUP_SemLog, USEMLOG_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Events Emitted"), STAT_SL_NumEventsEmitted, STATGROUP_SemLog, USEMLOG_API);
+
+/**
+ * Scoped cycle counter, falls back to a named Insights CPU event if stats are compiled out
+ * (with stats on, the cycle counter already shows up as a CPU event in Insights)
+ */
+#if STATS
+#define SL_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define SL_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif // STATS
@@ -0,0 +1,57 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations
+class FArchive;
+
+/**
+* Writes text to a file as UTF-8, the output is encoded into a fixed size buffer which is flushed to the archive when full
+* (shared by the streaming writers, the format specific escaping is done by their owners)
+*/
+class USEMLOG_API FSLUtf8FileWriter
+{
+public:
+	// Ctor
+	FSLUtf8FileWriter(int32 InBufferSize = 64 * 1024);
+
+	// Dtor, closes the file
+	~FSLUtf8FileWriter();
+
+	// Open the file for writing
+	bool Open(const FString& FilePath);
+
+	// Flush the buffer and close the file, returns false if any write failed
+	bool Close();
+
+	// True if the file is open
+	bool IsOpen() const { return Ar != nullptr; };
+
+	// Append the string as utf8
+	void Append(const FString& Str) { Append(*Str, Str.Len()); };
+
+	// Append a range of characters as utf8
+	void Append(const TCHAR* Str, int32 Len);
+
+	// Append raw ascii
+	void AppendRaw(const ANSICHAR* Str);
+
+	// Append raw utf8 bytes
+	void AppendBytes(const ANSICHAR* Bytes, int32 Num);
+
+	// Write the buffer to the archive
+	void Flush();
+
+private:
+	// Output archive
+	FArchive* Ar;
+
+	// Fixed size output buffer
+	TArray<ANSICHAR> Buffer;
+
+	// Used bytes of the buffer
+	int32 BufferNum;
+};
@@ -14,6 +14,7 @@
 // UOwl
 #include "Owl/SLOwlSemanticMap.h"
 #include "Owl/SLOwlSemanticMapStatics.h"
+#include "Owl/SLOwlWriter.h"
 
 // UUtils
 #include "Utils/SLTagIO.h"
@@ -49,8 +50,15 @@ bool FSLSemanticMapWriter::WriteToFile(UWorld* World, const FSLSemanticMapWriter
 	// Add individuals to map
 	AddWorldIndividuals(SemMap, World);
 
-	// Write map to file	
-	return FFileHelper::SaveStringToFile(SemMap->ToString(), *FullFilePath);
+	// Write map triples to file
+	if (InParams.bWriteNTriples)
+	{
+		FSLOwlWriter::WriteToFile(*SemMap, FPaths::ChangeExtension(FullFilePath,
+			FSLOwlWriter::GetFileExtension(ESLOwlWriterFormat::NTriples)), ESLOwlWriterFormat::NTriples);
+	}
+
+	// Write map to file
+	return FSLOwlWriter::WriteToFile(*SemMap, FullFilePath);
 }
 
 // Create semantic map template
@@ -31,15 +31,7 @@ FSLContactEvent::FSLContactEvent(const FString& InId, float InStart, uint64 InPa
 // Get an owl representation of the event
 FSLOwlNode FSLContactEvent::ToOwlNode() const
 {
-	// Create the contact event node
-	FSLOwlNode EventIndividual = FSLOwlExperimentStatics::CreateEventIndividual(
-		"log", Id, "TouchingSituation");
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", StartTime));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", EndTime));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log", Individual1->GetIdValue()));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log", Individual2->GetIdValue()));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInEpisodeProperty("log", EpisodeId));
-	return EventIndividual;
+	return CreateOwlNode(Id, StartTime, EndTime, Individual1->GetIdValue(), Individual2->GetIdValue(), EpisodeId);
 }
 
 // Add the owl representation of the event to the owl document
@@ -60,14 +52,13 @@ void FSLContactEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 // Get event context data as string (ToString equivalent)
 FString FSLContactEvent::Context() const
 {
-	return FString::Printf(TEXT("Contact - %lld"), PairId);
+	return CreateContext(PairId);
 }
 
 // Get the tooltip data
 FString FSLContactEvent::Tooltip() const
 {
-	return FString::Printf(TEXT("\'O1\',\'%s\',\'Id\',\'%s\',\'O2\',\'%s\',\'Id\',\'%s\',\'Id\',\'%s\'"),
-		*Individual1->GetClassValue(), *Individual1->GetIdValue(), *Individual2->GetClassValue(), *Individual2->GetIdValue(), *Id);
+	return CreateTooltip(Individual1->GetClassValue(), Individual1->GetIdValue(), Individual2->GetClassValue(), Individual2->GetIdValue(), Id);
 }
 
 // Get the data as string
@@ -76,4 +67,33 @@ FString FSLContactEvent::ToString() const
 	return FString::Printf(TEXT("Individual1:[%s] Individual2:[%s] PairId:%lld"),
 		*Individual1->GetInfo(), *Individual2->GetInfo(), PairId);
 }
-/* End ISLEvent interface */
\ No newline at end of file
+/* End ISLEvent interface */
+
+/* Serialization from plain data */
+// Create the owl representation of the event
+FSLOwlNode FSLContactEvent::CreateOwlNode(const FString& InId, float InStart, float InEnd,
+	const FString& Individual1Id, const FString& Individual2Id, const FString& InEpisodeId)
+{
+	FSLOwlNode EventIndividual = FSLOwlExperimentStatics::CreateEventIndividual(
+		"log", InId, "TouchingSituation");
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", InStart));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", InEnd));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log", Individual1Id));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log", Individual2Id));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInEpisodeProperty("log", InEpisodeId));
+	return EventIndividual;
+}
+
+// Get the context data
+FString FSLContactEvent::CreateContext(uint64 InPairId)
+{
+	return FString::Printf(TEXT("Contact - %lld"), InPairId);
+}
+
+// Get the tooltip data
+FString FSLContactEvent::CreateTooltip(const FString& Individual1Class, const FString& Individual1Id,
+	const FString& Individual2Class, const FString& Individual2Id, const FString& InId)
+{
+	return FString::Printf(TEXT("\'O1\',\'%s\',\'Id\',\'%s\',\'O2\',\'%s\',\'Id\',\'%s\',\'Id\',\'%s\'"),
+		*Individual1Class, *Individual1Id, *Individual2Class, *Individual2Id, *InId);
+}
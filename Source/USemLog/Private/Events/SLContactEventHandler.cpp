@@ -7,6 +7,7 @@
 #include "Events/SLSupportedByEvent.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 
 
 // Set parent
@@ -70,39 +71,38 @@ void FSLContactEventHandler::Finish(float EndTime, bool bForced)
 // Start new contact event
 void FSLContactEventHandler::AddNewContactEvent(const FSLContactResult& InResult)
 {
+	// Keep the already started event with the same individual
+	if (StartedContactEvents.Contains(InResult.Other))
+	{
+		return;
+	}
+
 	// Start a semantic contact event
 	TSharedPtr<FSLContactEvent> Event = MakeShareable(new FSLContactEvent(
 		FSLUuid::NewGuidInBase64Url(), InResult.Time,
 		FSLUuid::PairEncodeCantor(InResult.Self->GetUniqueID(), InResult.Other->GetUniqueID()),
 		InResult.Self, InResult.Other));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending contacts array
-	StartedContactEvents.Emplace(Event);
+	// Add event to the pending contacts
+	StartedContactEvents.Emplace(InResult.Other, Event);
 }
 
 // Publish finished event
 bool FSLContactEventHandler::FinishContactEvent(USLBaseIndividual* InOther, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedContactEvents.CreateIterator()); EventItr; ++EventItr)
+	// It is enough to search by the other individual (remove it from the pending events)
+	TSharedPtr<FSLContactEvent> Event;
+	if (StartedContactEvents.RemoveAndCopyValue(InOther, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual2 == InOther)
+		// Set the event end time
+		Event->EndTime = EndTime;
+
+		// Avoid publishing short events
+		if ((Event->EndTime - Event->StartTime) > ContactEventMin)
 		{
-			// Set the event end time
-			(*EventItr)->EndTime = EndTime;
-
-			// Avoid publishing short events
-			if (((*EventItr)->EndTime - (*EventItr)->StartTime) > ContactEventMin)
-			{
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-
-			return true;
+			OnSemanticEvent.ExecuteIfBound(Event);
 		}
+		return true;
 	}
 	return false;
 }
@@ -110,34 +110,35 @@ bool FSLContactEventHandler::FinishContactEvent(USLBaseIndividual* InOther, floa
 // Start new supported by event
 void FSLContactEventHandler::AddNewSupportedByEvent(USLBaseIndividual* Supported, USLBaseIndividual* Supporting, float StartTime, const uint64 EventPairId)
 {
+	// Keep the already started event with the same pair
+	if (StartedSupportedByEvents.Contains(EventPairId))
+	{
+		return;
+	}
+
 	// Start a supported by event
 	TSharedPtr<FSLSupportedByEvent> Event = MakeShareable(new FSLSupportedByEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime, EventPairId, Supported, Supporting));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending array
-	StartedSupportedByEvents.Emplace(Event);
+	// Add event to the pending events
+	StartedSupportedByEvents.Emplace(EventPairId, Event);
 }
 
 // Finish then publish the event
 bool FSLContactEventHandler::FinishSupportedByEvent(const uint64 InPairId, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedSupportedByEvents.CreateIterator()); EventItr; ++EventItr)
+	// Remove event from the pending events
+	TSharedPtr<FSLSupportedByEvent> Event;
+	if (StartedSupportedByEvents.RemoveAndCopyValue(InPairId, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->PairId == InPairId)
+		// Ignore short events
+		if (EndTime - Event->StartTime > SupportedByEventMin)
 		{
-			// Ignore short events
-			if (EndTime - (*EventItr)->StartTime > SupportedByEventMin)
-			{
-				// Set end time and publish event
-				(*EventItr)->EndTime = EndTime;
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
+			// Set end time and publish event
+			Event->EndTime = EndTime;
+			OnSemanticEvent.ExecuteIfBound(Event);
 		}
+		return true;
 	}
 	return false;
 }
@@ -145,54 +146,39 @@ bool FSLContactEventHandler::FinishSupportedByEvent(const uint64 InPairId, float
 // Terminate and publish pending contact events (this usually is called at end play)
 void FSLContactEventHandler::FinishAllEvents(float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactEventHandler);
 	// Finish contact events
-	for (auto& Ev : StartedContactEvents)
-	{
-		// Ignore short events
-		if (EndTime - Ev->StartTime > ContactEventMin)
-		{
-			// Set end time and publish event
-			Ev->EndTime = EndTime;
-			OnSemanticEvent.ExecuteIfBound(Ev);
-		}
-	}
-	StartedContactEvents.Empty();
+	FinishOpenEventsBatch(StartedContactEvents, EndTime, ContactEventMin);
 
 	// Finish supported by events
-	for (auto& Ev : StartedSupportedByEvents)
-	{
-		// Ignore short events
-		if ((EndTime - Ev->StartTime) > SupportedByEventMin)
-		{
-			// Set end time and publish event
-			Ev->EndTime = EndTime;
-			OnSemanticEvent.ExecuteIfBound(Ev);
-		}
-	}
-	StartedSupportedByEvents.Empty();
+	FinishOpenEventsBatch(StartedSupportedByEvents, EndTime, SupportedByEventMin);
 }
 
 // Event called when a semantic overlap event begins
 void FSLContactEventHandler::OnSLOverlapBegin(const FSLContactResult& InResult)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactEventHandler);
 	AddNewContactEvent(InResult);
 }
 
 // Event called when a semantic overlap event ends
 void FSLContactEventHandler::OnSLOverlapEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactEventHandler);
 	FinishContactEvent(Other, Time);
 }
 
 // Event called when a supported by event begins
 void FSLContactEventHandler::OnSLSupportedByBegin(USLBaseIndividual* Supported, USLBaseIndividual* Supporting, float StartTime, const uint64 PairId)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactEventHandler);
 	AddNewSupportedByEvent(Supported, Supporting, StartTime, PairId);
 }
 
 // Event called when a 'possible' supported by event ends
 void FSLContactEventHandler::OnSLSupportedByEnd(const uint64 PairId1, const uint64 PairId2, float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactEventHandler);
 	if(!FinishSupportedByEvent(PairId1, EndTime))
 	{
 		FinishSupportedByEvent(PairId2, EndTime);
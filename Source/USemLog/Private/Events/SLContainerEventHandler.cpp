@@ -7,6 +7,7 @@
 #include "Events/SLContainerEvent.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 
 
 // Set parent
@@ -57,6 +58,7 @@ void FSLContainerEventHandler::Finish(float EndTime, bool bForced)
 // Event called when a semantic grasp happens
 void FSLContainerEventHandler::OnContainerManipulation(USLBaseIndividual* Self, USLBaseIndividual* Other, float StartTime, float EndTime, const FString& Type)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContainerEventHandler);
 	OnSemanticEvent.ExecuteIfBound(MakeShareable(new FSLContainerEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime, EndTime,
 		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
@@ -0,0 +1,461 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLEventIntervalIndex.h"
+#include "Events/SLEventLog.h"
+#include "Events/SLEventStore.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#if SL_WITH_JSON
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#endif // SL_WITH_JSON
+
+/* Tree */
+// Build the tree (clears the previous data)
+void FSLEventIntervalTree::Build(TArray<FInterval> InIntervals)
+{
+	Reset();
+	for (auto& Interval : InIntervals)
+	{
+		if (Interval.End < Interval.Start)
+		{
+			Swap(Interval.Start, Interval.End);
+		}
+	}
+
+	SortedByStart = InIntervals;
+	SortedByStart.Sort([](const FInterval& A, const FInterval& B) { return A.Start < B.Start; });
+
+	ByStart.Reserve(InIntervals.Num());
+	ByEnd.Reserve(InIntervals.Num());
+	Root = BuildNode(InIntervals);
+}
+
+// Clear the tree
+void FSLEventIntervalTree::Reset()
+{
+	Nodes.Empty();
+	ByStart.Empty();
+	ByEnd.Empty();
+	SortedByStart.Empty();
+	Root = INDEX_NONE;
+}
+
+// Add the indexes of the intervals containing the time (Start <= T <= End)
+void FSLEventIntervalTree::Stab(float T, TArray<int32>& OutIdxs) const
+{
+	int32 NodeIdx = Root;
+	while (NodeIdx != INDEX_NONE)
+	{
+		const FNode& Node = Nodes[NodeIdx];
+		const int32 Last = Node.First + Node.Count;
+		if (T < Node.Center)
+		{
+			// All node intervals end after the center, only the start has to be checked
+			for (int32 Idx = Node.First; Idx < Last && ByStart[Idx].Start <= T; ++Idx)
+			{
+				OutIdxs.Add(ByStart[Idx].Idx);
+			}
+			NodeIdx = Node.Left;
+		}
+		else if (T > Node.Center)
+		{
+			// All node intervals start before the center, only the end has to be checked
+			for (int32 Idx = Node.First; Idx < Last && ByEnd[Idx].End >= T; ++Idx)
+			{
+				OutIdxs.Add(ByEnd[Idx].Idx);
+			}
+			NodeIdx = Node.Right;
+		}
+		else
+		{
+			for (int32 Idx = Node.First; Idx < Last; ++Idx)
+			{
+				OutIdxs.Add(ByStart[Idx].Idx);
+			}
+			break;
+		}
+	}
+}
+
+// Add the indexes of the intervals overlapping [T0, T1]
+void FSLEventIntervalTree::Overlap(float T0, float T1, TArray<int32>& OutIdxs) const
+{
+	if (T1 < T0)
+	{
+		Swap(T0, T1);
+	}
+
+	// Intervals already running at T0
+	Stab(T0, OutIdxs);
+
+	// Intervals starting in (T0, T1] (disjoint from the above)
+	int32 Lo = 0;
+	int32 Hi = SortedByStart.Num();
+	while (Lo < Hi)
+	{
+		const int32 Mid = Lo + (Hi - Lo) / 2;
+		if (SortedByStart[Mid].Start <= T0)
+		{
+			Lo = Mid + 1;
+		}
+		else
+		{
+			Hi = Mid;
+		}
+	}
+	for (int32 Idx = Lo; Idx < SortedByStart.Num() && SortedByStart[Idx].Start <= T1; ++Idx)
+	{
+		OutIdxs.Add(SortedByStart[Idx].Idx);
+	}
+}
+
+// Build the subtree of the intervals, returns the node index
+int32 FSLEventIntervalTree::BuildNode(TArray<FInterval>& InIntervals)
+{
+	if (InIntervals.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	// The median endpoint is contained by at least one interval, and splits the rest in halves
+	TArray<float> Endpoints;
+	Endpoints.Reserve(InIntervals.Num() * 2);
+	for (const auto& Interval : InIntervals)
+	{
+		Endpoints.Add(Interval.Start);
+		Endpoints.Add(Interval.End);
+	}
+	Endpoints.Sort();
+	const float Center = Endpoints[Endpoints.Num() / 2];
+
+	TArray<FInterval> LeftIntervals;
+	TArray<FInterval> RightIntervals;
+	TArray<FInterval> CenterIntervals;
+	for (const auto& Interval : InIntervals)
+	{
+		if (Interval.End < Center)
+		{
+			LeftIntervals.Add(Interval);
+		}
+		else if (Interval.Start > Center)
+		{
+			RightIntervals.Add(Interval);
+		}
+		else
+		{
+			CenterIntervals.Add(Interval);
+		}
+	}
+	InIntervals.Empty();
+
+	FNode Node;
+	Node.Center = Center;
+	Node.First = ByStart.Num();
+	Node.Count = CenterIntervals.Num();
+
+	CenterIntervals.Sort([](const FInterval& A, const FInterval& B) { return A.Start < B.Start; });
+	ByStart.Append(CenterIntervals);
+	CenterIntervals.Sort([](const FInterval& A, const FInterval& B) { return A.End > B.End; });
+	ByEnd.Append(CenterIntervals);
+
+	const int32 NodeIdx = Nodes.Add(Node);
+	const int32 LeftIdx = BuildNode(LeftIntervals);
+	const int32 RightIdx = BuildNode(RightIntervals);
+	Nodes[NodeIdx].Left = LeftIdx;
+	Nodes[NodeIdx].Right = RightIdx;
+	return NodeIdx;
+}
+
+
+/* Index */
+// Build the index from the finished events (streamed from the store)
+void FSLEventIntervalIndex::Build(const FSLEventStore& InEvents)
+{
+	TArray<FSLEventIntervalEntry> NewEntries;
+	NewEntries.Reserve(InEvents.Num());
+	InEvents.ForEachSnapshot([&NewEntries](const FSLEventSnapshot& Event)
+	{
+		FSLEventIntervalEntry& Entry = NewEntries.AddDefaulted_GetRef();
+		Entry.Id = Event.Id;
+		Entry.Kind = Event.Kind;
+		Entry.StartTime = Event.StartTime;
+		Entry.EndTime = Event.EndTime;
+
+		for (const auto& Participant : Event.Participants)
+		{
+			if (Participant.Individual)
+			{
+				Entry.ParticipantIds.Add(Participant.Individual->Id);
+				Entry.ParticipantRoles.Add(Participant.Role);
+			}
+		}
+	});
+	Build(MoveTemp(NewEntries));
+}
+
+// Build the index from already copied entries
+void FSLEventIntervalIndex::Build(TArray<FSLEventIntervalEntry> InEntries)
+{
+	Reset();
+	Entries = MoveTemp(InEntries);
+
+	// Deterministic entry order independent of the finishing order of the events
+	Entries.Sort([](const FSLEventIntervalEntry& A, const FSLEventIntervalEntry& B)
+	{
+		return A.StartTime < B.StartTime || (A.StartTime == B.StartTime && A.Id < B.Id);
+	});
+
+	TArray<FSLEventIntervalTree::FInterval> Intervals;
+	TMap<FString, TArray<FSLEventIntervalTree::FInterval>> IndividualIntervals;
+	Intervals.Reserve(Entries.Num());
+	IdToIdx.Reserve(Entries.Num());
+	for (int32 Idx = 0; Idx < Entries.Num(); ++Idx)
+	{
+		const FSLEventIntervalEntry& Entry = Entries[Idx];
+		const FSLEventIntervalTree::FInterval Interval{ Entry.StartTime, Entry.EndTime, Idx };
+		IdToIdx.Add(Entry.Id, Idx);
+		Intervals.Add(Interval);
+		for (const auto& IndividualId : Entry.ParticipantIds)
+		{
+			// Avoid duplicates if the individual has more than one role in the event
+			TArray<FSLEventIntervalTree::FInterval>& Arr = IndividualIntervals.FindOrAdd(IndividualId);
+			if (Arr.Num() == 0 || Arr.Last().Idx != Idx)
+			{
+				Arr.Add(Interval);
+			}
+		}
+	}
+
+	Tree.Build(MoveTemp(Intervals));
+	IndividualTrees.Reserve(IndividualIntervals.Num());
+	for (auto& Pair : IndividualIntervals)
+	{
+		IndividualTrees.Add(Pair.Key).Build(MoveTemp(Pair.Value));
+	}
+}
+
+// Load the events of a binary event log (.slev) or of a json lines (.ndjson) output
+bool FSLEventIntervalIndex::Load(const FString& FilePath)
+{
+	if (FPaths::GetExtension(FilePath).Equals(TEXT("slev"), ESearchCase::IgnoreCase))
+	{
+		return LoadFromEventLog(FilePath);
+	}
+	return LoadFromJson(FilePath);
+}
+
+// Load the events of a binary event log
+bool FSLEventIntervalIndex::LoadFromEventLog(const FString& FilePath)
+{
+	FSLEventLogReader Log;
+	if (!Log.Load(FilePath))
+	{
+		return false;
+	}
+
+	TArray<FSLEventIntervalEntry> NewEntries;
+	NewEntries.Reserve(Log.GetRecords().Num());
+	for (const auto& Record : Log.GetRecords())
+	{
+		FSLEventIntervalEntry& Entry = NewEntries.AddDefaulted_GetRef();
+		Entry.Id = Log.GetString(Record.IdStr);
+		Entry.Kind = Record.GetKind();
+		Entry.StartTime = Record.StartTime;
+		Entry.EndTime = Record.EndTime;
+		for (int32 Idx = 0; Idx < Record.NumParticipants; ++Idx)
+		{
+			const FString& IndividualId = Log.GetIndividualId(Record.Participants[Idx]);
+			if (!IndividualId.IsEmpty())
+			{
+				Entry.ParticipantIds.Add(IndividualId);
+				Entry.ParticipantRoles.Add((ESLEventRole)Record.Roles[Idx]);
+			}
+		}
+	}
+	Build(MoveTemp(NewEntries));
+	return true;
+}
+
+// Load the events of a json lines output (event stream or offline converter)
+bool FSLEventIntervalIndex::LoadFromJson(const FString& FilePath)
+{
+#if SL_WITH_JSON
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	TArray<FSLEventIntervalEntry> NewEntries;
+	NewEntries.Reserve(Lines.Num());
+	for (const auto& Line : Lines)
+	{
+		if (Line.IsEmpty())
+		{
+			continue;
+		}
+
+		TSharedPtr<FJsonObject> JsonObj;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Line);
+		if (!FJsonSerializer::Deserialize(Reader, JsonObj) || !JsonObj.IsValid())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Skipping invalid line in %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+			continue;
+		}
+
+		// Trailing summary line
+		if (JsonObj->HasField(TEXT("finished")))
+		{
+			continue;
+		}
+
+		FSLEventIntervalEntry& Entry = NewEntries.AddDefaulted_GetRef();
+		Entry.Id = JsonObj->GetStringField(TEXT("id"));
+		Entry.Kind = GetKindFromName(JsonObj->GetStringField(TEXT("type")));
+		Entry.StartTime = JsonObj->GetNumberField(TEXT("start"));
+		Entry.EndTime = JsonObj->GetNumberField(TEXT("end"));
+
+		const TArray<TSharedPtr<FJsonValue>>* ParticipantsArr;
+		if (JsonObj->TryGetArrayField(TEXT("participants"), ParticipantsArr))
+		{
+			for (const auto& ParticipantVal : *ParticipantsArr)
+			{
+				const TSharedPtr<FJsonObject> ParticipantObj = ParticipantVal->AsObject();
+				FString IndividualId;
+				if (ParticipantObj.IsValid() && ParticipantObj->TryGetStringField(TEXT("id"), IndividualId) && !IndividualId.IsEmpty())
+				{
+					Entry.ParticipantIds.Add(IndividualId);
+					Entry.ParticipantRoles.Add(GetRoleFromName(ParticipantObj->GetStringField(TEXT("role"))));
+				}
+			}
+		}
+	}
+	Build(MoveTemp(NewEntries));
+	return true;
+#else
+	UE_LOG(LogTemp, Error, TEXT("%s::%d SL_WITH_JSON flag is 0, cannot load %s, use the binary event log instead.."),
+		*FString(__FUNCTION__), __LINE__, *FilePath);
+	return false;
+#endif // SL_WITH_JSON
+}
+
+// Clear the index
+void FSLEventIntervalIndex::Reset()
+{
+	Entries.Empty();
+	IdToIdx.Empty();
+	Tree.Reset();
+	IndividualTrees.Empty();
+}
+
+// Get the event with the given id (nullptr if not found)
+const FSLEventIntervalEntry* FSLEventIntervalIndex::FindById(const FString& Id) const
+{
+	if (const int32* Idx = IdToIdx.Find(Id))
+	{
+		return &Entries[*Idx];
+	}
+	return nullptr;
+}
+
+// Get the events overlapping [T0, T1]
+void FSLEventIntervalIndex::QueryOverlapping(float T0, float T1, TArray<int32>& OutIdxs) const
+{
+	Tree.Overlap(T0, T1, OutIdxs);
+}
+
+// Get the events active at the given time
+void FSLEventIntervalIndex::QueryAt(float T, TArray<int32>& OutIdxs) const
+{
+	Tree.Stab(T, OutIdxs);
+}
+
+// Get the events of the individual overlapping [T0, T1], optionally of the given kind only
+void FSLEventIntervalIndex::QueryIndividualOverlapping(const FString& IndividualId, float T0, float T1, TArray<int32>& OutIdxs,
+	TOptional<ESLEventKind> Kind) const
+{
+	if (const FSLEventIntervalTree* IndividualTree = IndividualTrees.Find(IndividualId))
+	{
+		const int32 FirstNewIdx = OutIdxs.Num();
+		IndividualTree->Overlap(T0, T1, OutIdxs);
+		FilterKind(OutIdxs, FirstNewIdx, Kind);
+	}
+}
+
+// Get the events of the individual active at the given time, optionally of the given kind only
+void FSLEventIntervalIndex::QueryIndividualAt(const FString& IndividualId, float T, TArray<int32>& OutIdxs,
+	TOptional<ESLEventKind> Kind) const
+{
+	if (const FSLEventIntervalTree* IndividualTree = IndividualTrees.Find(IndividualId))
+	{
+		const int32 FirstNewIdx = OutIdxs.Num();
+		IndividualTree->Stab(T, OutIdxs);
+		FilterKind(OutIdxs, FirstNewIdx, Kind);
+	}
+}
+
+// Get the individuals sharing an event of the given kind with the individual at the given time
+void FSLEventIntervalIndex::QueryPartnersAt(const FString& IndividualId, float T, ESLEventKind Kind, TArray<FString>& OutIndividualIds) const
+{
+	TArray<int32> Idxs;
+	QueryIndividualAt(IndividualId, T, Idxs, Kind);
+	for (const int32 Idx : Idxs)
+	{
+		for (const auto& OtherId : Entries[Idx].ParticipantIds)
+		{
+			if (OtherId != IndividualId)
+			{
+				OutIndividualIds.AddUnique(OtherId);
+			}
+		}
+	}
+}
+
+// Get the event kind from its name
+ESLEventKind FSLEventIntervalIndex::GetKindFromName(const FString& InName)
+{
+	for (uint8 KindIdx = 0; KindIdx < (uint8)ESLEventKind::Dummy; ++KindIdx)
+	{
+		if (InName.Equals(ISLEvent::GetKindName((ESLEventKind)KindIdx)))
+		{
+			return (ESLEventKind)KindIdx;
+		}
+	}
+	return ESLEventKind::Dummy;
+}
+
+// Get the event role from its name
+ESLEventRole FSLEventIntervalIndex::GetRoleFromName(const FString& InName)
+{
+	for (uint8 RoleIdx = 0; RoleIdx <= (uint8)ESLEventRole::Output; ++RoleIdx)
+	{
+		if (InName.Equals(ISLEvent::GetRoleName((ESLEventRole)RoleIdx)))
+		{
+			return (ESLEventRole)RoleIdx;
+		}
+	}
+	return ESLEventRole::Participant;
+}
+
+// Remove the newly added result indexes of other kinds
+void FSLEventIntervalIndex::FilterKind(TArray<int32>& InOutIdxs, int32 FirstNewIdx, TOptional<ESLEventKind> Kind) const
+{
+	if (!Kind.IsSet())
+	{
+		return;
+	}
+
+	int32 WriteIdx = FirstNewIdx;
+	for (int32 ReadIdx = FirstNewIdx; ReadIdx < InOutIdxs.Num(); ++ReadIdx)
+	{
+		if (Entries[InOutIdxs[ReadIdx]].Kind == Kind.GetValue())
+		{
+			InOutIdxs[WriteIdx++] = InOutIdxs[ReadIdx];
+		}
+	}
+	InOutIdxs.SetNum(WriteIdx, false);
+}
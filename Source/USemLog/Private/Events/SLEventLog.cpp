@@ -0,0 +1,574 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLEventLog.h"
+#include "Events/SLGraspEvent.h"
+#include "Events/SLContainerEvent.h"
+#include "Events/SLSlicingEvent.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+
+// Serialize (fixed size)
+FArchive& operator<<(FArchive& Ar, FSLEventLogRecord& Record)
+{
+	Ar << Record.Kind;
+	Ar << Record.NumParticipants;
+	Ar << Record.Flags;
+	Ar << Record.StartTime;
+	Ar << Record.EndTime;
+	Ar << Record.IdStr;
+	Ar << Record.ExtraStr;
+	for (int32 Idx = 0; Idx < SLEventLog::MaxParticipants; ++Idx)
+	{
+		Ar << Record.Participants[Idx];
+	}
+	for (int32 Idx = 0; Idx < SLEventLog::MaxParticipants; ++Idx)
+	{
+		Ar << Record.Roles[Idx];
+	}
+	return Ar;
+}
+
+// Serialize a string as utf8 (length + bytes)
+static void SerializeUtf8(FArchive& Ar, FString& Str)
+{
+	if (Ar.IsLoading())
+	{
+		uint32 Len = 0;
+		Ar << Len;
+		if (Len > (uint32)(Ar.TotalSize() - Ar.Tell()))
+		{
+			Ar.SetError();
+			return;
+		}
+		TArray<ANSICHAR> Bytes;
+		Bytes.SetNumUninitialized(Len);
+		Ar.Serialize(Bytes.GetData(), Len);
+		FUTF8ToTCHAR Converter(Bytes.GetData(), Len);
+		Str = FString(Converter.Length(), Converter.Get());
+	}
+	else
+	{
+		FTCHARToUTF8 Converter(*Str);
+		uint32 Len = Converter.Length();
+		Ar << Len;
+		Ar.Serialize((void*)Converter.Get(), Len);
+	}
+}
+
+
+// Ctor
+FSLEventLogWriter::FSLEventLogWriter()
+{
+	bIsInit = false;
+	Ar = nullptr;
+	JournalAr = nullptr;
+	NumJournaledStrings = 0;
+	NumJournaledIndividuals = 0;
+	NumRecords = 0;
+	EpisodeStr = SLEventLog::None;
+	TaskStr = SLEventLog::None;
+	SemanticMapStr = SLEventLog::None;
+}
+
+// Dtor
+FSLEventLogWriter::~FSLEventLogWriter()
+{
+	if (bIsInit)
+	{
+		Finish(-1.f, -1.f);
+	}
+}
+
+// Open the log file (<Dir><EpisodeId>_ED.slev) and write the header
+bool FSLEventLogWriter::Init(const FString& InDirPath, const FString& InEpisodeId, const FString& InTaskId,
+	const FString& InSemanticMapId, bool bOverwrite)
+{
+	if (bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Event log writer is already initialized.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	FilePath = InDirPath + InEpisodeId + TEXT("_ED.slev");
+	FPaths::RemoveDuplicateSlashes(FilePath);
+	if (FPaths::FileExists(FilePath) && !bOverwrite)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Event log file %s already exists, and overwrite is false.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	Ar = IFileManager::Get().CreateFileWriter(*FilePath);
+	if (Ar == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open event log file %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	// The log is still usable without the journal, it only cannot be recovered after a crash
+	JournalFilePath = FilePath + TEXT(".journal");
+	JournalAr = IFileManager::Get().CreateFileWriter(*JournalFilePath);
+	if (JournalAr == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not open event log journal %s, the log will not be recoverable.."),
+			*FString(__FUNCTION__), __LINE__, *JournalFilePath);
+	}
+
+	// Header
+	uint32 Magic = SLEventLog::Magic;
+	uint16 Version = SLEventLog::Version;
+	uint16 RecordSize = (uint16)SLEventLog::RecordSize;
+	*Ar << Magic << Version << RecordSize;
+
+	NumRecords = 0;
+	Strings.Empty();
+	StringToIdx.Empty();
+	Individuals.Empty();
+	IndividualToIdx.Empty();
+	Index.Empty();
+	EpisodeStr = InternString(InEpisodeId);
+	TaskStr = InternString(InTaskId);
+	SemanticMapStr = InternString(InSemanticMapId);
+
+	NumJournaledStrings = 0;
+	NumJournaledIndividuals = 0;
+	if (JournalAr)
+	{
+		uint8 Tag = SLEventLog::JournalMeta;
+		*JournalAr << Tag << EpisodeStr << TaskStr << SemanticMapStr;
+		FlushJournal();
+	}
+	bIsInit = true;
+	return true;
+}
+
+// Append the event record
+void FSLEventLogWriter::Add(const ISLEvent& Event)
+{
+	if (!bIsInit)
+	{
+		return;
+	}
+
+	FSLEventLogRecord Record;
+	Record.Kind = (uint8)Event.Kind();
+	Record.StartTime = Event.StartTime;
+	Record.EndTime = Event.EndTime;
+	Record.IdStr = InternString(Event.Id);
+
+	FSLEventParticipants Participants;
+	Event.GetParticipants(Participants);
+	for (const auto& Participant : Participants)
+	{
+		if (Record.NumParticipants == SLEventLog::MaxParticipants)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Event %s has more than %d participants, the rest are not logged.."),
+				*FString(__FUNCTION__), __LINE__, *Event.Id, SLEventLog::MaxParticipants);
+			break;
+		}
+		Record.Participants[Record.NumParticipants] = GetIndividualIndex(Participant.Individual);
+		Record.Roles[Record.NumParticipants] = (uint8)Participant.Role;
+		Record.NumParticipants++;
+	}
+
+	// Kind specific data, we know the exact type from the kind (RTTI is not enabled by default)
+	switch (Event.Kind())
+	{
+	case ESLEventKind::Grasp:
+		Record.ExtraStr = InternString(static_cast<const FSLGraspEvent&>(Event).GraspType);
+		break;
+	case ESLEventKind::Container:
+		Record.ExtraStr = InternString(static_cast<const FSLContainerEvent&>(Event).Type);
+		break;
+	case ESLEventKind::Slicing:
+		if (static_cast<const FSLSlicingEvent&>(Event).bTaskSuccessful)
+		{
+			Record.Flags |= SLEventLog::FlagTaskSuccessful;
+		}
+		break;
+	default:
+		break;
+	}
+
+	// Index block of the record
+	if (NumRecords % SLEventLog::IndexBlockSize == 0)
+	{
+		FSLEventLogIndexEntry& Entry = Index.AddDefaulted_GetRef();
+		Entry.FirstRecord = NumRecords;
+		Entry.MinStartTime = Record.StartTime;
+		Entry.MaxEndTime = Record.EndTime;
+	}
+	else
+	{
+		FSLEventLogIndexEntry& Entry = Index.Last();
+		Entry.MinStartTime = FMath::Min(Entry.MinStartTime, Record.StartTime);
+		Entry.MaxEndTime = FMath::Max(Entry.MaxEndTime, Record.EndTime);
+	}
+
+	*Ar << Record;
+	NumRecords++;
+
+	if (NumRecords % SLEventLog::JournalInterval == 0)
+	{
+		FlushJournal();
+	}
+}
+
+// Write the tables, the index and the footer and close the file
+void FSLEventLogWriter::Finish(float EpisodeStartTime, float EpisodeEndTime)
+{
+	if (!bIsInit)
+	{
+		return;
+	}
+
+	// String table
+	uint64 StringsOffset = Ar->Tell();
+	uint32 NumStrings = Strings.Num();
+	*Ar << NumStrings;
+	for (auto& Str : Strings)
+	{
+		SerializeUtf8(*Ar, Str);
+	}
+
+	// Individual table
+	uint64 IndividualsOffset = Ar->Tell();
+	uint32 NumIndividuals = Individuals.Num();
+	*Ar << NumIndividuals;
+	for (auto& Individual : Individuals)
+	{
+		*Ar << Individual.IdStr << Individual.ClassStr << Individual.LabelStr;
+	}
+
+	// Index
+	uint64 IndexOffset = Ar->Tell();
+	uint32 NumIndexEntries = Index.Num();
+	*Ar << NumIndexEntries;
+	for (auto& Entry : Index)
+	{
+		*Ar << Entry.FirstRecord << Entry.MinStartTime << Entry.MaxEndTime;
+	}
+
+	// Footer (fixed size, read from the end of the file)
+	uint32 BlockSize = SLEventLog::IndexBlockSize;
+	uint32 Reserved = 0;
+	uint32 Magic = SLEventLog::Magic;
+	*Ar << StringsOffset << IndividualsOffset << IndexOffset;
+	*Ar << NumRecords << EpisodeStr << TaskStr << SemanticMapStr;
+	*Ar << EpisodeStartTime << EpisodeEndTime << BlockSize << Reserved << Reserved << Magic;
+
+	const bool bWritten = !Ar->IsError();
+	if (!bWritten)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Error while writing the event log %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+	}
+	Ar->Close();
+	delete Ar;
+	Ar = nullptr;
+
+	// The log is complete, the journal is only needed if the closing failed
+	if (JournalAr)
+	{
+		JournalAr->Close();
+		delete JournalAr;
+		JournalAr = nullptr;
+		if (bWritten)
+		{
+			IFileManager::Get().Delete(*JournalFilePath);
+		}
+	}
+	bIsInit = false;
+}
+
+// Get the string table index of the string
+uint32 FSLEventLogWriter::InternString(const FString& Str)
+{
+	if (const uint32* Idx = StringToIdx.Find(Str))
+	{
+		return *Idx;
+	}
+	const uint32 NewIdx = Strings.Add(Str);
+	StringToIdx.Add(Str, NewIdx);
+	return NewIdx;
+}
+
+// Get the individual table index of the individual
+uint32 FSLEventLogWriter::GetIndividualIndex(USLBaseIndividual* Individual)
+{
+	if (Individual == nullptr)
+	{
+		return SLEventLog::None;
+	}
+	if (const uint32* Idx = IndividualToIdx.Find(Individual))
+	{
+		return *Idx;
+	}
+
+	FSLEventLogIndividual Entry;
+	Entry.IdStr = InternString(Individual->GetIdValue());
+	Entry.ClassStr = InternString(Individual->GetClassValue());
+	Entry.LabelStr = InternString(Individual->GetParentActor() ? Individual->GetParentActor()->GetName() : Individual->GetIdValue());
+	const uint32 NewIdx = Individuals.Add(Entry);
+	IndividualToIdx.Add(Individual, NewIdx);
+	return NewIdx;
+}
+
+// Append the new table entries and the number of records to the journal, flush both files
+void FSLEventLogWriter::FlushJournal()
+{
+	if (JournalAr == nullptr)
+	{
+		return;
+	}
+
+	for (; NumJournaledStrings < Strings.Num(); ++NumJournaledStrings)
+	{
+		uint8 Tag = SLEventLog::JournalString;
+		*JournalAr << Tag;
+		SerializeUtf8(*JournalAr, Strings[NumJournaledStrings]);
+	}
+	for (; NumJournaledIndividuals < Individuals.Num(); ++NumJournaledIndividuals)
+	{
+		FSLEventLogIndividual& Individual = Individuals[NumJournaledIndividuals];
+		uint8 Tag = SLEventLog::JournalIndividual;
+		*JournalAr << Tag << Individual.IdStr << Individual.ClassStr << Individual.LabelStr;
+	}
+
+	// The records have to be on disk before the sync entry counting them
+	Ar->Flush();
+	uint8 Tag = SLEventLog::JournalSync;
+	uint32 NumSyncedRecords = NumRecords;
+	*JournalAr << Tag << NumSyncedRecords;
+	JournalAr->Flush();
+}
+
+
+// Load and validate the log file
+bool FSLEventLogReader::Load(const FString& InFilePath)
+{
+	FilePath = InFilePath;
+	bRecovered = false;
+	Records.Empty();
+	Strings.Empty();
+	Individuals.Empty();
+	Index.Empty();
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+	if (Data.Num() < SLEventLog::HeaderSize)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s is too small to be an event log.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	FMemoryReader Ar(Data);
+
+	// Header
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	uint16 RecordSize = 0;
+	Ar << Magic << Version << RecordSize;
+	if (Magic != SLEventLog::Magic || Version > SLEventLog::Version || RecordSize != SLEventLog::RecordSize)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s is not a supported event log (magic=%x, version=%d, record size=%d).."),
+			*FString(__FUNCTION__), __LINE__, *FilePath, Magic, Version, RecordSize);
+		return false;
+	}
+
+	// Footer
+	uint64 StringsOffset = 0, IndividualsOffset = 0, IndexOffset = 0;
+	uint32 NumRecords = 0, BlockSize = 0, Reserved = 0, FooterMagic = 0;
+	if (Data.Num() >= SLEventLog::HeaderSize + SLEventLog::FooterSize)
+	{
+		Ar.Seek(Data.Num() - SLEventLog::FooterSize);
+		Ar << StringsOffset << IndividualsOffset << IndexOffset;
+		Ar << NumRecords << EpisodeStr << TaskStr << SemanticMapStr;
+		Ar << StartTime << EndTime << BlockSize << Reserved << Reserved << FooterMagic;
+	}
+	if (FooterMagic != SLEventLog::Magic
+		|| SLEventLog::HeaderSize + (int64)NumRecords * SLEventLog::RecordSize != (int64)StringsOffset
+		|| StringsOffset > IndividualsOffset || IndividualsOffset > IndexOffset || (int64)IndexOffset > Data.Num())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s has an invalid footer, the log was probably not closed, recovering from the journal.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath);
+		return Recover(Data);
+	}
+
+	// Records
+	Ar.Seek(SLEventLog::HeaderSize);
+	Records.SetNum(NumRecords);
+	for (auto& Record : Records)
+	{
+		Ar << Record;
+	}
+
+	// String table
+	Ar.Seek(StringsOffset);
+	uint32 NumStrings = 0;
+	Ar << NumStrings;
+	Strings.SetNum(FMath::Min<uint32>(NumStrings, Data.Num()));
+	for (auto& Str : Strings)
+	{
+		SerializeUtf8(Ar, Str);
+	}
+
+	// Individual table
+	Ar.Seek(IndividualsOffset);
+	uint32 NumIndividuals = 0;
+	Ar << NumIndividuals;
+	Individuals.SetNum(FMath::Min<uint32>(NumIndividuals, Data.Num()));
+	for (auto& Individual : Individuals)
+	{
+		Ar << Individual.IdStr << Individual.ClassStr << Individual.LabelStr;
+	}
+
+	// Index
+	Ar.Seek(IndexOffset);
+	uint32 NumIndexEntries = 0;
+	Ar << NumIndexEntries;
+	Index.SetNum(FMath::Min<uint32>(NumIndexEntries, Data.Num()));
+	for (auto& Entry : Index)
+	{
+		Ar << Entry.FirstRecord << Entry.MinStartTime << Entry.MaxEndTime;
+	}
+
+	if (Ar.IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Error while reading %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+	return true;
+}
+
+// Load the records journaled before the crash (the log has no tables, index or footer)
+bool FSLEventLogReader::Recover(const TArray<uint8>& Data)
+{
+	const FString JournalFilePath = FilePath + TEXT(".journal");
+	TArray<uint8> JournalData;
+	if (!FFileHelper::LoadFileToArray(JournalData, *JournalFilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read the journal %s, the log cannot be recovered.."),
+			*FString(__FUNCTION__), __LINE__, *JournalFilePath);
+		return false;
+	}
+
+	// Only the entries up to the last sync are complete
+	FMemoryReader JournalAr(JournalData);
+	uint32 NumSyncedRecords = 0;
+	int32 NumSyncedStrings = 0;
+	int32 NumSyncedIndividuals = 0;
+	bool bHasSync = false;
+	while (!JournalAr.AtEnd())
+	{
+		uint8 Tag = 0;
+		JournalAr << Tag;
+		if (Tag == SLEventLog::JournalMeta)
+		{
+			JournalAr << EpisodeStr << TaskStr << SemanticMapStr;
+		}
+		else if (Tag == SLEventLog::JournalString)
+		{
+			SerializeUtf8(JournalAr, Strings.AddDefaulted_GetRef());
+		}
+		else if (Tag == SLEventLog::JournalIndividual)
+		{
+			FSLEventLogIndividual& Individual = Individuals.AddDefaulted_GetRef();
+			JournalAr << Individual.IdStr << Individual.ClassStr << Individual.LabelStr;
+		}
+		else if (Tag == SLEventLog::JournalSync)
+		{
+			uint32 NumJournalRecords = 0;
+			JournalAr << NumJournalRecords;
+			if (!JournalAr.IsError())
+			{
+				NumSyncedRecords = NumJournalRecords;
+				NumSyncedStrings = Strings.Num();
+				NumSyncedIndividuals = Individuals.Num();
+				bHasSync = true;
+			}
+		}
+		else
+		{
+			JournalAr.SetError();
+		}
+
+		if (JournalAr.IsError())
+		{
+			break;
+		}
+	}
+	if (!bHasSync)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d The journal %s has no sync entry, the log cannot be recovered.."),
+			*FString(__FUNCTION__), __LINE__, *JournalFilePath);
+		return false;
+	}
+	Strings.SetNum(NumSyncedStrings);
+	Individuals.SetNum(NumSyncedIndividuals);
+
+	// Records (the ones after the last sync might reference entries missing from the journal)
+	const uint32 NumRecords = FMath::Min<uint32>(NumSyncedRecords, (Data.Num() - SLEventLog::HeaderSize) / SLEventLog::RecordSize);
+	FMemoryReader Ar(Data);
+	Ar.Seek(SLEventLog::HeaderSize);
+	Records.SetNum(NumRecords);
+	for (auto& Record : Records)
+	{
+		Ar << Record;
+	}
+
+	// The index and the episode interval are rebuilt from the records
+	StartTime = 0.f;
+	EndTime = 0.f;
+	for (uint32 RecordIdx = 0; RecordIdx < NumRecords; ++RecordIdx)
+	{
+		const FSLEventLogRecord& Record = Records[RecordIdx];
+		if (RecordIdx % SLEventLog::IndexBlockSize == 0)
+		{
+			FSLEventLogIndexEntry& Entry = Index.AddDefaulted_GetRef();
+			Entry.FirstRecord = RecordIdx;
+			Entry.MinStartTime = Record.StartTime;
+			Entry.MaxEndTime = Record.EndTime;
+		}
+		else
+		{
+			FSLEventLogIndexEntry& Entry = Index.Last();
+			Entry.MinStartTime = FMath::Min(Entry.MinStartTime, Record.StartTime);
+			Entry.MaxEndTime = FMath::Max(Entry.MaxEndTime, Record.EndTime);
+		}
+		StartTime = RecordIdx == 0 ? Record.StartTime : FMath::Min(StartTime, Record.StartTime);
+		EndTime = FMath::Max(EndTime, Record.EndTime);
+	}
+
+	if (Ar.IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Error while recovering %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+	UE_LOG(LogTemp, Warning, TEXT("%s::%d Recovered %d records from %s (%d were not synced).."),
+		*FString(__FUNCTION__), __LINE__, NumRecords, *FilePath,
+		FMath::Max(0, (int32)((Data.Num() - SLEventLog::HeaderSize) / SLEventLog::RecordSize) - (int32)NumRecords));
+	bRecovered = true;
+	return true;
+}
+
+// Get the string from the string table (empty if not set)
+const FString& FSLEventLogReader::GetString(uint32 StrIdx) const
+{
+	static const FString Empty;
+	return Strings.IsValidIndex(StrIdx) ? Strings[StrIdx] : Empty;
+}
+
+// Get the id of the individual (empty if not set)
+const FString& FSLEventLogReader::GetIndividualId(uint32 IndividualIdx) const
+{
+	static const FString Empty;
+	return Individuals.IsValidIndex(IndividualIdx) ? GetString(Individuals[IndividualIdx].IdStr) : Empty;
+}
@@ -0,0 +1,284 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLEventLogConverter.h"
+#include "Events/SLTimelineLODWriter.h"
+#include "Owl/SLOwlExperimentStatics.h"
+#include "Owl/SLOwlWriter.h"
+#include "Runtime/SLEventStreamWriter.h"
+#include "Async/ParallelFor.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Convert the log to the selected outputs, written next to the log if the output directory is empty
+bool FSLEventLogConverter::Convert(const FString& LogFilePath, const FString& OutDirPath, ESLEventLogOutput Outputs, bool bOverwrite)
+{
+	FSLEventLogReader Log;
+	if (!Log.Load(LogFilePath))
+	{
+		return false;
+	}
+
+	const FString DirPath = (OutDirPath.IsEmpty() ? FPaths::GetPath(LogFilePath) : OutDirPath) + TEXT("/");
+	const FString EpisodeId = Log.GetEpisodeId().IsEmpty() ? FPaths::GetBaseFilename(LogFilePath) : Log.GetEpisodeId();
+	bool bSuccess = true;
+
+	if (EnumHasAnyFlags(Outputs, ESLEventLogOutput::Owl | ESLEventLogOutput::NTriples))
+	{
+		TSharedPtr<FSLOwlExperiment> ExperimentDoc = CreateExperimentDoc(Log);
+		if (EnumHasAnyFlags(Outputs, ESLEventLogOutput::Owl))
+		{
+			FSLOwlExperimentStatics::WriteToFile(ExperimentDoc, DirPath, bOverwrite,
+				EnumHasAnyFlags(Outputs, ESLEventLogOutput::NTriples));
+		}
+		else
+		{
+			FString FilePath = DirPath + EpisodeId + TEXT("_ED") + FSLOwlWriter::GetFileExtension(ESLOwlWriterFormat::NTriples);
+			FPaths::RemoveDuplicateSlashes(FilePath);
+			if (!FPaths::FileExists(FilePath) || bOverwrite)
+			{
+				bSuccess &= FSLOwlWriter::WriteToFile(*ExperimentDoc, FilePath, ESLOwlWriterFormat::NTriples);
+			}
+		}
+	}
+
+	if (EnumHasAnyFlags(Outputs, ESLEventLogOutput::Json))
+	{
+		FString FilePath = DirPath + EpisodeId + TEXT("_ED.ndjson");
+		FPaths::RemoveDuplicateSlashes(FilePath);
+		if (!FPaths::FileExists(FilePath) || bOverwrite)
+		{
+			bSuccess &= WriteJson(Log, FilePath);
+		}
+	}
+
+	if (EnumHasAnyFlags(Outputs, ESLEventLogOutput::Timeline))
+	{
+		bSuccess &= WriteTimeline(Log, DirPath, bOverwrite);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Converted %s (%d events).."),
+		*FString(__FUNCTION__), __LINE__, *LogFilePath, Log.GetRecords().Num());
+	return bSuccess;
+}
+
+// Convert the logs in parallel, returns the number of successfully converted logs
+int32 FSLEventLogConverter::ConvertAll(const TArray<FString>& LogFilePaths, const FString& OutDirPath, ESLEventLogOutput Outputs, bool bOverwrite)
+{
+	FThreadSafeCounter NumConverted;
+	ParallelFor(LogFilePaths.Num(), [&](int32 Idx)
+	{
+		if (Convert(LogFilePaths[Idx], OutDirPath, Outputs, bOverwrite))
+		{
+			NumConverted.Increment();
+		}
+	});
+	return NumConverted.GetValue();
+}
+
+// Create the experiment document of the log
+TSharedPtr<FSLOwlExperiment> FSLEventLogConverter::CreateExperimentDoc(const FSLEventLogReader& Log)
+{
+	TSharedPtr<FSLOwlExperiment> ExperimentDoc = FSLOwlExperimentStatics::CreateDefaultExperiment(Log.GetEpisodeId(), "log", "ameva_log");
+
+	TArray<FString> SubActionIds;
+	SubActionIds.Reserve(Log.GetRecords().Num());
+	for (const auto& Record : Log.GetRecords())
+	{
+		ExperimentDoc->RegisterTimepoint(Record.StartTime);
+		ExperimentDoc->RegisterTimepoint(Record.EndTime);
+		ExperimentDoc->AddIndividual(CreateEventNode(Log, Record));
+		SubActionIds.Add(Log.GetString(Record.IdStr));
+	}
+	ExperimentDoc->AddTimepointIndividuals();
+	ExperimentDoc->AddExperimentIndividual(SubActionIds, Log.GetSemanticMapId(), Log.GetTaskId());
+	return ExperimentDoc;
+}
+
+// Write the events as json lines (same layout as the event stream, without the context)
+bool FSLEventLogConverter::WriteJson(const FSLEventLogReader& Log, const FString& FilePath)
+{
+	FString Lines;
+	Lines.Reserve(Log.GetRecords().Num() * 192);
+	for (const auto& Record : Log.GetRecords())
+	{
+		Lines.Append(TEXT("{\"id\":\""));
+		FSLEventStreamWriter::AppendEscaped(Lines, Log.GetString(Record.IdStr));
+		Lines.Append(TEXT("\",\"type\":\""));
+		Lines.Append(ISLEvent::GetKindName(Record.GetKind()));
+		Lines.Append(FString::Printf(TEXT("\",\"start\":%f,\"end\":%f,\"episode\":\""), Record.StartTime, Record.EndTime));
+		FSLEventStreamWriter::AppendEscaped(Lines, Log.GetEpisodeId());
+		Lines.Append(TEXT("\",\"participants\":["));
+		for (int32 Idx = 0; Idx < Record.NumParticipants; ++Idx)
+		{
+			Lines.Append(Idx == 0 ? TEXT("{\"id\":\"") : TEXT(",{\"id\":\""));
+			FSLEventStreamWriter::AppendEscaped(Lines, Log.GetIndividualId(Record.Participants[Idx]));
+			Lines.Append(TEXT("\",\"role\":\""));
+			Lines.Append(ISLEvent::GetRoleName((ESLEventRole)Record.Roles[Idx]));
+			Lines.Append(TEXT("\"}"));
+		}
+		Lines.Append(TEXT("]}\n"));
+	}
+	Lines.Append(FString::Printf(TEXT("{\"finished\":true,\"end\":%f,\"num_events\":%d}\n"), Log.GetEndTime(), Log.GetRecords().Num()));
+	return FFileHelper::SaveStringToFile(Lines, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+// Write the level-of-detail timeline of the events
+bool FSLEventLogConverter::WriteTimeline(const FSLEventLogReader& Log, const FString& DirPath, bool bOverwrite)
+{
+	// One row per individual, plus one shared row for the events without participants
+	TArray<FString> Rows;
+	Rows.Reserve(Log.GetIndividuals().Num() + 1);
+	for (const auto& Individual : Log.GetIndividuals())
+	{
+		Rows.Add(Log.GetString(Individual.LabelStr));
+	}
+	const int32 NullRow = Rows.Add(TEXT("null"));
+
+	TArray<FSLTimelineRowEvent> RowEvents;
+	TArray<FString> EventIds;
+	RowEvents.Reserve(Log.GetRecords().Num() * 2);
+	EventIds.Reserve(Log.GetRecords().Num());
+	for (const auto& Record : Log.GetRecords())
+	{
+		const int32 EventIdx = EventIds.Add(Log.GetString(Record.IdStr));
+		for (int32 Idx = 0; Idx < Record.NumParticipants; ++Idx)
+		{
+			const int32 Row = Log.GetIndividuals().IsValidIndex(Record.Participants[Idx]) ? Record.Participants[Idx] : NullRow;
+			RowEvents.Add({ Row, Record.Kind, Record.StartTime, Record.EndTime, EventIdx });
+		}
+		if (Record.NumParticipants == 0)
+		{
+			RowEvents.Add({ NullRow, Record.Kind, Record.StartTime, Record.EndTime, EventIdx });
+		}
+	}
+
+	FSLTimelineLODParameters Params;
+	Params.StartTime = Log.GetStartTime();
+	Params.EndTime = Log.GetEndTime();
+	Params.TaskId = Log.GetTaskId();
+	Params.EpisodeId = Log.GetEpisodeId();
+	return FSLTimelineLODWriter::Write(MoveTemp(Rows), MoveTemp(RowEvents), EventIds, DirPath, Log.GetEpisodeId(), Params, bOverwrite);
+}
+
+// Parse a comma separated list of outputs (owl,nt,json,timeline,all)
+ESLEventLogOutput FSLEventLogConverter::ParseOutputs(const FString& InStr)
+{
+	ESLEventLogOutput Outputs = ESLEventLogOutput::None;
+	TArray<FString> Tokens;
+	InStr.ParseIntoArray(Tokens, TEXT(","));
+	for (const auto& Token : Tokens)
+	{
+		const FString Name = Token.TrimStartAndEnd();
+		if (Name.Equals(TEXT("owl"), ESearchCase::IgnoreCase))
+		{
+			Outputs |= ESLEventLogOutput::Owl;
+		}
+		else if (Name.Equals(TEXT("nt"), ESearchCase::IgnoreCase))
+		{
+			Outputs |= ESLEventLogOutput::NTriples;
+		}
+		else if (Name.Equals(TEXT("json"), ESearchCase::IgnoreCase))
+		{
+			Outputs |= ESLEventLogOutput::Json;
+		}
+		else if (Name.Equals(TEXT("timeline"), ESearchCase::IgnoreCase))
+		{
+			Outputs |= ESLEventLogOutput::Timeline;
+		}
+		else if (Name.Equals(TEXT("all"), ESearchCase::IgnoreCase))
+		{
+			Outputs |= ESLEventLogOutput::All;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Unknown output %s, ignored.."), *FString(__FUNCTION__), __LINE__, *Name);
+		}
+	}
+	return Outputs;
+}
+
+// Create the owl node of the record (same layout as the event classes)
+FSLOwlNode FSLEventLogConverter::CreateEventNode(const FSLEventLogReader& Log, const FSLEventLogRecord& Record)
+{
+	const ESLEventKind Kind = Record.GetKind();
+	FSLOwlNode EventIndividual = FSLOwlExperimentStatics::CreateEventIndividual(
+		"log", Log.GetString(Record.IdStr), GetOwlClass(Kind));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", Record.StartTime));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", Record.EndTime));
+
+	switch (Kind)
+	{
+	case ESLEventKind::Contact:
+		for (int32 Idx = 0; Idx < Record.NumParticipants; ++Idx)
+		{
+			EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInContactProperty("log",
+				Log.GetIndividualId(Record.Participants[Idx])));
+		}
+		break;
+	case ESLEventKind::SupportedBy:
+		EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportedProperty("log",
+			Log.GetIndividualId(Record.GetParticipant(ESLEventRole::Supported))));
+		EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportingProperty("log",
+			Log.GetIndividualId(Record.GetParticipant(ESLEventRole::Supporter))));
+		break;
+	case ESLEventKind::Slicing:
+	{
+		const bool bTaskSuccessful = (Record.Flags & SLEventLog::FlagTaskSuccessful) != 0;
+		EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreatePerformedByProperty("log",
+			Log.GetIndividualId(Record.GetParticipant(ESLEventRole::Agent))));
+		EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateDeviceUsedProperty("log",
+			Log.GetIndividualId(Record.GetParticipant(ESLEventRole::Instrument))));
+		EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateObjectActedOnProperty("log",
+			Log.GetIndividualId(Record.GetParticipant(ESLEventRole::Patient))));
+		EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateTaskSuccessProperty("log", bTaskSuccessful));
+		if (bTaskSuccessful)
+		{
+			EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateOutputsCreatedProperty("log",
+				Log.GetIndividualId(Record.GetParticipant(ESLEventRole::Output))));
+		}
+		break;
+	}
+	case ESLEventKind::Dummy:
+		break;
+	default:
+		// Manipulator events (reach, grasp, pick and place, container)
+		EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreatePerformedByProperty("log",
+			Log.GetIndividualId(Record.GetParticipant(ESLEventRole::Agent))));
+		EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateObjectActedOnProperty("log",
+			Log.GetIndividualId(Record.GetParticipant(ESLEventRole::Patient))));
+		if (Kind == ESLEventKind::Grasp)
+		{
+			EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateGraspTypeProperty("knowrob", Log.GetString(Record.ExtraStr)));
+		}
+		else if (Kind == ESLEventKind::Container)
+		{
+			EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateTypeProperty("knowrob", Log.GetString(Record.ExtraStr)));
+		}
+		break;
+	}
+
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInEpisodeProperty("log", Log.GetEpisodeId()));
+	return EventIndividual;
+}
+
+// Get the owl class of the event kind
+const TCHAR* FSLEventLogConverter::GetOwlClass(ESLEventKind Kind)
+{
+	switch (Kind)
+	{
+	case ESLEventKind::Contact:		return TEXT("TouchingSituation");
+	case ESLEventKind::SupportedBy:	return TEXT("SupportedBySituation");
+	case ESLEventKind::Grasp:		return TEXT("GraspingSomething");
+	case ESLEventKind::Reach:		return TEXT("ReachingForSomething");
+	case ESLEventKind::PreGrasp:	return TEXT("PreGraspSituation");
+	case ESLEventKind::PickUp:		return TEXT("PickUpSituation");
+	case ESLEventKind::Slide:		return TEXT("SlidingSituation");
+	case ESLEventKind::Transport:	return TEXT("TransportingSituation");
+	case ESLEventKind::PutDown:		return TEXT("PutDownSituation");
+	case ESLEventKind::Container:	return TEXT("ContainerManipulation");
+	case ESLEventKind::Slicing:		return TEXT("SlicingingSomething");
+	default:						return TEXT("Event");
+	}
+}
@@ -0,0 +1,112 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLEventSnapshot.h"
+#include "Events/SLContactEvent.h"
+#include "Events/SLSupportedByEvent.h"
+#include "Events/SLGraspEvent.h"
+#include "Owl/SLOwlExperiment.h"
+
+// Get the (first) participant with the given role, nullptr if none
+const FSLIndividualSnapshot* FSLEventSnapshot::GetParticipant(ESLEventRole Role) const
+{
+	for (const auto& Participant : Participants)
+	{
+		if (Participant.Role == Role)
+		{
+			return Participant.Individual;
+		}
+	}
+	return nullptr;
+}
+
+// Create the owl representation of the event
+FSLOwlNode FSLEventSnapshot::ToOwlNode() const
+{
+	switch (Kind)
+	{
+	case ESLEventKind::Contact:
+		return FSLContactEvent::CreateOwlNode(Id, StartTime, EndTime,
+			GetParticipantId(0), GetParticipantId(1), EpisodeId);
+	case ESLEventKind::SupportedBy:
+		return FSLSupportedByEvent::CreateOwlNode(Id, StartTime, EndTime,
+			GetParticipantId(0), GetParticipantId(1), EpisodeId);
+	case ESLEventKind::Grasp:
+		return FSLGraspEvent::CreateOwlNode(Id, StartTime, EndTime,
+			GetParticipantId(0), GetParticipantId(1), Extra, EpisodeId);
+	default:
+		return Serialized ? Serialized->OwlNode : FSLOwlNode();
+	}
+}
+
+// Add the owl representation of the event to the owl (experiment) document
+void FSLEventSnapshot::AddToOwlDoc(FSLOwlDoc* OutDoc) const
+{
+	// We know that the document is of type FOwlExperiment,
+	// we cannot use the safer dynamic_cast because RTTI is not enabled by default
+	FSLOwlExperiment* EventsDoc = static_cast<FSLOwlExperiment*>(OutDoc);
+
+	// The dummy event does not register its timepoints
+	if (Kind != ESLEventKind::Dummy)
+	{
+		EventsDoc->RegisterTimepoint(StartTime);
+		EventsDoc->RegisterTimepoint(EndTime);
+	}
+	for (const auto& Participant : Participants)
+	{
+		if (Participant.Individual)
+		{
+			EventsDoc->RegisterObject(Participant.Individual->Id, Participant.Individual->Class);
+		}
+	}
+	OutDoc->AddIndividual(ToOwlNode());
+}
+
+// Get the timeline context of the event
+FString FSLEventSnapshot::Context() const
+{
+	switch (Kind)
+	{
+	case ESLEventKind::Contact:
+		return FSLContactEvent::CreateContext(PairId);
+	case ESLEventKind::SupportedBy:
+		return FSLSupportedByEvent::CreateContext(PairId);
+	case ESLEventKind::Grasp:
+		return FSLGraspEvent::CreateContext(PairId);
+	default:
+		return Serialized ? Serialized->Context : FString();
+	}
+}
+
+// Get the timeline tooltip of the event
+FString FSLEventSnapshot::Tooltip() const
+{
+	switch (Kind)
+	{
+	case ESLEventKind::Contact:
+		return FSLContactEvent::CreateTooltip(GetParticipantClass(0), GetParticipantId(0),
+			GetParticipantClass(1), GetParticipantId(1), Id);
+	case ESLEventKind::SupportedBy:
+		return FSLSupportedByEvent::CreateTooltip(GetParticipantClass(0), GetParticipantId(0),
+			GetParticipantClass(1), GetParticipantId(1), Id);
+	case ESLEventKind::Grasp:
+		return FSLGraspEvent::CreateTooltip(GetParticipantClass(0), GetParticipantId(0),
+			GetParticipantClass(1), GetParticipantId(1), Id);
+	default:
+		return Serialized ? Serialized->Tooltip : FString();
+	}
+}
+
+// Id of the participant at the given position, empty if none
+const FString& FSLEventSnapshot::GetParticipantId(int32 Index) const
+{
+	static const FString Empty;
+	return Participants.IsValidIndex(Index) && Participants[Index].Individual ? Participants[Index].Individual->Id : Empty;
+}
+
+// Class of the participant at the given position, empty if none
+const FString& FSLEventSnapshot::GetParticipantClass(int32 Index) const
+{
+	static const FString Empty;
+	return Participants.IsValidIndex(Index) && Participants[Index].Individual ? Participants[Index].Individual->Class : Empty;
+}
@@ -0,0 +1,354 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLEventStore.h"
+#include "Events/SLContactEvent.h"
+#include "Events/SLSupportedByEvent.h"
+#include "Events/SLGraspEvent.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "GameFramework/Actor.h"
+
+// Default ctor
+FSLEventStore::FSLEventStore()
+{
+}
+
+// Store the finished event
+void FSLEventStore::Add(TSharedPtr<ISLEvent> Event)
+{
+	if (!Event.IsValid())
+	{
+		return;
+	}
+
+	// We know the exact type from the kind, RTTI is not enabled by default
+	switch (Event->Kind())
+	{
+	case ESLEventKind::Contact:
+	{
+		const FSLContactEvent* Ev = static_cast<FSLContactEvent*>(Event.Get());
+		const int32 Index = ContactRecords.AddElement(MakeRecord(*Ev, Ev->PairId, Ev->Individual1, Ev->Individual2));
+		Entries.Add({ ESLEventRecordKind::Contact, Index });
+		break;
+	}
+	case ESLEventKind::SupportedBy:
+	{
+		const FSLSupportedByEvent* Ev = static_cast<FSLSupportedByEvent*>(Event.Get());
+		const int32 Index = SupportedByRecords.AddElement(MakeRecord(*Ev, Ev->PairId, Ev->SupportedIndividual, Ev->SupportingIndividual));
+		Entries.Add({ ESLEventRecordKind::SupportedBy, Index });
+		break;
+	}
+	case ESLEventKind::Grasp:
+	{
+		const FSLGraspEvent* Ev = static_cast<FSLGraspEvent*>(Event.Get());
+		const int32 Index = GraspRecords.AddElement(MakeRecord(*Ev, Ev->PairId, Ev->Manipulator, Ev->Individual, Ev->GraspType));
+		Entries.Add({ ESLEventRecordKind::Grasp, Index });
+		break;
+	}
+	default:
+	{
+		// Serialize while the individuals are safe to read
+		FSLOtherEventRecord Record;
+		Record.Kind = Event->Kind();
+		FSLEventParticipants Participants;
+		Event->GetParticipants(Participants);
+		for (const auto& Participant : Participants)
+		{
+			Record.Participants.Add({ GetIndividualHandle(Participant.Individual), Participant.Role });
+		}
+		Record.Serialized.OwlNode = Event->ToOwlNode();
+		Record.Serialized.Context = Event->Context();
+		Record.Serialized.Tooltip = Event->Tooltip();
+		OtherRecords.AddElement(MoveTemp(Record));
+
+		const int32 Index = OtherEvents.Add(Event);
+		Entries.Add({ ESLEventRecordKind::Other, Index });
+		break;
+	}
+	}
+}
+
+// Remove all events
+void FSLEventStore::Reset()
+{
+	Entries.Empty();
+	ContactRecords.Empty();
+	SupportedByRecords.Empty();
+	GraspRecords.Empty();
+	OtherEvents.Empty();
+	OtherRecords.Empty();
+	IdChars.Empty();
+	Strings.Empty();
+	StringToIdx.Empty();
+	Individuals.Empty();
+	IndividualToHandle.Empty();
+	IndividualSnapshots.Empty();
+}
+
+// Materialize the event at the given index (insertion order)
+TSharedPtr<ISLEvent> FSLEventStore::Materialize(int32 Index) const
+{
+	if (!Entries.IsValidIndex(Index))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Invalid event index %d (num=%d).."),
+			*FString(__FUNCTION__), __LINE__, Index, Entries.Num());
+		return nullptr;
+	}
+
+	const FSLEventStoreEntry& Entry = Entries[Index];
+	switch (Entry.Kind)
+	{
+	case ESLEventRecordKind::Contact:
+	{
+		const FSLPairEventRecord& Record = ContactRecords[Entry.Index];
+		TSharedPtr<FSLContactEvent> Event = MakeShareable(new FSLContactEvent(
+			FString(), Record.StartTime, Record.EndTime, Record.PairId,
+			GetIndividual(Record.Individual1), GetIndividual(Record.Individual2)));
+		FillEvent(Record, *Event);
+		return Event;
+	}
+	case ESLEventRecordKind::SupportedBy:
+	{
+		const FSLPairEventRecord& Record = SupportedByRecords[Entry.Index];
+		TSharedPtr<FSLSupportedByEvent> Event = MakeShareable(new FSLSupportedByEvent(
+			FString(), Record.StartTime, Record.EndTime, Record.PairId,
+			GetIndividual(Record.Individual1), GetIndividual(Record.Individual2)));
+		FillEvent(Record, *Event);
+		return Event;
+	}
+	case ESLEventRecordKind::Grasp:
+	{
+		const FSLPairEventRecord& Record = GraspRecords[Entry.Index];
+		TSharedPtr<FSLGraspEvent> Event = MakeShareable(new FSLGraspEvent(
+			FString(), Record.StartTime, Record.EndTime, Record.PairId,
+			GetIndividual(Record.Individual1), GetIndividual(Record.Individual2),
+			Strings.IsValidIndex(Record.ExtraIdx) ? Strings[Record.ExtraIdx] : FString()));
+		FillEvent(Record, *Event);
+		return Event;
+	}
+	default:
+		return OtherEvents[Entry.Index];
+	}
+}
+
+// Materialize all events in insertion order
+void FSLEventStore::MaterializeAll(TArray<TSharedPtr<ISLEvent>>& OutEvents) const
+{
+	OutEvents.Reserve(OutEvents.Num() + Entries.Num());
+	for (int32 Idx = 0; Idx < Entries.Num(); ++Idx)
+	{
+		OutEvents.Emplace(Materialize(Idx));
+	}
+}
+
+// Call the function on every materialized event in insertion order (only one compact event is materialized at a time)
+void FSLEventStore::ForEach(TFunctionRef<void(const TSharedPtr<ISLEvent>&)> Func) const
+{
+	for (int32 Idx = 0; Idx < Entries.Num(); ++Idx)
+	{
+		if (Entries[Idx].Kind == ESLEventRecordKind::Other)
+		{
+			Func(OtherEvents[Entries[Idx].Index]);
+		}
+		else
+		{
+			Func(Materialize(Idx));
+		}
+	}
+}
+
+// Get the plain snapshot of the event at the given index (insertion order)
+FSLEventSnapshot FSLEventStore::Snapshot(int32 Index) const
+{
+	FSLEventSnapshot Snapshot;
+	if (!Entries.IsValidIndex(Index))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Invalid event index %d (num=%d).."),
+			*FString(__FUNCTION__), __LINE__, Index, Entries.Num());
+		return Snapshot;
+	}
+
+	const FSLEventStoreEntry& Entry = Entries[Index];
+	switch (Entry.Kind)
+	{
+	case ESLEventRecordKind::Contact:
+		FillSnapshot(ContactRecords[Entry.Index], ESLEventKind::Contact,
+			ESLEventRole::Participant, ESLEventRole::Participant, Snapshot);
+		break;
+	case ESLEventRecordKind::SupportedBy:
+		FillSnapshot(SupportedByRecords[Entry.Index], ESLEventKind::SupportedBy,
+			ESLEventRole::Supported, ESLEventRole::Supporter, Snapshot);
+		break;
+	case ESLEventRecordKind::Grasp:
+	{
+		const FSLPairEventRecord& Record = GraspRecords[Entry.Index];
+		FillSnapshot(Record, ESLEventKind::Grasp, ESLEventRole::Agent, ESLEventRole::Patient, Snapshot);
+		Snapshot.Extra = Strings.IsValidIndex(Record.ExtraIdx) ? Strings[Record.ExtraIdx] : FString();
+		break;
+	}
+	default:
+	{
+		// Only the plain members of the event are read
+		const ISLEvent& Event = *OtherEvents[Entry.Index];
+		const FSLOtherEventRecord& Record = OtherRecords[Entry.Index];
+		Snapshot.Id = Event.Id;
+		Snapshot.EpisodeId = Event.EpisodeId;
+		Snapshot.Kind = Record.Kind;
+		Snapshot.StartTime = Event.StartTime;
+		Snapshot.EndTime = Event.EndTime;
+		for (const auto& Participant : Record.Participants)
+		{
+			Snapshot.Participants.Add({ GetIndividualSnapshot(Participant.Handle), Participant.Role });
+		}
+		Snapshot.Serialized = &Record.Serialized;
+		break;
+	}
+	}
+	return Snapshot;
+}
+
+// Get the snapshots of all events in insertion order
+void FSLEventStore::SnapshotAll(TArray<FSLEventSnapshot>& OutSnapshots) const
+{
+	OutSnapshots.Reserve(OutSnapshots.Num() + Entries.Num());
+	for (int32 Idx = 0; Idx < Entries.Num(); ++Idx)
+	{
+		OutSnapshots.Emplace(Snapshot(Idx));
+	}
+}
+
+// Call the function on the snapshot of every event in insertion order
+void FSLEventStore::ForEachSnapshot(TFunctionRef<void(const FSLEventSnapshot&)> Func) const
+{
+	for (int32 Idx = 0; Idx < Entries.Num(); ++Idx)
+	{
+		Func(Snapshot(Idx));
+	}
+}
+
+// Memory used by the store
+SIZE_T FSLEventStore::GetAllocatedSize() const
+{
+	SIZE_T Size = Entries.GetAllocatedSize()
+		+ ContactRecords.GetAllocatedSize()
+		+ SupportedByRecords.GetAllocatedSize()
+		+ GraspRecords.GetAllocatedSize()
+		+ OtherEvents.GetAllocatedSize()
+		+ OtherRecords.GetAllocatedSize()
+		+ IdChars.GetAllocatedSize()
+		+ Strings.GetAllocatedSize()
+		+ StringToIdx.GetAllocatedSize()
+		+ Individuals.GetAllocatedSize()
+		+ IndividualToHandle.GetAllocatedSize()
+		+ IndividualSnapshots.GetAllocatedSize();
+	for (const auto& Str : Strings)
+	{
+		Size += Str.GetAllocatedSize();
+	}
+	return Size;
+}
+
+// Create the compact record of the event
+FSLPairEventRecord FSLEventStore::MakeRecord(const ISLEvent& Event, uint64 PairId,
+	USLBaseIndividual* Individual1, USLBaseIndividual* Individual2, const FString& Extra)
+{
+	FSLPairEventRecord Record;
+	Record.IdOffset = StoreId(Event.Id, Record.IdLen);
+	Record.EpisodeIdx = InternString(Event.EpisodeId);
+	Record.StartTime = Event.StartTime;
+	Record.EndTime = Event.EndTime;
+	Record.PairId = PairId;
+	Record.Individual1 = GetIndividualHandle(Individual1);
+	Record.Individual2 = GetIndividualHandle(Individual2);
+	Record.ExtraIdx = Extra.IsEmpty() ? INDEX_NONE : InternString(Extra);
+	return Record;
+}
+
+// Apply the common record data to the event
+void FSLEventStore::FillEvent(const FSLPairEventRecord& Record, ISLEvent& OutEvent) const
+{
+	OutEvent.Id = GetId(Record.IdOffset, Record.IdLen);
+	OutEvent.EpisodeId = Strings[Record.EpisodeIdx];
+}
+
+// Store the id characters, returns the offset in the buffer
+int32 FSLEventStore::StoreId(const FString& Id, int32& OutLen)
+{
+	// Ids are base64url guids, UTF8 keeps them at one byte per character
+	FTCHARToUTF8 Converter(*Id);
+	OutLen = Converter.Length();
+	const int32 Offset = IdChars.Num();
+	IdChars.Append((const ANSICHAR*)Converter.Get(), OutLen);
+	return Offset;
+}
+
+// Get the id from the buffer
+FString FSLEventStore::GetId(int32 Offset, int32 Len) const
+{
+	FUTF8ToTCHAR Converter(IdChars.GetData() + Offset, Len);
+	return FString(Converter.Length(), Converter.Get());
+}
+
+// Get the interned index of the string
+int32 FSLEventStore::InternString(const FString& Str)
+{
+	if (const int32* Idx = StringToIdx.Find(Str))
+	{
+		return *Idx;
+	}
+	const int32 NewIdx = Strings.Add(Str);
+	StringToIdx.Add(Str, NewIdx);
+	return NewIdx;
+}
+
+// Get the handle of the individual
+int32 FSLEventStore::GetIndividualHandle(USLBaseIndividual* Individual)
+{
+	if (!Individual)
+	{
+		return INDEX_NONE;
+	}
+	if (const int32* Handle = IndividualToHandle.Find(Individual))
+	{
+		return *Handle;
+	}
+	const int32 NewHandle = Individuals.Add(Individual);
+	IndividualToHandle.Add(Individual, NewHandle);
+
+	// Copy the data read by the outputs (we are on the game thread)
+	FSLIndividualSnapshot IndividualSnapshot;
+	IndividualSnapshot.Id = Individual->GetIdValue();
+	IndividualSnapshot.Class = Individual->GetClassValue();
+	if (AActor* ParentActor = Individual->GetParentActor())
+	{
+		IndividualSnapshot.ActorName = ParentActor->GetName();
+	}
+	IndividualSnapshots.AddElement(MoveTemp(IndividualSnapshot));
+	return NewHandle;
+}
+
+// Get the individual from its handle
+USLBaseIndividual* FSLEventStore::GetIndividual(int32 Handle) const
+{
+	return Individuals.IsValidIndex(Handle) ? Individuals[Handle] : nullptr;
+}
+
+// Get the individual snapshot from its handle
+const FSLIndividualSnapshot* FSLEventStore::GetIndividualSnapshot(int32 Handle) const
+{
+	return Handle >= 0 && Handle < IndividualSnapshots.Num() ? &IndividualSnapshots[Handle] : nullptr;
+}
+
+// Apply the common record data to the snapshot
+void FSLEventStore::FillSnapshot(const FSLPairEventRecord& Record, ESLEventKind Kind, ESLEventRole Role1, ESLEventRole Role2,
+	FSLEventSnapshot& OutSnapshot) const
+{
+	OutSnapshot.Id = GetId(Record.IdOffset, Record.IdLen);
+	OutSnapshot.EpisodeId = Strings[Record.EpisodeIdx];
+	OutSnapshot.Kind = Kind;
+	OutSnapshot.StartTime = Record.StartTime;
+	OutSnapshot.EndTime = Record.EndTime;
+	OutSnapshot.PairId = Record.PairId;
+	OutSnapshot.Participants.Add({ GetIndividualSnapshot(Record.Individual1), Role1 });
+	OutSnapshot.Participants.Add({ GetIndividualSnapshot(Record.Individual2), Role2 });
+}
@@ -6,6 +6,7 @@
 #include "Individuals/SLIndividualUtils.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 
 #if SL_WITH_MC_GRASP
 #include "MCGraspFixation.h"
@@ -68,32 +69,33 @@ void FSLFixationGraspEventHandler::Finish(float EndTime, bool bForced)
 // Start new grasp event
 void FSLFixationGraspEventHandler::AddNewEvent(USLBaseIndividual* Self, USLBaseIndividual* Other, float StartTime)
 {
+	// Keep the already started event with the same individual
+	if (StartedEvents.Contains(Other))
+	{
+		return;
+	}
+
 	// Start a semantic grasp event
 	TSharedPtr<FSLGraspEvent> Event = MakeShareable(new FSLGraspEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime, 
 		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
 		Self, Other));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending array
-	StartedEvents.Emplace(Event);
+	// Add event to the pending events
+	StartedEvents.Emplace(Other, Event);
 }
 
 // Publish finished event
 bool FSLFixationGraspEventHandler::FinishEvent(USLBaseIndividual* Other, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedEvents.CreateIterator()); EventItr; ++EventItr)
+	// Remove event from the pending events
+	TSharedPtr<FSLGraspEvent> Event;
+	if (StartedEvents.RemoveAndCopyValue(Other, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual == Other)
-		{
-			// Set end time and publish event
-			(*EventItr)->EndTime = EndTime;
-			OnSemanticEvent.ExecuteIfBound(*EventItr);
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
-		}
+		// Set end time and publish event
+		Event->EndTime = EndTime;
+		OnSemanticEvent.ExecuteIfBound(Event);
+		return true;
 	}
 	return false;
 }
@@ -101,20 +103,16 @@ bool FSLFixationGraspEventHandler::FinishEvent(USLBaseIndividual* Other, float E
 // Terminate and publish pending events (this usually is called at end play)
 void FSLFixationGraspEventHandler::FinishAllEvents(float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_FixationGraspEventHandler);
 	// Finish events
-	for (auto& Ev : StartedEvents)
-	{
-		// Set end time and publish event
-		Ev->EndTime = EndTime;
-		OnSemanticEvent.ExecuteIfBound(Ev);
-	}
-	StartedEvents.Empty();
+	FinishOpenEventsBatch(StartedEvents, EndTime);
 }
 
 
 // Event called when a semantic grasp event begins
 void FSLFixationGraspEventHandler::OnSLGraspBegin(AActor* SelfActor, AActor* OtherActor, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_FixationGraspEventHandler);
 	// Check that the objects are semantically annotated
 	if (USLBaseIndividual* SelfIndividual = FSLIndividualUtils::GetIndividualObject(SelfActor))
 	{
@@ -128,6 +126,7 @@ void FSLFixationGraspEventHandler::OnSLGraspBegin(AActor* SelfActor, AActor* Oth
 // Event called when a semantic grasp event ends
 void FSLFixationGraspEventHandler::OnSLGraspEnd(AActor* SelfActor, AActor* OtherActor, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_FixationGraspEventHandler);
 	if (USLBaseIndividual* OtherIndividual = FSLIndividualUtils::GetIndividualObject(OtherActor))
 	{
 		FSLFixationGraspEventHandler::FinishEvent(OtherIndividual, Time);
@@ -25,16 +25,7 @@ FSLGraspEvent::FSLGraspEvent(const FString& InId, const float InStart, const uin
 // Get an owl representation of the event
 FSLOwlNode FSLGraspEvent::ToOwlNode() const
 {
-	// Create the contact event node
-	FSLOwlNode EventIndividual = FSLOwlExperimentStatics::CreateEventIndividual(
-		"log", Id, "GraspingSomething");
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", StartTime));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", EndTime));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreatePerformedByProperty("log", Manipulator->GetIdValue()));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateObjectActedOnProperty("log", Individual->GetIdValue()));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateGraspTypeProperty("knowrob", GraspType));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInEpisodeProperty("log", EpisodeId));
-	return EventIndividual;
+	return CreateOwlNode(Id, StartTime, EndTime, Manipulator->GetIdValue(), Individual->GetIdValue(), GraspType, EpisodeId);
 }
 
 // Add the owl representation of the event to the owl document
@@ -55,14 +46,13 @@ void FSLGraspEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 // Get event context data as string (ToString equivalent)
 FString FSLGraspEvent::Context() const
 {
-	return FString::Printf(TEXT("Grasp - %lld"), PairId);
+	return CreateContext(PairId);
 }
 
 // Get the tooltip data
 FString FSLGraspEvent::Tooltip() const
 {
-	return FString::Printf(TEXT("\'Manipulator\',\'%s\',\'Id\',\'%s\',\'Other\',\'%s\',\'Id\',\'%s\',\'Id\',\'%s\'"),
-		*Manipulator->GetClassValue(), *Manipulator->GetIdValue(), *Individual->GetClassValue(), *Individual->GetIdValue(), *Id);
+	return CreateTooltip(Manipulator->GetClassValue(), Manipulator->GetIdValue(), Individual->GetClassValue(), Individual->GetIdValue(), Id);
 }
 
 // Get the data as string
@@ -71,4 +61,34 @@ FString FSLGraspEvent::ToString() const
 	return FString::Printf(TEXT("Manipulator:[%s] Other:[%s] PairId:%lld"),
 		*Manipulator->GetInfo(), *Individual->GetInfo(), PairId);
 }
-/* End ISLEvent interface */
\ No newline at end of file
+/* End ISLEvent interface */
+
+/* Serialization from plain data */
+// Create the owl representation of the event
+FSLOwlNode FSLGraspEvent::CreateOwlNode(const FString& InId, float InStart, float InEnd,
+	const FString& ManipulatorId, const FString& IndividualId, const FString& InGraspType, const FString& InEpisodeId)
+{
+	FSLOwlNode EventIndividual = FSLOwlExperimentStatics::CreateEventIndividual(
+		"log", InId, "GraspingSomething");
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", InStart));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", InEnd));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreatePerformedByProperty("log", ManipulatorId));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateObjectActedOnProperty("log", IndividualId));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateGraspTypeProperty("knowrob", InGraspType));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInEpisodeProperty("log", InEpisodeId));
+	return EventIndividual;
+}
+
+// Get the context data
+FString FSLGraspEvent::CreateContext(uint64 InPairId)
+{
+	return FString::Printf(TEXT("Grasp - %lld"), InPairId);
+}
+
+// Get the tooltip data
+FString FSLGraspEvent::CreateTooltip(const FString& ManipulatorClass, const FString& ManipulatorId,
+	const FString& IndividualClass, const FString& IndividualId, const FString& InId)
+{
+	return FString::Printf(TEXT("\'Manipulator\',\'%s\',\'Id\',\'%s\',\'Other\',\'%s\',\'Id\',\'%s\',\'Id\',\'%s\'"),
+		*ManipulatorClass, *ManipulatorId, *IndividualClass, *IndividualId, *InId);
+}
@@ -5,6 +5,7 @@
 #include "Monitors/SLManipulatorMonitor.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 
 // Set parent
 void FSLGraspEventHandler::Init(UObject* InParent)
@@ -62,36 +63,37 @@ void FSLGraspEventHandler::Finish(float EndTime, bool bForced)
 // Start new grasp event
 void FSLGraspEventHandler::AddNewEvent(USLBaseIndividual* Self, USLBaseIndividual* Other, float StartTime, const FString& InType)
 {
+	// Keep the already started event with the same individual
+	if (StartedEvents.Contains(Other))
+	{
+		return;
+	}
+
 	// Start a semantic grasp event
 	TSharedPtr<FSLGraspEvent> Event = MakeShareable(new FSLGraspEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime,
 		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
 		Self, Other, InType));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending array
-	StartedEvents.Emplace(Event);
+	// Add event to the pending events
+	StartedEvents.Emplace(Other, Event);
 }
 
 // Publish finished event
 bool FSLGraspEventHandler::FinishEvent(USLBaseIndividual* Other, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedEvents.CreateIterator()); EventItr; ++EventItr)
+	// Remove event from the pending events
+	TSharedPtr<FSLGraspEvent> Event;
+	if (StartedEvents.RemoveAndCopyValue(Other, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual == Other)
+		// Ignore short events
+		if ((EndTime - Event->StartTime) > GraspEventMin)
 		{
-			// Ignore short events
-			if ((EndTime - (*EventItr)->StartTime) > GraspEventMin)
-			{
-				// Set end time and publish event
-				(*EventItr)->EndTime = EndTime;
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
+			// Set end time and publish event
+			Event->EndTime = EndTime;
+			OnSemanticEvent.ExecuteIfBound(Event);
 		}
+		return true;
 	}
 	return false;
 }
@@ -99,29 +101,22 @@ bool FSLGraspEventHandler::FinishEvent(USLBaseIndividual* Other, float EndTime)
 // Terminate and publish pending events (this usually is called at end play)
 void FSLGraspEventHandler::FinishAllEvents(float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_GraspEventHandler);
 	// Finish events
-	for (auto& Ev : StartedEvents)
-	{
-		// Ignore short events
-		if ((EndTime - Ev->StartTime) > GraspEventMin)
-		{
-			// Set end time and publish event
-			Ev->EndTime = EndTime;
-			OnSemanticEvent.ExecuteIfBound(Ev);
-		}
-	}
-	StartedEvents.Empty();
+	FinishOpenEventsBatch(StartedEvents, EndTime, GraspEventMin);
 }
 
 
 // Event called when a semantic grasp event begins
 void FSLGraspEventHandler::OnSLGraspBegin(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time, const FString& Type)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_GraspEventHandler);
 	AddNewEvent(Self, Other, Time, Type);
 }
 
 // Event called when a semantic grasp event ends
 void FSLGraspEventHandler::OnSLGraspEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_GraspEventHandler);
 	FinishEvent(Other, Time);
 }
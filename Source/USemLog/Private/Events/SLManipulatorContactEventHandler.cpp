@@ -7,6 +7,7 @@
 #include "Events/SLContactEvent.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 
 // Set parent
 void FSLManipulatorContactEventHandler::Init(UObject* InParent)
@@ -63,34 +64,33 @@ void FSLManipulatorContactEventHandler::Finish(float EndTime, bool bForced)
 // Start new contact event
 void FSLManipulatorContactEventHandler::AddNewEvent(const FSLContactResult& InResult)
 {
+	// Keep the already started event with the same individual
+	if (StartedEvents.Contains(InResult.Other))
+	{
+		return;
+	}
+
 	// Start a semantic contact event
 	TSharedPtr<FSLContactEvent> Event = MakeShareable(new FSLContactEvent(
 		FSLUuid::NewGuidInBase64Url(), InResult.Time,
 		FSLUuid::PairEncodeCantor(InResult.Self->GetUniqueID(), InResult.Other->GetUniqueID()),
 		InResult.Self, InResult.Other));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending contacts array
-	StartedEvents.Emplace(Event);
+	// Add event to the pending contacts
+	StartedEvents.Emplace(InResult.Other, Event);
 }
 
 // Publish finished event
 bool FSLManipulatorContactEventHandler::FinishEvent(USLBaseIndividual* InOther, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedEvents.CreateIterator()); EventItr; ++EventItr)
+	// It is enough to search by the other individual (remove it from the pending events)
+	TSharedPtr<FSLContactEvent> Event;
+	if (StartedEvents.RemoveAndCopyValue(InOther, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual2 == InOther)
-		{
-			// Set the event end time
-			(*EventItr)->EndTime = EndTime;
-
-			OnSemanticEvent.ExecuteIfBound(*EventItr);
-
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
-		}
+		// Set the event end time
+		Event->EndTime = EndTime;
+		OnSemanticEvent.ExecuteIfBound(Event);
+		return true;
 	}
 	return false;
 }
@@ -98,25 +98,22 @@ bool FSLManipulatorContactEventHandler::FinishEvent(USLBaseIndividual* InOther,
 // Terminate and publish pending contact events (this usually is called at end play)
 void FSLManipulatorContactEventHandler::FinishAllEvents(float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorContactEventHandler);
 	// Finish contact events
-	for (auto& Ev : StartedEvents)
-	{
-		// Set end time and publish event
-		Ev->EndTime = EndTime;
-		OnSemanticEvent.ExecuteIfBound(Ev);
-	}
-	StartedEvents.Empty();
+	FinishOpenEventsBatch(StartedEvents, EndTime);
 }
 
 
 // Event called when a semantic overlap event begins
 void FSLManipulatorContactEventHandler::OnSLOverlapBegin(const FSLContactResult& SemanticOverlapResult)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorContactEventHandler);
 	AddNewEvent(SemanticOverlapResult);
 }
 
 // Event called when a semantic overlap event ends
 void FSLManipulatorContactEventHandler::OnSLOverlapEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorContactEventHandler);
 	FinishEvent(Other, Time);
 }
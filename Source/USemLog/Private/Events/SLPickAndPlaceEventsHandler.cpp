@@ -9,6 +9,7 @@
 #include "Events/SLTransportEvent.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 
 // Set parent
 void FSLPickAndPlaceEventsHandler::Init(UObject* InParent)
@@ -65,6 +66,7 @@ void FSLPickAndPlaceEventsHandler::Finish(float EndTime, bool bForced)
 // Event called when a slide event happened
 void FSLPickAndPlaceEventsHandler::OnSLSlide(USLBaseIndividual* Self, USLBaseIndividual* Other, float StartTime, float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_PickAndPlaceEventsHandler);
 	TSharedPtr<FSLSlideEvent> Event = MakeShareable(new FSLSlideEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime, EndTime,
 		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
@@ -76,6 +78,7 @@ void FSLPickAndPlaceEventsHandler::OnSLSlide(USLBaseIndividual* Self, USLBaseInd
 // Event called when a pick up event happened
 void FSLPickAndPlaceEventsHandler::OnSLPickUp(USLBaseIndividual* Self, USLBaseIndividual* Other, float StartTime, float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_PickAndPlaceEventsHandler);
 	TSharedPtr<FSLPickUpEvent> Event = MakeShareable(new FSLPickUpEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime, EndTime,
 		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
@@ -88,6 +91,7 @@ void FSLPickAndPlaceEventsHandler::OnSLPickUp(USLBaseIndividual* Self, USLBaseIn
 // Event called when a transport event happened
 void FSLPickAndPlaceEventsHandler::OnSLTransport(USLBaseIndividual* Self, USLBaseIndividual* Other, float StartTime, float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_PickAndPlaceEventsHandler);
 	TSharedPtr<FSLTransportEvent> Event = MakeShareable(new FSLTransportEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime, EndTime,
 		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
@@ -100,6 +104,7 @@ void FSLPickAndPlaceEventsHandler::OnSLTransport(USLBaseIndividual* Self, USLBas
 // Event called when a put down event happened
 void FSLPickAndPlaceEventsHandler::OnSLPutDown(USLBaseIndividual* Self,USLBaseIndividual* Other, float StartTime, float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_PickAndPlaceEventsHandler);
 	TSharedPtr<FSLPutDownEvent> Event = MakeShareable(new FSLPutDownEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime, EndTime,
 		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
@@ -5,6 +5,7 @@
 #include "Monitors/SLReachAndPreGraspMonitor.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 
 // Set parent
 void FSLReachAndPreGraspEventHandler::Init(UObject* InParent)
@@ -59,6 +60,7 @@ void FSLReachAndPreGraspEventHandler::Finish(float EndTime, bool bForced)
 // Event called when a semantic Reach event begins
 void FSLReachAndPreGraspEventHandler::OnSLReachAndPreGraspEvent(USLBaseIndividual* Self, USLBaseIndividual* Other, float ReachStartTime, float ReachEndTime, float PreGraspEndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ReachAndPreGraspEventHandler);
 	const uint64 PairID =FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID());
 	if(ReachEndTime - ReachStartTime > ReachEventMin)
 	{
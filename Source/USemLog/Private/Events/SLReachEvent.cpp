@@ -65,7 +65,7 @@ FString FSLReachEvent::Tooltip() const
 // Get the data as string
 FString FSLReachEvent::ToString() const
 {
-	return FString::Printf(TEXT("Individual:[%s] Manipulator:[%s] PairId:%lld"),
+	return FString::Printf(TEXT("Manipulator:[%s] Individual:[%s] PairId:%lld"),
 		*Manipulator->GetInfo(), *Individual->GetInfo(), PairId);
 }
 /* End ISLEvent interface */
\ No newline at end of file
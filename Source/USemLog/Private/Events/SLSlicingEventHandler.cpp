@@ -3,6 +3,7 @@
 
 #include "Events/SLSlicingEventHandler.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Individuals/SLIndividualUtils.h"
 
@@ -106,6 +107,7 @@ bool FSLSlicingEventHandler::FinishEvent(USLBaseIndividual* ObjectActedOn,
 // Terminate and publish pending events (this usually is called at end play)
 void FSLSlicingEventHandler::FinishAllEvents(float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_SlicingEventHandler);
 	// Finish events
 	for (auto& Ev : StartedEvents)
 	{
@@ -120,6 +122,7 @@ void FSLSlicingEventHandler::FinishAllEvents(float EndTime)
 // Event called when a semantic Slicing event begins
 void FSLSlicingEventHandler::OnSLSlicingBegin(AActor* PerformedBy, AActor* DeviceUsed, AActor* ObjectActedOn, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_SlicingEventHandler);
 	if (USLBaseIndividual* PerformedByIndvidiual = FSLIndividualUtils::GetIndividualObject(PerformedBy))
 	{
 		if (USLBaseIndividual* DeviceUsedIndividual = FSLIndividualUtils::GetIndividualObject(DeviceUsed))
@@ -135,6 +138,7 @@ void FSLSlicingEventHandler::OnSLSlicingBegin(AActor* PerformedBy, AActor* Devic
 // Event called when a semantic Slicing event ends
 void FSLSlicingEventHandler::OnSLSlicingEndFail(AActor* PerformedBy, AActor* ObjectActedOn, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_SlicingEventHandler);
 	if (USLBaseIndividual* PerformedByIndvidiual = FSLIndividualUtils::GetIndividualObject(PerformedBy))
 	{
 		if (USLBaseIndividual* ObjectActedOnIndvidiual = FSLIndividualUtils::GetIndividualObject(ObjectActedOn))
@@ -147,6 +151,7 @@ void FSLSlicingEventHandler::OnSLSlicingEndFail(AActor* PerformedBy, AActor* Obj
 // Event called when a semantic Slicing event ends
 void FSLSlicingEventHandler::OnSLSlicingEndSuccess(AActor* PerformedBy, AActor* ObjectActedOn, AActor* ObjectCreated, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_SlicingEventHandler);
 	if (USLBaseIndividual* PerformedByIndvidiual = FSLIndividualUtils::GetIndividualObject(PerformedBy))
 	{
 		if (USLBaseIndividual* ObjectActedOnIndividual = FSLIndividualUtils::GetIndividualObject(ObjectActedOn))
@@ -162,6 +167,7 @@ void FSLSlicingEventHandler::OnSLSlicingEndSuccess(AActor* PerformedBy, AActor*
 // Event called when new objects are created
 void FSLSlicingEventHandler::OnSLObjectCreation(AActor* TransformedObject, AActor* NewSlice, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_SlicingEventHandler);
 	if (USLBaseIndividual* OrigIndividual = FSLIndividualUtils::GetIndividualObject(TransformedObject))
 	{
 		// TODO create a new if since it is a new object
@@ -174,6 +180,7 @@ void FSLSlicingEventHandler::OnSLObjectCreation(AActor* TransformedObject, AActo
 // Event called when an object is destroyed
 void FSLSlicingEventHandler::OnSLObjectDestruction(AActor* ObjectActedOn, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_SlicingEventHandler);
 	if (USLBaseIndividual* ActedOnIndividual = FSLIndividualUtils::GetIndividualObject(ObjectActedOn))
 	{
 		// TODO hide or remove individual
@@ -23,15 +23,7 @@ FSLSupportedByEvent::FSLSupportedByEvent(const FString& InId, const float InStar
 // Get an owl representation of the event
 FSLOwlNode FSLSupportedByEvent::ToOwlNode() const
 {
-	// Create the contact event node
-	FSLOwlNode EventIndividual = FSLOwlExperimentStatics::CreateEventIndividual(
-		"log", Id, "SupportedBySituation");
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", StartTime));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", EndTime));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportedProperty("log", SupportedIndividual->GetIdValue()));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportingProperty("log", SupportingIndividual->GetIdValue()));
-	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInEpisodeProperty("log", EpisodeId));
-	return EventIndividual;
+	return CreateOwlNode(Id, StartTime, EndTime, SupportedIndividual->GetIdValue(), SupportingIndividual->GetIdValue(), EpisodeId);
 }
 
 // Add the owl representation of the event to the owl document
@@ -52,14 +44,13 @@ void FSLSupportedByEvent::AddToOwlDoc(FSLOwlDoc* OutDoc)
 // Get event context data as string (ToString equivalent)
 FString FSLSupportedByEvent::Context() const
 {
-	return FString::Printf(TEXT("SupportedBy - %lld"), PairId);
+	return CreateContext(PairId);
 }
 
 // Get the tooltip data
 FString FSLSupportedByEvent::Tooltip() const
 {
-	return FString::Printf(TEXT("\'SupportedIndividual\',\'%s\',\'Id\',\'%s\',\'SupportingIndividual\',\'%s\',\'Id\',\'%s\',\'Id\',\'%s\'"),
-		*SupportedIndividual->GetClassValue(), *SupportedIndividual->GetIdValue(), *SupportingIndividual->GetClassValue(), *SupportingIndividual->GetIdValue(), *Id);
+	return CreateTooltip(SupportedIndividual->GetClassValue(), SupportedIndividual->GetIdValue(), SupportingIndividual->GetClassValue(), SupportingIndividual->GetIdValue(), Id);
 }
 
 // Get the data as string
@@ -68,4 +59,33 @@ FString FSLSupportedByEvent::ToString() const
 	return FString::Printf(TEXT("SupportedIndividual:[%s] SupportingIndividual:[%s] PairId:%lld"),
 		*SupportedIndividual->GetInfo(), *SupportingIndividual->GetInfo(), PairId);
 }
-/* End ISLEvent interface */
\ No newline at end of file
+/* End ISLEvent interface */
+
+/* Serialization from plain data */
+// Create the owl representation of the event
+FSLOwlNode FSLSupportedByEvent::CreateOwlNode(const FString& InId, float InStart, float InEnd,
+	const FString& SupportedIndividualId, const FString& SupportingIndividualId, const FString& InEpisodeId)
+{
+	FSLOwlNode EventIndividual = FSLOwlExperimentStatics::CreateEventIndividual(
+		"log", InId, "SupportedBySituation");
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateStartTimeProperty("log", InStart));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateEndTimeProperty("log", InEnd));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportedProperty("log", SupportedIndividualId));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateIsSupportingProperty("log", SupportingIndividualId));
+	EventIndividual.AddChildNode(FSLOwlExperimentStatics::CreateInEpisodeProperty("log", InEpisodeId));
+	return EventIndividual;
+}
+
+// Get the context data
+FString FSLSupportedByEvent::CreateContext(uint64 InPairId)
+{
+	return FString::Printf(TEXT("SupportedBy - %lld"), InPairId);
+}
+
+// Get the tooltip data
+FString FSLSupportedByEvent::CreateTooltip(const FString& SupportedIndividualClass, const FString& SupportedIndividualId,
+	const FString& SupportingIndividualClass, const FString& SupportingIndividualId, const FString& InId)
+{
+	return FString::Printf(TEXT("\'SupportedIndividual\',\'%s\',\'Id\',\'%s\',\'SupportingIndividual\',\'%s\',\'Id\',\'%s\',\'Id\',\'%s\'"),
+		*SupportedIndividualClass, *SupportedIndividualId, *SupportingIndividualClass, *SupportingIndividualId, *InId);
+}
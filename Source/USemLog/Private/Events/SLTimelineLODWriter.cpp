@@ -0,0 +1,377 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLTimelineLODWriter.h"
+#include "Runtime/SLEventStreamWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Write the page and the level sidecars (<EpId>_TL.html, <EpId>_TL_L<N>.js)
+bool FSLTimelineLODWriter::Write(const TArray<FSLEventSnapshot>& InEvents,
+	const FString& DirectoryPath,
+	const FString& InEpId,
+	const FSLTimelineLODParameters& Params,
+	bool bOverwrite)
+{
+	TArray<FString> Rows;
+	TArray<FSLTimelineRowEvent> RowEvents;
+	CreateRowEvents(InEvents, Rows, RowEvents);
+
+	TArray<FString> EventIds;
+	EventIds.Reserve(InEvents.Num());
+	for (const auto& Event : InEvents)
+	{
+		EventIds.Add(Event.Id);
+	}
+	return Write(MoveTemp(Rows), MoveTemp(RowEvents), EventIds, DirectoryPath, InEpId, Params, bOverwrite);
+}
+
+// Write the page and the level sidecars from already split row events (e.g. loaded from an offline log)
+bool FSLTimelineLODWriter::Write(TArray<FString> Rows,
+	TArray<FSLTimelineRowEvent> RowEvents,
+	const TArray<FString>& EventIds,
+	const FString& DirectoryPath,
+	const FString& InEpId,
+	const FSLTimelineLODParameters& Params,
+	bool bOverwrite)
+{
+	FString PageFilePath = DirectoryPath + "/" + InEpId + TEXT("_TL.html");
+	FPaths::RemoveDuplicateSlashes(PageFilePath);
+
+	// Check the page and all the level sidecars before writing anything
+	const int32 NumLevels = FMath::Max(Params.NumLevels, 0) + (Params.bWriteRawLevel ? 1 : 0);
+	if (!bOverwrite)
+	{
+		for (int32 Level = -1; Level < NumLevels; ++Level)
+		{
+			const FString FilePath = Level < 0 ? PageFilePath : GetLevelFilePath(DirectoryPath, InEpId, Level);
+			if (FPaths::FileExists(FilePath))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Timeline file %s already exists, and overwrite is false.."),
+					*FString(__FUNCTION__), __LINE__, *FilePath);
+				return false;
+			}
+		}
+	}
+
+	SortRowEvents(Rows, RowEvents);
+
+	// Episode interval
+	float StartTime = Params.StartTime;
+	float EndTime = Params.EndTime;
+	if (StartTime < 0.f || EndTime <= StartTime)
+	{
+		StartTime = TNumericLimits<float>::Max();
+		EndTime = TNumericLimits<float>::Lowest();
+		for (const auto& RowEvent : RowEvents)
+		{
+			StartTime = FMath::Min(StartTime, RowEvent.Start);
+			EndTime = FMath::Max(EndTime, RowEvent.End);
+		}
+		if (RowEvents.Num() == 0)
+		{
+			StartTime = 0.f;
+			EndTime = 1.f;
+		}
+	}
+	const float Duration = FMath::Max(EndTime - StartTime, KINDA_SMALL_NUMBER);
+
+	// Aggregated levels, from coarse to fine
+	TArray<float> BucketWidths;
+	TArray<FSLTimelineBar> Bars;
+	float NumBuckets = FMath::Max(Params.CoarsestBuckets, 1);
+	for (int32 Level = 0; Level < Params.NumLevels; ++Level)
+	{
+		const float BucketWidth = Duration / NumBuckets;
+		AggregateLevel(RowEvents, StartTime, BucketWidth, Bars);
+		if (!WriteLevel(GetLevelFilePath(DirectoryPath, InEpId, Level), Level, BucketWidth, Bars, Rows, EventIds))
+		{
+			return false;
+		}
+		BucketWidths.Add(BucketWidth);
+		NumBuckets *= FMath::Max(Params.BucketsFactor, 2);
+	}
+
+	// Raw events level
+	if (Params.bWriteRawLevel)
+	{
+		Bars.Empty(RowEvents.Num());
+		for (const auto& RowEvent : RowEvents)
+		{
+			Bars.Add({ RowEvent.Row, RowEvent.Kind, RowEvent.Start, RowEvent.End, 1, RowEvent.EventIdx });
+		}
+		const int32 RawLevel = BucketWidths.Num();
+		if (!WriteLevel(GetLevelFilePath(DirectoryPath, InEpId, RawLevel), RawLevel, 0.f, Bars, Rows, EventIds))
+		{
+			return false;
+		}
+		BucketWidths.Add(0.f);
+	}
+
+	return FFileHelper::SaveStringToFile(GetPage(InEpId, Params, BucketWidths, StartTime, EndTime), *PageFilePath,
+		FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
+
+// Get the path of the level sidecar
+FString FSLTimelineLODWriter::GetLevelFilePath(const FString& DirectoryPath, const FString& InEpId, int32 Level)
+{
+	FString FilePath = DirectoryPath + "/" + InEpId + FString::Printf(TEXT("_TL_L%d.js"), Level);
+	FPaths::RemoveDuplicateSlashes(FilePath);
+	return FilePath;
+}
+
+// Split the events per individual row
+void FSLTimelineLODWriter::CreateRowEvents(const TArray<FSLEventSnapshot>& InEvents,
+	TArray<FString>& OutRows, TArray<FSLTimelineRowEvent>& OutRowEvents)
+{
+	// The individual snapshots are unique per individual in the event store
+	TMap<const FSLIndividualSnapshot*, int32> IndividualToRow;
+	OutRowEvents.Reserve(InEvents.Num() * 2);
+	for (int32 EventIdx = 0; EventIdx < InEvents.Num(); ++EventIdx)
+	{
+		const FSLEventSnapshot& Event = InEvents[EventIdx];
+
+		// Each event is shown on the row of every participant (events without participants share the null row)
+		const int32 NumRows = FMath::Max(Event.Participants.Num(), 1);
+		for (int32 Idx = 0; Idx < NumRows; ++Idx)
+		{
+			const FSLIndividualSnapshot* Individual = Event.Participants.IsValidIndex(Idx) ? Event.Participants[Idx].Individual : nullptr;
+			int32* Row = IndividualToRow.Find(Individual);
+			if (Row == nullptr)
+			{
+				Row = &IndividualToRow.Add(Individual, OutRows.Add(GetRowLabel(Individual)));
+			}
+			OutRowEvents.Add({ *Row, (int32)Event.Kind, Event.StartTime, Event.EndTime, EventIdx });
+		}
+	}
+}
+
+// Sort the rows alphabetically and the row events by row, kind and start time
+void FSLTimelineLODWriter::SortRowEvents(TArray<FString>& InOutRows, TArray<FSLTimelineRowEvent>& InOutRowEvents)
+{
+	TArray<int32> Order;
+	Order.Reserve(InOutRows.Num());
+	for (int32 Idx = 0; Idx < InOutRows.Num(); ++Idx)
+	{
+		Order.Add(Idx);
+	}
+	Order.Sort([&InOutRows](int32 A, int32 B) { return InOutRows[A] < InOutRows[B]; });
+	TArray<int32> NewIndex;
+	NewIndex.SetNumUninitialized(InOutRows.Num());
+	TArray<FString> SortedRows;
+	SortedRows.Reserve(InOutRows.Num());
+	for (int32 Idx = 0; Idx < Order.Num(); ++Idx)
+	{
+		NewIndex[Order[Idx]] = Idx;
+		SortedRows.Add(InOutRows[Order[Idx]]);
+	}
+	InOutRows = MoveTemp(SortedRows);
+	for (auto& RowEvent : InOutRowEvents)
+	{
+		RowEvent.Row = NewIndex[RowEvent.Row];
+	}
+
+	InOutRowEvents.Sort([](const FSLTimelineRowEvent& A, const FSLTimelineRowEvent& B)
+	{
+		if (A.Row != B.Row)
+		{
+			return A.Row < B.Row;
+		}
+		if (A.Kind != B.Kind)
+		{
+			return A.Kind < B.Kind;
+		}
+		return A.Start < B.Start;
+	});
+}
+
+// Aggregate the sorted row events into bars snapped to the bucket width
+void FSLTimelineLODWriter::AggregateLevel(const TArray<FSLTimelineRowEvent>& RowEvents, float Origin, float BucketWidth,
+	TArray<FSLTimelineBar>& OutBars)
+{
+	OutBars.Reset();
+	for (const auto& RowEvent : RowEvents)
+	{
+		const float Start = Origin + FMath::FloorToFloat((RowEvent.Start - Origin) / BucketWidth) * BucketWidth;
+		float End = Origin + FMath::CeilToFloat((RowEvent.End - Origin) / BucketWidth) * BucketWidth;
+		if (End <= Start)
+		{
+			End = Start + BucketWidth;
+		}
+
+		// Merge with the previous bar of the same row and kind if they touch
+		if (OutBars.Num() > 0)
+		{
+			FSLTimelineBar& Last = OutBars.Last();
+			if (Last.Row == RowEvent.Row && Last.Kind == RowEvent.Kind && Start <= Last.End)
+			{
+				Last.End = FMath::Max(Last.End, End);
+				Last.Count++;
+				continue;
+			}
+		}
+		OutBars.Add({ RowEvent.Row, RowEvent.Kind, Start, End, 1, INDEX_NONE });
+	}
+}
+
+// Write the level sidecar (json data wrapped in a callback so it can be loaded from a local file)
+bool FSLTimelineLODWriter::WriteLevel(const FString& FilePath, int32 Level, float BucketWidth,
+	const TArray<FSLTimelineBar>& Bars, const TArray<FString>& Rows,
+	const TArray<FString>& EventIds)
+{
+	FString LevelStr;
+	LevelStr.Reserve(128 + Bars.Num() * 48);
+	LevelStr += FString::Printf(TEXT("slOnLevel(%d, {\"bucket\":%.6f,\"rows\":["), Level, BucketWidth);
+	for (int32 Idx = 0; Idx < Rows.Num(); ++Idx)
+	{
+		if (Idx > 0)
+		{
+			LevelStr.AppendChar(TEXT(','));
+		}
+		LevelStr.AppendChar(TEXT('"'));
+		FSLEventStreamWriter::AppendEscaped(LevelStr, Rows[Idx]);
+		LevelStr.AppendChar(TEXT('"'));
+	}
+	LevelStr.Append(TEXT("],\"kinds\":["));
+	for (int32 Kind = 0; Kind <= (int32)ESLEventKind::Dummy; ++Kind)
+	{
+		if (Kind > 0)
+		{
+			LevelStr.AppendChar(TEXT(','));
+		}
+		LevelStr.AppendChar(TEXT('"'));
+		FSLEventStreamWriter::AppendEscaped(LevelStr, ISLEvent::GetKindName((ESLEventKind)Kind));
+		LevelStr.AppendChar(TEXT('"'));
+	}
+
+	// Bars as [row, kind, start, end, count(, id)]
+	LevelStr.Append(TEXT("],\"bars\":["));
+	for (int32 Idx = 0; Idx < Bars.Num(); ++Idx)
+	{
+		const FSLTimelineBar& Bar = Bars[Idx];
+		LevelStr += FString::Printf(TEXT("%s\n[%d,%d,%.3f,%.3f,%d"), Idx > 0 ? TEXT(",") : TEXT(""),
+			Bar.Row, Bar.Kind, Bar.Start, Bar.End, Bar.Count);
+		if (EventIds.IsValidIndex(Bar.EventIdx))
+		{
+			LevelStr.Append(TEXT(",\""));
+			FSLEventStreamWriter::AppendEscaped(LevelStr, EventIds[Bar.EventIdx]);
+			LevelStr.AppendChar(TEXT('"'));
+		}
+		LevelStr.AppendChar(TEXT(']'));
+	}
+	LevelStr.Append(TEXT("\n]});\n"));
+
+	if (!FFileHelper::SaveStringToFile(LevelStr, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write timeline level %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+	return true;
+}
+
+// Get the html page
+FString FSLTimelineLODWriter::GetPage(const FString& InEpId, const FSLTimelineLODParameters& Params,
+	const TArray<float>& BucketWidths, float StartTime, float EndTime)
+{
+	FString Widths;
+	FString LevelOptions;
+	for (int32 Level = 0; Level < BucketWidths.Num(); ++Level)
+	{
+		Widths += FString::Printf(TEXT("%s%.6f"), Level > 0 ? TEXT(",") : TEXT(""), BucketWidths[Level]);
+		const FString LevelName = BucketWidths[Level] > 0.f
+			? FString::Printf(TEXT("L%d (%.3fs buckets)"), Level, BucketWidths[Level])
+			: FString::Printf(TEXT("L%d (raw events)"), Level);
+		LevelOptions += FString::Printf(TEXT("\t<option value=\"%d\">%s</option>\n"), Level, *LevelName);
+	}
+
+	FString Page =
+		"<html>\n"
+		"<head>\n"
+		"<title>" + Params.TaskId + " " + InEpId + "</title>\n"
+		"<script type=\"text/javascript\" src=\"https://www.gstatic.com/charts/loader.js\"></script>\n"
+		"</head>\n"
+		"<body>\n"
+		"<div>\n"
+		"\t Level: <select id=\"level\" onchange=\"slLoad()\">\n"
+		"\t<option value=\"-1\">auto</option>\n" + LevelOptions +
+		"\t</select>\n"
+		"\t From (s): <input id=\"from\" type=\"number\" step=\"any\" value=\"" + FString::Printf(TEXT("%.3f"), StartTime) + "\" onchange=\"slLoad()\"/>\n"
+		"\t To (s): <input id=\"to\" type=\"number\" step=\"any\" value=\"" + FString::Printf(TEXT("%.3f"), EndTime) + "\" onchange=\"slLoad()\"/>\n"
+		"\t <span id=\"status\"></span>\n"
+		"</div>\n"
+		"<div id=\"event_tl\" style=\"height:900px;\"></div>\n"
+		"\n"
+		"<script type=\"text/javascript\">\n"
+		"\t var SL = { episode: '" + InEpId + "', widths: [" + Widths + "], factor: " + FString::FromInt(FMath::Max(Params.BucketsFactor, 2)) + ", levels: {}, maxBars: 5000, chart: null };\n"
+		"\n"
+		"\t google.charts.load(\"current\", {packages:[\"timeline\"]});\n"
+		"\t google.charts.setOnLoadCallback(function() {\n"
+		"\t\t SL.chart = new google.visualization.Timeline(document.getElementById('event_tl'));\n"
+		"\t\t slLoad();\n"
+		"\t });\n"
+		"\n"
+		"\t // Called by the level sidecar scripts\n"
+		"\t function slOnLevel(level, data) { SL.levels[level] = data; slDraw(); }\n"
+		"\n"
+		"\t // Pick the finest level that keeps the visible window within the bars budget\n"
+		"\t function slLevel() {\n"
+		"\t\t var level = +document.getElementById('level').value;\n"
+		"\t\t if (level >= 0) { return level; }\n"
+		"\t\t var span = (+document.getElementById('to').value) - (+document.getElementById('from').value);\n"
+		"\t\t level = 0;\n"
+		"\t\t for (var l = 0; l < SL.widths.length; ++l) {\n"
+		"\t\t\t var w = SL.widths[l] > 0 ? SL.widths[l] : SL.widths[Math.max(l - 1, 0)] / SL.factor;\n"
+		"\t\t\t if (span / w <= 200) { level = l; }\n"
+		"\t\t }\n"
+		"\t\t return level;\n"
+		"\t }\n"
+		"\n"
+		"\t // Load the level sidecar on demand (script tag, works for local files)\n"
+		"\t function slLoad() {\n"
+		"\t\t var level = slLevel();\n"
+		"\t\t if (SL.levels[level]) { slDraw(); return; }\n"
+		"\t\t document.getElementById('status').textContent = 'loading level ' + level + '..';\n"
+		"\t\t var script = document.createElement('script');\n"
+		"\t\t script.src = SL.episode + '_TL_L' + level + '.js';\n"
+		"\t\t document.head.appendChild(script);\n"
+		"\t }\n"
+		"\n"
+		"\t function slDraw() {\n"
+		"\t\t var level = slLevel();\n"
+		"\t\t var data = SL.levels[level];\n"
+		"\t\t if (!data || !SL.chart) { return; }\n"
+		"\t\t var from = +document.getElementById('from').value;\n"
+		"\t\t var to = +document.getElementById('to').value;\n"
+		"\t\t var rows = [];\n"
+		"\t\t for (var i = 0; i < data.bars.length && rows.length < SL.maxBars; ++i) {\n"
+		"\t\t\t var b = data.bars[i];\n"
+		"\t\t\t if (b[3] < from || b[2] > to) { continue; }\n"
+		"\t\t\t var label = data.kinds[b[1]] + (b[4] > 1 ? ' x' + b[4] : '') + (b.length > 5 ? ' ' + b[5] : '');\n"
+		"\t\t\t rows.push([data.rows[b[0]], label, Math.max(b[2], from) * 1000, Math.min(b[3], to) * 1000]);\n"
+		"\t\t }\n"
+		"\t\t document.getElementById('status').textContent = 'level ' + level + ', ' + rows.length + ' bars' +\n"
+		"\t\t\t (rows.length >= SL.maxBars ? ' (truncated, narrow the window)' : '');\n"
+		"\t\t if (rows.length == 0) { SL.chart.clearChart(); return; }\n"
+		"\t\t var dataTable = new google.visualization.DataTable();\n"
+		"\t\t dataTable.addColumn({ type: 'string', id: 'individual' });\n"
+		"\t\t dataTable.addColumn({ type: 'string', id: 'event' });\n"
+		"\t\t dataTable.addColumn({ type: 'number', id: 'start' });\n"
+		"\t\t dataTable.addColumn({ type: 'number', id: 'end' });\n"
+		"\t\t dataTable.addRows(rows);\n"
+		"\t\t SL.chart.draw(dataTable, { timeline: {showRowLabels: true}, avoidOverlappingGridLines: false });\n"
+		"\t }\n"
+		"</script>\n"
+		"</body>\n"
+		"</html>\n";
+	return Page;
+}
+
+// Get the row label of the individual
+FString FSLTimelineLODWriter::GetRowLabel(const FSLIndividualSnapshot* Individual)
+{
+	if (Individual == nullptr)
+	{
+		return FString(TEXT("null"));
+	}
+	return !Individual->ActorName.IsEmpty() ? Individual->ActorName : Individual->Id;
+}
@@ -0,0 +1,205 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoEpisodeLoader.h"
+#include "Mongo/SLMongoQueryDBHandler.h"
+#include "Mongo/SLMongoPipelinedReader.h"
+
+// Do the loading here
+void FSLMongoEpisodeLoaderAsyncTask::DoWork()
+{
+	if (!Loader)
+	{
+		return;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	double ExecBegin = FPlatformTime::Seconds();
+
+	bson_error_t error;
+	mongoc_uri_t* uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*Loader->Uri), &error);
+	if (!uri)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__FUNCTION__), __LINE__, *FString(error.message));
+		Loader->bError = true;
+		Loader->bDone = true;
+		return;
+	}
+
+	mongoc_client_t* client = mongoc_client_new_from_uri(uri);
+	if (!client)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the mongo client.."), *FString(__FUNCTION__), __LINE__);
+		mongoc_uri_destroy(uri);
+		Loader->bError = true;
+		Loader->bDone = true;
+		return;
+	}
+	mongoc_client_set_appname(client, "MongoQAEpisodeLoader");
+	mongoc_collection_t* collection = mongoc_client_get_collection(client,
+		TCHAR_TO_UTF8(*Loader->DBName), TCHAR_TO_UTF8(*Loader->CollName));
+
+	bson_t opts;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *pipeline;
+
+	// If the episode is very large the hard drive needs to be used to cache results
+	bson_init(&opts);
+	BSON_APPEND_BOOL(&opts, "allowDiskUse", true);
+
+	// Count the frames for the progress report
+	pipeline = Loader->Schema.CreateFrameCountPipeline();
+	cursor = mongoc_collection_aggregate(
+		collection, MONGOC_QUERY_NONE, pipeline, &opts, NULL);
+	if (mongoc_cursor_next(cursor, &doc))
+	{
+		bson_iter_t iter;
+		if (bson_iter_init_find(&iter, doc, "count"))
+		{
+			Loader->NumTotalFrames.Set(int32(FSLMongoFrameDecoder::GetDouble(&iter)));
+		}
+	}
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(pipeline);
+
+	pipeline = Loader->Schema.CreateEpisodePipeline();
+	cursor = mongoc_collection_aggregate(
+		collection, MONGOC_QUERY_NONE, pipeline, &opts, NULL);
+	mongoc_cursor_set_batch_size(cursor, Loader->BatchSize);
+
+	// Read cursor if no errors occured, the batches are decoded in parallel and handed over in order
+	if (!mongoc_cursor_error(cursor, &error))
+	{
+		FSLMongoPipelinedReader Reader(Loader->BatchSize);
+		const bool bRead = Reader.Read(cursor, [this](TArray<FSLMongoEpisodeLoader::FFrame>&& Frames)
+		{
+			Loader->NumLoadedFrames.Add(Frames.Num());
+			Loader->Chunks.Enqueue(MoveTemp(Frames));
+		}, &Loader->bCancelRequested);
+
+		if (!bRead)
+		{
+			if (Loader->bCancelRequested)
+			{
+				Loader->bCancelled = true;
+			}
+			else
+			{
+				Loader->bError = true;
+			}
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__FUNCTION__), __LINE__, *FString(error.message));
+		Loader->bError = true;
+	}
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(pipeline);
+	bson_destroy(&opts);
+	mongoc_collection_destroy(collection);
+	mongoc_client_destroy(client);
+	mongoc_uri_destroy(uri);
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Loaded %d/%d frames of %s.%s in [%f] seconds (cancelled=%s)..;"),
+		*FString(__FUNCTION__), __LINE__, Loader->NumLoaded(), Loader->NumTotal(), *Loader->DBName, *Loader->CollName,
+		FPlatformTime::Seconds() - ExecBegin, Loader->bCancelled ? TEXT("true") : TEXT("false"));
+#else
+	Loader->bError = true;
+#endif // SL_WITH_LIBMONGO_C
+	Loader->bDone = true;
+}
+
+
+// Ctor
+FSLMongoEpisodeLoader::FSLMongoEpisodeLoader()
+{
+	BatchSize = 256;
+	bStarted = false;
+	LoaderTask = nullptr;
+}
+
+// Dtor, cancels and waits for the loading
+FSLMongoEpisodeLoader::~FSLMongoEpisodeLoader()
+{
+	if (LoaderTask)
+	{
+		Cancel();
+		LoaderTask->EnsureCompletion();
+		delete LoaderTask;
+		LoaderTask = nullptr;
+	}
+}
+
+// Start loading the collection in the background
+bool FSLMongoEpisodeLoader::Start(const FString& InUri, const FString& InDBName, const FString& InCollName, const FSLMongoSchema& InSchema, int32 InBatchSize)
+{
+	if (bStarted)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode loader is already started.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	Uri = InUri;
+	DBName = InDBName;
+	CollName = InCollName;
+	Schema = InSchema;
+	BatchSize = FMath::Max(InBatchSize, 1);
+
+	LoaderTask = new FAsyncTask<FSLMongoEpisodeLoaderAsyncTask>();
+	LoaderTask->GetTask().Init(this);
+	LoaderTask->StartBackgroundTask();
+	bStarted = true;
+	return true;
+#else
+	UE_LOG(LogTemp, Error, TEXT("%s::%d Mongo module is missing.."), *FString(__FUNCTION__), __LINE__);
+	bError = true;
+	bDone = true;
+	return false;
+#endif // SL_WITH_LIBMONGO_C
+}
+
+// Block until the background loading is done
+void FSLMongoEpisodeLoader::Wait()
+{
+	if (LoaderTask)
+	{
+		LoaderTask->EnsureCompletion();
+	}
+}
+
+// Move the frames loaded since the last call to the output, returns the number of moved frames
+int32 FSLMongoEpisodeLoader::ConsumeFrames(TArray<FFrame>& OutFrames)
+{
+	int32 NumMoved = 0;
+	TArray<FFrame> Chunk;
+	while (Chunks.Dequeue(Chunk))
+	{
+		NumMoved += Chunk.Num();
+		if (OutFrames.Num() == 0)
+		{
+			OutFrames = MoveTemp(Chunk);
+		}
+		else
+		{
+			OutFrames.Append(MoveTemp(Chunk));
+		}
+	}
+	return NumMoved;
+}
+
+// Loading progress [0, 1]
+float FSLMongoEpisodeLoader::GetProgress() const
+{
+	if (bDone)
+	{
+		return 1.f;
+	}
+	const int32 Total = NumTotal();
+	return Total > 0 ? FMath::Clamp(float(NumLoaded()) / float(Total), 0.f, 1.f) : 0.f;
+}
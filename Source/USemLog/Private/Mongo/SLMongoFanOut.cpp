@@ -0,0 +1,156 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoFanOut.h"
+#include "Misc/QueuedThreadPool.h"
+#include "HAL/PlatformMisc.h"
+
+// Query episodes with a client of the pool until no episodes are left
+void FSLMongoFanOutAsyncTask::DoWork()
+{
+#if SL_WITH_LIBMONGO_C
+	// The client is used by this worker only
+	mongoc_client_t* worker_client = mongoc_client_pool_pop(Work->pool);
+	const TArray<FSLMongoEpisodeRef>& Episodes = *Work->Episodes;
+	for (int32 Idx = Work->NextIdx.Increment() - 1; Idx < Episodes.Num(); Idx = Work->NextIdx.Increment() - 1)
+	{
+		const FSLMongoEpisodeRef& Episode = Episodes[Idx];
+		FSLMongoQueryDBHandler Handler;
+		if (Handler.SetClient(worker_client)
+			&& Handler.SetDatabase(Episode.TaskId)
+			&& Handler.SetCollection(Episode.EpisodeId))
+		{
+			(*Work->Query)(Idx, Handler);
+			(*Work->Success)[Idx] = true;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not open episode %s.%s, skipping.."),
+				*FString(__FUNCTION__), __LINE__, *Episode.TaskId, *Episode.EpisodeId);
+			Work->NumFailed.Increment();
+		}
+	}
+	mongoc_client_pool_push(Work->pool, worker_client);
+#endif // SL_WITH_LIBMONGO_C
+}
+
+// Ctor (libmongoc is initialized by the query handler owning the uri)
+FSLMongoFanOut::FSLMongoFanOut(const FString& InUri, int32 InMaxConnections)
+{
+	MaxConnections = InMaxConnections > 0 ? InMaxConnections
+		: FMath::Max(FPlatformMisc::NumberOfWorkerThreadsToSpawn(), 1);
+	ThreadPool = nullptr;
+
+#if SL_WITH_LIBMONGO_C
+	pool = nullptr;
+
+	bson_error_t error;
+	uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*InUri), &error);
+	if (!uri)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s; [Uri=%s]"),
+			*FString(__FUNCTION__), __LINE__, *FString(error.message), *InUri);
+		return;
+	}
+
+	// Popping blocks when all the clients are in use, this bounds the number of concurrent queries
+	pool = mongoc_client_pool_new(uri);
+	if (!pool)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the mongo client pool.."), *FString(__FUNCTION__), __LINE__);
+		return;
+	}
+	mongoc_client_pool_set_error_api(pool, MONGOC_ERROR_API_VERSION_2);
+	mongoc_client_pool_max_size(pool, MaxConnections);
+	mongoc_client_pool_set_appname(pool, "MongoQAFanOut");
+
+	ThreadPool = FQueuedThreadPool::Allocate();
+	if (!ThreadPool->Create(MaxConnections, 256 * 1024, TPri_Normal))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not create the worker threads.."), *FString(__FUNCTION__), __LINE__);
+		delete ThreadPool;
+		ThreadPool = nullptr;
+	}
+#endif // SL_WITH_LIBMONGO_C
+}
+
+// Dtor
+FSLMongoFanOut::~FSLMongoFanOut()
+{
+	if (ThreadPool)
+	{
+		ThreadPool->Destroy();
+		delete ThreadPool;
+	}
+#if SL_WITH_LIBMONGO_C
+	if (pool)
+	{
+		mongoc_client_pool_destroy(pool);
+	}
+	if (uri)
+	{
+		mongoc_uri_destroy(uri);
+	}
+#endif // SL_WITH_LIBMONGO_C
+}
+
+// True if the client pool was created
+bool FSLMongoFanOut::IsValid() const
+{
+#if SL_WITH_LIBMONGO_C
+	return pool != nullptr && ThreadPool != nullptr;
+#else
+	return false;
+#endif // SL_WITH_LIBMONGO_C
+}
+
+// Run the query on every episode, the episodes are shared between at most MaxConnections workers
+bool FSLMongoFanOut::RunEach(const TArray<FSLMongoEpisodeRef>& Episodes,
+	TFunctionRef<void(int32 EpisodeIdx, const FSLMongoQueryDBHandler& Handler)> Query, TArray<bool>& OutSuccess)
+{
+	OutSuccess.Init(false, Episodes.Num());
+	if (!IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Client pool is not created, cannot query the episodes.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+	if (Episodes.Num() == 0)
+	{
+		return true;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	double ExecBegin = FPlatformTime::Seconds();
+
+	FSLMongoFanOutWork Work;
+	Work.Episodes = &Episodes;
+	Work.Query = &Query;
+	Work.Success = &OutSuccess;
+	Work.pool = pool;
+
+	// Every worker pulls episodes until none are left
+	const int32 NumWorkers = FMath::Min(MaxConnections, Episodes.Num());
+	TArray<FAsyncTask<FSLMongoFanOutAsyncTask>*> Workers;
+	Workers.Reserve(NumWorkers);
+	for (int32 WorkerIdx = 0; WorkerIdx < NumWorkers; ++WorkerIdx)
+	{
+		FAsyncTask<FSLMongoFanOutAsyncTask>* Worker = new FAsyncTask<FSLMongoFanOutAsyncTask>();
+		Worker->GetTask().Init(&Work);
+		Worker->StartBackgroundTask(ThreadPool);
+		Workers.Add(Worker);
+	}
+
+	// The shared work lives on this stack frame, wait for all the workers
+	for (FAsyncTask<FSLMongoFanOutAsyncTask>* Worker : Workers)
+	{
+		Worker->EnsureCompletion();
+		delete Worker;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: total=[%f] seconds, Episodes=[%d], Failed=[%d], Connections=[%d]..;"),
+		*FString(__FUNCTION__), __LINE__, FPlatformTime::Seconds() - ExecBegin, Episodes.Num(), Work.NumFailed.GetValue(), NumWorkers);
+	return Work.NumFailed.GetValue() == 0;
+#else
+	return false;
+#endif // SL_WITH_LIBMONGO_C
+}
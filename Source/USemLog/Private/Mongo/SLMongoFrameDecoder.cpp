@@ -0,0 +1,189 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoFrameDecoder.h"
+
+#if SL_WITH_ROS_CONVERSIONS
+#include "Conversions.h"
+#endif // SL_WITH_ROS_CONVERSIONS
+
+#if SL_WITH_LIBMONGO_C
+// Decode the pose (loc, quat) of the document
+bool FSLMongoFrameDecoder::DecodePose(const bson_t* doc, FTransform& OutPose)
+{
+	FVector Loc = FVector::ZeroVector;
+	FQuat Quat = FQuat::Identity;
+	bson_iter_t fields;
+	if (bson_iter_init(&fields, doc) && DecodePoseFields(&fields, Loc, Quat, nullptr))
+	{
+		OutPose = MakePose(Loc, Quat);
+		return true;
+	}
+	OutPose = MakePose(Loc, Quat);
+	return false;
+}
+
+// Decode the pose (loc, quat) of the sub-document the iterator points to
+bool FSLMongoFrameDecoder::DecodePose(const bson_iter_t* iter, FTransform& OutPose)
+{
+	FVector Loc = FVector::ZeroVector;
+	FQuat Quat = FQuat::Identity;
+	bson_iter_t fields;
+	if (bson_iter_recurse(iter, &fields) && DecodePoseFields(&fields, Loc, Quat, nullptr))
+	{
+		OutPose = MakePose(Loc, Quat);
+		return true;
+	}
+	OutPose = MakePose(Loc, Quat);
+	return false;
+}
+
+// Decode the id and the pose of the individual sub-document the iterator points to
+bool FSLMongoFrameDecoder::DecodeIndividual(const bson_iter_t* iter, FString& OutId, FTransform& OutPose)
+{
+	FVector Loc = FVector::ZeroVector;
+	FQuat Quat = FQuat::Identity;
+	bson_iter_t fields;
+	if (bson_iter_recurse(iter, &fields))
+	{
+		DecodePoseFields(&fields, Loc, Quat, &OutId);
+	}
+	OutPose = MakePose(Loc, Quat);
+	return !OutId.IsEmpty();
+}
+
+// Decode the timestamp and the individuals of the given array of a frame document
+int32 FSLMongoFrameDecoder::DecodeFrame(const bson_t* doc, const char* ArrayName, double& OutTs,
+	TFunctionRef<void(FString&& Id, const FTransform& Pose)> OnIndividual)
+{
+	int32 Num = 0;
+	bson_iter_t frame_iter;
+	if (!bson_iter_init(&frame_iter, doc))
+	{
+		return Num;
+	}
+
+	// Locate the timestamp and the array first (top level keys only), so the timestamp is known before the callbacks
+	bson_iter_t array_iter;
+	bool bHasArray = false;
+	while (bson_iter_next(&frame_iter))
+	{
+		const char* key = bson_iter_key(&frame_iter);
+		if (strcmp(key, "timestamp") == 0)
+		{
+			OutTs = GetDouble(&frame_iter);
+		}
+		else if (strcmp(key, ArrayName) == 0 && BSON_ITER_HOLDS_ARRAY(&frame_iter))
+		{
+			bHasArray = bson_iter_recurse(&frame_iter, &array_iter);
+		}
+	}
+
+	if (bHasArray)
+	{
+		FString Id;
+		FTransform Pose;
+		while (bson_iter_next(&array_iter))
+		{
+			if (BSON_ITER_HOLDS_DOCUMENT(&array_iter) && DecodeIndividual(&array_iter, Id, Pose))
+			{
+				OnIndividual(MoveTemp(Id), Pose);
+				Num++;
+			}
+			Id.Reset();
+		}
+	}
+	return Num;
+}
+
+// Read a numeric value as double (0 if not numeric)
+double FSLMongoFrameDecoder::GetDouble(const bson_iter_t* iter)
+{
+	switch (bson_iter_type(iter))
+	{
+	case BSON_TYPE_DOUBLE:
+		return bson_iter_double(iter);
+	case BSON_TYPE_INT32:
+		return bson_iter_int32(iter);
+	case BSON_TYPE_INT64:
+		return bson_iter_int64(iter);
+	default:
+		return 0.0;
+	}
+}
+
+// Walk the fields of the pose document once
+bool FSLMongoFrameDecoder::DecodePoseFields(bson_iter_t* fields, FVector& OutLoc, FQuat& OutQuat, FString* OutId)
+{
+	bool bHasLoc = false;
+	bool bHasQuat = false;
+	while (bson_iter_next(fields))
+	{
+		const char* key = bson_iter_key(fields);
+		if (strcmp(key, "loc") == 0 && BSON_ITER_HOLDS_DOCUMENT(fields))
+		{
+			bson_iter_t value;
+			if (bson_iter_recurse(fields, &value))
+			{
+				while (bson_iter_next(&value))
+				{
+					const char* axis = bson_iter_key(&value);
+					if (axis[0] != '\0' && axis[1] == '\0')
+					{
+						switch (axis[0])
+						{
+						case 'x': OutLoc.X = GetDouble(&value); break;
+						case 'y': OutLoc.Y = GetDouble(&value); break;
+						case 'z': OutLoc.Z = GetDouble(&value); break;
+						default: break;
+						}
+					}
+				}
+				bHasLoc = true;
+			}
+		}
+		else if (strcmp(key, "quat") == 0 && BSON_ITER_HOLDS_DOCUMENT(fields))
+		{
+			bson_iter_t value;
+			if (bson_iter_recurse(fields, &value))
+			{
+				while (bson_iter_next(&value))
+				{
+					const char* axis = bson_iter_key(&value);
+					if (axis[0] != '\0' && axis[1] == '\0')
+					{
+						switch (axis[0])
+						{
+						case 'x': OutQuat.X = GetDouble(&value); break;
+						case 'y': OutQuat.Y = GetDouble(&value); break;
+						case 'z': OutQuat.Z = GetDouble(&value); break;
+						case 'w': OutQuat.W = GetDouble(&value); break;
+						default: break;
+						}
+					}
+				}
+				bHasQuat = true;
+			}
+		}
+		else if (OutId && strcmp(key, "id") == 0 && BSON_ITER_HOLDS_UTF8(fields))
+		{
+			uint32_t len = 0;
+			const char* str = bson_iter_utf8(fields, &len);
+			FUTF8ToTCHAR Converter(str, len);
+			*OutId = FString(Converter.Length(), Converter.Get());
+		}
+	}
+	return bHasLoc || bHasQuat;
+}
+
+// Create the pose from the decoded values
+FTransform FSLMongoFrameDecoder::MakePose(const FVector& Loc, FQuat Quat)
+{
+	Quat.Normalize();
+#if SL_WITH_ROS_CONVERSIONS
+	return FConversions::ROSToU(FTransform(Quat, Loc));
+#else
+	return FTransform(Quat, Loc);
+#endif // SL_WITH_ROS_CONVERSIONS
+}
+#endif // SL_WITH_LIBMONGO_C
@@ -0,0 +1,113 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoPipelinedReader.h"
+#include "Async/TaskGraphInterfaces.h"
+
+#if SL_WITH_LIBMONGO_C
+// Raw documents of a batch and their decoded frames (same slots)
+struct FSLMongoPipelinedBatch
+{
+	TArray<bson_t*> Docs;
+	TArray<FSLMongoPipelinedReader::FFrame> Frames;
+};
+
+// Ctor
+FSLMongoPipelinedReader::FSLMongoPipelinedReader(int32 InBatchSize, int32 InMaxBatchesInFlight)
+{
+	BatchSize = FMath::Max(InBatchSize, 1);
+	MaxBatchesInFlight = InMaxBatchesInFlight > 0 ? InMaxBatchesInFlight
+		: FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+}
+
+// Read the whole cursor, OnBatch is called on the calling thread with the decoded batches in order
+bool FSLMongoPipelinedReader::Read(mongoc_cursor_t* cursor, TFunctionRef<void(TArray<FFrame>&& Frames)> OnBatch,
+	const FThreadSafeBool* bCancel)
+{
+	// Batches being decoded, oldest first
+	TArray<TPair<FGraphEventRef, TSharedPtr<FSLMongoPipelinedBatch>>> InFlight;
+	const char* Name = ArrayName;
+
+	// Hand over the decoded batches from the front, optionally waiting for them
+	auto HandOver = [&InFlight, &OnBatch](int32 NumToWait)
+	{
+		while (InFlight.Num() > 0)
+		{
+			if (NumToWait > 0)
+			{
+				FTaskGraphInterface::Get().WaitUntilTaskCompletes(InFlight[0].Key);
+				NumToWait--;
+			}
+			else if (!InFlight[0].Key->IsComplete())
+			{
+				break;
+			}
+			OnBatch(MoveTemp(InFlight[0].Value->Frames));
+			InFlight.RemoveAt(0, 1, false);
+		}
+	};
+
+	// Decode the batch in the background, the slots are preallocated so the order is kept
+	auto Dispatch = [&InFlight, &HandOver, Name, this](TSharedPtr<FSLMongoPipelinedBatch> Batch)
+	{
+		if (InFlight.Num() >= MaxBatchesInFlight)
+		{
+			HandOver(1);
+		}
+		FGraphEventRef Task = FFunctionGraphTask::CreateAndDispatchWhenReady([Batch, Name]()
+		{
+			Batch->Frames.SetNum(Batch->Docs.Num());
+			for (int32 Idx = 0; Idx < Batch->Docs.Num(); ++Idx)
+			{
+				FFrame& Frame = Batch->Frames[Idx];
+				double Ts = 0.0;
+				FSLMongoFrameDecoder::DecodeFrame(Batch->Docs[Idx], Name, Ts,
+					[&Frame](FString&& Id, const FTransform& Pose) { Frame.Value.Emplace(MoveTemp(Id), Pose); });
+				Frame.Key = Ts;
+				bson_destroy(Batch->Docs[Idx]);
+			}
+			Batch->Docs.Empty();
+		}, TStatId(), nullptr, ENamedThreads::AnyThread);
+		InFlight.Emplace(Task, Batch);
+	};
+
+	bool bCancelled = false;
+	const bson_t* doc;
+	TSharedPtr<FSLMongoPipelinedBatch> Batch = MakeShared<FSLMongoPipelinedBatch>();
+	Batch->Docs.Reserve(BatchSize);
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		if (bCancel && *bCancel)
+		{
+			bCancelled = true;
+			break;
+		}
+
+		// The cursor reuses the document memory, the workers get their own copy
+		Batch->Docs.Add(bson_copy(doc));
+		if (Batch->Docs.Num() >= BatchSize)
+		{
+			Dispatch(Batch);
+			Batch = MakeShared<FSLMongoPipelinedBatch>();
+			Batch->Docs.Reserve(BatchSize);
+			HandOver(0);
+		}
+	}
+	if (Batch->Docs.Num() > 0)
+	{
+		Dispatch(Batch);
+	}
+
+	// Wait for the remaining batches
+	HandOver(InFlight.Num());
+
+	bson_error_t error;
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__FUNCTION__), __LINE__, *FString(error.message));
+		return false;
+	}
+	return !bCancelled;
+}
+#endif // SL_WITH_LIBMONGO_C
@@ -0,0 +1,230 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoPoseIndex.h"
+
+// Add a sample, returns false if the memory budget is exceeded
+bool FSLMongoPoseIndex::Add(const FString& Id, float Ts, const FTransform& Pose)
+{
+	if (bOverBudget)
+	{
+		return false;
+	}
+
+	FSLMongoPoseTrack* Track = Tracks.Find(Id);
+	if (!Track)
+	{
+		Track = &Tracks.Add(Id);
+		AllocatedSize += sizeof(FSLMongoPoseTrack) + Id.GetAllocatedSize();
+	}
+
+	if (Track->Num() > 0 && Ts < Track->Timestamps.Last())
+	{
+		bNeedsSort = true;
+	}
+	Track->Timestamps.Add(Ts);
+	Track->Locations.Add(Pose.GetLocation());
+	Track->Rotations.Add(Pose.GetRotation());
+	AllocatedSize += SampleSize;
+	NumSamplesTotal++;
+
+	if (MemoryBudget > 0 && AllocatedSize > MemoryBudget)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Pose index exceeds the memory budget (%lld bytes) after %lld samples, clearing it.."),
+			*FString(__FUNCTION__), __LINE__, MemoryBudget, NumSamplesTotal);
+		Reset();
+		bOverBudget = true;
+		return false;
+	}
+	return true;
+}
+
+// Sort the tracks if samples were added out of order, the index can be queried afterwards
+void FSLMongoPoseIndex::Finish()
+{
+	if (bOverBudget)
+	{
+		return;
+	}
+
+	if (bNeedsSort)
+	{
+		for (auto& Pair : Tracks)
+		{
+			FSLMongoPoseTrack& Track = Pair.Value;
+			TArray<int32> Order;
+			Order.Reserve(Track.Num());
+			for (int32 Idx = 0; Idx < Track.Num(); ++Idx)
+			{
+				Order.Add(Idx);
+			}
+			Order.StableSort([&Track](int32 A, int32 B) { return Track.Timestamps[A] < Track.Timestamps[B]; });
+
+			FSLMongoPoseTrack Sorted;
+			Sorted.Timestamps.Reserve(Track.Num());
+			Sorted.Locations.Reserve(Track.Num());
+			Sorted.Rotations.Reserve(Track.Num());
+			for (int32 Idx : Order)
+			{
+				Sorted.Timestamps.Add(Track.Timestamps[Idx]);
+				Sorted.Locations.Add(Track.Locations[Idx]);
+				Sorted.Rotations.Add(Track.Rotations[Idx]);
+			}
+			Track = MoveTemp(Sorted);
+		}
+		bNeedsSort = false;
+	}
+
+	for (auto& Pair : Tracks)
+	{
+		Pair.Value.Timestamps.Shrink();
+		Pair.Value.Locations.Shrink();
+		Pair.Value.Rotations.Shrink();
+	}
+	bLoaded = true;
+}
+
+// Clear the index
+void FSLMongoPoseIndex::Reset()
+{
+	Tracks.Empty();
+	AllocatedSize = 0;
+	NumSamplesTotal = 0;
+	bNeedsSort = false;
+	bLoaded = false;
+	bOverBudget = false;
+}
+
+// Get the pose of the individual at the given time, optionally interpolated with the next sample
+bool FSLMongoPoseIndex::GetPoseAt(const FString& Id, float Ts, FTransform& OutPose, bool bInterpolate) const
+{
+	const FSLMongoPoseTrack* Track = Tracks.Find(Id);
+	if (!Track)
+	{
+		return false;
+	}
+
+	const int32 Idx = FindLastAtOrBefore(Track->Timestamps, Ts);
+	if (Idx == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutPose = bInterpolate ? Interpolate(*Track, Idx, Ts) : Track->GetPose(Idx);
+	return true;
+}
+
+// Get the poses of all the individuals at the given time
+void FSLMongoPoseIndex::GetFrameAt(float Ts, TMap<FString, FTransform>& OutFrame, bool bInterpolate) const
+{
+	OutFrame.Reserve(OutFrame.Num() + Tracks.Num());
+	for (const auto& Pair : Tracks)
+	{
+		const int32 Idx = FindLastAtOrBefore(Pair.Value.Timestamps, Ts);
+		if (Idx != INDEX_NONE)
+		{
+			OutFrame.Add(Pair.Key, bInterpolate ? Interpolate(Pair.Value, Idx, Ts) : Pair.Value.GetPose(Idx));
+		}
+	}
+}
+
+// Get the poses of the individual between the given timestamps
+bool FSLMongoPoseIndex::GetTrajectory(const FString& Id, float StartTs, float EndTs, TArray<FTransform>& OutTrajectory,
+	float DeltaT, bool bInterpolate) const
+{
+	FSLMongoPoseTrack Track;
+	if (GetTrack(Id, StartTs, EndTs, Track, DeltaT, bInterpolate))
+	{
+		OutTrajectory.Append(Track.GetPoses());
+		return true;
+	}
+	return false;
+}
+
+// Get the samples of the individual between the given timestamps as a track
+bool FSLMongoPoseIndex::GetTrack(const FString& Id, float StartTs, float EndTs, FSLMongoPoseTrack& OutTrack,
+	float DeltaT, bool bInterpolate) const
+{
+	const FSLMongoPoseTrack* Track = Tracks.Find(Id);
+	if (!Track)
+	{
+		return false;
+	}
+
+	if (bInterpolate && DeltaT > 0.f)
+	{
+		// Resample at fixed steps, starting from the first sample in the window
+		int32 Idx = FindLastAtOrBefore(Track->Timestamps, StartTs);
+		float Ts = StartTs;
+		if (Idx == INDEX_NONE)
+		{
+			Idx = 0;
+			Ts = Track->Timestamps[0];
+		}
+		for (; Ts <= EndTs; Ts += DeltaT)
+		{
+			while (Idx + 1 < Track->Num() && Track->Timestamps[Idx + 1] <= Ts)
+			{
+				++Idx;
+			}
+			OutTrack.Add(Ts, Interpolate(*Track, Idx, Ts));
+		}
+		return OutTrack.Num() > 0;
+	}
+
+	// First sample at or after the start time
+	int32 Idx = FindLastAtOrBefore(Track->Timestamps, StartTs);
+	if (Idx == INDEX_NONE || Track->Timestamps[Idx] < StartTs)
+	{
+		++Idx;
+	}
+
+	double PrevTs = -BIG_NUMBER;
+	for (; Idx < Track->Num() && Track->Timestamps[Idx] <= EndTs; ++Idx)
+	{
+		const float CurrTs = Track->Timestamps[Idx];
+		if (DeltaT <= 0.f || CurrTs - PrevTs > DeltaT)
+		{
+			OutTrack.Add(CurrTs, Track->GetPose(Idx));
+			PrevTs = CurrTs;
+		}
+	}
+	return OutTrack.Num() > 0;
+}
+
+// Index of the last sample at or before the given time (INDEX_NONE if there is none)
+int32 FSLMongoPoseIndex::FindLastAtOrBefore(const TArray<float>& Timestamps, float Ts)
+{
+	// Upper bound, first sample after the given time
+	int32 Lo = 0;
+	int32 Hi = Timestamps.Num();
+	while (Lo < Hi)
+	{
+		const int32 Mid = Lo + (Hi - Lo) / 2;
+		if (Timestamps[Mid] <= Ts)
+		{
+			Lo = Mid + 1;
+		}
+		else
+		{
+			Hi = Mid;
+		}
+	}
+	return Lo - 1;
+}
+
+// Pose at the given time interpolated between the sample and the next one
+FTransform FSLMongoPoseIndex::Interpolate(const FSLMongoPoseTrack& Track, int32 Idx, float Ts)
+{
+	if (Idx + 1 >= Track.Num() || Ts <= Track.Timestamps[Idx])
+	{
+		return Track.GetPose(Idx);
+	}
+
+	const float T0 = Track.Timestamps[Idx];
+	const float T1 = Track.Timestamps[Idx + 1];
+	const float Alpha = T1 > T0 ? FMath::Clamp((Ts - T0) / (T1 - T0), 0.f, 1.f) : 0.f;
+	return FTransform(
+		FQuat::Slerp(Track.Rotations[Idx], Track.Rotations[Idx + 1], Alpha),
+		FMath::Lerp(Track.Locations[Idx], Track.Locations[Idx + 1], Alpha));
+}
@@ -0,0 +1,140 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoQueryCache.h"
+
+// Set the memory budget in bytes (<= 0 disables the cache)
+void FSLMongoQueryCache::SetMemoryBudget(int64 InMemoryBudget)
+{
+	MemoryBudget = InMemoryBudget;
+
+	// Shrink to the new budget
+	while (AllocatedSize > FMath::Max<int64>(MemoryBudget, 0) && LruList.GetTail())
+	{
+		Remove(LruList.GetTail()->GetValue());
+	}
+}
+
+// Get the cached result, marks it as the most recently used
+bool FSLMongoQueryCache::Find(const FSLMongoQueryCacheKey& Key, FSLMongoQueryCacheValue& OutValue)
+{
+	if (MemoryBudget <= 0)
+	{
+		return false;
+	}
+
+	FEntry* Entry = Entries.Find(Key);
+	if (!Entry)
+	{
+		NumMisses++;
+		return false;
+	}
+	NumHits++;
+
+	// Move to the front of the usage list
+	if (Entry->Node != LruList.GetHead())
+	{
+		LruList.RemoveNode(Entry->Node, false);
+		LruList.AddHead(Entry->Node);
+	}
+	OutValue = Entry->Value;
+	return true;
+}
+
+// Store the result, evicts the least recently used ones if the budget is exceeded
+void FSLMongoQueryCache::Add(const FSLMongoQueryCacheKey& Key, const FSLMongoQueryCacheValue& Value)
+{
+	const int64 Size = CalcSize(Key, Value);
+	if (MemoryBudget <= 0 || Size > MemoryBudget)
+	{
+		return;
+	}
+
+	// Replace the previous result
+	if (Entries.Contains(Key))
+	{
+		Remove(Key);
+	}
+
+	while (AllocatedSize + Size > MemoryBudget && LruList.GetTail())
+	{
+		Remove(LruList.GetTail()->GetValue());
+	}
+
+	LruList.AddHead(Key);
+	FEntry& Entry = Entries.Add(Key);
+	Entry.Value = Value;
+	Entry.Size = Size;
+	Entry.Node = LruList.GetHead();
+	AllocatedSize += Size;
+}
+
+// Remove the results of the episode
+void FSLMongoQueryCache::Invalidate(const FString& TaskId, const FString& EpisodeId)
+{
+	RemoveIf([&TaskId, &EpisodeId](const FSLMongoQueryCacheKey& Key)
+	{
+		return Key.TaskId.Equals(TaskId, ESearchCase::CaseSensitive)
+			&& Key.EpisodeId.Equals(EpisodeId, ESearchCase::CaseSensitive);
+	});
+}
+
+// Remove the results of all the episodes of the task
+void FSLMongoQueryCache::Invalidate(const FString& TaskId)
+{
+	RemoveIf([&TaskId](const FSLMongoQueryCacheKey& Key)
+	{
+		return Key.TaskId.Equals(TaskId, ESearchCase::CaseSensitive);
+	});
+}
+
+// Remove all results
+void FSLMongoQueryCache::Reset()
+{
+	Entries.Empty();
+	LruList.Empty();
+	AllocatedSize = 0;
+}
+
+// Remove the entries matching the predicate
+template<typename PredicateType>
+void FSLMongoQueryCache::RemoveIf(PredicateType Predicate)
+{
+	TArray<FSLMongoQueryCacheKey> ToRemove;
+	for (const auto& Pair : Entries)
+	{
+		if (Predicate(Pair.Key))
+		{
+			ToRemove.Add(Pair.Key);
+		}
+	}
+	for (const auto& Key : ToRemove)
+	{
+		Remove(Key);
+	}
+}
+
+// Remove the entry and its usage node
+void FSLMongoQueryCache::Remove(const FSLMongoQueryCacheKey& Key)
+{
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Key, Entry))
+	{
+		AllocatedSize -= Entry.Size;
+		LruList.RemoveNode(Entry.Node);
+	}
+}
+
+// Approximate size of the result
+int64 FSLMongoQueryCache::CalcSize(const FSLMongoQueryCacheKey& Key, const FSLMongoQueryCacheValue& Value)
+{
+	// The key is stored in the map and in the usage list
+	int64 Size = 2 * (sizeof(FSLMongoQueryCacheKey) + Key.TaskId.GetAllocatedSize()
+		+ Key.EpisodeId.GetAllocatedSize() + Key.IndividualId.GetAllocatedSize());
+	Size += sizeof(FEntry) + Value.Poses.GetAllocatedSize() + Value.BonePoses.GetAllocatedSize();
+	for (const auto& Bones : Value.BonePoses)
+	{
+		Size += Bones.GetAllocatedSize();
+	}
+	return Size;
+}
@@ -2,10 +2,7 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "Mongo/SLMongoQueryDBHandler.h"
-
-#if SL_WITH_ROS_CONVERSIONS
-#include "Conversions.h"
-#endif // SL_WITH_ROS_CONVERSIONS
+#include "Mongo/SLMongoPipelinedReader.h"
 
 // Ctor
 FSLMongoQueryDBHandler::FSLMongoQueryDBHandler()
@@ -13,6 +10,15 @@ FSLMongoQueryDBHandler::FSLMongoQueryDBHandler()
 	bConnected = false;
 	bDatabaseSet = false;
 	bCollectionSet = false;
+	bOwnsClient = true;
+
+#if SL_WITH_LIBMONGO_C
+	uri = nullptr;
+	client = nullptr;
+	database = nullptr;
+	collection = nullptr;
+	meta_collection = nullptr;
+#endif // SL_WITH_LIBMONGO_C
 }
 
 // Dtor
@@ -88,6 +94,38 @@ bool FSLMongoQueryDBHandler::Connect(const FString& ServerIp, uint16 ServerPort)
 #endif // SL_WITH_LIBMONGO_C
 }
 
+#if SL_WITH_LIBMONGO_C
+// Use a client owned by the caller (e.g. popped from a client pool), it is not destroyed on disconnect
+bool FSLMongoQueryDBHandler::SetClient(mongoc_client_t* InClient)
+{
+	if (bConnected)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Handler is already connected to the server.."), *FString(__func__), __LINE__);
+		return false;
+	}
+	if (!InClient)
+	{
+		return false;
+	}
+	client = InClient;
+	bOwnsClient = false;
+	bConnected = true;
+	return true;
+}
+#endif // SL_WITH_LIBMONGO_C
+
+// Get the server uri (empty if not connected)
+FString FSLMongoQueryDBHandler::GetUri() const
+{
+#if SL_WITH_LIBMONGO_C
+	if (client)
+	{
+		return FString(mongoc_uri_get_string(mongoc_client_get_uri(client)));
+	}
+#endif // SL_WITH_LIBMONGO_C
+	return FString();
+}
+
 // Set database
 bool FSLMongoQueryDBHandler::SetDatabase(const FString& InDBName)
 {
@@ -187,6 +225,9 @@ bool FSLMongoQueryDBHandler::SetCollection(const FString& InCollName)
 
 	// Set collection
 	collection = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*InCollName));
+
+	// Layout of the episode documents, the query pipelines are generated from it
+	LoadSchema(InCollName);
 	bCollectionSet = true;
 	return true;
 #else
@@ -208,22 +249,35 @@ void FSLMongoQueryDBHandler::Disconnect()
 	if (meta_collection)
 	{
 		mongoc_collection_destroy(meta_collection);
+		meta_collection = nullptr;
 	}
 	if (collection)
 	{
 		mongoc_collection_destroy(collection);
+		collection = nullptr;
 	}
 	if (database)
 	{
 		mongoc_database_destroy(database);
+		database = nullptr;
+	}
+
+	// A borrowed client is returned by its owner
+	if (!bOwnsClient)
+	{
+		client = nullptr;
+		bOwnsClient = true;
+		return;
 	}
 	if (uri)
 	{
 		mongoc_uri_destroy(uri);
+		uri = nullptr;
 	}
 	if (client)
 	{
 		mongoc_client_destroy(client);
+		client = nullptr;
 	}
 	mongoc_cleanup();
 #endif //SL_WITH_LIBMONGO_C
@@ -248,43 +302,7 @@ FTransform FSLMongoQueryDBHandler::GetIndividualPoseAt(const FString& Id, float
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
-	pipeline = BCON_NEW("pipeline", "[",
-		"{",
-			"$match",
-			"{",
-				"timestamp", "{", "$lte", BCON_DOUBLE(Ts), "}",
-				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
-			"}",
-		"}",
-		"{",
-			"$sort",
-			"{",
-				"timestamp", BCON_INT32(-1),							// required to get the last pose (no time penalty if the collection is indexed)
-			"}",
-		"}",
-		"{",
-			"$limit", BCON_INT32(1),
-		"}",
-		"{",
-			"$unwind", BCON_UTF8("$individuals"),
-		"}",
-		"{",
-			"$match",
-			"{",
-				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// match against the searched id in the unwinded array (has all individuals from the doc)
-			"}",
-		"}",
-		"{",
-			"$project",
-			"{",
-				"_id", BCON_INT32(0),
-				"timestamp", BCON_INT32(1),
-				"loc", BCON_UTF8("$individuals.loc"),
-				"quat", BCON_UTF8("$individuals.quat"),
-				"pose", BCON_UTF8("$individuals.pose"),
-			"}",
-		"}",
-		"]");
+	pipeline = Schema.CreatePoseAtPipeline(Id, Ts);
 
 	cursor = mongoc_collection_aggregate(
 		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
@@ -331,44 +349,13 @@ TArray<FTransform> FSLMongoQueryDBHandler::GetIndividualTrajectory(const FString
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
-	pipeline = BCON_NEW("pipeline", "[",
-		"{",
-			"$match",
-			"{",
-				"timestamp", 
-				"{", 
-					"$gte", BCON_DOUBLE(StartTs),
-					"$lte", BCON_DOUBLE(EndTs),
-				"}",
-				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
-			"}",
-		"}",
-		"{",
-			"$sort",
-			"{",
-				"timestamp", BCON_INT32(1),								// no time penalty if the collection is indexed
-			"}",
-		"}",
-		"{",
-			"$unwind", BCON_UTF8("$individuals"),
-		"}",
-		"{",
-			"$match",
-			"{",
-				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// match against the searched id in the unwinded array (has all individuals from the doc)
-			"}",
-		"}",
-		"{",
-			"$project",
-			"{",
-				"_id", BCON_INT32(0),
-				"timestamp", BCON_INT32(1),
-				"loc", BCON_UTF8("$individuals.loc"),
-				"quat", BCON_UTF8("$individuals.quat"),
-				"pose", BCON_UTF8("$individuals.pose"),
-			"}",
-		"}",
-		"]");
+	pipeline = Schema.CreateTrajectoryPipeline(Id, StartTs, EndTs);
+
+	// Only one pose per DeltaT interval is sent over
+	if (DeltaT > 0.f)
+	{
+		pipeline = AppendDownsampleStages(pipeline, StartTs, DeltaT);
+	}
 
 	cursor = mongoc_collection_aggregate(
 		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
@@ -377,25 +364,9 @@ TArray<FTransform> FSLMongoQueryDBHandler::GetIndividualTrajectory(const FString
 	// Read cursor if no errors occured
 	if (!mongoc_cursor_error(cursor, &error))
 	{
-		if (DeltaT > 0.f)
-		{
-			double PrevTs = -BIG_NUMBER;
-			while (mongoc_cursor_next(cursor, &doc))
-			{
-				double CurrTs = GetTs(doc);
-				if (CurrTs - PrevTs > DeltaT)
-				{
-					Trajectory.Add(GetPose(doc));
-					PrevTs = CurrTs;
-				}
-			}
-		}
-		else
+		while (mongoc_cursor_next(cursor, &doc))
 		{
-			while (mongoc_cursor_next(cursor, &doc))
-			{
-				Trajectory.Add(GetPose(doc));
-			}
+			Trajectory.Add(GetPose(doc));
 		}
 	}
 	else
@@ -435,44 +406,7 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
-	pipeline = BCON_NEW("pipeline", "[",
-		"{",
-			"$match",
-			"{",
-				"timestamp", "{", "$lte", BCON_DOUBLE(Ts), "}",
-				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
-			"}",
-		"}",
-		"{",
-			"$sort",
-			"{",
-				"timestamp", BCON_INT32(-1),
-			"}",
-		"}",
-		"{",
-			"$limit", BCON_INT32(1),
-		"}",
-		"{",
-			"$unwind", BCON_UTF8("$skel_individuals"),
-		"}",
-		"{",
-			"$match",
-			"{",
-				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// match against the searched id in the unwinded array (has all individuals from the doc)
-			"}",
-		"}",
-		"{",
-			"$project",
-			"{",
-				"_id", BCON_INT32(0),
-				"timestamp", BCON_INT32(1),
-				"bones", BCON_UTF8("$skel_individuals.bones"),		// bones data (index, loc, quat)
-				"loc", BCON_UTF8("$skel_individuals.loc"),			// actor loc
-				"quat", BCON_UTF8("$skel_individuals.quat"),		// actor quat
-				"pose", BCON_UTF8("$skel_individuals.pose"),
-			"}",
-		"}",
-		"]");
+	pipeline = Schema.CreateSkeletalPoseAtPipeline(mongoc_collection_get_name(collection), Id, Ts);
 
 	cursor = mongoc_collection_aggregate(
 		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
@@ -540,46 +474,13 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSk
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
-	pipeline = BCON_NEW("pipeline", "[",
-		"{",
-			"$match",
-			"{",
-				"timestamp", 
-				"{", 
-					"$gte", BCON_DOUBLE(StartTs),
-					"$lte", BCON_DOUBLE(EndTs),
-				"}",
-				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
-			"}",
-		"}",
-		"{",
-			"$sort",
-			"{",
-				"timestamp", BCON_INT32(1),								// if sort if right after match it barely adds any time penalty
-			"}",
-		"}",
-		"{",
-			"$unwind", BCON_UTF8("$skel_individuals"),
-		"}",
-		"{",
-			"$match",
-			"{",
-				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// match against the searched id in the unwinded array (has all individuals from the doc)
-			"}",
-		"}",
-		"{",
-			"$project",
-			"{",
-				"_id", BCON_INT32(0),
-				"timestamp", BCON_INT32(1),
-				"bones", BCON_UTF8("$skel_individuals.bones"),		// bones data (index, loc, quat)
-				"loc", BCON_UTF8("$skel_individuals.loc"),			// actor loc
-				"quat", BCON_UTF8("$skel_individuals.quat"),		// actor quat
-				"pose", BCON_UTF8("$skel_individuals.pose"),
+	pipeline = Schema.CreateSkeletalTrajectoryPipeline(mongoc_collection_get_name(collection), Id, StartTs, EndTs);
 
-			"}",
-		"}",
-		"]");
+	// Only one pose per DeltaT interval is sent over
+	if (DeltaT > 0.f)
+	{
+		pipeline = AppendDownsampleStages(pipeline, StartTs, DeltaT);
+	}
 
 	cursor = mongoc_collection_aggregate(
 		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
@@ -588,25 +489,176 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSk
 	// Read cursor if no errors occured
 	if (!mongoc_cursor_error(cursor, &error))
 	{
-		if (DeltaT > 0.f)
+		while (mongoc_cursor_next(cursor, &doc))
 		{
-			double PrevTs = -BIG_NUMBER;
-			while (mongoc_cursor_next(cursor, &doc))
+			TPair<FTransform, TMap<int32, FTransform>> SkeletalPosePair;
+			SkeletalPosePair.Key = GetPose(doc);
+
+			// Get bones data
+			bson_iter_t bones;
+			if (bson_iter_init(&bones, doc) && bson_iter_find(&bones, "bones"))
 			{
-				double CurrTs = GetTs(doc);
-				if (CurrTs - PrevTs > DeltaT)
+				bson_iter_t bone;
+				if (bson_iter_recurse(&bones, &bone))
+				{
+					int32 BoneIndex;
+					bson_iter_t value;
+					while (bson_iter_next(&bone))
+					{
+						if (bson_iter_recurse(&bone, &value) && bson_iter_find(&value, "idx"))
+						{
+							BoneIndex = bson_iter_int32(&value);
+						}
+						SkeletalPosePair.Value.Emplace(BoneIndex, GetPose(&bone));
+					}
+				}
+			}
+			SkeletalTrajectoryPair.Add(SkeletalPosePair);
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	double CursorReadDuration = FPlatformTime::Seconds() - ExecBegin - QueryDuration;
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(pipeline);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds, Num=[%d]..;"),
+		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin, SkeletalTrajectoryPair.Num());
+#endif
+	if (SkeletalTrajectoryPair.Num() == 0)
+	{
+		SkeletalTrajectoryPair.Add(GetSkeletalIndividualPoseAt(Id, StartTs));
+	}
+	return SkeletalTrajectoryPair;
+}
+
+// Get the trajectories of the individuals between the given timestamps in a single aggregation
+TMap<FString, FSLMongoPoseTrack> FSLMongoQueryDBHandler::GetIndividualsTrajectories(const TArray<FString>& Ids, float StartTs, float EndTs, float DeltaT) const
+{
+	TMap<FString, FSLMongoPoseTrack> Trajectories;
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return Trajectories;
+	}
+	if (Ids.Num() == 0)
+	{
+		return Trajectories;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	double ExecBegin = FPlatformTime::Seconds();
+
+	bson_error_t error;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *pipeline = Schema.CreateFramesPipeline(Ids, StartTs, EndTs);
+
+	// Only one pose per individual and DeltaT interval is sent over
+	if (DeltaT > 0.f)
+	{
+		pipeline = AppendFramesDownsampleStages(pipeline, "individuals", StartTs, DeltaT);
+	}
+
+	cursor = mongoc_collection_aggregate(
+		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
+	double QueryDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	int32 NumPoses = 0;
+	// Read cursor if no errors occured
+	if (!mongoc_cursor_error(cursor, &error))
+	{
+		while (mongoc_cursor_next(cursor, &doc))
+		{
+			double CurrTs = 0.0;
+			FSLMongoFrameDecoder::DecodeFrame(doc, "individuals", CurrTs,
+				[&Trajectories, &CurrTs, &NumPoses](FString&& Id, const FTransform& Pose)
 				{
-					TPair<FTransform, TMap<int32, FTransform>> SkeletalPosePair;
-					SkeletalPosePair.Key = GetPose(doc);
+					Trajectories.FindOrAdd(MoveTemp(Id)).Add(CurrTs, Pose);
+					NumPoses++;
+				});
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	double CursorReadDuration = FPlatformTime::Seconds() - ExecBegin - QueryDuration;
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(pipeline);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds, Individuals=[%d/%d], Num=[%d]..;"),
+		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin, Trajectories.Num(), Ids.Num(), NumPoses);
+#endif // SL_WITH_LIBMONGO_C
+	return Trajectories;
+}
+
+// Get the trajectories of the skeletal individuals between the given timestamps in a single aggregation
+TMap<FString, FSLMongoSkeletalPoseTrack> FSLMongoQueryDBHandler::GetSkeletalIndividualsTrajectories(const TArray<FString>& Ids, float StartTs, float EndTs, float DeltaT) const
+{
+	TMap<FString, FSLMongoSkeletalPoseTrack> Trajectories;
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return Trajectories;
+	}
+	if (Ids.Num() == 0)
+	{
+		return Trajectories;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	double ExecBegin = FPlatformTime::Seconds();
+
+	bson_error_t error;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *pipeline = Schema.CreateSkeletalFramesPipeline(mongoc_collection_get_name(collection), Ids, StartTs, EndTs);
+
+	// Only one pose per skeletal individual and DeltaT interval is sent over
+	if (DeltaT > 0.f)
+	{
+		pipeline = AppendFramesDownsampleStages(pipeline, "skel_individuals", StartTs, DeltaT);
+	}
+
+	cursor = mongoc_collection_aggregate(
+		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
+	double QueryDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	int32 NumPoses = 0;
+	// Read cursor if no errors occured
+	if (!mongoc_cursor_error(cursor, &error))
+	{
+		while (mongoc_cursor_next(cursor, &doc))
+		{
+			const double CurrTs = GetTs(doc);
+			bson_iter_t individuals_iter;
+			if (bson_iter_init_find(&individuals_iter, doc, "skel_individuals") && bson_iter_recurse(&individuals_iter, &individuals_iter))
+			{
+				while (bson_iter_next(&individuals_iter))
+				{
+					bson_iter_t individual_val_iter;
+					if (!bson_iter_recurse(&individuals_iter, &individual_val_iter) || !bson_iter_find(&individual_val_iter, "id"))
+					{
+						continue;
+					}
+
+					FSLMongoSkeletalPoseTrack& SkelTrack = Trajectories.FindOrAdd(FString(bson_iter_utf8(&individual_val_iter, NULL)));
+					SkelTrack.Track.Add(CurrTs, GetPose(&individuals_iter));
+					NumPoses++;
 
 					// Get bones data
 					bson_iter_t bones;
-					if (bson_iter_init(&bones, doc) && bson_iter_find(&bones, "bones"))
+					if (bson_iter_recurse(&individuals_iter, &bones) && bson_iter_find(&bones, "bones"))
 					{
 						bson_iter_t bone;
 						if (bson_iter_recurse(&bones, &bone))
 						{
-							int32 BoneIndex;
+							int32 BoneIndex = INDEX_NONE;
 							bson_iter_t value;
 							while (bson_iter_next(&bone))
 							{
@@ -614,42 +666,11 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSk
 								{
 									BoneIndex = bson_iter_int32(&value);
 								}
-								SkeletalPosePair.Value.Emplace(BoneIndex, GetPose(&bone));
-							}
-						}
-					}
-					SkeletalTrajectoryPair.Add(SkeletalPosePair);
-					PrevTs = CurrTs;
-				}
-			}
-		}
-		else
-		{
-			while (mongoc_cursor_next(cursor, &doc))
-			{
-				TPair<FTransform, TMap<int32, FTransform>> SkeletalPosePair;
-				SkeletalPosePair.Key = GetPose(doc);
-
-				// Get bones data
-				bson_iter_t bones;
-				if (bson_iter_init(&bones, doc) && bson_iter_find(&bones, "bones"))
-				{
-					bson_iter_t bone;
-					if (bson_iter_recurse(&bones, &bone))
-					{
-						int32 BoneIndex;
-						bson_iter_t value;
-						while (bson_iter_next(&bone))
-						{
-							if (bson_iter_recurse(&bone, &value) && bson_iter_find(&value, "idx"))
-							{
-								BoneIndex = bson_iter_int32(&value);
+								SkelTrack.BoneTracks.FindOrAdd(BoneIndex).Add(CurrTs, GetPose(&bone));
 							}
-							SkeletalPosePair.Value.Emplace(BoneIndex, GetPose(&bone));
 						}
 					}
 				}
-				SkeletalTrajectoryPair.Add(SkeletalPosePair);
 			}
 		}
 	}
@@ -662,14 +683,10 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSk
 
 	mongoc_cursor_destroy(cursor);
 	bson_destroy(pipeline);
-	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds, Num=[%d]..;"),
-		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin, SkeletalTrajectoryPair.Num());
-#endif
-	if (SkeletalTrajectoryPair.Num() == 0)
-	{
-		SkeletalTrajectoryPair.Add(GetSkeletalIndividualPoseAt(Id, StartTs));
-	}
-	return SkeletalTrajectoryPair;
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds, Individuals=[%d/%d], Num=[%d]..;"),
+		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin, Trajectories.Num(), Ids.Num(), NumPoses);
+#endif // SL_WITH_LIBMONGO_C
+	return Trajectories;
 }
 
 // Get the whole episode data
@@ -687,35 +704,10 @@ TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpiso
 
 	bson_error_t error;
 	bson_t opts;
-	const bson_t *doc;
 	mongoc_cursor_t *cursor;
 	bson_t *pipeline;
 
-	pipeline = BCON_NEW("pipeline", "[",
-		"{",
-			"$match",
-			"{",
-				"timestamp", 
-				"{",
-					"$exists", BCON_BOOL(true),
-				"}",
-			"}",
-		"}",
-		"{",
-			"$sort",
-			"{",
-				"timestamp", BCON_INT32(1),
-			"}",
-		"}",
-		"{",
-			"$project",
-			"{",
-				"_id", BCON_INT32(0),
-				"timestamp", BCON_INT32(1),
-				"individuals", BCON_UTF8("$individuals"),
-			"}",
-		"}",
-		"]");
+	pipeline = Schema.CreateEpisodePipeline();
 
 	// If the episode is very large the hard drive needs to be used to cache results
 	bson_init(&opts);
@@ -725,40 +717,29 @@ TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpiso
 
 	double QueryDuration = FPlatformTime::Seconds() - ExecBegin;
 
-	int32 FrameIdx = 0;
-	// Read cursor if no errors occured
+	// Read cursor if no errors occured, the batches are decoded in parallel and appended in order
 	if (!mongoc_cursor_error(cursor, &error))
 	{
-		while (mongoc_cursor_next(cursor, &doc))
+		FSLMongoPipelinedReader Reader;
+		const bool bRead = Reader.Read(cursor, [&EpisodeData](TArray<TPair<float, TMap<FString, FTransform>>>&& Frames)
 		{
-			if (FrameIdx++ % 250 == 0) { UE_LOG(LogTemp, Log, TEXT(" mongo processing frame %d .."), FrameIdx++); }
-			bson_iter_t frame_iter;
-			if (bson_iter_init(&frame_iter, doc))
+			if (EpisodeData.Num() == 0)
 			{
-				TMap<FString, FTransform> CurrIndividualsData;
-				float CurrTs;
-				
-				if (bson_iter_find(&frame_iter, "timestamp"))
-				{
-					CurrTs = bson_iter_double(&frame_iter);
-				}
-
-				bson_iter_t individuals_iter;
-				if (bson_iter_find(&frame_iter, "individuals") && bson_iter_recurse(&frame_iter, &individuals_iter))
-				{
-					while (bson_iter_next(&individuals_iter))
-					{
-						FString Id;
-						bson_iter_t individual_val_iter;
-						if (bson_iter_recurse(&individuals_iter, &individual_val_iter) && bson_iter_find(&individual_val_iter, "id"))
-						{
-							Id = FString(bson_iter_utf8(&individual_val_iter, NULL));
-						}
-						CurrIndividualsData.Emplace(Id, GetPose(&individuals_iter));
-					}
-				}
-				EpisodeData.Emplace(CurrTs, CurrIndividualsData);
+				EpisodeData = MoveTemp(Frames);
+			}
+			else
+			{
+				EpisodeData.Append(MoveTemp(Frames));
 			}
+			UE_LOG(LogTemp, Verbose, TEXT("%s::%d Mongo processed %d frames.."), *FString(__func__), __LINE__, EpisodeData.Num());
+		});
+
+		// The cursor failed while reading, do not return a truncated episode
+		if (!bRead)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read the whole episode (failed after %d frames), discarding the data.."),
+				*FString(__func__), __LINE__, EpisodeData.Num());
+			EpisodeData.Empty();
 		}
 	}
 	else
@@ -776,177 +757,365 @@ TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpiso
 	return EpisodeData;
 }
 
-// Get the whole episode data in an async thread
-TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpisodeDataAsync() const
+// Load the poses of all the individuals of the episode into the index (fails if the index memory budget is exceeded)
+bool FSLMongoQueryDBHandler::LoadPoseIndex(FSLMongoPoseIndex& OutIndex) const
 {
-	// TODO
-	return TArray<TPair<float, TMap<FString, FTransform>>>();
-}
-
-// Get the episode data at the given timestamp (frame)
-TMap<FString, FTransform> FSLMongoQueryDBHandler::GetFrameData(float Ts)
-{
-	return TMap<FString, FTransform>();
-}
+	OutIndex.Reset();
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
 
-/* Helpers */
 #if SL_WITH_LIBMONGO_C
-// Get the pose data from document
-FTransform FSLMongoQueryDBHandler::GetPose(const bson_t* doc) const
-{
-	FVector Loc;
-	FQuat Quat;
+	double ExecBegin = FPlatformTime::Seconds();
 
-	bson_iter_t iter;
-	bson_iter_t value;
+	bson_error_t error;
+	bson_t opts;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *pipeline;
+
+	// Samples are appended in order, no sorting needed in the index
+	pipeline = Schema.CreateEpisodePipeline();
+
+	// If the episode is very large the hard drive needs to be used to cache results
+	bson_init(&opts);
+	BSON_APPEND_BOOL(&opts, "allowDiskUse", true);
+	cursor = mongoc_collection_aggregate(
+		collection, MONGOC_QUERY_NONE, pipeline, &opts, NULL);
+
+	double QueryDuration = FPlatformTime::Seconds() - ExecBegin;
 
-	if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, "loc.x", &value)/* && BSON_ITER_HOLDS_DOUBLE(&value)*/)
+	bool bWithinBudget = true;
+	// Read cursor if no errors occured
+	if (!mongoc_cursor_error(cursor, &error))
 	{
-		Loc.X = bson_iter_double(&value);
+		while (bWithinBudget && mongoc_cursor_next(cursor, &doc))
+		{
+			double CurrTs = 0.0;
+			FSLMongoFrameDecoder::DecodeFrame(doc, "individuals", CurrTs,
+				[&OutIndex, &CurrTs, &bWithinBudget](FString&& Id, const FTransform& Pose)
+				{
+					bWithinBudget = bWithinBudget && OutIndex.Add(Id, CurrTs, Pose);
+				});
+		}
 	}
-	if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, "loc.y", &value)/* && BSON_ITER_HOLDS_DOUBLE(&value)*/)
+	else
 	{
-		Loc.Y = bson_iter_double(&value);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bWithinBudget = false;
 	}
-	if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, "loc.z", &value)/* && BSON_ITER_HOLDS_DOUBLE(&value)*/)
+	double CursorReadDuration = FPlatformTime::Seconds() - ExecBegin - QueryDuration;
+
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(pipeline);
+	bson_destroy(&opts);
+
+	if (bWithinBudget)
 	{
-		Loc.Z = bson_iter_double(&value);
+		OutIndex.Finish();
 	}
-	if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, "quat.x", &value)/* && BSON_ITER_HOLDS_DOUBLE(&value)*/)
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor=[%f], total=[%f] seconds, Individuals=[%d], Samples=[%lld], Bytes=[%lld], Loaded=[%s]..;"),
+		*FString(__func__), __LINE__, QueryDuration, CursorReadDuration, FPlatformTime::Seconds() - ExecBegin,
+		OutIndex.Num(), OutIndex.NumSamples(), OutIndex.GetAllocatedSize(), OutIndex.IsLoaded() ? TEXT("true") : TEXT("false"));
+	return OutIndex.IsLoaded();
+#else
+	return false;
+#endif // SL_WITH_LIBMONGO_C
+}
+
+// Get the uncompressed size in bytes of the episode documents (collStats), -1 if unknown
+int64 FSLMongoQueryDBHandler::GetEpisodeDataSize() const
+{
+	if (!IsReady())
 	{
-		Quat.X = bson_iter_double(&value);
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return -1;
 	}
-	if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, "quat.y", &value)/* && BSON_ITER_HOLDS_DOUBLE(&value)*/)
+
+	int64 Size = -1;
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	bson_t reply;
+	bson_t* stats_cmd = BCON_NEW("collStats", BCON_UTF8(mongoc_collection_get_name(collection)));
+	if (mongoc_database_command_simple(database, stats_cmd, NULL, &reply, &error))
 	{
-		Quat.Y = bson_iter_double(&value);
+		bson_iter_t iter;
+		if (bson_iter_init_find(&iter, &reply, "size"))
+		{
+			Size = (int64)FSLMongoFrameDecoder::GetDouble(&iter);
+		}
 	}
-	if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, "quat.z", &value)/* && BSON_ITER_HOLDS_DOUBLE(&value)*/)
+	else
 	{
-		Quat.Z = bson_iter_double(&value);
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not get the episode stats, err.:%s"),
+			*FString(__FUNCTION__), __LINE__, *FString(error.message));
 	}
-	if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, "quat.w", &value)/* && BSON_ITER_HOLDS_DOUBLE(&value)*/)
+	bson_destroy(&reply);
+	bson_destroy(stats_cmd);
+#endif // SL_WITH_LIBMONGO_C
+	return Size;
+}
+
+// Start loading the whole episode data in the background (own connection), the frames can be consumed while loading
+TSharedPtr<FSLMongoEpisodeLoader> FSLMongoQueryDBHandler::GetEpisodeDataAsync(int32 BatchSize) const
+{
+	TSharedPtr<FSLMongoEpisodeLoader> Loader = MakeShareable(new FSLMongoEpisodeLoader());
+	if (!IsReady())
 	{
-		Quat.W = bson_iter_double(&value);
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return Loader;
 	}
 
-	// using pose[x y z qx qy qz qw]
-	//bson_iter_t iter;
-	//const uint8_t *data = NULL;
-	//uint32_t len = 0;
-	//
-	//if (bson_iter_init_find(&iter, doc, "pose"))
-	//{
-	//	bson_iter_array(&iter, &len, &data);
-	//	bson_t * pose_arr = bson_new_from_data(data, len);
-	//	bson_iter_t pose_iter;
-	//	bson_iter_init(&pose_iter, pose_arr);
-	//	
-	//	bson_iter_find(&pose_iter, "0");
-	//	Loc.X = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "1");
-	//	Loc.Y = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "2");
-	//	Loc.Z = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "3");
-	//	Quat.X = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "4");
-	//	Quat.Y = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "5");
-	//	Quat.Z = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "6");
-	//	Quat.W = bson_iter_double(&pose_iter);
-	//}
-
-	Quat.Normalize();
-#if SL_WITH_ROS_CONVERSIONS
-	return FConversions::ROSToU(FTransform(Quat, Loc));
-#else
-	return FTransform(Quat, Loc);
-#endif // SL_WITH_ROS_CONVERSIONS	
+#if SL_WITH_LIBMONGO_C
+	// The mongo client is not thread safe, the loader connects with the same uri
+	Loader->Start(GetUri(),
+		FString(mongoc_database_get_name(database)),
+		FString(mongoc_collection_get_name(collection)),
+		Schema,
+		BatchSize);
+#endif // SL_WITH_LIBMONGO_C
+	return Loader;
 }
 
-// Get the pose data from iterator
-FTransform FSLMongoQueryDBHandler::GetPose(const bson_iter_t* iter) const
+// Get the episode data at the given timestamp (frame), rebuilt from the previous keyframe and the following sparse documents
+TMap<FString, FTransform> FSLMongoQueryDBHandler::GetFrameData(float Ts) const
 {
-	FVector Loc;
-	FQuat Quat;
+	TMap<FString, FTransform> FrameData;
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return FrameData;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	double ExecBegin = FPlatformTime::Seconds();
 
-	bson_iter_t value;
-	bson_iter_t sub_value;
+	bson_error_t error;
+	const bson_t *doc;
+	mongoc_cursor_t *cursor;
+	bson_t *pipeline;
 
-	if (bson_iter_recurse(iter, &value) && bson_iter_find_descendant(&value, "loc.x", &sub_value))
+	// Latest keyframe at or before the given time
+	double KeyframeTs = -1.0;
+	pipeline = Schema.CreateKeyframePipeline(Ts);
+	cursor = mongoc_collection_aggregate(
+		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
+	if (mongoc_cursor_next(cursor, &doc))
 	{
-		Loc.X = bson_iter_double(&sub_value);
+		KeyframeTs = GetTs(doc);
+		ApplyFrameDoc(doc, FrameData);
 	}
-	if (bson_iter_recurse(iter, &value) && bson_iter_find_descendant(&value, "loc.y", &sub_value))
+	else if (mongoc_cursor_error(cursor, &error))
 	{
-		Loc.Y = bson_iter_double(&sub_value);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
 	}
-	if (bson_iter_recurse(iter, &value) && bson_iter_find_descendant(&value, "loc.z", &sub_value))
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(pipeline);
+	double KeyframeDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	// Sparse frames between the keyframe and the given time (from the episode start if there is no keyframe)
+	int32 NumDeltas = 0;
+	pipeline = Schema.CreateFramesPipeline(TArray<FString>(), KeyframeTs, Ts, true);
+	cursor = mongoc_collection_aggregate(
+		collection, MONGOC_QUERY_NONE, pipeline, NULL, NULL);
+	while (mongoc_cursor_next(cursor, &doc))
 	{
-		Loc.Z = bson_iter_double(&sub_value);
+		ApplyFrameDoc(doc, FrameData);
+		NumDeltas++;
 	}
-	if (bson_iter_recurse(iter, &value) && bson_iter_find_descendant(&value, "quat.x", &sub_value))
+	if (mongoc_cursor_error(cursor, &error))
 	{
-		Quat.X = bson_iter_double(&sub_value);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
 	}
-	if (bson_iter_recurse(iter, &value) && bson_iter_find_descendant(&value, "quat.y", &sub_value))
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(pipeline);
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: keyframe=[%f], total=[%f] seconds, KeyframeTs=[%f], Deltas=[%d], Individuals=[%d]..;"),
+		*FString(__func__), __LINE__, KeyframeDuration, FPlatformTime::Seconds() - ExecBegin,
+		KeyframeTs, NumDeltas, FrameData.Num());
+#endif // SL_WITH_LIBMONGO_C
+	return FrameData;
+}
+
+/* Helpers */
+#if SL_WITH_LIBMONGO_C
+// Load the schema of the episode from the meta collection (frames layout if none is stored) and make sure its indexes exist
+void FSLMongoQueryDBHandler::LoadSchema(const FString& EpisodeId)
+{
+	Schema = FSLMongoSchema::Frames();
+
+	bson_error_t error;
+	const bson_t *doc;
+	bson_t* filter = FSLMongoSchema::CreateMetadataFilter(EpisodeId);
+	mongoc_cursor_t* cursor = mongoc_collection_find_with_opts(meta_collection, filter, NULL, NULL);
+	if (mongoc_cursor_next(cursor, &doc))
 	{
-		Quat.Y = bson_iter_double(&sub_value);
+		if (!FSLMongoSchema::FromMetadataDoc(doc, Schema))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not read the schema of %s, using the frames layout.."),
+				*FString(__FUNCTION__), __LINE__, *EpisodeId);
+			Schema = FSLMongoSchema::Frames();
+		}
 	}
-	if (bson_iter_recurse(iter, &value) && bson_iter_find_descendant(&value, "quat.z", &sub_value))
+	else if (mongoc_cursor_error(cursor, &error))
 	{
-		Quat.Z = bson_iter_double(&sub_value);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__FUNCTION__), __LINE__, *FString(error.message));
 	}
-	if (bson_iter_recurse(iter, &value) && bson_iter_find_descendant(&value, "quat.w", &sub_value))
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+
+	// Creating existing indexes is a no-op on the server, older episodes get the indexes their pipelines use
+	bson_t* index_command = Schema.CreateIndexesCommand(mongoc_collection_get_name(collection));
+	if (!mongoc_collection_write_command_with_opts(collection, index_command, NULL, NULL, &error))
 	{
-		Quat.W = bson_iter_double(&sub_value);
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not create the indexes of %s, queries might be slow, err.:%s"),
+			*FString(__FUNCTION__), __LINE__, *EpisodeId, *FString(error.message));
 	}
+	bson_destroy(index_command);
 
-	// using pose[x y z qx qy qz qw]
-	//const uint8_t *data = NULL;
-	//uint32_t len = 0;
-	//bson_iter_t  value;
-	//if (bson_iter_recurse(iter, &value) && bson_iter_find(&value, "pose"))
-	//{
-	//	bson_iter_array(&value, &len, &data);
-	//	bson_t * pose_arr = bson_new_from_data(data, len);
-	//	bson_iter_t pose_iter;
-	//	bson_iter_init(&pose_iter, pose_arr);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s uses the %s layout (schema v%d).."),
+		*FString(__FUNCTION__), __LINE__, *EpisodeId, Schema.GetLayoutName(), Schema.Version);
+}
 
-	//	bson_iter_find(&pose_iter, "0");
-	//	Loc.X = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "1");
-	//	Loc.Y = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "2");
-	//	Loc.Z = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "3");
-	//	Quat.X = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "4");
-	//	Quat.Y = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "5");
-	//	Quat.Z = bson_iter_double(&pose_iter);
-	//	bson_iter_find(&pose_iter, "6");
-	//	Quat.W = bson_iter_double(&pose_iter);
-	//}
-	//
+// Get the pose data from document
+FTransform FSLMongoQueryDBHandler::GetPose(const bson_t* doc)
+{
+	FTransform Pose;
+	FSLMongoFrameDecoder::DecodePose(doc, Pose);
+	return Pose;
+}
 
-	Quat.Normalize();
-#if SL_WITH_ROS_CONVERSIONS
-	return FConversions::ROSToU(FTransform(Quat, Loc));
-#else
-	return FTransform(Quat, Loc);
-#endif // SL_WITH_ROS_CONVERSIONS	
+// Get the pose data from iterator
+FTransform FSLMongoQueryDBHandler::GetPose(const bson_iter_t* iter)
+{
+	FTransform Pose;
+	FSLMongoFrameDecoder::DecodePose(iter, Pose);
+	return Pose;
 }
 
 // Get the timestamp value from document (used for trajectory delta time comparison)
-double FSLMongoQueryDBHandler::GetTs(const bson_t* doc) const
+double FSLMongoQueryDBHandler::GetTs(const bson_t* doc)
 {
 	bson_iter_t iter;
-	if (bson_iter_init(&iter, doc) && bson_iter_find(&iter, "timestamp"))
+	if (bson_iter_init_find(&iter, doc, "timestamp"))
 	{
-		return bson_iter_double(&iter);
+		return FSLMongoFrameDecoder::GetDouble(&iter);
 	}
 	return -1.f;
 }
+
+// Apply the individual poses of the frame document to the frame data
+void FSLMongoQueryDBHandler::ApplyFrameDoc(const bson_t* doc, TMap<FString, FTransform>& OutFrameData)
+{
+	double Ts = 0.0;
+	FSLMongoFrameDecoder::DecodeFrame(doc, "individuals", Ts,
+		[&OutFrameData](FString&& Id, const FTransform& Pose) { OutFrameData.Add(MoveTemp(Id), Pose); });
+}
+
+// Append the stages keeping only the first document of every DeltaT interval (resampled on the server), the input pipeline is destroyed
+bson_t* FSLMongoQueryDBHandler::AppendDownsampleStages(bson_t* pipeline, float StartTs, float DeltaT)
+{
+	// Bucket the (sorted) documents by the interval index and keep the first one of each bucket
+	bson_t* group = BCON_NEW(
+		"$group",
+		"{",
+			"_id",
+			"{",
+				"$floor",
+				"{",
+					"$divide", "[", "{", "$subtract", "[", BCON_UTF8("$timestamp"), BCON_DOUBLE(StartTs), "]", "}", BCON_DOUBLE(DeltaT), "]",
+				"}",
+			"}",
+			"doc", "{", "$first", BCON_UTF8("$$ROOT"), "}",
+		"}");
+	bson_t* replace_root = BCON_NEW("$replaceRoot", "{", "newRoot", BCON_UTF8("$doc"), "}");
+	bson_t* sort = BCON_NEW("$sort", "{", "timestamp", BCON_INT32(1), "}");		// the groups are not ordered
+
+	return AppendStages(pipeline, { group, replace_root, sort });
+}
+
+// Append the stages keeping only the first entry of every individual of the frames array in every DeltaT interval,
+// the entries are regrouped into frames (resampled on the server), the input pipeline is destroyed
+bson_t* FSLMongoQueryDBHandler::AppendFramesDownsampleStages(bson_t* pipeline, const char* ArrayField, float StartTs, float DeltaT)
+{
+	// The individuals are only written when they move, a frame does not hold all of them, so the buckets are per individual
+	const FString ArrayVar = FString(TEXT("$")) + UTF8_TO_TCHAR(ArrayField);
+	const FTCHARToUTF8 ArrayVarUtf8(*ArrayVar);
+	const FTCHARToUTF8 EntryIdVar(*(ArrayVar + TEXT(".id")));
+
+	bson_t* unwind = BCON_NEW("$unwind", BCON_UTF8(ArrayVarUtf8.Get()));
+	bson_t* group = BCON_NEW(
+		"$group",
+		"{",
+			"_id",
+			"{",
+				"id", BCON_UTF8(EntryIdVar.Get()),
+				"bucket",
+				"{",
+					"$floor",
+					"{",
+						"$divide", "[", "{", "$subtract", "[", BCON_UTF8("$timestamp"), BCON_DOUBLE(StartTs), "]", "}", BCON_DOUBLE(DeltaT), "]",
+					"}",
+				"}",
+			"}",
+			"timestamp", "{", "$first", BCON_UTF8("$timestamp"), "}",
+			"entry", "{", "$first", BCON_UTF8(ArrayVarUtf8.Get()), "}",
+		"}");
+	bson_t* regroup = BCON_NEW(
+		"$group",
+		"{",
+			"_id", BCON_UTF8("$timestamp"),										// the kept entries of the same time form a frame again
+			ArrayField, "{", "$push", BCON_UTF8("$entry"), "}",
+		"}");
+	bson_t* sort = BCON_NEW("$sort", "{", "_id", BCON_INT32(1), "}");			// the groups are not ordered
+	bson_t* project = BCON_NEW(
+		"$project",
+		"{",
+			"_id", BCON_INT32(0),
+			"timestamp", BCON_UTF8("$_id"),
+			ArrayField, BCON_INT32(1),
+		"}");
+
+	return AppendStages(pipeline, { unwind, group, regroup, sort, project });
+}
+
+// Copy the stages of the pipeline followed by the given ones, the input pipeline and the stages are destroyed
+bson_t* FSLMongoQueryDBHandler::AppendStages(bson_t* pipeline, std::initializer_list<bson_t*> Stages)
+{
+	bson_t* extended_pipeline = bson_new();
+	bson_t stages;
+	bson_append_array_begin(extended_pipeline, "pipeline", -1, &stages);
+
+	// Copy the existing stages
+	uint32_t stage_idx = 0;
+	char idx_str[16];
+	const char *idx_key;
+	bson_iter_t pipeline_iter;
+	bson_iter_t stage_iter;
+	if (bson_iter_init_find(&pipeline_iter, pipeline, "pipeline") && bson_iter_recurse(&pipeline_iter, &stage_iter))
+	{
+		while (bson_iter_next(&stage_iter))
+		{
+			bson_uint32_to_string(stage_idx++, &idx_key, idx_str, sizeof idx_str);
+			bson_append_iter(&stages, idx_key, -1, &stage_iter);
+		}
+	}
+
+	for (bson_t* stage : Stages)
+	{
+		bson_uint32_to_string(stage_idx++, &idx_key, idx_str, sizeof idx_str);
+		bson_append_document(&stages, idx_key, -1, stage);
+		bson_destroy(stage);
+	}
+	bson_append_array_end(extended_pipeline, &stages);
+
+	bson_destroy(pipeline);
+	return extended_pipeline;
+}
 #endif // SL_WITH_LIBMONGO_C
\ No newline at end of file
@@ -139,6 +139,7 @@ bool ASLMongoQueryManager::Connect(const FString& ServerIp, uint16 ServerPort)
 	if (DBHandler.Connect(ServerIp, ServerPort))
 	{
 		bConnected = true;
+		QueryCache.SetMemoryBudget(bUseQueryCache ? int64(QueryCacheMemoryBudgetMB) * 1024 * 1024 : 0);
 	}
 	else
 	{
@@ -153,6 +154,8 @@ void ASLMongoQueryManager::Disconnect()
 	if (bConnected)
 	{
 		DBHandler.Disconnect();
+		PoseIndex.Reset();
+		QueryCache.Reset();
 		TaskId = "";
 		EpisodeId = "";
 		
@@ -174,8 +177,15 @@ bool ASLMongoQueryManager::SetTask(const FString& InTaskId)
 	{
 		return true;
 	}
+	// The active episode belongs to the previous task
+	EpisodeId = "";
+	bEpisodeSet = false;
+	PoseIndex.Reset();
+
 	if (DBHandler.SetDatabase(InTaskId))
 	{
+		// Re-selected tasks are queried again from the server
+		QueryCache.Invalidate(InTaskId);
 		TaskId = InTaskId;
 		bTaskSet = true;	
 	}
@@ -205,10 +215,25 @@ bool ASLMongoQueryManager::SetEpisode(const FString& InEpisodeId)
 	{
 		return true;
 	}
+	PoseIndex.Reset();
 	if (DBHandler.SetCollection(InEpisodeId))
 	{
+		// Re-selected episodes are queried again from the server
+		QueryCache.Invalidate(TaskId, InEpisodeId);
 		EpisodeId = InEpisodeId;
 		bEpisodeSet = true;
+
+		// Load the episode poses once, the queries fall back to the server if the budget is exceeded
+		if (bUsePoseIndex && !IsPoseIndexOverBudget())
+		{
+			PoseIndex.SetMemoryBudget(int64(PoseIndexMemoryBudgetMB) * 1024 * 1024);
+			if (!DBHandler.LoadPoseIndex(PoseIndex))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not load the pose index of %s, the pose queries will run on the server.."),
+					*FString(__FUNCTION__), __LINE__, *InEpisodeId);
+				PoseIndex.Reset();
+			}
+		}
 	}
 	else
 	{
@@ -218,6 +243,32 @@ bool ASLMongoQueryManager::SetEpisode(const FString& InEpisodeId)
 	return bEpisodeSet;
 }
 
+// True if the pose index of the active episode is estimated to exceed the memory budget (checked before loading it)
+bool ASLMongoQueryManager::IsPoseIndexOverBudget() const
+{
+	if (PoseIndexMemoryBudgetMB <= 0)
+	{
+		return false;
+	}
+
+	// Unknown size, the load itself stops at the budget
+	const int64 DataSize = DBHandler.GetEpisodeDataSize();
+	if (DataSize < 0)
+	{
+		return false;
+	}
+
+	const int64 Budget = int64(PoseIndexMemoryBudgetMB) * 1024 * 1024;
+	const int64 EstimatedSize = FSLMongoPoseIndex::EstimateAllocatedSize(DataSize);
+	if (EstimatedSize > Budget)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d The pose index of %s is estimated at %lld bytes (documents=%lld bytes, budget=%lld bytes), it is not loaded, the pose queries will run on the server.."),
+			*FString(__FUNCTION__), __LINE__, *EpisodeId, EstimatedSize, DataSize, Budget);
+		return true;
+	}
+	return false;
+}
+
 /* Queries */
 // Get the individual pose with task and episode init
 FTransform ASLMongoQueryManager::GetIndividualPoseAt(const FString& InTaskId, const FString& InEpisodeId, const FString& IndividualId, float Ts)
@@ -250,7 +301,24 @@ FTransform ASLMongoQueryManager::GetIndividualPoseAt(const FString& InEpisodeId,
 // Get the individual pose
 FTransform ASLMongoQueryManager::GetIndividualPoseAt(const FString& IndividualId, float Ts) const
 {
-	return DBHandler.GetIndividualPoseAt(IndividualId, Ts);
+	if (PoseIndex.IsLoaded())
+	{
+		FTransform Pose;
+		PoseIndex.GetPoseAt(IndividualId, Ts, Pose, bInterpolateIndexedPoses);
+		return Pose;
+	}
+
+	const FSLMongoQueryCacheKey Key(ESLMongoQueryCacheType::Pose, TaskId, EpisodeId, IndividualId, Ts);
+	FSLMongoQueryCacheValue Cached;
+	if (QueryCache.Find(Key, Cached) && Cached.Poses.Num() == 1)
+	{
+		return Cached.Poses[0];
+	}
+	const FTransform Pose = DBHandler.GetIndividualPoseAt(IndividualId, Ts);
+	Cached.Poses.Reset();
+	Cached.Poses.Add(Pose);
+	QueryCache.Add(Key, Cached);
+	return Pose;
 }
 
 // Get the individual trajectory with task and episode init
@@ -284,7 +352,26 @@ TArray<FTransform> ASLMongoQueryManager::GetIndividualTrajectory(const FString&
 // Get the individual trajectory 
 TArray<FTransform> ASLMongoQueryManager::GetIndividualTrajectory(const FString& IndividualId, float StartTs, float EndTs, float DeltaT) const
 {
-	return DBHandler.GetIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
+	if (PoseIndex.IsLoaded())
+	{
+		TArray<FTransform> Trajectory;
+		if (!PoseIndex.GetTrajectory(IndividualId, StartTs, EndTs, Trajectory, DeltaT, bInterpolateIndexedPoses))
+		{
+			// Same as the server query, the pose at the start time if there are no samples in the window
+			Trajectory.Add(GetIndividualPoseAt(IndividualId, StartTs));
+		}
+		return Trajectory;
+	}
+
+	const FSLMongoQueryCacheKey Key(ESLMongoQueryCacheType::Trajectory, TaskId, EpisodeId, IndividualId, StartTs, EndTs, DeltaT);
+	FSLMongoQueryCacheValue Cached;
+	if (QueryCache.Find(Key, Cached))
+	{
+		return MoveTemp(Cached.Poses);
+	}
+	Cached.Poses = DBHandler.GetIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
+	QueryCache.Add(Key, Cached);
+	return MoveTemp(Cached.Poses);
 }
 
 
@@ -319,7 +406,19 @@ TPair<FTransform, TMap<int32, FTransform>> ASLMongoQueryManager::GetSkeletalIndi
 // Get skeletal individual pose
 TPair<FTransform, TMap<int32, FTransform>> ASLMongoQueryManager::GetSkeletalIndividualPoseAt(const FString& IndividualId, float Ts) const
 {
-	return DBHandler.GetSkeletalIndividualPoseAt(IndividualId, Ts);	
+	const FSLMongoQueryCacheKey Key(ESLMongoQueryCacheType::SkeletalPose, TaskId, EpisodeId, IndividualId, Ts);
+	FSLMongoQueryCacheValue Cached;
+	if (QueryCache.Find(Key, Cached) && Cached.Poses.Num() == 1 && Cached.BonePoses.Num() == 1)
+	{
+		return TPair<FTransform, TMap<int32, FTransform>>(Cached.Poses[0], MoveTemp(Cached.BonePoses[0]));
+	}
+	TPair<FTransform, TMap<int32, FTransform>> SkelPose = DBHandler.GetSkeletalIndividualPoseAt(IndividualId, Ts);
+	Cached.Poses.Reset();
+	Cached.BonePoses.Reset();
+	Cached.Poses.Add(SkelPose.Key);
+	Cached.BonePoses.Add(SkelPose.Value);
+	QueryCache.Add(Key, Cached);
+	return SkelPose;
 }
 
 // Get skeletal individual trajectory with task and episode init
@@ -354,7 +453,110 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkel
 // Get skeletal individual trajectory
 TArray<TPair<FTransform, TMap<int32, FTransform>>> ASLMongoQueryManager::GetSkeletalIndividualTrajectory(const FString& IndividualId, float StartTs, float EndTs, float DeltaT) const
 {
-	return DBHandler.GetSkeletalIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
+	const FSLMongoQueryCacheKey Key(ESLMongoQueryCacheType::SkeletalTrajectory, TaskId, EpisodeId, IndividualId, StartTs, EndTs, DeltaT);
+	FSLMongoQueryCacheValue Cached;
+	TArray<TPair<FTransform, TMap<int32, FTransform>>> Trajectory;
+	if (QueryCache.Find(Key, Cached) && Cached.Poses.Num() == Cached.BonePoses.Num())
+	{
+		Trajectory.Reserve(Cached.Poses.Num());
+		for (int32 Idx = 0; Idx < Cached.Poses.Num(); ++Idx)
+		{
+			Trajectory.Emplace(Cached.Poses[Idx], MoveTemp(Cached.BonePoses[Idx]));
+		}
+		return Trajectory;
+	}
+
+	Trajectory = DBHandler.GetSkeletalIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
+	Cached.Poses.Reset(Trajectory.Num());
+	Cached.BonePoses.Reset(Trajectory.Num());
+	for (const auto& SkelPose : Trajectory)
+	{
+		Cached.Poses.Add(SkelPose.Key);
+		Cached.BonePoses.Add(SkelPose.Value);
+	}
+	QueryCache.Add(Key, Cached);
+	return Trajectory;
+}
+
+// Get the trajectories of several individuals with task and episode init
+TMap<FString, FSLMongoPoseTrack> ASLMongoQueryManager::GetIndividualsTrajectories(const FString& InTaskId, const FString& InEpisodeId, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT)
+{
+	if (SetTask(InTaskId))
+	{
+		return GetIndividualsTrajectories(InEpisodeId, IndividualIds, StartTs, EndTs, DeltaT);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set task: %s .."), *FString(__FUNCTION__), __LINE__, *InTaskId);
+		return TMap<FString, FSLMongoPoseTrack>();
+	}
+}
+
+// Get the trajectories of several individuals with episode init
+TMap<FString, FSLMongoPoseTrack> ASLMongoQueryManager::GetIndividualsTrajectories(const FString& InEpisodeId, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT)
+{
+	if (SetEpisode(InEpisodeId))
+	{
+		return GetIndividualsTrajectories(IndividualIds, StartTs, EndTs, DeltaT);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set episode: %s .."), *FString(__FUNCTION__), __LINE__, *InEpisodeId);
+		return TMap<FString, FSLMongoPoseTrack>();
+	}
+}
+
+// Get the trajectories of several individuals
+TMap<FString, FSLMongoPoseTrack> ASLMongoQueryManager::GetIndividualsTrajectories(const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT) const
+{
+	if (PoseIndex.IsLoaded())
+	{
+		TMap<FString, FSLMongoPoseTrack> Trajectories;
+		for (const auto& Id : IndividualIds)
+		{
+			FSLMongoPoseTrack Track;
+			if (PoseIndex.GetTrack(Id, StartTs, EndTs, Track, DeltaT, bInterpolateIndexedPoses))
+			{
+				Trajectories.Emplace(Id, MoveTemp(Track));
+			}
+		}
+		return Trajectories;
+	}
+	return DBHandler.GetIndividualsTrajectories(IndividualIds, StartTs, EndTs, DeltaT);
+}
+
+// Get the trajectories of several skeletal individuals with task and episode init
+TMap<FString, FSLMongoSkeletalPoseTrack> ASLMongoQueryManager::GetSkeletalIndividualsTrajectories(const FString& InTaskId, const FString& InEpisodeId, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT)
+{
+	if (SetTask(InTaskId))
+	{
+		return GetSkeletalIndividualsTrajectories(InEpisodeId, IndividualIds, StartTs, EndTs, DeltaT);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set task: %s .."), *FString(__FUNCTION__), __LINE__, *InTaskId);
+		return TMap<FString, FSLMongoSkeletalPoseTrack>();
+	}
+}
+
+// Get the trajectories of several skeletal individuals with episode init
+TMap<FString, FSLMongoSkeletalPoseTrack> ASLMongoQueryManager::GetSkeletalIndividualsTrajectories(const FString& InEpisodeId, const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT)
+{
+	if (SetEpisode(InEpisodeId))
+	{
+		return GetSkeletalIndividualsTrajectories(IndividualIds, StartTs, EndTs, DeltaT);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set episode: %s .."), *FString(__FUNCTION__), __LINE__, *InEpisodeId);
+		return TMap<FString, FSLMongoSkeletalPoseTrack>();
+	}
+}
+
+// Get the trajectories of several skeletal individuals
+TMap<FString, FSLMongoSkeletalPoseTrack> ASLMongoQueryManager::GetSkeletalIndividualsTrajectories(const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT) const
+{
+	return DBHandler.GetSkeletalIndividualsTrajectories(IndividualIds, StartTs, EndTs, DeltaT);
 }
 
 // Get the episode data with task and episode init
@@ -391,6 +593,100 @@ TArray<TPair<float, TMap<FString, FTransform>>> ASLMongoQueryManager::GetEpisode
 	return DBHandler.GetEpisodeData();
 }
 
+// Get the frame data with task and episode init
+TMap<FString, FTransform> ASLMongoQueryManager::GetFrameData(const FString& InTaskId, const FString& InEpisodeId, float Ts)
+{
+	if (SetTask(InTaskId))
+	{
+		return GetFrameData(InEpisodeId, Ts);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set task: %s .."), *FString(__FUNCTION__), __LINE__, *InTaskId);
+		return TMap<FString, FTransform>();
+	}
+}
+
+// Get the frame data with episode init
+TMap<FString, FTransform> ASLMongoQueryManager::GetFrameData(const FString& InEpisodeId, float Ts)
+{
+	if (SetEpisode(InEpisodeId))
+	{
+		return GetFrameData(Ts);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set episode: %s .."), *FString(__FUNCTION__), __LINE__, *InEpisodeId);
+		return TMap<FString, FTransform>();
+	}
+}
+
+// Get the frame data
+TMap<FString, FTransform> ASLMongoQueryManager::GetFrameData(float Ts) const
+{
+	if (PoseIndex.IsLoaded())
+	{
+		TMap<FString, FTransform> FrameData;
+		PoseIndex.GetFrameAt(Ts, FrameData, bInterpolateIndexedPoses);
+		return FrameData;
+	}
+	return DBHandler.GetFrameData(Ts);
+}
+
+// Start loading the episode data in the background with task and episode init
+TSharedPtr<FSLMongoEpisodeLoader> ASLMongoQueryManager::GetEpisodeDataAsync(const FString& InTaskId, const FString& InEpisodeId, int32 BatchSize)
+{
+	if (SetTask(InTaskId))
+	{
+		return GetEpisodeDataAsync(InEpisodeId, BatchSize);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set task: %s .."), *FString(__FUNCTION__), __LINE__, *InTaskId);
+		return TSharedPtr<FSLMongoEpisodeLoader>();
+	}
+}
+
+// Start loading the episode data in the background with episode init
+TSharedPtr<FSLMongoEpisodeLoader> ASLMongoQueryManager::GetEpisodeDataAsync(const FString& InEpisodeId, int32 BatchSize)
+{
+	if (SetEpisode(InEpisodeId))
+	{
+		return GetEpisodeDataAsync(BatchSize);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set episode: %s .."), *FString(__FUNCTION__), __LINE__, *InEpisodeId);
+		return TSharedPtr<FSLMongoEpisodeLoader>();
+	}
+}
+
+// Start loading the episode data in the background
+TSharedPtr<FSLMongoEpisodeLoader> ASLMongoQueryManager::GetEpisodeDataAsync(int32 BatchSize) const
+{
+	return DBHandler.GetEpisodeDataAsync(BatchSize);
+}
+
+// Get the individual trajectory in every episode
+TArray<TSLMongoEpisodeResult<TArray<FTransform>>> ASLMongoQueryManager::GetIndividualTrajectory(const TArray<FSLMongoEpisodeRef>& Episodes,
+	const FString& IndividualId, float StartTs, float EndTs, float DeltaT) const
+{
+	return QueryEpisodes<TArray<FTransform>>(Episodes, [&IndividualId, StartTs, EndTs, DeltaT](const FSLMongoQueryDBHandler& Handler)
+	{
+		return Handler.GetIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
+	});
+}
+
+// Get the trajectories of several individuals in every episode
+TArray<TSLMongoEpisodeResult<TMap<FString, FSLMongoPoseTrack>>> ASLMongoQueryManager::GetIndividualsTrajectories(const TArray<FSLMongoEpisodeRef>& Episodes,
+	const TArray<FString>& IndividualIds, float StartTs, float EndTs, float DeltaT) const
+{
+	return QueryEpisodes<TMap<FString, FSLMongoPoseTrack>>(Episodes, [&IndividualIds, StartTs, EndTs, DeltaT](const FSLMongoQueryDBHandler& Handler)
+	{
+		return Handler.GetIndividualsTrajectories(IndividualIds, StartTs, EndTs, DeltaT);
+	});
+}
+
 // Spawn or get manager from the world
 ASLMongoQueryManager* ASLMongoQueryManager::GetExistingOrSpawnNew(UWorld* World)
 {
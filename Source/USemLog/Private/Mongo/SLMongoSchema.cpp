@@ -0,0 +1,1103 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoSchema.h"
+
+// UUtils
+#if SL_WITH_ROS_CONVERSIONS
+#include "Conversions.h"
+#endif // SL_WITH_ROS_CONVERSIONS
+
+// Schema of the episodes without stored schema
+FSLMongoSchema FSLMongoSchema::Frames()
+{
+	FSLMongoSchema Schema;
+	Schema.Version = FramesVersion;
+	Schema.Layout = ESLMongoSchemaLayout::Frames;
+	Schema.TimeField = TEXT("timestamp");
+	Schema.IdField = TEXT("id");
+	Schema.LocField = TEXT("loc");
+	Schema.QuatField = TEXT("quat");
+	Schema.IndividualsArray = TEXT("individuals");
+	Schema.SkeletalArray = TEXT("skel_individuals");
+	Schema.BonesArray = TEXT("bones");
+	Schema.BoneIndexField = TEXT("idx");
+	return Schema;
+}
+
+// Schema of the tf layout, the timestamps are stored as dates relative to the given episode start (unix ms)
+FSLMongoSchema FSLMongoSchema::Tf(int64 InTimeOriginMs)
+{
+	FSLMongoSchema Schema;
+	Schema.Version = TfVersion;
+	Schema.Layout = ESLMongoSchemaLayout::Tf;
+	Schema.TimeField = TEXT("header.stamp");
+	Schema.IdField = TEXT("child_frame_id");
+	Schema.LocField = TEXT("transform.translation");
+	Schema.QuatField = TEXT("transform.rotation");
+	Schema.IndividualsArray = TEXT("transforms");
+	Schema.SkeletonField = TEXT("skeleton");
+	Schema.BoneIndexField = TEXT("bone_index");
+	Schema.TimeOriginMs = InTimeOriginMs;
+	return Schema;
+}
+
+#if SL_WITH_LIBMONGO_C
+/* Metadata */
+// Create the metadata document of the episode
+bson_t* FSLMongoSchema::CreateMetadataDoc(const FString& EpisodeId) const
+{
+	bson_t* doc = bson_new();
+	BSON_APPEND_UTF8(doc, "type_id", "schema");
+	BSON_APPEND_UTF8(doc, "episode_id", TCHAR_TO_UTF8(*EpisodeId));
+	BSON_APPEND_INT32(doc, "version", Version);
+	BSON_APPEND_UTF8(doc, "layout", TCHAR_TO_UTF8(GetLayoutName()));
+	BSON_APPEND_UTF8(doc, "time_field", TCHAR_TO_UTF8(*TimeField));
+	BSON_APPEND_UTF8(doc, "id_field", TCHAR_TO_UTF8(*IdField));
+	BSON_APPEND_UTF8(doc, "loc_field", TCHAR_TO_UTF8(*LocField));
+	BSON_APPEND_UTF8(doc, "quat_field", TCHAR_TO_UTF8(*QuatField));
+	BSON_APPEND_UTF8(doc, "individuals_array", TCHAR_TO_UTF8(*IndividualsArray));
+	BSON_APPEND_UTF8(doc, "skeletal_array", TCHAR_TO_UTF8(*SkeletalArray));
+	BSON_APPEND_UTF8(doc, "bones_array", TCHAR_TO_UTF8(*BonesArray));
+	BSON_APPEND_UTF8(doc, "skeleton_field", TCHAR_TO_UTF8(*SkeletonField));
+	BSON_APPEND_UTF8(doc, "bone_index_field", TCHAR_TO_UTF8(*BoneIndexField));
+	BSON_APPEND_DATE_TIME(doc, "time_origin", TimeOriginMs);
+	return doc;
+}
+
+// Create the filter of the metadata document of the episode
+bson_t* FSLMongoSchema::CreateMetadataFilter(const FString& EpisodeId)
+{
+	return BCON_NEW(
+		"type_id", BCON_UTF8("schema"),
+		"episode_id", BCON_UTF8(TCHAR_TO_UTF8(*EpisodeId)));
+}
+
+// Read the schema from the metadata document, false if missing fields or unknown version
+bool FSLMongoSchema::FromMetadataDoc(const bson_t* doc, FSLMongoSchema& OutSchema)
+{
+	FSLMongoSchema Schema;
+	Schema.Version = INDEX_NONE;
+	FString LayoutName;
+
+	// Map of the string fields
+	TMap<FString, FString*> StringFields;
+	StringFields.Add(TEXT("layout"), &LayoutName);
+	StringFields.Add(TEXT("time_field"), &Schema.TimeField);
+	StringFields.Add(TEXT("id_field"), &Schema.IdField);
+	StringFields.Add(TEXT("loc_field"), &Schema.LocField);
+	StringFields.Add(TEXT("quat_field"), &Schema.QuatField);
+	StringFields.Add(TEXT("individuals_array"), &Schema.IndividualsArray);
+	StringFields.Add(TEXT("skeletal_array"), &Schema.SkeletalArray);
+	StringFields.Add(TEXT("bones_array"), &Schema.BonesArray);
+	StringFields.Add(TEXT("skeleton_field"), &Schema.SkeletonField);
+	StringFields.Add(TEXT("bone_index_field"), &Schema.BoneIndexField);
+
+	bson_iter_t iter;
+	if (!bson_iter_init(&iter, doc))
+	{
+		return false;
+	}
+	while (bson_iter_next(&iter))
+	{
+		const FString Key = FString(UTF8_TO_TCHAR(bson_iter_key(&iter)));
+		if (Key.Equals(TEXT("version")) && BSON_ITER_HOLDS_INT32(&iter))
+		{
+			Schema.Version = bson_iter_int32(&iter);
+		}
+		else if (Key.Equals(TEXT("time_origin")) && BSON_ITER_HOLDS_DATE_TIME(&iter))
+		{
+			Schema.TimeOriginMs = bson_iter_date_time(&iter);
+		}
+		else if (FString** Field = StringFields.Find(Key))
+		{
+			if (BSON_ITER_HOLDS_UTF8(&iter))
+			{
+				**Field = FString(UTF8_TO_TCHAR(bson_iter_utf8(&iter, NULL)));
+			}
+		}
+	}
+
+	if (Schema.Version < FramesVersion || Schema.Version > CurrentVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Unknown schema version %d (latest known is %d).."),
+			*FString(__FUNCTION__), __LINE__, Schema.Version, CurrentVersion);
+		return false;
+	}
+
+	if (LayoutName.Equals(TEXT("tf")))
+	{
+		Schema.Layout = ESLMongoSchemaLayout::Tf;
+	}
+	else if (LayoutName.Equals(TEXT("frames")))
+	{
+		Schema.Layout = ESLMongoSchemaLayout::Frames;
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Unknown schema layout %s.."), *FString(__FUNCTION__), __LINE__, *LayoutName);
+		return false;
+	}
+
+	if (Schema.TimeField.IsEmpty() || Schema.IdField.IsEmpty() || Schema.LocField.IsEmpty() || Schema.QuatField.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Schema metadata is missing required fields.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	OutSchema = Schema;
+	return true;
+}
+
+/* Documents (written by the world state logger) */
+// Append the tf header (sequence, stamp as date of the episode time, frame)
+void FSLMongoSchema::AppendTfHeader(bson_t* doc, int32 Seq, double Ts) const
+{
+	bson_t header;
+	BSON_APPEND_DOCUMENT_BEGIN(doc, "header", &header);
+		BSON_APPEND_INT32(&header, "seq", Seq);
+		BSON_APPEND_DATE_TIME(&header, "stamp", ToDateTime(Ts));
+		BSON_APPEND_UTF8(&header, "frame_id", "map");
+	bson_append_document_end(doc, &header);
+}
+
+// Create the tf document of the transform at the given episode time
+bson_t* FSLMongoSchema::CreateTfDoc(int32 Seq, double Ts, const FString& ChildFrameId, const FTransform& Pose) const
+{
+	bson_t* doc = bson_new();
+	AppendTfHeader(doc, Seq, Ts);
+	BSON_APPEND_UTF8(doc, "child_frame_id", TCHAR_TO_UTF8(*ChildFrameId));
+	AppendTfPose(doc, Pose);
+	bson_append_now_utc(doc, "__recorded", -1);
+	BSON_APPEND_UTF8(doc, "topic", "tf");
+	return doc;
+}
+
+// Link the tf document of a bone to its skeletal individual
+void FSLMongoSchema::AppendTfBone(bson_t* doc, const FString& SkelId, int32 BoneIndex) const
+{
+	bson_append_utf8(doc, TCHAR_TO_UTF8(*SkeletonField), -1, TCHAR_TO_UTF8(*SkelId), -1);
+	bson_append_int32(doc, TCHAR_TO_UTF8(*BoneIndexField), -1, BoneIndex);
+}
+
+// Append the transform (translation, rotation) of the pose
+void FSLMongoSchema::AppendTfPose(bson_t* doc, FTransform Pose)
+{
+#if SL_WITH_ROS_CONVERSIONS
+	FConversions::UToROS(Pose);
+#endif // SL_WITH_ROS_CONVERSIONS
+
+	bson_t child_obj_loc;
+	bson_t child_obj_rot;
+	bson_t child_obj_trans;
+
+	BSON_APPEND_DOCUMENT_BEGIN(doc, "transform", &child_obj_trans);
+
+	BSON_APPEND_DOCUMENT_BEGIN(&child_obj_trans, "translation", &child_obj_loc);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "x", Pose.GetLocation().X);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "y", Pose.GetLocation().Y);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "z", Pose.GetLocation().Z);
+	bson_append_document_end(&child_obj_trans, &child_obj_loc);
+
+	BSON_APPEND_DOCUMENT_BEGIN(&child_obj_trans, "rotation", &child_obj_rot);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "x", Pose.GetRotation().X);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "y", Pose.GetRotation().Y);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "z", Pose.GetRotation().Z);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "w", Pose.GetRotation().W);
+	bson_append_document_end(&child_obj_trans, &child_obj_rot);
+
+	bson_append_document_end(doc, &child_obj_trans);
+}
+
+/* Indexes */
+// Create the command building the indexes used by the query pipelines
+bson_t* FSLMongoSchema::CreateIndexesCommand(const char* CollName) const
+{
+	const bool bTf = Layout == ESLMongoSchemaLayout::Tf;
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 IdPath(bTf ? *IdField : *(IndividualsArray + TEXT(".") + IdField));
+	const FTCHARToUTF8 SkelPath(bTf ? *SkeletonField : *(SkeletalArray + TEXT(".") + IdField));
+
+	// Time (frames and range queries)
+	bson_t idx_ts;
+	bson_init(&idx_ts);
+	BSON_APPEND_INT32(&idx_ts, Time.Get(), 1);
+	char* idx_ts_chr = mongoc_collection_keys_to_index_string(&idx_ts);
+
+	// Individual and time (pose and trajectory queries)
+	bson_t idx_id;
+	bson_init(&idx_id);
+	BSON_APPEND_INT32(&idx_id, IdPath.Get(), 1);
+	BSON_APPEND_INT32(&idx_id, Time.Get(), 1);
+	char* idx_id_chr = mongoc_collection_keys_to_index_string(&idx_id);
+
+	// Skeletal individual and time (skeletal queries)
+	bson_t idx_skel;
+	bson_init(&idx_skel);
+	BSON_APPEND_INT32(&idx_skel, SkelPath.Get(), 1);
+	BSON_APPEND_INT32(&idx_skel, Time.Get(), 1);
+	char* idx_skel_chr = mongoc_collection_keys_to_index_string(&idx_skel);
+
+	// Keyframes (latest keyframe before a time)
+	bson_t idx_keyframe;
+	bson_init(&idx_keyframe);
+	BSON_APPEND_INT32(&idx_keyframe, "keyframe", 1);
+	BSON_APPEND_INT32(&idx_keyframe, Time.Get(), -1);
+	char* idx_keyframe_chr = mongoc_collection_keys_to_index_string(&idx_keyframe);
+
+	bson_t* index_command = BCON_NEW("createIndexes",
+		BCON_UTF8(CollName),
+		"indexes",
+		"[",
+			"{",
+				"key", BCON_DOCUMENT(&idx_ts),
+				"name", BCON_UTF8(idx_ts_chr),
+			"}",
+			"{",
+				"key", BCON_DOCUMENT(&idx_id),
+				"name", BCON_UTF8(idx_id_chr),
+			"}",
+			"{",
+				"key", BCON_DOCUMENT(&idx_skel),
+				"name", BCON_UTF8(idx_skel_chr),
+				"sparse", BCON_BOOL(true),							// only the skeletal documents are indexed
+			"}",
+			"{",
+				"key", BCON_DOCUMENT(&idx_keyframe),
+				"name", BCON_UTF8(idx_keyframe_chr),
+				"sparse", BCON_BOOL(true),							// only the keyframe documents are indexed
+			"}",
+		"]");
+
+	bson_destroy(&idx_ts);
+	bson_destroy(&idx_id);
+	bson_destroy(&idx_skel);
+	bson_destroy(&idx_keyframe);
+	bson_free(idx_ts_chr);
+	bson_free(idx_id_chr);
+	bson_free(idx_skel_chr);
+	bson_free(idx_keyframe_chr);
+	return index_command;
+}
+
+/* Query pipelines */
+// Last pose of the individual at or before the given time
+bson_t* FSLMongoSchema::CreatePoseAtPipeline(const FString& Id, float Ts) const
+{
+	const double End = Ts;
+	bson_t* range = CreateTimeRange(nullptr, false, &End);
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 IdVal(*Id);
+	bson_t* pipeline = nullptr;
+
+	if (Layout == ESLMongoSchemaLayout::Tf)
+	{
+		const FTCHARToUTF8 IdKey(*IdField);
+		const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+		const FTCHARToUTF8 LocVar(*(TEXT("$") + LocField));
+		const FTCHARToUTF8 QuatVar(*(TEXT("$") + QuatField));
+		bson_t* ts_expr = CreateTimestampExpr(TimeVar.Get());
+
+		pipeline = BCON_NEW("pipeline", "[",
+			"{",
+				"$match",
+				"{",
+					IdKey.Get(), BCON_UTF8(IdVal.Get()),
+					Time.Get(), BCON_DOCUMENT(range),
+				"}",
+			"}",
+			"{",
+				"$sort",
+				"{",
+					Time.Get(), BCON_INT32(-1),							// uses the individual-time index
+				"}",
+			"}",
+			"{",
+				"$limit", BCON_INT32(1),
+			"}",
+			"{",
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_DOCUMENT(ts_expr),
+					"loc", BCON_UTF8(LocVar.Get()),
+					"quat", BCON_UTF8(QuatVar.Get()),
+				"}",
+			"}",
+			"]");
+		bson_destroy(ts_expr);
+	}
+	else
+	{
+		const FTCHARToUTF8 IdKey(*(IndividualsArray + TEXT(".") + IdField));
+		const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+		const FTCHARToUTF8 ArrayVar(*(TEXT("$") + IndividualsArray));
+		const FTCHARToUTF8 LocVar(*(TEXT("$") + IndividualsArray + TEXT(".") + LocField));
+		const FTCHARToUTF8 QuatVar(*(TEXT("$") + IndividualsArray + TEXT(".") + QuatField));
+
+		pipeline = BCON_NEW("pipeline", "[",
+			"{",
+				"$match",
+				"{",
+					Time.Get(), BCON_DOCUMENT(range),
+					IdKey.Get(), BCON_UTF8(IdVal.Get()),				// yields faster results if we match against the id from the start
+				"}",
+			"}",
+			"{",
+				"$sort",
+				"{",
+					Time.Get(), BCON_INT32(-1),							// required to get the last pose (no time penalty if the collection is indexed)
+				"}",
+			"}",
+			"{",
+				"$limit", BCON_INT32(1),
+			"}",
+			"{",
+				"$unwind", BCON_UTF8(ArrayVar.Get()),
+			"}",
+			"{",
+				"$match",
+				"{",
+					IdKey.Get(), BCON_UTF8(IdVal.Get()),				// match against the searched id in the unwinded array (has all individuals from the doc)
+				"}",
+			"}",
+			"{",
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_UTF8(TimeVar.Get()),
+					"loc", BCON_UTF8(LocVar.Get()),
+					"quat", BCON_UTF8(QuatVar.Get()),
+				"}",
+			"}",
+			"]");
+	}
+
+	bson_destroy(range);
+	return pipeline;
+}
+
+// Poses of the individual between the given times (ascending)
+bson_t* FSLMongoSchema::CreateTrajectoryPipeline(const FString& Id, float StartTs, float EndTs) const
+{
+	const double Start = StartTs;
+	const double End = EndTs;
+	bson_t* range = CreateTimeRange(&Start, false, &End);
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 IdVal(*Id);
+	bson_t* pipeline = nullptr;
+
+	if (Layout == ESLMongoSchemaLayout::Tf)
+	{
+		const FTCHARToUTF8 IdKey(*IdField);
+		const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+		const FTCHARToUTF8 LocVar(*(TEXT("$") + LocField));
+		const FTCHARToUTF8 QuatVar(*(TEXT("$") + QuatField));
+		bson_t* ts_expr = CreateTimestampExpr(TimeVar.Get());
+
+		pipeline = BCON_NEW("pipeline", "[",
+			"{",
+				"$match",
+				"{",
+					IdKey.Get(), BCON_UTF8(IdVal.Get()),
+					Time.Get(), BCON_DOCUMENT(range),
+				"}",
+			"}",
+			"{",
+				"$sort",
+				"{",
+					Time.Get(), BCON_INT32(1),
+				"}",
+			"}",
+			"{",
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_DOCUMENT(ts_expr),
+					"loc", BCON_UTF8(LocVar.Get()),
+					"quat", BCON_UTF8(QuatVar.Get()),
+				"}",
+			"}",
+			"]");
+		bson_destroy(ts_expr);
+	}
+	else
+	{
+		const FTCHARToUTF8 IdKey(*(IndividualsArray + TEXT(".") + IdField));
+		const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+		const FTCHARToUTF8 ArrayVar(*(TEXT("$") + IndividualsArray));
+		const FTCHARToUTF8 LocVar(*(TEXT("$") + IndividualsArray + TEXT(".") + LocField));
+		const FTCHARToUTF8 QuatVar(*(TEXT("$") + IndividualsArray + TEXT(".") + QuatField));
+
+		pipeline = BCON_NEW("pipeline", "[",
+			"{",
+				"$match",
+				"{",
+					Time.Get(), BCON_DOCUMENT(range),
+					IdKey.Get(), BCON_UTF8(IdVal.Get()),				// yields faster results if we match against the id from the start
+					"keyframe", "{", "$ne", BCON_BOOL(true), "}",		// the keyframes repeat the poses of the frames
+				"}",
+			"}",
+			"{",
+				"$sort",
+				"{",
+					Time.Get(), BCON_INT32(1),							// no time penalty if the collection is indexed
+				"}",
+			"}",
+			"{",
+				"$unwind", BCON_UTF8(ArrayVar.Get()),
+			"}",
+			"{",
+				"$match",
+				"{",
+					IdKey.Get(), BCON_UTF8(IdVal.Get()),				// match against the searched id in the unwinded array (has all individuals from the doc)
+				"}",
+			"}",
+			"{",
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_UTF8(TimeVar.Get()),
+					"loc", BCON_UTF8(LocVar.Get()),
+					"quat", BCON_UTF8(QuatVar.Get()),
+				"}",
+			"}",
+			"]");
+	}
+
+	bson_destroy(range);
+	return pipeline;
+}
+
+// Last pose of the skeletal individual and of its bones at or before the given time
+bson_t* FSLMongoSchema::CreateSkeletalPoseAtPipeline(const char* CollName, const FString& Id, float Ts) const
+{
+	const double End = Ts;
+	if (Layout == ESLMongoSchemaLayout::Tf)
+	{
+		return CreateTfSkeletalPipeline(CollName, TArray<FString>{ Id }, nullptr, &End, true, false);
+	}
+
+	bson_t* range = CreateTimeRange(nullptr, false, &End);
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 IdVal(*Id);
+	const FTCHARToUTF8 IdKey(*(SkeletalArray + TEXT(".") + IdField));
+	const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+	const FTCHARToUTF8 ArrayVar(*(TEXT("$") + SkeletalArray));
+	const FTCHARToUTF8 BonesVar(*(TEXT("$") + SkeletalArray + TEXT(".") + BonesArray));
+	const FTCHARToUTF8 LocVar(*(TEXT("$") + SkeletalArray + TEXT(".") + LocField));
+	const FTCHARToUTF8 QuatVar(*(TEXT("$") + SkeletalArray + TEXT(".") + QuatField));
+
+	bson_t* pipeline = BCON_NEW("pipeline", "[",
+		"{",
+			"$match",
+			"{",
+				Time.Get(), BCON_DOCUMENT(range),
+				IdKey.Get(), BCON_UTF8(IdVal.Get()),					// yields faster results if we match against the id from the start
+			"}",
+		"}",
+		"{",
+			"$sort",
+			"{",
+				Time.Get(), BCON_INT32(-1),
+			"}",
+		"}",
+		"{",
+			"$limit", BCON_INT32(1),
+		"}",
+		"{",
+			"$unwind", BCON_UTF8(ArrayVar.Get()),
+		"}",
+		"{",
+			"$match",
+			"{",
+				IdKey.Get(), BCON_UTF8(IdVal.Get()),					// match against the searched id in the unwinded array (has all individuals from the doc)
+			"}",
+		"}",
+		"{",
+			"$project",
+			"{",
+				"_id", BCON_INT32(0),
+				"timestamp", BCON_UTF8(TimeVar.Get()),
+				"bones", BCON_UTF8(BonesVar.Get()),						// bones data (index, loc, quat)
+				"loc", BCON_UTF8(LocVar.Get()),							// actor loc
+				"quat", BCON_UTF8(QuatVar.Get()),						// actor quat
+			"}",
+		"}",
+		"]");
+
+	bson_destroy(range);
+	return pipeline;
+}
+
+// Poses of the skeletal individual and of its bones between the given times (ascending)
+bson_t* FSLMongoSchema::CreateSkeletalTrajectoryPipeline(const char* CollName, const FString& Id, float StartTs, float EndTs) const
+{
+	const double Start = StartTs;
+	const double End = EndTs;
+	if (Layout == ESLMongoSchemaLayout::Tf)
+	{
+		return CreateTfSkeletalPipeline(CollName, TArray<FString>{ Id }, &Start, &End, false, false);
+	}
+
+	bson_t* range = CreateTimeRange(&Start, false, &End);
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 IdVal(*Id);
+	const FTCHARToUTF8 IdKey(*(SkeletalArray + TEXT(".") + IdField));
+	const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+	const FTCHARToUTF8 ArrayVar(*(TEXT("$") + SkeletalArray));
+	const FTCHARToUTF8 BonesVar(*(TEXT("$") + SkeletalArray + TEXT(".") + BonesArray));
+	const FTCHARToUTF8 LocVar(*(TEXT("$") + SkeletalArray + TEXT(".") + LocField));
+	const FTCHARToUTF8 QuatVar(*(TEXT("$") + SkeletalArray + TEXT(".") + QuatField));
+
+	bson_t* pipeline = BCON_NEW("pipeline", "[",
+		"{",
+			"$match",
+			"{",
+				Time.Get(), BCON_DOCUMENT(range),
+				IdKey.Get(), BCON_UTF8(IdVal.Get()),					// yields faster results if we match against the id from the start
+			"}",
+		"}",
+		"{",
+			"$sort",
+			"{",
+				Time.Get(), BCON_INT32(1),								// if sort if right after match it barely adds any time penalty
+			"}",
+		"}",
+		"{",
+			"$unwind", BCON_UTF8(ArrayVar.Get()),
+		"}",
+		"{",
+			"$match",
+			"{",
+				IdKey.Get(), BCON_UTF8(IdVal.Get()),					// match against the searched id in the unwinded array (has all individuals from the doc)
+			"}",
+		"}",
+		"{",
+			"$project",
+			"{",
+				"_id", BCON_INT32(0),
+				"timestamp", BCON_UTF8(TimeVar.Get()),
+				"bones", BCON_UTF8(BonesVar.Get()),						// bones data (index, loc, quat)
+				"loc", BCON_UTF8(LocVar.Get()),							// actor loc
+				"quat", BCON_UTF8(QuatVar.Get()),						// actor quat
+			"}",
+		"}",
+		"]");
+
+	bson_destroy(range);
+	return pipeline;
+}
+
+// Frames of the given individuals (all if empty) between the given times (ascending), keyframes excluded
+bson_t* FSLMongoSchema::CreateFramesPipeline(const TArray<FString>& Ids, float StartTs, float EndTs, bool bStartExclusive) const
+{
+	const double Start = StartTs;
+	const double End = EndTs;
+	return CreateFramesPipeline(Ids, &Start, bStartExclusive, &End);
+}
+
+// Frames of the given skeletal individuals between the given times (ascending)
+bson_t* FSLMongoSchema::CreateSkeletalFramesPipeline(const char* CollName, const TArray<FString>& Ids, float StartTs, float EndTs) const
+{
+	const double Start = StartTs;
+	const double End = EndTs;
+	if (Layout == ESLMongoSchemaLayout::Tf)
+	{
+		return CreateTfSkeletalPipeline(CollName, Ids, &Start, &End, false, true);
+	}
+
+	bson_t* range = CreateTimeRange(&Start, false, &End);
+	bson_t* ids_arr = CreateIdsArray(Ids);
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 IdKey(*(SkeletalArray + TEXT(".") + IdField));
+	const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+	const FTCHARToUTF8 ArrayVar(*(TEXT("$") + SkeletalArray));
+	const FTCHARToUTF8 EntryIdVar(*(TEXT("$$ind.") + IdField));
+
+	bson_t* pipeline = BCON_NEW("pipeline", "[",
+		"{",
+			"$match",
+			"{",
+				Time.Get(), BCON_DOCUMENT(range),
+				IdKey.Get(), "{", "$in", BCON_ARRAY(ids_arr), "}",		// documents with at least one of the searched individuals
+			"}",
+		"}",
+		"{",
+			"$sort",
+			"{",
+				Time.Get(), BCON_INT32(1),								// no time penalty if the collection is indexed
+			"}",
+		"}",
+		"{",
+			"$project",
+			"{",
+				"_id", BCON_INT32(0),
+				"timestamp", BCON_UTF8(TimeVar.Get()),
+				"skel_individuals",										// keep only the searched individuals, one document per frame instead of one per individual
+				"{",
+					"$filter",
+					"{",
+						"input", BCON_UTF8(ArrayVar.Get()),
+						"as", BCON_UTF8("ind"),
+						"cond", "{", "$in", "[", BCON_UTF8(EntryIdVar.Get()), BCON_ARRAY(ids_arr), "]", "}",
+					"}",
+				"}",
+			"}",
+		"}",
+		"]");
+
+	bson_destroy(range);
+	bson_destroy(ids_arr);
+	return pipeline;
+}
+
+// All the frames of the episode (ascending), keyframes excluded
+bson_t* FSLMongoSchema::CreateEpisodePipeline() const
+{
+	return CreateFramesPipeline(TArray<FString>(), nullptr, false, nullptr);
+}
+
+// Number of frames of the episode (single document with a count field)
+bson_t* FSLMongoSchema::CreateFrameCountPipeline() const
+{
+	const FTCHARToUTF8 Time(*TimeField);
+	if (Layout == ESLMongoSchemaLayout::Tf)
+	{
+		const FTCHARToUTF8 IdKey(*IdField);
+		const FTCHARToUTF8 SkelKey(*SkeletonField);
+		const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+		return BCON_NEW("pipeline", "[",
+			"{",
+				"$match",
+				"{",
+					IdKey.Get(), "{", "$exists", BCON_BOOL(true), "}",		// skips the keyframes
+					SkelKey.Get(), "{", "$exists", BCON_BOOL(false), "}",	// skips the bones
+				"}",
+			"}",
+			"{",
+				"$group", "{", "_id", BCON_UTF8(TimeVar.Get()), "}",		// one frame per time
+			"}",
+			"{",
+				"$count", BCON_UTF8("count"),
+			"}",
+			"]");
+	}
+
+	return BCON_NEW("pipeline", "[",
+		"{",
+			"$match",
+			"{",
+				Time.Get(), "{", "$exists", BCON_BOOL(true), "}",
+				"keyframe", "{", "$ne", BCON_BOOL(true), "}",
+			"}",
+		"}",
+		"{",
+			"$count", BCON_UTF8("count"),
+		"}",
+		"]");
+}
+
+// Last keyframe at or before the given time
+bson_t* FSLMongoSchema::CreateKeyframePipeline(float Ts) const
+{
+	const double End = Ts;
+	bson_t* range = CreateTimeRange(nullptr, false, &End);
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+	const FTCHARToUTF8 ArrayVar(*(TEXT("$") + IndividualsArray));
+	bson_t* pipeline = nullptr;
+
+	if (Layout == ESLMongoSchemaLayout::Tf)
+	{
+		const FTCHARToUTF8 EntryIdVar(*(TEXT("$$t.") + IdField));
+		const FTCHARToUTF8 EntryLocVar(*(TEXT("$$t.") + LocField));
+		const FTCHARToUTF8 EntryQuatVar(*(TEXT("$$t.") + QuatField));
+		bson_t* ts_expr = CreateTimestampExpr(TimeVar.Get());
+
+		pipeline = BCON_NEW("pipeline", "[",
+			"{",
+				"$match",
+				"{",
+					"keyframe", BCON_BOOL(true),
+					Time.Get(), BCON_DOCUMENT(range),
+				"}",
+			"}",
+			"{",
+				"$sort", "{", Time.Get(), BCON_INT32(-1), "}",
+			"}",
+			"{",
+				"$limit", BCON_INT32(1),
+			"}",
+			"{",
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_DOCUMENT(ts_expr),
+					"individuals",
+					"{",
+						"$map",
+						"{",
+							"input", BCON_UTF8(ArrayVar.Get()),
+							"as", BCON_UTF8("t"),
+							"in", "{",
+								"id", BCON_UTF8(EntryIdVar.Get()),
+								"loc", BCON_UTF8(EntryLocVar.Get()),
+								"quat", BCON_UTF8(EntryQuatVar.Get()),
+							"}",
+						"}",
+					"}",
+				"}",
+			"}",
+			"]");
+		bson_destroy(ts_expr);
+	}
+	else
+	{
+		pipeline = BCON_NEW("pipeline", "[",
+			"{",
+				"$match",
+				"{",
+					"keyframe", BCON_BOOL(true),
+					Time.Get(), BCON_DOCUMENT(range),
+				"}",
+			"}",
+			"{",
+				"$sort", "{", Time.Get(), BCON_INT32(-1), "}",
+			"}",
+			"{",
+				"$limit", BCON_INT32(1),
+			"}",
+			"{",
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_UTF8(TimeVar.Get()),
+					"individuals", BCON_UTF8(ArrayVar.Get()),
+				"}",
+			"}",
+			"]");
+	}
+
+	bson_destroy(range);
+	return pipeline;
+}
+
+// Append the time value (number or date)
+void FSLMongoSchema::AppendTime(bson_t* doc, const char* key, double Ts) const
+{
+	if (HasDateTime())
+	{
+		BSON_APPEND_DATE_TIME(doc, key, ToDateTime(Ts));
+	}
+	else
+	{
+		BSON_APPEND_DOUBLE(doc, key, Ts);
+	}
+}
+
+// Create the time condition document, without bounds it only checks the field existence
+bson_t* FSLMongoSchema::CreateTimeRange(const double* StartTs, bool bStartExclusive, const double* EndTs) const
+{
+	bson_t* range = bson_new();
+	if (StartTs)
+	{
+		AppendTime(range, bStartExclusive ? "$gt" : "$gte", *StartTs);
+	}
+	if (EndTs)
+	{
+		AppendTime(range, "$lte", *EndTs);
+	}
+	if (!StartTs && !EndTs)
+	{
+		BSON_APPEND_BOOL(range, "$exists", true);
+	}
+	return range;
+}
+
+// Create the expression converting the date at the given field path to the episode time in seconds (tf layout)
+bson_t* FSLMongoSchema::CreateTimestampExpr(const char* TimeVar) const
+{
+	return BCON_NEW(
+		"$divide",
+		"[",
+			"{", "$subtract", "[", BCON_UTF8(TimeVar), BCON_DATE_TIME(TimeOriginMs), "]", "}",	// date difference in ms
+			BCON_DOUBLE(1000.0),
+		"]");
+}
+
+// Create the array of the given ids
+bson_t* FSLMongoSchema::CreateIdsArray(const TArray<FString>& Ids)
+{
+	bson_t* ids_arr = bson_new();
+	char idx_str[16];
+	const char *idx_key;
+	for (int32 Idx = 0; Idx < Ids.Num(); ++Idx)
+	{
+		bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_UTF8(ids_arr, idx_key, TCHAR_TO_UTF8(*Ids[Idx]));
+	}
+	return ids_arr;
+}
+
+// Frames pipeline with optional time bounds
+bson_t* FSLMongoSchema::CreateFramesPipeline(const TArray<FString>& Ids, const double* StartTs, bool bStartExclusive, const double* EndTs) const
+{
+	bson_t* range = CreateTimeRange(StartTs, bStartExclusive, EndTs);
+	bson_t* ids_arr = CreateIdsArray(Ids);
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+	bson_t* match = bson_new();
+	bson_t* pipeline = nullptr;
+
+	if (Layout == ESLMongoSchemaLayout::Tf)
+	{
+		const FTCHARToUTF8 IdKey(*IdField);
+		const FTCHARToUTF8 SkelKey(*SkeletonField);
+		const FTCHARToUTF8 IdVar(*(TEXT("$") + IdField));
+		const FTCHARToUTF8 LocVar(*(TEXT("$") + LocField));
+		const FTCHARToUTF8 QuatVar(*(TEXT("$") + QuatField));
+
+		// Individual documents only (the keyframes have no child frame, the bones are part of the skeletal queries)
+		BSON_APPEND_DOCUMENT(match, Time.Get(), range);
+		bson_t id_cond;
+		BSON_APPEND_DOCUMENT_BEGIN(match, IdKey.Get(), &id_cond);
+		if (Ids.Num() > 0)
+		{
+			BSON_APPEND_ARRAY(&id_cond, "$in", ids_arr);
+		}
+		else
+		{
+			BSON_APPEND_BOOL(&id_cond, "$exists", true);
+		}
+		bson_append_document_end(match, &id_cond);
+		bson_t skel_cond;
+		BSON_APPEND_DOCUMENT_BEGIN(match, SkelKey.Get(), &skel_cond);
+		BSON_APPEND_BOOL(&skel_cond, "$exists", false);
+		bson_append_document_end(match, &skel_cond);
+
+		bson_t* ts_expr = CreateTimestampExpr("$_id");
+		pipeline = BCON_NEW("pipeline", "[",
+			"{",
+				"$match", BCON_DOCUMENT(match),
+			"}",
+			"{",
+				"$sort", "{", Time.Get(), BCON_INT32(1), "}",
+			"}",
+			"{",
+				"$group",
+				"{",
+					"_id", BCON_UTF8(TimeVar.Get()),							// the transforms written at the same time form a frame
+					"individuals",
+					"{",
+						"$push",
+						"{",
+							"id", BCON_UTF8(IdVar.Get()),
+							"loc", BCON_UTF8(LocVar.Get()),
+							"quat", BCON_UTF8(QuatVar.Get()),
+						"}",
+					"}",
+				"}",
+			"}",
+			"{",
+				"$sort", "{", "_id", BCON_INT32(1), "}",						// the groups are not ordered
+			"}",
+			"{",
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_DOCUMENT(ts_expr),
+					"individuals", BCON_INT32(1),
+				"}",
+			"}",
+			"]");
+		bson_destroy(ts_expr);
+	}
+	else
+	{
+		const FTCHARToUTF8 ArrayVar(*(TEXT("$") + IndividualsArray));
+		const FTCHARToUTF8 EntryIdVar(*(TEXT("$$ind.") + IdField));
+
+		BSON_APPEND_DOCUMENT(match, Time.Get(), range);
+		bson_t kf_cond;
+		BSON_APPEND_DOCUMENT_BEGIN(match, "keyframe", &kf_cond);
+		BSON_APPEND_BOOL(&kf_cond, "$ne", true);
+		bson_append_document_end(match, &kf_cond);
+
+		// Keep only the searched individuals, one document per frame instead of one per individual
+		bson_t* project = bson_new();
+		BSON_APPEND_INT32(project, "_id", 0);
+		BSON_APPEND_UTF8(project, "timestamp", TimeVar.Get());
+		if (Ids.Num() > 0)
+		{
+			const FTCHARToUTF8 IdKey(*(IndividualsArray + TEXT(".") + IdField));
+			bson_t in_cond;
+			BSON_APPEND_DOCUMENT_BEGIN(match, IdKey.Get(), &in_cond);
+			BSON_APPEND_ARRAY(&in_cond, "$in", ids_arr);
+			bson_append_document_end(match, &in_cond);
+
+			bson_t* filter = BCON_NEW(
+				"$filter",
+				"{",
+					"input", BCON_UTF8(ArrayVar.Get()),
+					"as", BCON_UTF8("ind"),
+					"cond", "{", "$in", "[", BCON_UTF8(EntryIdVar.Get()), BCON_ARRAY(ids_arr), "]", "}",
+				"}");
+			BSON_APPEND_DOCUMENT(project, "individuals", filter);
+			bson_destroy(filter);
+		}
+		else
+		{
+			BSON_APPEND_UTF8(project, "individuals", ArrayVar.Get());
+		}
+
+		pipeline = BCON_NEW("pipeline", "[",
+			"{",
+				"$match", BCON_DOCUMENT(match),
+			"}",
+			"{",
+				"$sort", "{", Time.Get(), BCON_INT32(1), "}",					// no time penalty if the collection is indexed
+			"}",
+			"{",
+				"$project", BCON_DOCUMENT(project),
+			"}",
+			"]");
+		bson_destroy(project);
+	}
+
+	bson_destroy(match);
+	bson_destroy(range);
+	bson_destroy(ids_arr);
+	return pipeline;
+}
+
+// Skeletal pipelines of the tf layout, the bones are looked up by the time of the skeletal individual document
+bson_t* FSLMongoSchema::CreateTfSkeletalPipeline(const char* CollName, const TArray<FString>& Ids, const double* StartTs, const double* EndTs,
+	bool bLastOnly, bool bAsFrames) const
+{
+	bson_t* range = CreateTimeRange(StartTs, false, EndTs);
+	bson_t* ids_arr = CreateIdsArray(Ids);
+	const FTCHARToUTF8 Time(*TimeField);
+	const FTCHARToUTF8 IdKey(*IdField);
+	const FTCHARToUTF8 TimeVar(*(TEXT("$") + TimeField));
+	const FTCHARToUTF8 IdVar(*(TEXT("$") + IdField));
+	const FTCHARToUTF8 LocVar(*(TEXT("$") + LocField));
+	const FTCHARToUTF8 QuatVar(*(TEXT("$") + QuatField));
+	const FTCHARToUTF8 SkelKey(*SkeletonField);
+	const FTCHARToUTF8 SkelVar(*(TEXT("$") + SkeletonField));
+	const FTCHARToUTF8 BoneIdxVar(*(TEXT("$$b.") + BoneIndexField));
+	const FTCHARToUTF8 BoneLocVar(*(TEXT("$$b.") + LocField));
+	const FTCHARToUTF8 BoneQuatVar(*(TEXT("$$b.") + QuatField));
+	bson_t* ts_expr = CreateTimestampExpr(TimeVar.Get());
+
+	// Skeletal individual documents in the time window
+	bson_t* stages = BCON_NEW("pipeline", "[",
+		"{",
+			"$match",
+			"{",
+				IdKey.Get(), "{", "$in", BCON_ARRAY(ids_arr), "}",
+				Time.Get(), BCON_DOCUMENT(range),
+			"}",
+		"}",
+		"{",
+			"$sort", "{", Time.Get(), BCON_INT32(bLastOnly ? -1 : 1), "}",
+		"}",
+		"{",
+			"$limit", BCON_INT32(bLastOnly ? 1 : INT32_MAX),
+		"}",
+		"{",
+			"$lookup",															// bone documents of the skeletal individual written at the same time
+			"{",																// (uses the skeleton and time index)
+				"from", BCON_UTF8(CollName),
+				"let", "{", "stamp", BCON_UTF8(TimeVar.Get()), "skel", BCON_UTF8(IdVar.Get()), "}",
+				"pipeline", "[",
+					"{",
+						"$match",
+						"{",
+							SkelKey.Get(), "{", "$exists", BCON_BOOL(true), "}",
+							"$expr",
+							"{",
+								"$and", "[",
+									"{", "$eq", "[", BCON_UTF8(SkelVar.Get()), BCON_UTF8("$$skel"), "]", "}",
+									"{", "$eq", "[", BCON_UTF8(TimeVar.Get()), BCON_UTF8("$$stamp"), "]", "}",
+								"]",
+							"}",
+						"}",
+					"}",
+				"]",
+				"as", BCON_UTF8("bones"),
+			"}",
+		"}",
+		"{",
+			"$project",
+			"{",
+				"_id", BCON_INT32(0),
+				"timestamp", BCON_DOCUMENT(ts_expr),
+				"id", BCON_UTF8(IdVar.Get()),
+				"loc", BCON_UTF8(LocVar.Get()),
+				"quat", BCON_UTF8(QuatVar.Get()),
+				"bones",
+				"{",
+					"$map",
+					"{",
+						"input", BCON_UTF8("$bones"),
+						"as", BCON_UTF8("b"),
+						"in", "{",
+							"idx", BCON_UTF8(BoneIdxVar.Get()),
+							"loc", BCON_UTF8(BoneLocVar.Get()),
+							"quat", BCON_UTF8(BoneQuatVar.Get()),
+						"}",
+					"}",
+				"}",
+			"}",
+		"}",
+		"]");
+
+	bson_t* pipeline = stages;
+	if (bAsFrames)
+	{
+		// Copy the stages and group the skeletal individuals of the same time into frames
+		pipeline = bson_new();
+		bson_t pipeline_arr;
+		bson_append_array_begin(pipeline, "pipeline", -1, &pipeline_arr);
+		uint32_t stage_idx = 0;
+		char idx_str[16];
+		const char *idx_key;
+		bson_iter_t iter;
+		bson_iter_t stage_iter;
+		if (bson_iter_init_find(&iter, stages, "pipeline") && bson_iter_recurse(&iter, &stage_iter))
+		{
+			while (bson_iter_next(&stage_iter))
+			{
+				bson_uint32_to_string(stage_idx++, &idx_key, idx_str, sizeof idx_str);
+				bson_append_iter(&pipeline_arr, idx_key, -1, &stage_iter);
+			}
+		}
+
+		bson_t* group = BCON_NEW(
+			"$group",
+			"{",
+				"_id", BCON_UTF8("$timestamp"),
+				"skel_individuals",
+				"{",
+					"$push", "{", "id", BCON_UTF8("$id"), "loc", BCON_UTF8("$loc"), "quat", BCON_UTF8("$quat"), "bones", BCON_UTF8("$bones"), "}",
+				"}",
+			"}");
+		bson_t* sort = BCON_NEW("$sort", "{", "_id", BCON_INT32(1), "}");
+		bson_t* project = BCON_NEW("$project", "{", "_id", BCON_INT32(0), "timestamp", BCON_UTF8("$_id"), "skel_individuals", BCON_INT32(1), "}");
+		for (bson_t* stage : { group, sort, project })
+		{
+			bson_uint32_to_string(stage_idx++, &idx_key, idx_str, sizeof idx_str);
+			bson_append_document(&pipeline_arr, idx_key, -1, stage);
+			bson_destroy(stage);
+		}
+		bson_append_array_end(pipeline, &pipeline_arr);
+		bson_destroy(stages);
+	}
+
+	bson_destroy(ts_expr);
+	bson_destroy(range);
+	bson_destroy(ids_arr);
+	return pipeline;
+}
+#endif //SL_WITH_LIBMONGO_C
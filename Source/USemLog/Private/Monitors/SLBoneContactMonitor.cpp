@@ -8,6 +8,7 @@
 #include "Animation/SkeletalMeshActor.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "TimerManager.h"
+#include "Utils/SLStats.h"
 
 // Ctor
 USLBoneContactMonitor::USLBoneContactMonitor()
@@ -393,6 +394,8 @@ void USLBoneContactMonitor::OnGraspOverlapBegin(UPrimitiveComponent* OverlappedC
 	bool bFromSweep,
 	const FHitResult& SweepResult)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_BoneContactMonitorOverlap);
+	INC_DWORD_STAT(STAT_SL_NumOverlapCallbacks);
 	// Ignore self overlaps
 	if (OtherActor == GetOwner())
 	{
@@ -455,6 +458,8 @@ void USLBoneContactMonitor::OnGraspOverlapEnd(UPrimitiveComponent* OverlappedCom
 	UPrimitiveComponent* OtherComp,
 	int32 OtherBodyIndex)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_BoneContactMonitorOverlap);
+	INC_DWORD_STAT(STAT_SL_NumOverlapCallbacks);
 	// Ignore self overlaps
 	if (OtherActor == GetOwner())
 	{
@@ -503,6 +508,7 @@ void USLBoneContactMonitor::OnGraspOverlapEnd(UPrimitiveComponent* OverlappedCom
 		// Delay publishing for a while, in case the new event is of the same type and should be concatenated
 		if(!GetWorld()->GetTimerManager().IsTimerActive(GraspDelayTimerHandle))
 		{
+			INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 			GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this, 
 				&USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback, ConcatenateIfSmaller*1.1f, false);
 		}
@@ -525,6 +531,7 @@ void USLBoneContactMonitor::OnGraspOverlapEnd(UPrimitiveComponent* OverlappedCom
 // Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
 void USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback()
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_BoneContactMonitorDelayedEnd);
 	// Curr time (keep very recently added events for another delay)
 	const float CurrTime = GetWorld()->GetTimeSeconds();
 	
@@ -552,6 +559,7 @@ void USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback()
 	if(RecentlyEndedGraspOverlapEvents.Num() > 0)
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle,
 			this, &USLBoneContactMonitor::DelayedGraspOverlapEndEventCallback, DelayValue, false);
 	}
@@ -634,6 +642,8 @@ void USLBoneContactMonitor::OnContactOverlapBegin(UPrimitiveComponent* Overlappe
 	bool bFromSweep,
 	const FHitResult& SweepResult)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_BoneContactMonitorOverlap);
+	INC_DWORD_STAT(STAT_SL_NumOverlapCallbacks);
 	// Ignore self overlaps
 	if (OtherActor == GetOwner())
 	{
@@ -692,6 +702,8 @@ void USLBoneContactMonitor::OnContactOverlapEnd(UPrimitiveComponent* OverlappedC
 	UPrimitiveComponent* OtherComp,
 	int32 OtherBodyIndex)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_BoneContactMonitorOverlap);
+	INC_DWORD_STAT(STAT_SL_NumOverlapCallbacks);
 	// Ignore self overlaps
 	if (OtherActor == GetOwner())
 	{
@@ -739,6 +751,7 @@ void USLBoneContactMonitor::OnContactOverlapEnd(UPrimitiveComponent* OverlappedC
 	if(!GetWorld()->GetTimerManager().IsTimerActive(ContactDelayTimerHandle))
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, 
 			this, &USLBoneContactMonitor::DelayContactEndCallback, DelayValue, false);
 	}
@@ -748,6 +761,7 @@ void USLBoneContactMonitor::OnContactOverlapEnd(UPrimitiveComponent* OverlappedC
 // Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
 void USLBoneContactMonitor::DelayContactEndCallback()
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_BoneContactMonitorDelayedEnd);
 	// Curr time (keep very recently added events for another delay)
 	const float CurrTime = GetWorld()->GetTimeSeconds();
 	
@@ -775,6 +789,7 @@ void USLBoneContactMonitor::DelayContactEndCallback()
 	if(RecentlyEndedContactOverlapEvents.Num() > 0)
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle,
 			this, &USLBoneContactMonitor::DelayContactEndCallback, DelayValue, false);
 	}
@@ -5,6 +5,7 @@
 #include "Individuals/SLIndividualUtils.h"
 #include "Components/MeshComponent.h"
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 
 // Stop publishing overlap events
 void ISLContactMonitorInterface::Finish(bool bForced)
@@ -63,6 +64,7 @@ void ISLContactMonitorInterface::StartSupportedByUpdateCheck()
 	{
 		// Start updating the timer, will be paused if there are no candidates
 		SupportedByTimerDelegate.BindRaw(this, &ISLContactMonitorInterface::SupportedByUpdateCheckBegin);
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		World->GetTimerManager().SetTimer(SupportedByTimerHandle, SupportedByTimerDelegate, SupportedByUpdateRate, true);
 	}
 }
@@ -71,6 +73,7 @@ void ISLContactMonitorInterface::StartSupportedByUpdateCheck()
 // TODO is a supported by end update look required?
 void ISLContactMonitorInterface::SupportedByUpdateCheckBegin()
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactMonitorSupportedBy);
 	// Check if candidates are in a supported by event
 	for (auto CandidateItr(SupportedByCandidates.CreateIterator()); CandidateItr; ++CandidateItr)
 	{
@@ -148,6 +151,8 @@ void ISLContactMonitorInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 	bool bFromSweep,
 	const FHitResult& SweepResult)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactMonitorOverlap);
+	INC_DWORD_STAT(STAT_SL_NumOverlapCallbacks);
 	//UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4fs \t BeginContact: \t %s:%s;"),
 	//	*FString(__FUNCTION__), __LINE__, World->GetTimeSeconds(), *OtherActor->GetName(), *OtherComp->GetName());
 
@@ -228,6 +233,8 @@ void ISLContactMonitorInterface::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
 	UPrimitiveComponent* OtherComp,
 	int32 OtherBodyIndex)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactMonitorOverlap);
+	INC_DWORD_STAT(STAT_SL_NumOverlapCallbacks);
 	//UE_LOG(LogTemp, Error, TEXT("%s::%d::%.4fs \t EndContact: \t %s::%s;"),
 	//	*FString(__FUNCTION__), __LINE__, World->GetTimeSeconds(), *OtherActor->GetName(), *OtherComp->GetName());
 
@@ -252,6 +259,7 @@ void ISLContactMonitorInterface::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
 	if(!World->GetTimerManager().IsTimerActive(DelayTimerHandle))
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		World->GetTimerManager().SetTimer(DelayTimerHandle, DelayTimerDelegate, DelayValue, false);
 	}
 }
@@ -259,6 +267,7 @@ void ISLContactMonitorInterface::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
 // Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
 void ISLContactMonitorInterface::DelayedOverlapEndEventCallback()
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContactMonitorDelayedEnd);
 	// Curr time (keep very recently added events for another delay)
 	const float CurrTime = World->GetTimeSeconds();
 	
@@ -275,6 +284,7 @@ void ISLContactMonitorInterface::DelayedOverlapEndEventCallback()
 	if(RecentlyEndedOverlapEvents.Num() > 0)
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		World->GetTimerManager().SetTimer(DelayTimerHandle, DelayTimerDelegate, DelayValue, false);
 	}
 }
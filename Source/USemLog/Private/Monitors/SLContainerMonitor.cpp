@@ -9,6 +9,7 @@
 
 #include "PhysicsEngine/PhysicsConstraintActor.h"
 #include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "Utils/SLStats.h"
 
 
 // Sets default values for this component's properties
@@ -105,6 +106,7 @@ void USLContainerMonitor::Finish(bool bForced)
 // Called when grasp starts
 void USLContainerMonitor::OnSLGraspBegin(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time, const FString& GraspType)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContainerMonitorCallbacks);
 	if(CurrGraspedIndividual)
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] Cannot set %s as grasped object.. manipulator is already grasping %s;"),
@@ -123,6 +125,7 @@ void USLContainerMonitor::OnSLGraspBegin(USLBaseIndividual* Self, USLBaseIndivid
 // Called when grasp ends
 void USLContainerMonitor::OnSLGraspEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ContainerMonitorCallbacks);
 	if(CurrGraspedIndividual == nullptr)
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d [%f] This should not happen.. currently grasped object is nullptr while ending grasp with %s"),
@@ -13,6 +13,7 @@
 #include "PhysicsEngine/PhysicsConstraintComponent.h" // AdHoc grasp helper
 #include "Components/StaticMeshComponent.h" // AdHoc grasp helper
 #include "Components/SkeletalMeshComponent.h" // AdHoc grasp helper
+#include "Utils/SLStats.h"
 
 #if SL_WITH_MC_GRASP
 #include "MCGraspAnimController.h"
@@ -533,6 +534,7 @@ void USLManipulatorMonitor::GraspInputAxisCallback(float Value)
 // Process beginning of grasp in group A
 void USLManipulatorMonitor::OnGroupAGraspContactBegin(USLBaseIndividual* OtherIndividual, const FName& BoneName)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorMonitorGrasp);
 	if (int32* NumContacts = GroupANumGraspContacts.Find(OtherIndividual))
 	{
 		// Already in contact with the group, increase the number of contacts
@@ -597,6 +599,7 @@ void USLManipulatorMonitor::OnGroupAGraspContactBegin(USLBaseIndividual* OtherIn
 // Process beginning of grasp in group B
 void USLManipulatorMonitor::OnGroupBGraspContactBegin(USLBaseIndividual* OtherIndividual, const FName& BoneName)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorMonitorGrasp);
 	if (int32* NumContacts = GroupBNumGraspContacts.Find(OtherIndividual))
 	{
 		// Already in contact with the group, increase the number of contacts
@@ -661,6 +664,7 @@ void USLManipulatorMonitor::OnGroupBGraspContactBegin(USLBaseIndividual* OtherIn
 // Process ending of contact in group A
 void USLManipulatorMonitor::OnGroupAGraspContactEnd(USLBaseIndividual* OtherIndividual, const FName& BoneName)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorMonitorGrasp);
 	if (int32* NumContacts = GroupANumGraspContacts.Find(OtherIndividual))
 	{
 		// Decrease the number of contacts
@@ -729,6 +733,7 @@ void USLManipulatorMonitor::OnGroupAGraspContactEnd(USLBaseIndividual* OtherIndi
 // Process ending of contact in group B
 void USLManipulatorMonitor::OnGroupBGraspContactEnd(USLBaseIndividual* OtherIndividual, const FName& BoneName)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorMonitorGrasp);
 	if (int32* NumContacts = GroupBNumGraspContacts.Find(OtherIndividual))
 	{
 		// Decrease the number of contacts
@@ -866,6 +871,7 @@ void USLManipulatorMonitor::GraspEnded(USLBaseIndividual* OtherIndividual)
 		if(!GetWorld()->GetTimerManager().IsTimerActive(GraspDelayTimerHandle))
 		{
 			const float DelayValue = GraspConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+			INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 			GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this,
 				&USLManipulatorMonitor::DelayedGraspEndCallback, DelayValue, false);
 		}
@@ -880,6 +886,7 @@ void USLManipulatorMonitor::GraspEnded(USLBaseIndividual* OtherIndividual)
 // Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
 void USLManipulatorMonitor::DelayedGraspEndCallback()
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorMonitorDelayedEnd);
 	// Curr time (keep very recently added events for another delay)
 	const float CurrTime = GetWorld()->GetTimeSeconds();
 	
@@ -913,6 +920,7 @@ void USLManipulatorMonitor::DelayedGraspEndCallback()
 	if(RecentlyEndedGraspEvents.Num() > 0)
 	{
 		const float DelayValue = GraspConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		GetWorld()->GetTimerManager().SetTimer(GraspDelayTimerHandle, this,
 			&USLManipulatorMonitor::DelayedGraspEndCallback, DelayValue, false);
 	}
@@ -949,6 +957,7 @@ bool USLManipulatorMonitor::IsAJitterGrasp(USLBaseIndividual* OtherIndividual, f
 // Process beginning of contact
 void USLManipulatorMonitor::OnBoneContactBegin(USLBaseIndividual* OtherIndividual, const FName& BoneName)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorMonitorContact);
 	if (int32* NumContacts = ManipulatorNumContacts.Find(OtherIndividual))
 	{
 		(*NumContacts)++;
@@ -982,6 +991,7 @@ void USLManipulatorMonitor::OnBoneContactBegin(USLBaseIndividual* OtherIndividua
 // Process ending of contact
 void USLManipulatorMonitor::OnBoneContactEnd(USLBaseIndividual* OtherIndividual, const FName& BoneName)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorMonitorContact);
 	if (int32* NumContacts = ManipulatorNumContacts.Find(OtherIndividual))
 	{
 		(*NumContacts)--;
@@ -1013,6 +1023,7 @@ void USLManipulatorMonitor::OnBoneContactEnd(USLBaseIndividual* OtherIndividual,
 			if(!GetWorld()->GetTimerManager().IsTimerActive(ContactDelayTimerHandle))
 			{
 				const float DelayValue = ContactConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+				INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 				GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, this,
 					&USLManipulatorMonitor::DelayedContactEndCallback,	DelayValue, false);
 			}
@@ -1063,6 +1074,7 @@ void USLManipulatorMonitor::UnbindContactCallbacks()
 // Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
 void USLManipulatorMonitor::DelayedContactEndCallback()
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ManipulatorMonitorDelayedEnd);
 	// Curr time (keep very recently added events for another delay)
 	const float CurrTime = GetWorld()->GetTimeSeconds();
 	
@@ -1090,6 +1102,7 @@ void USLManipulatorMonitor::DelayedContactEndCallback()
 	if(RecentlyEndedContactEvents.Num() > 0)
 	{
 		const float DelayValue = ContactConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		GetWorld()->GetTimerManager().SetTimer(ContactDelayTimerHandle, this,
 			&USLManipulatorMonitor::DelayedContactEndCallback, DelayValue, false);
 	}
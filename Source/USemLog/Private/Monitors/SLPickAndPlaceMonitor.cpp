@@ -6,6 +6,7 @@
 #include "Individuals/SLIndividualComponent.h"
 #include "Individuals/Type/SLBaseIndividual.h"
 #include "Animation/SkeletalMeshActor.h"
+#include "Utils/SLStats.h"
 
 // Sets default values for this component's properties
 USLPickAndPlaceMonitor::USLPickAndPlaceMonitor()
@@ -75,6 +76,7 @@ void USLPickAndPlaceMonitor::BeginPlay()
 // Called every frame, used for timeline visualizations, activated and deactivated on request
 void USLPickAndPlaceMonitor::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_PickAndPlaceMonitorUpdate);
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 	(this->*UpdateFunctionPtr)();
 }
@@ -191,6 +193,7 @@ bool USLPickAndPlaceMonitor::SubscribeForGraspEvents()
 // Called when grasp starts
 void USLPickAndPlaceMonitor::OnManipulatorGraspBegin(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time, const FString& GraspType)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_PickAndPlaceMonitorCallbacks);
 	if (bLogDebug)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4fs %s's Grasp event started received: \t %s->%s;"), *FString(__FUNCTION__), __LINE__,
@@ -272,6 +275,7 @@ void USLPickAndPlaceMonitor::OnManipulatorGraspBegin(USLBaseIndividual* Self, US
 // Called when grasp ends
 void USLPickAndPlaceMonitor::OnManipulatorGraspEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float Time)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_PickAndPlaceMonitorCallbacks);
 	if (bLogDebug)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4fs %s's Grasp event ended received: \t %s->%s;"), *FString(__FUNCTION__), __LINE__,
@@ -12,6 +12,7 @@
 #include "Engine/StaticMeshActor.h"
 #include "TimerManager.h"
 #include "Components/StaticMeshComponent.h"
+#include "Utils/SLStats.h"
 
 // Set default values
 USLReachAndPreGraspMonitor::USLReachAndPreGraspMonitor()
@@ -35,6 +36,8 @@ USLReachAndPreGraspMonitor::USLReachAndPreGraspMonitor()
 	// Default values
 	UpdateRate = 0.037;
 	ConcatenateIfSmaller = 0.4f;
+	CandidateGridCellSize = 25.f;
+	ReachHistoryDuration = 3.f;
 
 	ShapeColor = FColor::Orange.WithAlpha(64);
 
@@ -87,11 +90,14 @@ void USLReachAndPreGraspMonitor::Init()
 			return;
 		}
 
-		// Set tick update rate
+		// Set tick update rate (every frame if not set)
 		if (UpdateRate > 0.f)
 		{
 			SetComponentTickInterval(UpdateRate);
 		}
+
+		// Set the candidate tracking parameters
+		CandidatesTracker.Init(CandidateGridCellSize, ReachHistoryDuration, IgnoreMovementsSmallerThanValue);
 		
 		// Disable overlaps until start
 		SetGenerateOverlapEvents(false);
@@ -117,7 +123,7 @@ void USLReachAndPreGraspMonitor::Start()
 {
 	if (!bIsStarted && bIsInit)
 	{
-		// Start listening for overlaps
+		// Start listening for overlaps (the update callback is started with the first candidate)
 		SetGenerateOverlapEvents(true);
 
 		//// Iterate through the currently overlapping componets
@@ -229,62 +235,27 @@ bool USLReachAndPreGraspMonitor::SubscribeForManipulatorEvents()
 	return false;
 }
 
-// Update callback, checks distance to hand, if it increases it resets the start time
+// Update callback, records the hand motion and updates the candidates near the hand swept volume
 void USLReachAndPreGraspMonitor::UpdateCandidatesData(float DeltaTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ReachMonitorUpdate);
+	CandidatesTracker.Update(GetWorld()->GetTimeSeconds(), GetOwner()->GetActorLocation(), GetCandidateInfluenceRadius(DeltaTime));
+
 	if (bLogVerboseDebug)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f %s's CandidatesNum=%d; ContactNum=%d; DeltaTime=%f;"),
-		*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(), *GetOwner()->GetName(),
-			CandidatesData.Num(), ManipulatorContactData.Num(), DeltaTime);
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f %s's CandidatesNum=%d; UpdatedNum=%d; ContactNum=%d; DeltaTime=%f; HandVelocity=%s; Candidates=%s;"),
+			*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(), *GetOwner()->GetName(),
+			CandidatesTracker.Num(), CandidatesTracker.GetLastNumUpdated(), ManipulatorContactData.Num(), DeltaTime,
+			*CandidatesTracker.GetHandVelocity().ToString(), *CandidatesTracker.GetCandidatesInfo());
 	}
+}
 
-	const float CurrTimestamp = GetWorld()->GetTimeSeconds();
-	for (auto& CanidateData : CandidatesData)
-	{
-		const float CurrDist = FVector::Distance(GetOwner()->GetActorLocation(), CanidateData.Key->GetParentActor()->GetActorLocation());
-		const float PrevDist = CanidateData.Value.Get<1>();
-		const float DiffDist = PrevDist - CurrDist;
-
-		// Ignore small difference changes (IgnoreMovementsSmallerThanValue)
-		if (DiffDist > IgnoreMovementsSmallerThanValue)
-		{
-			if (bLogVerboseDebug)
-			{
-				UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f %s's is moving closer to %s; (PrevDist=%f; CurrDist=%f; DiffDist=%f;)"),
-					*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(),
-					*GetOwner()->GetName(), *CanidateData.Key->GetParentActor()->GetName(),
-					PrevDist, CurrDist, DiffDist);
-			}
-			// Positive difference makes the hand closer to the object, update the distance
-			CanidateData.Value.Get<ESLTimeAndDist::SLDist>() = CurrDist;
-		}
-		else if (DiffDist < -IgnoreMovementsSmallerThanValue)
-		{
-			// Negative difference makes the hand further away from the object, update distance, reset the start time
-			CanidateData.Value.Get<ESLTimeAndDist::SLTime>() = CurrTimestamp;
-			CanidateData.Value.Get<ESLTimeAndDist::SLDist>() = CurrDist;
-
-			if (bLogVerboseDebug)
-			{
-				UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f %s's is moving further to %s; (PrevDist=%f; CurrDist=%f; DiffDist=%f;)"),
-					*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(),
-					*GetOwner()->GetName(), *CanidateData.Key->GetParentActor()->GetName(),
-					PrevDist, CurrDist, DiffDist);
-			}
-		}
-		else
-		{
-			// TODO reset time when idling for a longer period
-			if (bLogVerboseDebug)
-			{
-				UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f %s's is idling relative to %s; (PrevDist=%f; CurrDist=%f; DiffDist=%f;)"),
-					*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(),
-					*GetOwner()->GetName(), *CanidateData.Key->GetParentActor()->GetName(),
-					PrevDist, CurrDist, DiffDist);
-			}
-		}
-	}
+// Radius around the hand swept volume in which the candidates are updated
+float USLReachAndPreGraspMonitor::GetCandidateInfluenceRadius(float DeltaTime) const
+{
+	// Distance the hand can cover until the next update, plus one grid cell as margin
+	// (the candidates further away are dormant and get their reach start back-tracked when needed)
+	return CandidatesTracker.GetHandVelocity().Size() * DeltaTime + CandidateGridCellSize;
 }
 
 // Publish currently overlapping components
@@ -351,6 +322,8 @@ void USLReachAndPreGraspMonitor::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 	bool bFromSweep,
 	const FHitResult& SweepResult)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ReachMonitorOverlap);
+	INC_DWORD_STAT(STAT_SL_NumOverlapCallbacks);
 	// Check if the component or its outer is semantically annotated
 	USLBaseIndividual* OtherIndividual = FSLIndividualUtils::GetIndividualObject(OtherActor);
 	if (OtherIndividual == nullptr)
@@ -362,14 +335,14 @@ void USLReachAndPreGraspMonitor::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 	// Check if the individual can be a reach candidate
 	if (CanBeACandidate(OtherActor))
 	{
-		const float Dist = FVector::Distance(GetOwner()->GetActorLocation(), OtherActor->GetActorLocation());
-		CandidatesData.Emplace(OtherIndividual, MakeTuple(GetWorld()->GetTimeSeconds(), Dist));
+		// The reach start is back-tracked from the recorded hand motion, late entering candidates keep their earliest reach start
+		CandidatesTracker.AddCandidate(OtherIndividual, GetWorld()->GetTimeSeconds(), GetOwner()->GetActorLocation());
 
 		if (bLogDebug)
 		{
 			UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f %s's added %s::%s as candidate (CandidatesNum=%d).."),
 				*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(),
-				*GetOwner()->GetName(), *OtherActor->GetName(), *OtherComp->GetName(), CandidatesData.Num());
+				*GetOwner()->GetName(), *OtherActor->GetName(), *OtherComp->GetName(), CandidatesTracker.Num());
 		}
 
 		// Make sure the candidate update check is running
@@ -377,7 +350,7 @@ void USLReachAndPreGraspMonitor::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 		{
 			if (bLogDebug)
 			{
-				UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f \t %s's first candidate added, starting tick.."),
+				UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f \t %s's candidate added, starting tick.."),
 					*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(), *GetOwner()->GetName());
 			}
 			SetComponentTickEnabled(true);
@@ -400,6 +373,8 @@ void USLReachAndPreGraspMonitor::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
 	UPrimitiveComponent* OtherComp,
 	int32 OtherBodyIndex)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ReachMonitorOverlap);
+	INC_DWORD_STAT(STAT_SL_NumOverlapCallbacks);
 	// Check if the component or its outer is semantically annotated
 	USLBaseIndividual* OtherIndividual = FSLIndividualUtils::GetIndividualObject(OtherActor);
 	if (OtherIndividual == nullptr)
@@ -409,24 +384,27 @@ void USLReachAndPreGraspMonitor::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
 	}
 
 	// Remove candidate
-	if (CandidatesData.Remove(OtherIndividual) > 0)
+	if (CandidatesTracker.RemoveCandidate(OtherIndividual))
 	{
 		if (bLogDebug)
 		{
 			UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f %s's removed %s::%s as candidate (CandidatesNum=%d).."),
 				*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(),
-				*GetOwner()->GetName(), *OtherActor->GetName(), *OtherComp->GetName(), CandidatesData.Num());
+				*GetOwner()->GetName(), *OtherActor->GetName(), *OtherComp->GetName(), CandidatesTracker.Num());
 		}
 
-		// Stop candidate update if this was the last candidate
-		if (CandidatesData.Num() == 0)
+		// Stop the update callback if there are no more candidates
+		if (CandidatesTracker.Num() == 0 && IsComponentTickEnabled())
 		{
 			if (bLogDebug)
 			{
-				UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f \t %s's last candidate removed, stopping tick.."),
+				UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4f \t %s's no more candidates, stopping tick.."),
 					*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(), *GetOwner()->GetName());
 			}
 			SetComponentTickEnabled(false);
+
+			// The velocity should not be estimated over the paused interval
+			CandidatesTracker.ResetHandHistory();
 		}
 	}
 	else
@@ -444,6 +422,7 @@ void USLReachAndPreGraspMonitor::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
 // Called when sibling detects a grasp, used for ending the manipulator positioning event
 void USLReachAndPreGraspMonitor::OnManipulatorGraspBegin(USLBaseIndividual* Self, USLBaseIndividual* Other, float Timestamp, const FString& GraspType)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ReachMonitorCallbacks);
 	if (bLogDebug)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4fs %s's Grasp event started received: \t %s->%s;"), *FString(__FUNCTION__), __LINE__,
@@ -460,7 +439,8 @@ void USLReachAndPreGraspMonitor::OnManipulatorGraspBegin(USLBaseIndividual* Self
 	}
 
 	// Check if the grasped object is a candidate and is in contact with the hand
-	if(FSLTimeAndDist* CandidateTimeAndDist = CandidatesData.Find(Other))
+	float ReachStartTime;
+	if(CandidatesTracker.GetReachStartTime(Other, ReachStartTime))
 	{
 		// TODO this could be an outdated time due to the delay, it however makes sense to keep it this way
 		// since if there is a grasp with the object, it should also be in contact with
@@ -480,24 +460,18 @@ void USLReachAndPreGraspMonitor::OnManipulatorGraspBegin(USLBaseIndividual* Self
 			GetWorld()->GetTimerManager().ClearTimer(DelayTimerHandle);
 
 			// Broadcast reach and pre grasp events
-			const float ReachStartTime = CandidateTimeAndDist->Get<ESLTimeAndDist::SLTime>();
 			const float ReachEndTime = *ContactTime;
 			OnReachAndPreGraspEvent.Broadcast(OwnerIndividualObject, Other, ReachStartTime, ReachEndTime, Timestamp);
 
 			if (bLogDebug)
 			{
-				FString CandidatesStr;
-				for (const auto& C : CandidatesData)
-				{
-					CandidatesStr.Append(C.Key->GetParentActor()->GetName() + ";");
-				}
 				UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4fs %s's removing candidates %s.."),
 					*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(),
-					*GetOwner()->GetName(), *CandidatesStr);
+					*GetOwner()->GetName(), *CandidatesTracker.GetCandidatesInfo());
 			}
 
 			// Remove existing candidates and pause the update callback while the hand is grasping
-			CandidatesData.Empty();
+			CandidatesTracker.Reset();
 			ManipulatorContactData.Empty();
 			SetComponentTickEnabled(false);
 
@@ -553,7 +527,7 @@ void USLReachAndPreGraspMonitor::OnManipulatorGraspEnd(USLBaseIndividual* Self,
 	// Set individual to nullptr
 	CurrGraspedIndividual = nullptr;
 	
-	// Grasp released start listening to overlaps
+	// Grasp released start listening to overlaps (the update callback is started with the first candidate)
 	SetGenerateOverlapEvents(true);
 
 	// TODO seems this is not needed anymore since the generate overlap events function already triggers the values
@@ -564,6 +538,7 @@ void USLReachAndPreGraspMonitor::OnManipulatorGraspEnd(USLBaseIndividual* Self,
 // Called when the sibling is in contact with an object, used for ending the reaching event and starting the manipulator positioning event
 void USLReachAndPreGraspMonitor::OnManipulatorContactBegin(const FSLContactResult& ContactResult)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ReachMonitorCallbacks);
 	if (bLogDebug)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4fs %s's Contact event started received: \t %s->%s;"), *FString(__FUNCTION__), __LINE__,
@@ -582,7 +557,7 @@ void USLReachAndPreGraspMonitor::OnManipulatorContactBegin(const FSLContactResul
 	}
 
 	// Make sure the individual in contact with the hand is in the candidates list
-	if (!CandidatesData.Contains(ContactResult.Other))
+	if (!CandidatesTracker.Contains(ContactResult.Other))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d::%4.f %s's %s IS in contact with the manipulator, but it is not in the candidates list, this should not happen.."),
 			*FString(__FUNCTION__), __LINE__, GetWorld()->GetTimeSeconds(), *GetOwner()->GetName(), *ContactResult.Other->GetParentActor()->GetName());
@@ -606,6 +581,7 @@ void USLReachAndPreGraspMonitor::OnManipulatorContactBegin(const FSLContactResul
 // Manipulator is not in contact with object anymore, check for possible concatenation, or reset the potential reach time
 void USLReachAndPreGraspMonitor::OnManipulatorContactEnd(USLBaseIndividual* Self, USLBaseIndividual* Other, float EndTime)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ReachMonitorCallbacks);
 	if (bLogDebug)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d::%.4fs %s's Contact event ended received: \t %s->%s;"), *FString(__FUNCTION__), __LINE__,
@@ -624,7 +600,7 @@ void USLReachAndPreGraspMonitor::OnManipulatorContactEnd(USLBaseIndividual* Self
 	}
 
 	// Make sure the individual in contact with the hand is in the candidates list
-	if (!CandidatesData.Contains(Other))
+	if (!CandidatesTracker.Contains(Other))
 	{
 		// Might happen due to the contact event end jitter check publishing delay
 		UE_LOG(LogTemp, Error, TEXT("%s::%d::%4.f %s's %s WAS in contact with the manipulator, but it is not in the candidates list, this can happen if moving fast.."),
@@ -645,6 +621,7 @@ void USLReachAndPreGraspMonitor::OnManipulatorContactEnd(USLBaseIndividual* Self
 	if(!GetWorld()->GetTimerManager().IsTimerActive(DelayTimerHandle))
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		GetWorld()->GetTimerManager().SetTimer(DelayTimerHandle,
 			this, &USLReachAndPreGraspMonitor::DelayContactEndCallback, DelayValue, false);
 	}
@@ -653,6 +630,7 @@ void USLReachAndPreGraspMonitor::OnManipulatorContactEnd(USLBaseIndividual* Self
 // Delayed call of setting finished event to check for possible concatenation of jittering events of the same type
 void USLReachAndPreGraspMonitor::DelayContactEndCallback()
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_ReachMonitorCallbacks);
 	// Curr time (keep very recently added events for another delay)
 	const float CurrTime = GetWorld()->GetTimeSeconds();
 	
@@ -662,14 +640,14 @@ void USLReachAndPreGraspMonitor::DelayContactEndCallback()
 		if(CurrTime - EvItr->Time > ConcatenateIfSmaller)
 		{
 			// Reset reach start in the candidate
-			if(FSLTimeAndDist* TimeAndDist = CandidatesData.Find(EvItr->Other))
+			if(CandidatesTracker.Contains(EvItr->Other))
 			{
 				// No new contact happened, remove and reset reach time
 				if(ManipulatorContactData.Remove(EvItr->Other) > 0)
 				{
 					//UE_LOG(LogTemp, Warning, TEXT("%s::%d [%f] %s removed as object in contact with the manipulator.. (after delay, contact end time=%f)"),
 					//	*FString(__func__), __LINE__, GetWorld()->GetTimeSeconds(), *EvItr->Other->GetName(), EvItr->Timestamp);
-					TimeAndDist->Get<ESLTimeAndDist::SLTime>() = GetWorld()->GetTimeSeconds();
+					CandidatesTracker.ResetReachStartTime(EvItr->Other, GetWorld()->GetTimeSeconds());
 				}
 				else
 				{
@@ -695,6 +673,7 @@ void USLReachAndPreGraspMonitor::DelayContactEndCallback()
 	if(RecentlyEndedEvents.Num() > 0)
 	{
 		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+		INC_DWORD_STAT(STAT_SL_NumTimersArmed);
 		GetWorld()->GetTimerManager().SetTimer(DelayTimerHandle,
 			this, &USLReachAndPreGraspMonitor::DelayContactEndCallback, DelayValue, false);
 	}
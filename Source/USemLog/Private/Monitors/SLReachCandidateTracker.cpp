@@ -0,0 +1,320 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Monitors/SLReachCandidateTracker.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "GameFramework/Actor.h"
+#include "Utils/SLStats.h"
+
+// Default ctor
+FSLReachCandidateTracker::FSLReachCandidateTracker()
+{
+	HandVelocity = FVector::ZeroVector;
+	PrevUpdateTime = 0.f;
+	LastNumUpdated = 0;
+	Init(25.f, 3.f, 2.5f);
+}
+
+// Set the tracking parameters
+void FSLReachCandidateTracker::Init(float InCellSize, float InHistoryDuration, float InIgnoreMovementsSmallerThan)
+{
+	CellSize = FMath::Max(InCellSize, 1.f);
+	InvCellSize = 1.f / CellSize;
+	HistoryDuration = FMath::Max(InHistoryDuration, 0.f);
+	IgnoreMovementsSmallerThan = InIgnoreMovementsSmallerThan;
+}
+
+// Remove all candidates and the hand motion history
+void FSLReachCandidateTracker::Reset()
+{
+	DEC_DWORD_STAT_BY(STAT_SL_NumReachCandidates, Candidates.Num());
+	Candidates.Empty();
+	Grid.Empty();
+	ResetHandHistory();
+	LastNumUpdated = 0;
+}
+
+// Record the hand location and update the candidates around the hand swept volume
+void FSLReachCandidateTracker::Update(float Time, const FVector& HandLocation, float InfluenceRadius)
+{
+	// Estimate the hand velocity from the previous sample
+	FVector PrevHandLocation = HandLocation;
+	float DeltaTime = 0.f;
+	if (HandHistory.Num() > 0)
+	{
+		const FSLReachHandSample& PrevSample = HandHistory.Last();
+		PrevHandLocation = PrevSample.Location;
+		DeltaTime = Time - PrevSample.Time;
+		if (DeltaTime > KINDA_SMALL_NUMBER)
+		{
+			HandVelocity = (HandLocation - PrevSample.Location) / DeltaTime;
+		}
+	}
+
+	// Record the sample and drop the ones older than the history duration (keep at least one)
+	HandHistory.Emplace(Time, HandLocation);
+	int32 NumExpired = 0;
+	while (NumExpired < HandHistory.Num() - 1 && Time - HandHistory[NumExpired].Time > HistoryDuration)
+	{
+		NumExpired++;
+	}
+	if (NumExpired > 0)
+	{
+		HandHistory.RemoveAt(0, NumExpired, false);
+	}
+
+	LastNumUpdated = 0;
+	if (Candidates.Num() == 0)
+	{
+		PrevUpdateTime = Time;
+		return;
+	}
+
+	// Swept volume of the hand from the previous to the predicted next location
+	const FVector PredictedHandLocation = HandLocation + HandVelocity * DeltaTime;
+	FBox SweptBox(ForceInit);
+	SweptBox += PrevHandLocation;
+	SweptBox += HandLocation;
+	SweptBox += PredictedHandLocation;
+	SweptBox = SweptBox.ExpandBy(InfluenceRadius);
+
+	const FIntVector MinCell = GetCell(SweptBox.Min);
+	const FIntVector MaxCell = GetCell(SweptBox.Max);
+	const int64 NumSweptCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1) * int64(MaxCell.Z - MinCell.Z + 1);
+
+	// Candidates which moved to another cell, rebinned after the iteration
+	TArray<TPair<USLBaseIndividual*, FIntVector>> ToRebin;
+
+	auto UpdateCell = [&](const TArray<USLBaseIndividual*>& CellCandidates)
+	{
+		for (USLBaseIndividual* Individual : CellCandidates)
+		{
+			FSLReachCandidateData& Data = Candidates.FindChecked(Individual);
+			const FVector CandidateLocation = GetCandidateLocation(Individual);
+			if (UpdateCandidate(Data, CandidateLocation, Time, HandLocation))
+			{
+				ToRebin.Emplace(Individual, GetCell(CandidateLocation));
+			}
+			LastNumUpdated++;
+		}
+	};
+
+	if (NumSweptCells > Grid.Num())
+	{
+		// Fewer occupied cells than swept cells, check the occupied ones against the swept bounds
+		for (const auto& CellPair : Grid)
+		{
+			const FIntVector& Cell = CellPair.Key;
+			if (Cell.X >= MinCell.X && Cell.X <= MaxCell.X &&
+				Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y &&
+				Cell.Z >= MinCell.Z && Cell.Z <= MaxCell.Z)
+			{
+				UpdateCell(CellPair.Value);
+			}
+		}
+	}
+	else
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+				{
+					if (const TArray<USLBaseIndividual*>* CellCandidates = Grid.Find(FIntVector(X, Y, Z)))
+					{
+						UpdateCell(*CellCandidates);
+					}
+				}
+			}
+		}
+	}
+
+	for (const auto& RebinPair : ToRebin)
+	{
+		Rebin(RebinPair.Key, Candidates.FindChecked(RebinPair.Key), RebinPair.Value);
+	}
+	INC_DWORD_STAT_BY(STAT_SL_NumReachCandidatesUpdated, LastNumUpdated);
+
+	PrevUpdateTime = Time;
+}
+
+// Add candidate, the reach start time is back-tracked from the hand motion history
+bool FSLReachCandidateTracker::AddCandidate(USLBaseIndividual* Individual, float Time, const FVector& HandLocation)
+{
+	if (Individual == nullptr || Individual->GetParentActor() == nullptr)
+	{
+		return false;
+	}
+
+	// Re-adding a candidate restarts its data
+	RemoveCandidate(Individual);
+
+	const FVector CandidateLocation = GetCandidateLocation(Individual);
+	const FIntVector Cell = GetCell(CandidateLocation);
+	const float ReachStartTime = BacktrackReachStartTime(CandidateLocation, Time, HandLocation);
+	Candidates.Emplace(Individual, FSLReachCandidateData(ReachStartTime,
+		FVector::Distance(HandLocation, CandidateLocation), Cell, Time));
+	Grid.FindOrAdd(Cell).Add(Individual);
+	INC_DWORD_STAT(STAT_SL_NumReachCandidates);
+	return true;
+}
+
+// Remove candidate, returns false if it was not tracked
+bool FSLReachCandidateTracker::RemoveCandidate(USLBaseIndividual* Individual)
+{
+	FSLReachCandidateData Data;
+	if (Candidates.RemoveAndCopyValue(Individual, Data))
+	{
+		if (TArray<USLBaseIndividual*>* CellCandidates = Grid.Find(Data.Cell))
+		{
+			CellCandidates->RemoveSingleSwap(Individual, false);
+			if (CellCandidates->Num() == 0)
+			{
+				Grid.Remove(Data.Cell);
+			}
+		}
+		DEC_DWORD_STAT(STAT_SL_NumReachCandidates);
+		return true;
+	}
+	return false;
+}
+
+// Get the reach start time of the candidate (refreshed if the candidate is dormant), returns false if not a candidate
+bool FSLReachCandidateTracker::GetReachStartTime(USLBaseIndividual* Individual, float& OutReachStartTime)
+{
+	if (FSLReachCandidateData* Data = Candidates.Find(Individual))
+	{
+		// Dormant candidate, back-track the reach start from the latest hand sample
+		if (Data->LastUpdateTime < PrevUpdateTime && HandHistory.Num() > 0)
+		{
+			const FSLReachHandSample& LastSample = HandHistory.Last();
+			const FVector CandidateLocation = GetCandidateLocation(Individual);
+			BacktrackDormantCandidate(*Data, CandidateLocation, LastSample.Time, LastSample.Location);
+			Data->Dist = FVector::Distance(LastSample.Location, CandidateLocation);
+			Data->LastUpdateTime = LastSample.Time;
+		}
+		OutReachStartTime = Data->ReachStartTime;
+		return true;
+	}
+	return false;
+}
+
+// Restart the reach of the candidate from the given time (e.g. the hand lost contact with it)
+bool FSLReachCandidateTracker::ResetReachStartTime(USLBaseIndividual* Individual, float Time)
+{
+	if (FSLReachCandidateData* Data = Candidates.Find(Individual))
+	{
+		Data->ReachStartTime = Time;
+		Data->ResetTime = Time;
+		return true;
+	}
+	return false;
+}
+
+// Get the candidate names as a string (debug)
+FString FSLReachCandidateTracker::GetCandidatesInfo() const
+{
+	FString Info;
+	for (const auto& CandidatePair : Candidates)
+	{
+		Info.Append(FString::Printf(TEXT("%s(%.3fs);"),
+			CandidatePair.Key->GetParentActor() ? *CandidatePair.Key->GetParentActor()->GetName() : TEXT("null"),
+			CandidatePair.Value.ReachStartTime));
+	}
+	return Info;
+}
+
+// Update the reach data of the candidate, returns true if it changed cells
+bool FSLReachCandidateTracker::UpdateCandidate(FSLReachCandidateData& Data, const FVector& CandidateLocation, float Time, const FVector& HandLocation)
+{
+	const float CurrDist = FVector::Distance(HandLocation, CandidateLocation);
+	if (Data.LastUpdateTime < PrevUpdateTime)
+	{
+		// Candidate was dormant (outside of the swept volume), back-track its reach start
+		BacktrackDormantCandidate(Data, CandidateLocation, Time, HandLocation);
+		Data.Dist = CurrDist;
+	}
+	else
+	{
+		const float DiffDist = Data.Dist - CurrDist;
+		if (DiffDist > IgnoreMovementsSmallerThan)
+		{
+			// Positive difference makes the hand closer to the object, update the distance
+			Data.Dist = CurrDist;
+		}
+		else if (DiffDist < -IgnoreMovementsSmallerThan)
+		{
+			// Negative difference makes the hand further away from the object, update distance, reset the start time
+			Data.ReachStartTime = Time;
+			Data.Dist = CurrDist;
+		}
+	}
+	Data.LastUpdateTime = Time;
+	return GetCell(CandidateLocation) != Data.Cell;
+}
+
+// Earliest time since the hand did not move away from the given location
+float FSLReachCandidateTracker::BacktrackReachStartTime(const FVector& CandidateLocation, float Time, const FVector& HandLocation, bool* bOutHitOldest) const
+{
+	if (bOutHitOldest)
+	{
+		*bOutHitOldest = true;
+	}
+
+	// Walk back in time as long as no later sample is further away than the current one (up to the ignore threshold)
+	float ReachStartTime = Time;
+	float MaxLaterDist = FVector::Distance(HandLocation, CandidateLocation);
+	for (int32 Idx = HandHistory.Num() - 1; Idx >= 0; --Idx)
+	{
+		const FSLReachHandSample& Sample = HandHistory[Idx];
+		if (Sample.Time > Time)
+		{
+			continue;
+		}
+		const float SampleDist = FVector::Distance(Sample.Location, CandidateLocation);
+		if (MaxLaterDist - SampleDist > IgnoreMovementsSmallerThan)
+		{
+			if (bOutHitOldest)
+			{
+				*bOutHitOldest = false;
+			}
+			break;
+		}
+		ReachStartTime = Sample.Time;
+		MaxLaterDist = FMath::Max(MaxLaterDist, SampleDist);
+	}
+	return ReachStartTime;
+}
+
+// Back-track the reach start of the dormant candidate, keeps its earlier start if the history is too short
+void FSLReachCandidateTracker::BacktrackDormantCandidate(FSLReachCandidateData& Data, const FVector& CandidateLocation, float Time, const FVector& HandLocation) const
+{
+	bool bHitOldest = false;
+	const float Backtrack = BacktrackReachStartTime(CandidateLocation, Time, HandLocation, &bHitOldest);
+
+	// Without a break the hand was approaching for the whole history, the previously known start is still valid
+	const float ReachStartTime = bHitOldest ? FMath::Min(Data.ReachStartTime, Backtrack) : Backtrack;
+	Data.ReachStartTime = FMath::Max(ReachStartTime, Data.ResetTime);
+}
+
+// Move the candidate to its new cell
+void FSLReachCandidateTracker::Rebin(USLBaseIndividual* Individual, FSLReachCandidateData& Data, const FIntVector& NewCell)
+{
+	if (TArray<USLBaseIndividual*>* OldCellCandidates = Grid.Find(Data.Cell))
+	{
+		OldCellCandidates->RemoveSingleSwap(Individual, false);
+		if (OldCellCandidates->Num() == 0)
+		{
+			Grid.Remove(Data.Cell);
+		}
+	}
+	Grid.FindOrAdd(NewCell).Add(Individual);
+	Data.Cell = NewCell;
+}
+
+// Get the tracked location of the individual
+FVector FSLReachCandidateTracker::GetCandidateLocation(USLBaseIndividual* Individual)
+{
+	return Individual->GetParentActor()->GetActorLocation();
+}
@@ -105,7 +105,7 @@ TSharedPtr<FSLOwlExperiment> FSLOwlExperimentStatics::CreateDefaultExperiment(
 //}
 
 // Write experiment to file
-void FSLOwlExperimentStatics::WriteToFile(TSharedPtr<FSLOwlExperiment> Experiment, const FString& Path, bool bOverwrite)
+void FSLOwlExperimentStatics::WriteToFile(TSharedPtr<FSLOwlExperiment> Experiment, const FString& Path, bool bOverwrite, bool bWriteNTriples)
 {
 	// Write owl data to file
 	if (Experiment.IsValid())
@@ -115,7 +115,17 @@ void FSLOwlExperimentStatics::WriteToFile(TSharedPtr<FSLOwlExperiment> Experimen
 		FPaths::RemoveDuplicateSlashes(FullFilePath);
 		if (!FPaths::FileExists(FullFilePath) || bOverwrite)
 		{
-			FFileHelper::SaveStringToFile(Experiment->ToString(), *FullFilePath);
+			FSLOwlWriter::WriteToFile(*Experiment, FullFilePath);
+		}
+
+		// Write experiment triples to file
+		if (bWriteNTriples)
+		{
+			const FString TriplesFilePath = FPaths::ChangeExtension(FullFilePath, FSLOwlWriter::GetFileExtension(ESLOwlWriterFormat::NTriples));
+			if (!FPaths::FileExists(TriplesFilePath) || bOverwrite)
+			{
+				FSLOwlWriter::WriteToFile(*Experiment, TriplesFilePath, ESLOwlWriterFormat::NTriples);
+			}
 		}
 	}
 }
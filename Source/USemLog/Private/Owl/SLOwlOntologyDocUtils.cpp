@@ -8,6 +8,7 @@
 #include "EngineUtils.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
+#include "Owl/SLOwlWriter.h"
 
 // Owl
 #include "Owl/SLOwlDoc.h"
@@ -88,7 +89,7 @@ bool FSLOwlOntologyDocUtils::PrintDoc(const FSLOwlDoc& InDoc, const FString& Pat
         return false;
     }
 
-    return FFileHelper::SaveStringToFile(InDoc.ToString(), *FullPath);
+    return FSLOwlWriter::WriteToFile(InDoc, FullPath);
 }
 
 // Create a semantic map document template
@@ -8,6 +8,7 @@
 #include "EngineUtils.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
+#include "Owl/SLOwlWriter.h"
 
 // Owl
 #include "Owl/SLOwlDoc.h"
@@ -87,7 +88,7 @@ bool FSLOwlSemMapDocUtils::PrintDoc(const FSLOwlDoc& InDoc, const FString& Path,
         return false;
     }
 
-    return FFileHelper::SaveStringToFile(InDoc.ToString(), *FullPath);
+    return FSLOwlWriter::WriteToFile(InDoc, FullPath);
 }
 
 // Create a semantic map document template
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Owl/SLOwlTaskStatics.h"
+#include "Owl/SLOwlWriter.h"
 
 /* Semantic map template creation */
 // Create default Task document
@@ -61,7 +62,7 @@ void FSLOwlTaskStatics::WriteToFile(TSharedPtr<FSLOwlTask> Task, const FString&
 		FPaths::RemoveDuplicateSlashes(FullFilePath);
 		if (!FPaths::FileExists(FullFilePath) || bOverwrite)
 		{
-			FFileHelper::SaveStringToFile(Task->ToString(), *FullFilePath);
+			FSLOwlWriter::WriteToFile(*Task, FullFilePath);
 		}
 	}
 }
\ No newline at end of file
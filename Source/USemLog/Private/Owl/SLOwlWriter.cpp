@@ -0,0 +1,512 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Owl/SLOwlWriter.h"
+
+// Ctor
+FSLOwlWriter::FSLOwlWriter(ESLOwlWriterFormat InFormat, int32 InBufferSize) : Out(InBufferSize)
+{
+	Format = InFormat;
+	BlankNodesNum = 0;
+	TriplesNum = 0;
+}
+
+// Write the document to the file
+bool FSLOwlWriter::Write(const FSLOwlDoc& Doc, const FString& FilePath)
+{
+	if (Out.IsOpen())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Owl writer is already writing a document.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+	if (!Out.Open(FilePath))
+	{
+		return false;
+	}
+
+	BlankNodesNum = 0;
+	TriplesNum = 0;
+
+	if (Format == ESLOwlWriterFormat::RdfXml)
+	{
+		WriteXmlDoc(Doc);
+	}
+	else
+	{
+		InitPrefixes(Doc);
+		WriteNodeTriples(Doc.OntologyImports);
+		WriteNodesTriples(Doc.PropertyDefinitions);
+		WriteNodesTriples(Doc.DatatypeDefinitions);
+		WriteNodesTriples(Doc.ClassDefinitions);
+		WriteNodesTriples(Doc.Individuals);
+	}
+
+	const bool bSuccess = Out.Close();
+	if (!bSuccess)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Error while writing %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+	}
+	return bSuccess;
+}
+
+// Write the document to the file in the given format
+bool FSLOwlWriter::WriteToFile(const FSLOwlDoc& Doc, const FString& FilePath, ESLOwlWriterFormat Format)
+{
+	FSLOwlWriter Writer(Format);
+	return Writer.Write(Doc, FilePath);
+}
+
+// Get the file extension of the format (with the dot)
+const TCHAR* FSLOwlWriter::GetFileExtension(ESLOwlWriterFormat Format)
+{
+	return Format == ESLOwlWriterFormat::NTriples ? TEXT(".nt") : TEXT(".owl");
+}
+
+
+/* RDF/XML */
+// Write the xml header, the entity definitions and the root node
+void FSLOwlWriter::WriteXmlDoc(const FSLOwlDoc& Doc)
+{
+	Out.AppendRaw("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n\n");
+
+	// Document Type Definition
+	if (Doc.EntityDefinitions.EntityPairs.Num() > 0)
+	{
+		Out.AppendRaw("<!DOCTYPE ");
+		Out.Append(Doc.EntityDefinitions.Name.ToString());
+		Out.AppendRaw("[\n");
+		for (const auto& EntityPair : Doc.EntityDefinitions.EntityPairs)
+		{
+			AppendIndent(1);
+			Out.AppendRaw("<!ENTITY ");
+			Out.Append(EntityPair.Key);
+			Out.AppendRaw(" \"");
+			Out.Append(EntityPair.Value);
+			Out.AppendRaw("\">\n");
+		}
+		Out.AppendRaw("]>\n\n");
+	}
+
+	// Root node with the namespaces, the children are streamed from the document arrays
+	WriteXmlOpenTag(FSLOwlPrefixName("rdf", "RDF"), Doc.Namespaces, 0);
+	Out.AppendRaw(">\n");
+	WriteXmlNode(Doc.OntologyImports, 1);
+	for (const auto& Node : Doc.PropertyDefinitions)
+	{
+		WriteXmlNode(Node, 1);
+	}
+	for (const auto& Node : Doc.DatatypeDefinitions)
+	{
+		WriteXmlNode(Node, 1);
+	}
+	for (const auto& Node : Doc.ClassDefinitions)
+	{
+		WriteXmlNode(Node, 1);
+	}
+	for (const auto& Node : Doc.Individuals)
+	{
+		WriteXmlNode(Node, 1);
+	}
+	Out.AppendRaw("</rdf:RDF>\n");
+}
+
+// Write the node and its children
+void FSLOwlWriter::WriteXmlNode(const FSLOwlNode& Node, int32 Depth)
+{
+	// Add comment
+	if (!Node.Comment.IsEmpty())
+	{
+		Out.AppendRaw("\n");
+		AppendIndent(Depth);
+		Out.AppendRaw("<!-- ");
+		Out.Append(Node.Comment);
+		Out.AppendRaw(" -->\n");
+	}
+
+	// Comment only OR empty node
+	if (Node.Name.IsEmpty())
+	{
+		return;
+	}
+
+	WriteXmlOpenTag(Node.Name, Node.Attributes, Depth);
+
+	// Node cannot have value and children
+	if (Node.ChildNodes.Num() == 0 && Node.Value.IsEmpty())
+	{
+		Out.AppendRaw("/>\n");
+	}
+	else if (!Node.Value.IsEmpty())
+	{
+		Out.AppendRaw(">");
+		AppendXmlEscaped(Node.Value);
+		Out.AppendRaw("</");
+		Out.Append(Node.Name.ToString());
+		Out.AppendRaw(">\n");
+	}
+	else
+	{
+		Out.AppendRaw(">\n");
+		for (const auto& Child : Node.ChildNodes)
+		{
+			WriteXmlNode(Child, Depth + 1);
+		}
+		AppendIndent(Depth);
+		Out.AppendRaw("</");
+		Out.Append(Node.Name.ToString());
+		Out.AppendRaw(">\n");
+	}
+}
+
+// Write the opening tag of the node (without closing it)
+void FSLOwlWriter::WriteXmlOpenTag(const FSLOwlPrefixName& Name, const TArray<FSLOwlAttribute>& Attributes, int32 Depth)
+{
+	AppendIndent(Depth);
+	Out.AppendRaw("<");
+	Out.Append(Name.ToString());
+	for (int32 Idx = 0; Idx < Attributes.Num(); ++Idx)
+	{
+		Out.AppendRaw(" ");
+		Out.Append(Attributes[Idx].Key.ToString());
+		Out.AppendRaw("=");
+		WriteXmlAttributeValue(Attributes[Idx].Value);
+
+		// Multiple attributes are written on separate lines, the last one does not have a new line
+		if (Idx < Attributes.Num() - 1)
+		{
+			Out.AppendRaw("\n");
+			AppendIndent(Depth + 1);
+		}
+	}
+}
+
+// Write the attribute value with its quotes ("&Ns;LocalValue")
+void FSLOwlWriter::WriteXmlAttributeValue(const FSLOwlAttributeValue& AttributeValue)
+{
+	Out.AppendRaw("\"");
+	if (!AttributeValue.Ns.IsEmpty())
+	{
+		Out.AppendRaw("&");
+		Out.Append(AttributeValue.Ns);
+		Out.AppendRaw(";");
+	}
+	AppendXmlEscaped(AttributeValue.LocalValue);
+	Out.AppendRaw("\"");
+}
+
+
+/* N-Triples */
+// Cache the namespace and entity expansions of the document
+void FSLOwlWriter::InitPrefixes(const FSLOwlDoc& Doc)
+{
+	NamespaceIris.Empty();
+	EntityIris.Empty();
+	BaseIri.Empty();
+
+	for (const auto& EntityPair : Doc.EntityDefinitions.EntityPairs)
+	{
+		EntityIris.Add(EntityPair.Key, EntityPair.Value);
+	}
+
+	// The namespace values can use the entities as well
+	for (const auto& Namespace : Doc.Namespaces)
+	{
+		if (Namespace.Key.Prefix.Equals(TEXT("xmlns")))
+		{
+			NamespaceIris.Add(Namespace.Key.LocalName, ExpandValue(Namespace.Value));
+		}
+		else if (Namespace.Key.Prefix.Equals(TEXT("xml")) && Namespace.Key.LocalName.Equals(TEXT("base")))
+		{
+			BaseIri = ExpandValue(Namespace.Value);
+		}
+	}
+}
+
+// Write the triples of the nodes
+void FSLOwlWriter::WriteNodesTriples(const TArray<FSLOwlNode>& Nodes)
+{
+	for (const auto& Node : Nodes)
+	{
+		WriteNodeTriples(Node);
+	}
+}
+
+// Write the triples of the node element, returns its subject term
+FString FSLOwlWriter::WriteNodeTriples(const FSLOwlNode& Node)
+{
+	// Comment only OR empty node
+	if (Node.Name.IsEmpty())
+	{
+		return FString();
+	}
+
+	// Subject from rdf:about, rdf:nodeID or a new blank node
+	FString Subject;
+	if (const FSLOwlAttribute* About = FindAttribute(Node, TEXT("rdf"), TEXT("about")))
+	{
+		Subject = ToIriTerm(ExpandValue(About->Value));
+	}
+	else if (const FSLOwlAttribute* NodeId = FindAttribute(Node, TEXT("rdf"), TEXT("nodeID")))
+	{
+		Subject = TEXT("_:") + NodeId->Value.LocalValue;
+	}
+	else
+	{
+		Subject = FString::Printf(TEXT("_:b%d"), BlankNodesNum++);
+	}
+
+	// Typed node element (rdf:Description has no type)
+	if (!(Node.Name.Prefix.Equals(TEXT("rdf")) && Node.Name.LocalName.Equals(TEXT("Description"))))
+	{
+		WriteTriple(Subject, ExpandName(FSLOwlPrefixName("rdf", "type")), ToIriTerm(ExpandName(Node.Name)));
+	}
+
+	// Property attributes
+	for (const auto& Attribute : Node.Attributes)
+	{
+		const FString& AttrPrefix = Attribute.Key.Prefix;
+		if ((AttrPrefix.Equals(TEXT("rdf")) && (Attribute.Key.LocalName.Equals(TEXT("about")) || Attribute.Key.LocalName.Equals(TEXT("nodeID"))))
+			|| AttrPrefix.Equals(TEXT("xml")) || AttrPrefix.Equals(TEXT("xmlns")))
+		{
+			continue;
+		}
+		WriteLiteralTriple(Subject, ExpandName(Attribute.Key), Attribute.Value.LocalValue, FString(), FString());
+	}
+
+	// Property elements
+	for (const auto& Child : Node.ChildNodes)
+	{
+		if (!Child.Name.IsEmpty())
+		{
+			WritePropertyTriples(Subject, Child);
+		}
+	}
+	return Subject;
+}
+
+// Write the triples of the property element of the subject
+void FSLOwlWriter::WritePropertyTriples(const FString& Subject, const FSLOwlNode& Property)
+{
+	const FString PredicateIri = ExpandName(Property.Name);
+
+	if (const FSLOwlAttribute* Resource = FindAttribute(Property, TEXT("rdf"), TEXT("resource")))
+	{
+		WriteTriple(Subject, PredicateIri, ToIriTerm(ExpandValue(Resource->Value)));
+	}
+	else if (Property.ChildNodes.Num() > 0)
+	{
+		// Nested node elements (e.g. owl:Restriction in rdfs:subClassOf)
+		for (const auto& Child : Property.ChildNodes)
+		{
+			const FString Object = WriteNodeTriples(Child);
+			if (!Object.IsEmpty())
+			{
+				WriteTriple(Subject, PredicateIri, Object);
+			}
+		}
+	}
+	else
+	{
+		const FSLOwlAttribute* Datatype = FindAttribute(Property, TEXT("rdf"), TEXT("datatype"));
+		const FSLOwlAttribute* Lang = FindAttribute(Property, TEXT("xml"), TEXT("lang"));
+		WriteLiteralTriple(Subject, PredicateIri, Property.Value,
+			Datatype ? ExpandValue(Datatype->Value) : FString(),
+			Lang ? Lang->Value.LocalValue : FString());
+	}
+}
+
+// Write a triple with an already formatted object term
+void FSLOwlWriter::WriteTriple(const FString& Subject, const FString& PredicateIri, const FString& ObjectTerm)
+{
+	Out.Append(Subject);
+	Out.AppendRaw(" ");
+	Out.Append(ToIriTerm(PredicateIri));
+	Out.AppendRaw(" ");
+	Out.Append(ObjectTerm);
+	Out.AppendRaw(" .\n");
+	TriplesNum++;
+}
+
+// Write a triple with a literal object
+void FSLOwlWriter::WriteLiteralTriple(const FString& Subject, const FString& PredicateIri, const FString& Literal,
+	const FString& DatatypeIri, const FString& Lang)
+{
+	Out.Append(Subject);
+	Out.AppendRaw(" ");
+	Out.Append(ToIriTerm(PredicateIri));
+	Out.AppendRaw(" \"");
+	AppendLiteralEscaped(Literal);
+	Out.AppendRaw("\"");
+	if (!DatatypeIri.IsEmpty())
+	{
+		Out.AppendRaw("^^");
+		Out.Append(ToIriTerm(DatatypeIri));
+	}
+	else if (!Lang.IsEmpty())
+	{
+		Out.AppendRaw("@");
+		Out.Append(Lang);
+	}
+	Out.AppendRaw(" .\n");
+	TriplesNum++;
+}
+
+// Expand the prefixed name to an iri (e.g. owl:Class -> http://www.w3.org/2002/07/owl#Class)
+FString FSLOwlWriter::ExpandName(const FSLOwlPrefixName& Name) const
+{
+	// Name without prefix, use the default namespace
+	if (Name.LocalName.IsEmpty())
+	{
+		const FString* DefaultIri = NamespaceIris.Find(FString());
+		return DefaultIri ? *DefaultIri + Name.Prefix : Name.Prefix;
+	}
+
+	if (const FString* Iri = NamespaceIris.Find(Name.Prefix))
+	{
+		return *Iri + Name.LocalName;
+	}
+	if (const FString* Iri = EntityIris.Find(Name.Prefix))
+	{
+		return *Iri + Name.LocalName;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("%s::%d Unknown prefix %s, the name is written unexpanded.."),
+		*FString(__FUNCTION__), __LINE__, *Name.Prefix);
+	return Name.ToString();
+}
+
+// Expand the attribute value to an iri (e.g. &log;abc -> http://knowrob.org/kb/ameva_log.owl#abc)
+FString FSLOwlWriter::ExpandValue(const FSLOwlAttributeValue& AttributeValue) const
+{
+	if (!AttributeValue.Ns.IsEmpty())
+	{
+		if (const FString* Iri = EntityIris.Find(AttributeValue.Ns))
+		{
+			return *Iri + AttributeValue.LocalValue;
+		}
+		if (const FString* Iri = NamespaceIris.Find(AttributeValue.Ns))
+		{
+			return *Iri + AttributeValue.LocalValue;
+		}
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Unknown entity %s, the value is written unexpanded.."),
+			*FString(__FUNCTION__), __LINE__, *AttributeValue.Ns);
+		return AttributeValue.Ns + TEXT(":") + AttributeValue.LocalValue;
+	}
+
+	// Inline entity reference (e.g. "&knowrob;Pose")
+	const FString& Value = AttributeValue.LocalValue;
+	int32 EntityEnd = INDEX_NONE;
+	if (Value.StartsWith(TEXT("&")) && Value.FindChar(TEXT(';'), EntityEnd))
+	{
+		if (const FString* Iri = EntityIris.Find(Value.Mid(1, EntityEnd - 1)))
+		{
+			return *Iri + Value.RightChop(EntityEnd + 1);
+		}
+	}
+
+	// Relative values are resolved against the base
+	if (!BaseIri.IsEmpty() && !Value.Contains(TEXT(":")))
+	{
+		return BaseIri + Value;
+	}
+	return Value;
+}
+
+// Create an iri term (<iri>) with the N-Triples escaping
+FString FSLOwlWriter::ToIriTerm(const FString& Iri)
+{
+	FString Term;
+	Term.Reserve(Iri.Len() + 2);
+	Term.AppendChar(TEXT('<'));
+	for (const TCHAR C : Iri)
+	{
+		if (C <= 0x20 || C == TEXT('<') || C == TEXT('>') || C == TEXT('"') || C == TEXT('{') || C == TEXT('}')
+			|| C == TEXT('|') || C == TEXT('^') || C == TEXT('`') || C == TEXT('\\'))
+		{
+			Term += FString::Printf(TEXT("\\u%04X"), (uint32)C);
+		}
+		else
+		{
+			Term.AppendChar(C);
+		}
+	}
+	Term.AppendChar(TEXT('>'));
+	return Term;
+}
+
+// Find the attribute of the node
+const FSLOwlAttribute* FSLOwlWriter::FindAttribute(const FSLOwlNode& Node, const TCHAR* Prefix, const TCHAR* LocalName)
+{
+	for (const auto& Attribute : Node.Attributes)
+	{
+		if (Attribute.Key.Prefix.Equals(Prefix) && Attribute.Key.LocalName.Equals(LocalName))
+		{
+			return &Attribute;
+		}
+	}
+	return nullptr;
+}
+
+
+/* Buffer */
+// Append the string with the xml escaping (&, <, >, ")
+void FSLOwlWriter::AppendXmlEscaped(const FString& Str)
+{
+	// Write the runs without special characters in one go
+	const TCHAR* RunStart = *Str;
+	const TCHAR* Curr = RunStart;
+	for (; *Curr; ++Curr)
+	{
+		const ANSICHAR* Escaped = nullptr;
+		switch (*Curr)
+		{
+		case TEXT('&'): Escaped = "&amp;"; break;
+		case TEXT('<'): Escaped = "&lt;"; break;
+		case TEXT('>'): Escaped = "&gt;"; break;
+		case TEXT('"'): Escaped = "&quot;"; break;
+		default: break;
+		}
+		if (Escaped)
+		{
+			Out.Append(RunStart, Curr - RunStart);
+			Out.AppendRaw(Escaped);
+			RunStart = Curr + 1;
+		}
+	}
+	Out.Append(RunStart, Curr - RunStart);
+}
+
+// Append the string with the N-Triples literal escaping (\, ", \n, \r)
+void FSLOwlWriter::AppendLiteralEscaped(const FString& Str)
+{
+	const TCHAR* RunStart = *Str;
+	const TCHAR* Curr = RunStart;
+	for (; *Curr; ++Curr)
+	{
+		const ANSICHAR* Escaped = nullptr;
+		switch (*Curr)
+		{
+		case TEXT('\\'): Escaped = "\\\\"; break;
+		case TEXT('"'): Escaped = "\\\""; break;
+		case TEXT('\n'): Escaped = "\\n"; break;
+		case TEXT('\r'): Escaped = "\\r"; break;
+		default: break;
+		}
+		if (Escaped)
+		{
+			Out.Append(RunStart, Curr - RunStart);
+			Out.AppendRaw(Escaped);
+			RunStart = Curr + 1;
+		}
+	}
+	Out.Append(RunStart, Curr - RunStart);
+}
+
+// Append the indentation
+void FSLOwlWriter::AppendIndent(int32 Depth)
+{
+	for (int32 Idx = 0; Idx < Depth; ++Idx)
+	{
+		Out.AppendBytes("\t", 1);
+	}
+}
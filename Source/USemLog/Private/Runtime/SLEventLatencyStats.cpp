@@ -0,0 +1,86 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLEventLatencyStats.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Record the broadcast of the finished event at the given world time
+void FSLEventLatencyStats::Add(const ISLEvent& Event, float BroadcastTime)
+{
+	Latencies[(uint8)Event.Kind()].Add(FMath::Max(BroadcastTime - Event.StartTime, 0.f));
+}
+
+// Clear the recorded latencies
+void FSLEventLatencyStats::Reset()
+{
+	for (auto& KindLatencies : Latencies)
+	{
+		KindLatencies.Empty();
+	}
+}
+
+// Get the latency summary of each detector with at least one event
+void FSLEventLatencyStats::GetSummaries(TArray<FSLEventLatencySummary>& OutSummaries) const
+{
+	for (uint8 KindIdx = 0; KindIdx <= (uint8)ESLEventKind::Dummy; ++KindIdx)
+	{
+		if (Latencies[KindIdx].Num() == 0)
+		{
+			continue;
+		}
+
+		TArray<float> Sorted = Latencies[KindIdx];
+		Sorted.Sort();
+
+		double Sum = 0.0;
+		for (const float Latency : Sorted)
+		{
+			Sum += Latency;
+		}
+
+		FSLEventLatencySummary& Summary = OutSummaries.AddDefaulted_GetRef();
+		Summary.Kind = (ESLEventKind)KindIdx;
+		Summary.Num = Sorted.Num();
+		Summary.Mean = Sum / Sorted.Num();
+		Summary.P50 = Sorted[(Sorted.Num() - 1) / 2];
+		Summary.P95 = Sorted[FMath::Min(FMath::CeilToInt(Sorted.Num() * 0.95f) - 1, Sorted.Num() - 1)];
+		Summary.Max = Sorted.Last();
+	}
+}
+
+// Log the summaries
+void FSLEventLatencyStats::LogSummaries(const FString& InTitle) const
+{
+	TArray<FSLEventLatencySummary> Summaries;
+	GetSummaries(Summaries);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d %s event detection latency (onset to broadcast, seconds):"),
+		*FString(__FUNCTION__), __LINE__, *InTitle);
+	for (const auto& Summary : Summaries)
+	{
+		UE_LOG(LogTemp, Log, TEXT("\t %-12s num=%6d mean=%.3f p50=%.3f p95=%.3f max=%.3f"),
+			ISLEvent::GetKindName(Summary.Kind), Summary.Num, Summary.Mean, Summary.P50, Summary.P95, Summary.Max);
+	}
+}
+
+// Write the summaries as csv (kind,num,mean,p50,p95,max)
+bool FSLEventLatencyStats::WriteToFile(const FString& FilePath, bool bOverwrite) const
+{
+	if (FPaths::FileExists(FilePath) && !bOverwrite)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d File %s already exists, and overwrite is false.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	TArray<FSLEventLatencySummary> Summaries;
+	GetSummaries(Summaries);
+
+	FString Csv = TEXT("kind,num,mean,p50,p95,max\n");
+	for (const auto& Summary : Summaries)
+	{
+		Csv += FString::Printf(TEXT("%s,%d,%f,%f,%f,%f\n"), ISLEvent::GetKindName(Summary.Kind),
+			Summary.Num, Summary.Mean, Summary.P50, Summary.P95, Summary.Max);
+	}
+	return FFileHelper::SaveStringToFile(Csv, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+}
@@ -0,0 +1,199 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLEventStreamWriter.h"
+#include "Events/ISLEvent.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "HAL/PlatformFilemanager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/Paths.h"
+
+// Do the file writing here
+void FSLEventStreamWriterAsyncTask::DoWork()
+{
+	if (FileHandle && !Lines.IsEmpty())
+	{
+		FTCHARToUTF8 Converter(*Lines);
+		FileHandle->Write((const uint8*)Converter.Get(), Converter.Length());
+		FileHandle->Flush();
+	}
+	// Keep the allocation for the next batch
+	Lines.Reset();
+}
+
+
+// Ctor
+FSLEventStreamWriter::FSLEventStreamWriter()
+{
+	bIsInit = false;
+	FileHandle = nullptr;
+	NumEvents = 0;
+	WriterTask = nullptr;
+}
+
+// Dtor
+FSLEventStreamWriter::~FSLEventStreamWriter()
+{
+	if (bIsInit)
+	{
+		// Not finished explicitly, keep the streamed events but do not mark the stream as complete
+		Close(FString::Printf(TEXT("{\"finished\":false,\"aborted\":true,\"num_events\":%d}\n"), NumEvents));
+	}
+}
+
+// Open the stream file
+bool FSLEventStreamWriter::Init(const FString& InDirPath, const FString& InEpisodeId, bool bOverwrite)
+{
+	if (bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Event stream writer is already initialized.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	FilePath = InDirPath + InEpisodeId + TEXT("_ED.ndjson");
+	FPaths::RemoveDuplicateSlashes(FilePath);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (PlatformFile.FileExists(*FilePath) && !bOverwrite)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Event stream file %s already exists, and overwrite is false.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+	FileHandle = PlatformFile.OpenWrite(*FilePath);
+	if (FileHandle == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open event stream file %s.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	WriterTask = new FAsyncTask<FSLEventStreamWriterAsyncTask>();
+	WriterTask->GetTask().Init(FileHandle);
+	NumEvents = 0;
+	bIsInit = true;
+	return true;
+}
+
+// Serialize the event and hand it over to the background writer when it is free
+void FSLEventStreamWriter::Add(TSharedPtr<ISLEvent> Event)
+{
+	if (!bIsInit || !Event.IsValid())
+	{
+		return;
+	}
+
+	PendingLines.Append(ToJsonLine(*Event));
+	PendingLines.AppendChar(TEXT('\n'));
+	NumEvents++;
+	TryFlush(false);
+}
+
+// Write the remaining events and close the file
+void FSLEventStreamWriter::Finish(float EpisodeEndTime)
+{
+	if (!bIsInit)
+	{
+		return;
+	}
+
+	// Mark the stream as complete, a missing footer means the episode did not finish properly
+	Close(FString::Printf(TEXT("{\"finished\":true,\"end\":%f,\"num_events\":%d}\n"), EpisodeEndTime, NumEvents));
+}
+
+// Write the pending lines followed by the footer line and close the file
+void FSLEventStreamWriter::Close(const FString& FooterLine)
+{
+	PendingLines.Append(FooterLine);
+	TryFlush(true);
+
+	// Wait for the last batch to be written
+	WriterTask->EnsureCompletion(false);
+	delete WriterTask;
+	WriterTask = nullptr;
+
+	delete FileHandle;
+	FileHandle = nullptr;
+	bIsInit = false;
+}
+
+// Serialize event to a single line json object
+FString FSLEventStreamWriter::ToJsonLine(const ISLEvent& Event)
+{
+	FString Line;
+	Line.Reserve(192);
+	Line.Append(TEXT("{\"id\":\""));
+	AppendEscaped(Line, Event.Id);
+	Line.Append(TEXT("\",\"type\":\""));
+	Line.Append(ISLEvent::GetKindName(Event.Kind()));
+	Line.Append(FString::Printf(TEXT("\",\"start\":%f,\"end\":%f,\"episode\":\""), Event.StartTime, Event.EndTime));
+	AppendEscaped(Line, Event.EpisodeId);
+	Line.Append(TEXT("\",\"context\":\""));
+	AppendEscaped(Line, Event.Context());
+	Line.Append(TEXT("\",\"participants\":["));
+	FSLEventParticipants Participants;
+	Event.GetParticipants(Participants);
+	for (int32 Idx = 0; Idx < Participants.Num(); ++Idx)
+	{
+		Line.Append(Idx == 0 ? TEXT("{\"id\":\"") : TEXT(",{\"id\":\""));
+		if (Participants[Idx].Individual)
+		{
+			AppendEscaped(Line, Participants[Idx].Individual->GetIdValue());
+		}
+		Line.Append(TEXT("\",\"role\":\""));
+		Line.Append(ISLEvent::GetRoleName(Participants[Idx].Role));
+		Line.Append(TEXT("\"}"));
+	}
+	Line.Append(TEXT("]}"));
+	return Line;
+}
+
+// Start writing the pending lines if the previous job is done
+void FSLEventStreamWriter::TryFlush(bool bWait)
+{
+	if (PendingLines.IsEmpty())
+	{
+		return;
+	}
+
+	if (!WriterTask->IsDone())
+	{
+		if (!bWait)
+		{
+			// Keep accumulating, the lines are handed over with the next event
+			return;
+		}
+		WriterTask->EnsureCompletion(false);
+	}
+
+	// The task emptied its buffer, swap it with the pending lines
+	Swap(WriterTask->GetTask().Lines, PendingLines);
+	WriterTask->StartBackgroundTask();
+}
+
+// Append json escaped string
+void FSLEventStreamWriter::AppendEscaped(FString& Out, const FString& In)
+{
+	for (const TCHAR C : In)
+	{
+		switch (C)
+		{
+		case TEXT('"'):		Out.Append(TEXT("\\\"")); break;
+		case TEXT('\\'):	Out.Append(TEXT("\\\\")); break;
+		case TEXT('\n'):	Out.Append(TEXT("\\n")); break;
+		case TEXT('\r'):	Out.Append(TEXT("\\r")); break;
+		case TEXT('\t'):	Out.Append(TEXT("\\t")); break;
+		default:
+			if (C < 0x20)
+			{
+				Out.Append(FString::Printf(TEXT("\\u%04x"), (int32)C));
+			}
+			else
+			{
+				Out.AppendChar(C);
+			}
+		}
+	}
+}
@@ -0,0 +1,374 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLEventsDBHandler.h"
+#include "Events/ISLEvent.h"
+#include "Events/SLEventStore.h"
+
+// Number of events sent to the server in one bulk operation
+static const int32 SLEventsDBBulkSize = 1000;
+
+// Ctor
+FSLEventsDBHandler::FSLEventsDBHandler()
+{
+	bIsInit = false;
+	bIsFinished = false;
+#if SL_WITH_LIBMONGO_C
+	uri = nullptr;
+	client = nullptr;
+	database = nullptr;
+	collection = nullptr;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Dtor
+FSLEventsDBHandler::~FSLEventsDBHandler()
+{
+	if (bIsInit && !bIsFinished)
+	{
+		Finish();
+	}
+}
+
+// Connect to the db
+bool FSLEventsDBHandler::Init(const FSLLoggerLocationParams& InLocationParameters,
+	const FSLLoggerDBServerParams& InDBServerParameters)
+{
+	if (bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Events db handler is already init.."), *FString(__FUNCTION__), __LINE__);
+		return true;
+	}
+
+	if (!Connect(InLocationParameters.TaskId, InLocationParameters.EpisodeId + TEXT(".events"),
+		InDBServerParameters.Ip, InDBServerParameters.Port, InLocationParameters.bOverwrite))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Events DB handler could not connect to the database.."), *FString(__FUNCTION__), __LINE__);
+		Disconnect();
+		return false;
+	}
+
+	bIsInit = true;
+	bIsFinished = false;
+	return true;
+}
+
+// Bulk insert the events, returns the number of inserted events
+int32 FSLEventsDBHandler::Write(const FSLEventStore& InEvents)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Events db handler is not init, cannot write.."), *FString(__FUNCTION__), __LINE__);
+		return 0;
+	}
+
+	int32 NumInserted = 0;
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	bson_t* bulk_opts = BCON_NEW("ordered", BCON_BOOL(false));
+	mongoc_bulk_operation_t* bulk = nullptr;
+	int32 NumAdded = 0;
+
+	// Send the current bulk to the server
+	auto ExecuteBulk = [&bulk, &NumAdded, &NumInserted, &error]()
+	{
+		if (NumAdded > 0)
+		{
+			bson_t reply;
+			const uint32_t ret = mongoc_bulk_operation_execute(bulk, &reply, &error);
+			if (!ret)
+			{
+				// Unordered bulk, the valid documents are still inserted (e.g. duplicate ids are skipped)
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Bulk insert err.: %s"),
+					*FString(__FUNCTION__), __LINE__, *FString(error.message));
+			}
+
+			bson_iter_t iter;
+			if (bson_iter_init_find(&iter, &reply, "nInserted") && BSON_ITER_HOLDS_INT32(&iter))
+			{
+				NumInserted += bson_iter_int32(&iter);
+			}
+			bson_destroy(&reply);
+		}
+		if (bulk)
+		{
+			mongoc_bulk_operation_destroy(bulk);
+			bulk = nullptr;
+		}
+		NumAdded = 0;
+	};
+
+	// The events are read as plain snapshots one at a time, at most one bulk of documents is kept in memory
+	InEvents.ForEachSnapshot([this, &bulk, bulk_opts, &NumAdded, &error, &ExecuteBulk](const FSLEventSnapshot& Event)
+	{
+		if (!bulk)
+		{
+			bulk = mongoc_collection_create_bulk_operation_with_opts(collection, bulk_opts);
+		}
+
+		bson_t* doc = bson_new();
+		AddEvent(Event, doc);
+		if (mongoc_bulk_operation_insert_with_opts(bulk, doc, NULL, &error))
+		{
+			NumAdded++;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not add event %s to the bulk operation, err.: %s"),
+				*FString(__FUNCTION__), __LINE__, *Event.Id, *FString(error.message));
+		}
+		bson_destroy(doc);
+
+		if (NumAdded >= SLEventsDBBulkSize)
+		{
+			ExecuteBulk();
+		}
+	});
+	ExecuteBulk();
+
+	bson_destroy(bulk_opts);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Inserted %d/%d events into %s.."),
+		*FString(__FUNCTION__), __LINE__, NumInserted, InEvents.Num(), *FString(mongoc_collection_get_name(collection)));
+#endif //SL_WITH_LIBMONGO_C
+	return NumInserted;
+}
+
+// Create the indexes and disconnect from db
+void FSLEventsDBHandler::Finish()
+{
+	if (bIsFinished)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Events db handler is already finished.."), *FString(__FUNCTION__), __LINE__);
+		return;
+	}
+
+	CreateIndexes();
+	Disconnect();
+
+	bIsInit = false;
+	bIsFinished = true;
+}
+
+// Connect to the database
+bool FSLEventsDBHandler::Connect(const FString& DBName, const FString& CollName, const FString& ServerIp,
+	uint16 ServerPort, bool bOverwrite)
+{
+#if SL_WITH_LIBMONGO_C
+	// Required to initialize libmongoc's internals	
+	mongoc_init();
+
+	// Stores any error that might appear during the connection
+	bson_error_t error;
+
+	// Safely create a MongoDB URI object from the given string
+	FString Uri = TEXT("mongodb://") + ServerIp + TEXT(":") + FString::FromInt(ServerPort);
+	uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*Uri), &error);
+	if (!uri)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s; [Uri=%s]"),
+			*FString(__func__), __LINE__, *FString(error.message), *Uri);
+		return false;
+	}
+
+	// Create a new client instance
+	client = mongoc_client_new_from_uri(uri);
+	if (!client)
+	{
+		return false;
+	}
+
+	// Register the application name so we can track it in the profile logs on the server
+	mongoc_client_set_appname(client, TCHAR_TO_UTF8(*("SL_EventsWriter_" + CollName)));
+
+	// Get a handle on the database "db_name"
+	database = mongoc_client_get_database(client, TCHAR_TO_UTF8(*DBName));
+
+	// Check if the collection already exists
+	if (mongoc_database_has_collection(database, TCHAR_TO_UTF8(*CollName), &error))
+	{
+		if (bOverwrite)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Events collection %s already exists, will be removed and overwritten.."),
+				*FString(__func__), __LINE__, *CollName);
+			mongoc_collection_t* prev_coll = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*CollName));
+			const bool bDropped = mongoc_collection_drop(prev_coll, &error);
+			mongoc_collection_destroy(prev_coll);
+			if (!bDropped)
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Could not drop collection, err.:%s;"),
+					*FString(__func__), __LINE__, *FString(error.message));
+				return false;
+			}
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Events collection %s already exists and should not be overwritten, skipping events logging.."),
+				*FString(__func__), __LINE__, *CollName);
+			return false;
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Creating collection %s.%s .."),
+			*FString(__func__), __LINE__, *DBName, *CollName);
+	}
+
+	collection = mongoc_client_get_collection(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*CollName));
+
+	// Check server. Ping the "admin" database
+	bson_t* server_ping_cmd;
+	server_ping_cmd = BCON_NEW("ping", BCON_INT32(1));
+	if (!mongoc_client_command_simple(client, "admin", server_ping_cmd, NULL, NULL, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Check server err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bson_destroy(server_ping_cmd);
+		return false;
+	}
+
+	bson_destroy(server_ping_cmd);
+	return true;
+#else
+	UE_LOG(LogTemp, Error, TEXT("%s::%d SL_WITH_LIBMONGO_C flag is 0, aborting.."),
+		*FString(__func__), __LINE__);
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+#if SL_WITH_LIBMONGO_C
+// Add the event document (id, type, interval, participant ids and roles)
+void FSLEventsDBHandler::AddEvent(const FSLEventSnapshot& Event, bson_t* doc) const
+{
+	BSON_APPEND_UTF8(doc, "_id", TCHAR_TO_UTF8(*Event.Id));
+	BSON_APPEND_UTF8(doc, "type", TCHAR_TO_UTF8(ISLEvent::GetKindName(Event.Kind)));
+	BSON_APPEND_DOUBLE(doc, "start", Event.StartTime);
+	BSON_APPEND_DOUBLE(doc, "end", Event.EndTime);
+
+	const auto& Participants = Event.Participants;
+
+	// Flat id array (multikey index), and the id / role pairs
+	bson_t participants_arr;
+	bson_t roles_arr;
+	char idx_str[16];
+	const char* idx_key;
+	uint32_t arr_idx = 0;
+
+	BSON_APPEND_ARRAY_BEGIN(doc, "participants", &participants_arr);
+	for (const auto& Participant : Participants)
+	{
+		if (Participant.Individual)
+		{
+			bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_UTF8(&participants_arr, idx_key, TCHAR_TO_UTF8(*Participant.Individual->Id));
+			arr_idx++;
+		}
+	}
+	bson_append_array_end(doc, &participants_arr);
+
+	arr_idx = 0;
+	BSON_APPEND_ARRAY_BEGIN(doc, "roles", &roles_arr);
+	for (const auto& Participant : Participants)
+	{
+		if (Participant.Individual)
+		{
+			bson_t role_obj;
+			bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_DOCUMENT_BEGIN(&roles_arr, idx_key, &role_obj);
+			BSON_APPEND_UTF8(&role_obj, "id", TCHAR_TO_UTF8(*Participant.Individual->Id));
+			BSON_APPEND_UTF8(&role_obj, "class", TCHAR_TO_UTF8(*Participant.Individual->Class));
+			BSON_APPEND_UTF8(&role_obj, "role", TCHAR_TO_UTF8(ISLEvent::GetRoleName(Participant.Role)));
+			bson_append_document_end(&roles_arr, &role_obj);
+			arr_idx++;
+		}
+	}
+	bson_append_array_end(doc, &roles_arr);
+}
+#endif //SL_WITH_LIBMONGO_C
+
+// Disconnect and clean db connection
+void FSLEventsDBHandler::Disconnect()
+{
+#if SL_WITH_LIBMONGO_C
+	// Release handles and clean up mongoc
+	if (collection)
+	{
+		mongoc_collection_destroy(collection);
+		collection = nullptr;
+	}
+	if (database)
+	{
+		mongoc_database_destroy(database);
+		database = nullptr;
+	}
+	if (client)
+	{
+		mongoc_client_destroy(client);
+		client = nullptr;
+	}
+	if (uri)
+	{
+		mongoc_uri_destroy(uri);
+		uri = nullptr;
+	}
+	mongoc_cleanup();
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Create the (type, start) and (participants, start) indexes
+bool FSLEventsDBHandler::CreateIndexes() const
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Not connected to the db, could not create indexes.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	bson_t* index_command;
+	bson_error_t error;
+
+	bson_t idx_type_start;
+	bson_init(&idx_type_start);
+	BSON_APPEND_INT32(&idx_type_start, "type", 1);
+	BSON_APPEND_INT32(&idx_type_start, "start", 1);
+	char* idx_type_start_chr = mongoc_collection_keys_to_index_string(&idx_type_start);
+
+	bson_t idx_participants_start;
+	bson_init(&idx_participants_start);
+	BSON_APPEND_INT32(&idx_participants_start, "participants", 1);
+	BSON_APPEND_INT32(&idx_participants_start, "start", 1);
+	char* idx_participants_start_chr = mongoc_collection_keys_to_index_string(&idx_participants_start);
+
+	index_command = BCON_NEW("createIndexes",
+		BCON_UTF8(mongoc_collection_get_name(collection)),
+		"indexes",
+		"[",
+			"{",
+				"key", BCON_DOCUMENT(&idx_type_start),
+				"name", BCON_UTF8(idx_type_start_chr),
+			"}",
+			"{",
+				"key", BCON_DOCUMENT(&idx_participants_start),
+				"name", BCON_UTF8(idx_participants_start_chr),
+			"}",
+		"]");
+
+	bool bSuccess = true;
+	if (!mongoc_collection_write_command_with_opts(collection, index_command, NULL/*opts*/, NULL/*reply*/, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Create indexes err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bSuccess = false;
+	}
+
+	// Clean up
+	bson_destroy(index_command);
+	bson_destroy(&idx_type_start);
+	bson_destroy(&idx_participants_start);
+	bson_free(idx_type_start_chr);
+	bson_free(idx_participants_start_chr);
+	return bSuccess;
+#else
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
@@ -0,0 +1,137 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLJsonTripleWriter.h"
+
+// Ctor
+FSLJsonTripleWriter::FSLJsonTripleWriter(const FString& InGraph, int32 InBufferSize) : Out(InBufferSize)
+{
+	NumTriples = 0;
+
+	FTCHARToUTF8 GraphConverter(*InGraph);
+	Graph.Append((const ANSICHAR*)GraphConverter.Get(), GraphConverter.Length());
+	Graph.Add('\0');
+}
+
+// Dtor, closes the file
+FSLJsonTripleWriter::~FSLJsonTripleWriter()
+{
+	Close();
+}
+
+// Open the file and start the json array
+bool FSLJsonTripleWriter::Open(const FString& FilePath)
+{
+	if (!Out.Open(FilePath))
+	{
+		return false;
+	}
+
+	NumTriples = 0;
+	Out.AppendRaw("[");
+	return true;
+}
+
+// Write a triple with an iri object
+void FSLJsonTripleWriter::WriteTriple(const FSLTripleTerm& S, const TCHAR* P, const FSLTripleTerm& O)
+{
+	if (!Out.IsOpen())
+	{
+		return;
+	}
+	BeginTriple(S, P);
+	Out.AppendRaw("\"o\":\"");
+	AppendTerm(O);
+	Out.AppendRaw("\",");
+	EndTriple();
+}
+
+// Write a triple with a decimal object ({ "$numberDecimal": "Value" })
+void FSLJsonTripleWriter::WriteDecimalTriple(const FSLTripleTerm& S, const TCHAR* P, float Value)
+{
+	if (!Out.IsOpen())
+	{
+		return;
+	}
+	BeginTriple(S, P);
+	Out.AppendRaw("\"o\":{\"$numberDecimal\":\"");
+	AppendEscaped(*FString::SanitizeFloat(Value));
+	Out.AppendRaw("\"},");
+	EndTriple();
+}
+
+// End the json array and close the file
+void FSLJsonTripleWriter::Close()
+{
+	if (!Out.IsOpen())
+	{
+		return;
+	}
+	Out.AppendRaw("\n]\n");
+	Out.Close();
+}
+
+// Start a new triple object (adds the separator)
+void FSLJsonTripleWriter::BeginTriple(const FSLTripleTerm& S, const TCHAR* P)
+{
+	Out.AppendRaw(NumTriples == 0 ? "\n{\"s\":\"" : ",\n{\"s\":\"");
+	AppendTerm(S);
+	Out.AppendRaw("\",\"p\":\"");
+	AppendEscaped(P);
+	Out.AppendRaw("\",");
+}
+
+// End the triple object
+void FSLJsonTripleWriter::EndTriple()
+{
+	Out.AppendRaw("\"graph\":\"");
+	Out.AppendBytes(Graph.GetData(), Graph.Num() - 1);
+	Out.AppendRaw("\"}");
+	NumTriples++;
+}
+
+// Append a json escaped term
+void FSLJsonTripleWriter::AppendTerm(const FSLTripleTerm& Term)
+{
+	AppendEscaped(Term.Iri);
+	if (Term.Suffix)
+	{
+		AppendEscaped(Term.Separator);
+		AppendEscaped(Term.Suffix);
+	}
+}
+
+// Append a json escaped string
+void FSLJsonTripleWriter::AppendEscaped(const TCHAR* Str)
+{
+	if (Str == nullptr)
+	{
+		return;
+	}
+
+	// Write the runs without special characters in one go
+	const TCHAR* RunStart = Str;
+	const TCHAR* Curr = Str;
+	for (; *Curr; ++Curr)
+	{
+		const TCHAR C = *Curr;
+		if (C == TEXT('"') || C == TEXT('\\') || C < 0x20)
+		{
+			Out.Append(RunStart, Curr - RunStart);
+			ANSICHAR Escaped[8];
+			if (C == TEXT('"') || C == TEXT('\\'))
+			{
+				Escaped[0] = '\\';
+				Escaped[1] = (ANSICHAR)C;
+				Out.AppendBytes(Escaped, 2);
+			}
+			else
+			{
+				FCStringAnsi::Sprintf(Escaped, "\\u%04x", (int32)C);
+				Out.AppendBytes(Escaped, 6);
+			}
+			RunStart = Curr + 1;
+		}
+	}
+	Out.Append(RunStart, Curr - RunStart);
+}
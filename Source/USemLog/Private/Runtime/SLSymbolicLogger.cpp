@@ -2,15 +2,18 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "Runtime/SLSymbolicLogger.h"
+#include "Runtime/SLJsonTripleWriter.h"
 #include "Individuals/SLIndividualManager.h"
 #include "Individuals/SLIndividualComponent.h"
 #include "Individuals/SLIndividualUtils.h" 
 
 #include "Utils/SLUuid.h"
+#include "Utils/SLStats.h"
 #include "EngineUtils.h"
 #include "TimerManager.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "Engine/Engine.h"
 #include "GameFramework/PlayerController.h"
 #include "Components/InputComponent.h"
@@ -167,6 +170,30 @@ void ASLSymbolicLogger::Finish(bool bForced)
 	FinishImpl();
 }
 
+// Get the finished events overlapping [T0, T1]
+void ASLSymbolicLogger::QueryEvents(float T0, float T1, TArray<const FSLEventIntervalEntry*>& OutEvents) const
+{
+	TArray<int32> Idxs;
+	EventIndex.QueryOverlapping(T0, T1, Idxs);
+	OutEvents.Reserve(OutEvents.Num() + Idxs.Num());
+	for (const int32 Idx : Idxs)
+	{
+		OutEvents.Add(&EventIndex.GetEntries()[Idx]);
+	}
+}
+
+// Get the finished events of the individual overlapping [T0, T1]
+void ASLSymbolicLogger::QueryIndividualEvents(const FString& IndividualId, float T0, float T1, TArray<const FSLEventIntervalEntry*>& OutEvents) const
+{
+	TArray<int32> Idxs;
+	EventIndex.QueryIndividualOverlapping(IndividualId, T0, T1, Idxs);
+	OutEvents.Reserve(OutEvents.Num() + Idxs.Num());
+	for (const int32 Idx : Idxs)
+	{
+		OutEvents.Add(&EventIndex.GetEntries()[Idx]);
+	}
+}
+
 // Init logger (called when the logger is used independently)
 void ASLSymbolicLogger::InitImpl()
 {
@@ -202,6 +229,7 @@ void ASLSymbolicLogger::InitImpl()
 
 	// Create the document template
 	ExperimentDoc = CreateEventsDocTemplate(ESLOwlExperimentTemplate::Default, LocationParameters.EpisodeId);
+	ExperimentDoc->SetTimepointResolution(LoggerParameters.OwlTimepointResolution);
 
 	// Setup monitors
 	if (LoggerParameters.EventsSelection.bSelectAll)
@@ -267,6 +295,34 @@ void ASLSymbolicLogger::InitImpl()
 		InitROSPublisher();
 	}
 
+	if (LoggerParameters.bStreamEvents)
+	{
+		if (!EventStreamWriter.Init(GetOutputDirPath(), LocationParameters.EpisodeId, LocationParameters.bOverwrite))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Symbolic logger (%s) could not open the event stream, events will only be written at the end.."),
+				*FString(__FUNCTION__), __LINE__, *GetName());
+		}
+	}
+
+	if (LoggerParameters.bWriteEventLog)
+	{
+		if (!EventLogWriter.Init(GetOutputDirPath(), LocationParameters.EpisodeId, LocationParameters.TaskId,
+			LocationParameters.SemanticMapId, LocationParameters.bOverwrite))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Symbolic logger (%s) could not open the binary event log.."),
+				*FString(__FUNCTION__), __LINE__, *GetName());
+		}
+	}
+
+	if (LoggerParameters.bWriteEventsToDB)
+	{
+		if (!EventsDBHandler.Init(LocationParameters, LoggerParameters.EventsDBServerParams))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Symbolic logger (%s) could not connect to the events database.."),
+				*FString(__FUNCTION__), __LINE__, *GetName());
+		}
+	}
+
 	bIsInit = true;
 	UE_LOG(LogTemp, Warning, TEXT("%s::%d Symbolic logger (%s) succesfully initialized at %.2f.."),
 		*FString(__FUNCTION__), __LINE__, *GetName(), GetWorld()->GetTimeSeconds());
@@ -335,179 +391,297 @@ void ASLSymbolicLogger::StartImpl()
 }
 
 
-void ASLSymbolicLogger::GetIndividuals(FString Ev, FString &Indiv1, FString &Indiv2, FString &Indiv1Class, FString &Indiv2Class) {
-	FString temp;
-	int32 indexS;
-	int32 indexE;
-
-	//get first Individual
-	Ev.FindChar('[', indexS);
-	Ev.FindChar(']', indexE);
-	temp = Ev.Mid((indexS + 1), (indexE - indexS)); //get the full individual
-	indexS = temp.Find("ParentActor=", ESearchCase::IgnoreCase, ESearchDir::FromStart, 0);
-	temp.FindChar(';', indexE);
-
-	Indiv1 = temp.Mid((indexS + 12), (indexE - (indexS + 12))); // +12 = char amount of "ParentActor="
-
-	//Get Class of first Individual
-	indexS = temp.Find("Class=", ESearchCase::IgnoreCase, ESearchDir::FromStart, 0);
-	temp.FindLastChar(';', indexE);
-	Indiv1Class = temp.Mid((indexS + 6), (indexE - (indexS + 6))); // = char amount of "Class="
-
-	//Get second individual
-	Ev.FindLastChar('[', indexS);
-	Ev.FindLastChar(']', indexE);
-	temp = Ev.Mid((indexS + 1), (indexE - indexS)); //get the full individual
-	indexS = temp.Find("ParentActor=", ESearchCase::IgnoreCase, ESearchDir::FromStart, 0);
-	temp.FindChar(';', indexE);
-
-	Indiv2 = temp.Mid((indexS + 12), (indexE - (indexS + 12)));
-
-	//Get Class of second Individual
-	//Get Class of first Individual
-	indexS = temp.Find("Class=", ESearchCase::IgnoreCase, ESearchDir::FromStart, 0);
-	temp.FindLastChar(';', indexE);
-	Indiv2Class = temp.Mid((indexS + 6), (indexE - (indexS + 6))); // = char amount of "Class="
+//name of the participant individual as used in the json triples (parent actor name, copied on the game thread)
+FString ParticipantName(const FSLIndividualSnapshot* Individual) {
+	return Individual && !Individual->ActorName.IsEmpty() ? Individual->ActorName : FString("null");
 }
 
-//iterate over all individuals in the world and write them to a String in the correct json format
-FString AllWorldIndividuals(UWorld* World) {
+//iterate over all individuals in the world and collect their names and classes (game thread only)
+void GetWorldIndividuals(UWorld* World, TArray<TPair<FString, FString>>& OutNamesAndClasses) {
 	// Iterate individuals from the world
-	FString temp;
 	for (TActorIterator<AActor> ActItr(World); ActItr; ++ActItr)
 	{
 		if (USLBaseIndividual* BI = FSLIndividualUtils::GetIndividualObject(*ActItr))
 		{
-			//FSLOwlSemMapDocUtils::AddIndividual(SemMapOwlDoc, BI);
 			//temp.Append(BI->GetClassValue()); // SoupSpoon
 			//temp.Append(BI->GetName()); //SLRigidIndividual_0
 			//temp.Append(BI->GetIdValue()); //CoDFZCpfYEufMO7oJHMWIw
 			//temp.Append(BI->GetParentActor()->GetHumanReadableName()); //SM_SoupSpoon_41
-
-			//define Named Individual
-			temp.Append("{\"s\": \"http://www.ease-crc.org/ont/SOMA.owl#");
-			temp.Append(BI->GetParentActor()->GetHumanReadableName());
-			//temp.Append(BI->GetName());
-			temp.Append("\", \"p\": \"http://www.w3.org/1999/02/22-rdf-syntax-ns#type\",");
-			temp.Append("\"o\": \"http://www.w3.org/2002/07/owl#NamedIndividual\", ");
-			temp.Append("\"graph\": \"user\" }, \n");
-
-			//define the individual as Object of Class
-			temp.Append("{\"s\": \"http://www.ease-crc.org/ont/SOMA.owl#");
-			temp.Append(BI->GetParentActor()->GetHumanReadableName());
-			//temp.Append(BI->GetName());
-			temp.Append("\", \"p\": \"http://www.w3.org/1999/02/22-rdf-syntax-ns#type\",");
-			temp.Append("\"o\": \"http://www.ease-crc.org/ont/SOMA.owl#");
-			temp.Append(BI->GetClassValue());
-			temp.Append("\", \"graph\": \"user\" }, \n");
+			OutNamesAndClasses.Emplace(BI->GetParentActor()->GetHumanReadableName(), BI->GetClassValue());
 		}
 	}
-	return temp;
 }
+
+//write the collected world individuals as named individuals of their respective classes
+void AllWorldIndividuals(FSLJsonTripleWriter& Writer, const TArray<TPair<FString, FString>>& NamesAndClasses) {
+	for (const auto& Pair : NamesAndClasses)
+	{
+		const FString& Name = Pair.Key;
+
+		//define Named Individual
+		Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), Name, TEXT("")),
+			TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#type"),
+			TEXT("http://www.w3.org/2002/07/owl#NamedIndividual"));
+
+		//define the individual as Object of Class
+		Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), Name, TEXT("")),
+			TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#type"),
+			FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), Pair.Value, TEXT("")));
+	}
+}
+
 //---------------Building JSON Utils-------------------------------
 // define Individual
 // id = Ev->Id (Event ID)
-// subject = http://www.ease-crc.org/ont/SOMA.owl#SupportState_ (Or any other link to Soma) 
-FString NamedIndividual(FString id, FString subject) {
-	FString eventJson;
-	eventJson.Append("{\"s\": \"");
-	eventJson.Append(subject);
-	eventJson.Append("_");
-	eventJson.Append(id);
-	eventJson.Append("\", \"p\": \"http://www.w3.org/1999/02/22-rdf-syntax-ns#type\",");
-	eventJson.Append("\"o\": \"http://www.w3.org/2002/07/owl#NamedIndividual\", ");
-	eventJson.Append("\"graph\": \"user\" }, \n");
-	return eventJson;
+// subject = http://www.ease-crc.org/ont/SOMA.owl#SupportState (Or any other link to Soma) 
+void NamedIndividual(FSLJsonTripleWriter& Writer, const FString& id, const TCHAR* subject) {
+	Writer.WriteTriple(FSLTripleTerm(subject, id),
+		TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#type"),
+		TEXT("http://www.w3.org/2002/07/owl#NamedIndividual"));
 }
 
 //define the specific object of a certain type (maybe the correct term is entity?)
 //related via type
 //id of the Event
 //subject = http://www.ease-crc.org/ont/SOMA.owl#SupportState
-FString SubjectOfTypeObject(FString id, FString subject) {
-	FString eventJson;
-	eventJson.Append("{\"s\": \"");
-	eventJson.Append(subject);
-	eventJson.Append("_");
-	eventJson.Append(id);
-	eventJson.Append("\", \"p\": \"http://www.w3.org/1999/02/22-rdf-syntax-ns#type\",");
-	eventJson.Append("\"o\": \"");
-	eventJson.Append(subject);
-	eventJson.Append("\", \"graph\": \"user\"}, \n");
-	return eventJson;
+void SubjectOfTypeObject(FSLJsonTripleWriter& Writer, const FString& id, const TCHAR* subject) {
+	Writer.WriteTriple(FSLTripleTerm(subject, id),
+		TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#type"),
+		subject);
 }
 
 //Define the individual of an Event via Classifinies relation. 
-//Generates a string that describes a role classifying an object
+//Writes a triple that describes a role classifying an object
 //id = Ev->Id (Event ID)
-//individual = NameOfIndividual
-//individualRole = http://www.ease-crc.org/ont/SOMA.owl#Supporter_ (The role of the individual in event)
-FString RoleIndividualClassifies(FString id, FString individual, FString individualRole ){
-	FString eventJson;
-	eventJson.Append("{\"s\": \"");
-	eventJson.Append(individualRole);
-	eventJson.Append("_");
-	eventJson.Append(id);
-	eventJson.Append("\", \"p\": \"http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies\",");
-	eventJson.Append("\"o\": \"http://www.ease-crc.org/ont/SOMA.owl#");
-	eventJson.Append(individual);
-	eventJson.Append("\", \"graph\": \"user\" }, \n");
-	return eventJson;
+//individual = iri of the individual
+//individualRole = http://www.ease-crc.org/ont/SOMA.owl#Supporter (The role of the individual in event)
+void RoleIndividualClassifies(FSLJsonTripleWriter& Writer, const FString& id, const FSLTripleTerm& individual, const TCHAR* individualRole) {
+	Writer.WriteTriple(FSLTripleTerm(individualRole, id),
+		TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies"),
+		individual);
 }
 
 //Defines the Time interval of an Event/State/Action
-//subject = http://www.ease-crc.org/ont/SOMA.owl#State_
+//subject = http://www.ease-crc.org/ont/SOMA.owl#State
 //startTime = Ev->StartTime (floats directly is fine)
-FString TimeIntervalOfSomething(FString id, FString subject, float startTime, float endTime) {
-	FString eventJson;
+void TimeIntervalOfSomething(FSLJsonTripleWriter& Writer, const FString& id, const TCHAR* subject, float startTime, float endTime) {
+	NamedIndividual(Writer, id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#TimeInterval"));
+	SubjectOfTypeObject(Writer, id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#TimeInterval"));
 
-	eventJson = NamedIndividual(id, "http://www.ease-crc.org/ont/SOMA.owl#TimeInterval");
-	eventJson.Append(SubjectOfTypeObject(id, "http://www.ease-crc.org/ont/SOMA.owl#TimeInterval"));
-
-	eventJson.Append("{\"s\": \"");
-	eventJson.Append(subject);
-	eventJson.Append("_");
-	eventJson.Append(id);
-	eventJson.Append("\", \"p\": \"http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#hasTimeInterval\",");
-	eventJson.Append("\"o\": \"http://www.ease-crc.org/ont/SOMA.owl#TimeInterval_");
-	eventJson.Append(id);
-	eventJson.Append("\", \"graph\": \"user\" }, \n");
+	Writer.WriteTriple(FSLTripleTerm(subject, id),
+		TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#hasTimeInterval"),
+		FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#TimeInterval"), id));
 
 	//start time
-	eventJson.Append("{\"s\": \"http://www.ease-crc.org/ont/SOMA.owl#TimeInterval_");
-	eventJson.Append(id);
-	eventJson.Append("\", \"p\": \"http://www.ease-crc.org/ont/SOMA.owl#hasIntervalBegin\",");
-	eventJson.Append("\"o\": { \"$numberDecimal\": \"");
-	eventJson.Append(FString::SanitizeFloat(startTime));
-	eventJson.Append("\" }, ");
-	eventJson.Append("\"graph\": \"user\" }, \n");
+	Writer.WriteDecimalTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#TimeInterval"), id),
+		TEXT("http://www.ease-crc.org/ont/SOMA.owl#hasIntervalBegin"), startTime);
 
 	//end time
-	eventJson.Append("{\"s\": \"http://www.ease-crc.org/ont/SOMA.owl#TimeInterval_");
-	eventJson.Append(id);
-	eventJson.Append("\", \"p\": \"http://www.ease-crc.org/ont/SOMA.owl#hasIntervalEnd\",");
-	eventJson.Append("\"o\": { \"$numberDecimal\": \"");
-	eventJson.Append(FString::SanitizeFloat(endTime));
-	eventJson.Append("\" }, ");
-	eventJson.Append("\"graph\": \"user\" }, \n");
-
-	return eventJson;
+	Writer.WriteDecimalTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#TimeInterval"), id),
+		TEXT("http://www.ease-crc.org/ont/SOMA.owl#hasIntervalEnd"), endTime);
 }
 
-FString GenerateTriple(FString const& s, FString const& p, FString const& o) {
-	FString eventJson;
-	eventJson.Append("{\"s\": \"");
-	eventJson.Append(s);
-	eventJson.Append("\", \"p\": \"");
-	eventJson.Append(p);
-	eventJson.Append("\", \"o\": \"");
-	eventJson.Append(o);
-	eventJson.Append("\", \"graph\": \"user\"}, \n");
-	return eventJson;
-}
+//write the episode, the world individuals and the events as json triples
+void WriteJsonTriples(const FString& FullPath, const FString& EpisodeId,
+	const TArray<TPair<FString, FString>>& WorldIndividuals, const FSLEventStore& FinishedEvents) {
+	//stream the triples to the file
+	FSLJsonTripleWriter Writer;
+	if (!Writer.Open(FullPath))
+	{
+		return;
+	}
+
+	//Define Episode and Episode ID at the beginning of the file
+	Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Episode"), EpisodeId),
+		TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#type"),
+		TEXT("http://www.ease-crc.org/ont/SOMA.owl#Episode"));
 
+	//Define Episode as an Individual of?
+	Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Episode"), EpisodeId),
+		TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#type"),
+		TEXT("http://www.w3.org/2002/07/owl#NamedIndividual"));
 
+	AllWorldIndividuals(Writer, WorldIndividuals); // add All Objects as named individuals and their respective classes
 
+	FinishedEvents.ForEachSnapshot([&Writer](const FSLEventSnapshot& Ev)
+	{
+		///----------------Supported By-------------------------------------------------------
+		switch (Ev.Kind) {
+		case ESLEventKind::SupportedBy: {
+			//----------------SUPPORTEDBY-----------------
+			//define Individual
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportState"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportState"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#State"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#State"), Ev.Id), TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportState"));
+
+			//define Individual for state
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#State"));
+			//define defines
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportState"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Supporter"), Ev.Id));
+			//define defines
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportState"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportedObject"), Ev.Id));
+
+			//get the individuals from their roles
+			const FString ind1 = ParticipantName(Ev.GetParticipant(ESLEventRole::Supported));
+			const FString ind2 = ParticipantName(Ev.GetParticipant(ESLEventRole::Supporter));
+
+			//define Supporter
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Supporter"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Supporter"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind2, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#Supporter"));
+
+			//define Supported
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportedObject"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportedObject"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind1, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#SupportedObject"));
+
+			//define Time Interval
+			TimeIntervalOfSomething(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#State"), Ev.StartTime, Ev.EndTime);
+			break;
+		}
+		case ESLEventKind::Contact: {
+			//---------CONTACT--------------------
+			//define Individual
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#ContactState"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#ContactState"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#State"));
+
+			//define Individual for state
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#State"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#State"), Ev.Id), TEXT("http://www.ease-crc.org/ont/SOMA.owl#ContactState"));
+
+			//define defines
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#ContactState"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"), Ev.Id));
+
+			//get the individuals in contact (in declaration order)
+			const FString ind1 = ParticipantName(Ev.Participants.Num() > 0 ? Ev.Participants[0].Individual : nullptr);
+			const FString ind2 = ParticipantName(Ev.Participants.Num() > 1 ? Ev.Participants[1].Individual : nullptr);
+
+			//define Patient (Object2)
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind2, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+
+			//define Patient (Object1)
+			//NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			//SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind1, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+
+			//define Time Interval
+			TimeIntervalOfSomething(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#State"), Ev.StartTime, Ev.EndTime);
+			break;
+		}
+		case ESLEventKind::Grasp: {
+			// ---------- GRASPING ----------------
+			//define Individual
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
+
+			//define Individual for state
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
+
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies"), FSLTripleTerm(TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.Id));
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"), Ev.Id));
+
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#executesTask"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"), Ev.Id));
+			
+			//get the individuals from their roles
+			const FString ind1 = ParticipantName(Ev.GetParticipant(ESLEventRole::Agent));
+			const FString ind2 = ParticipantName(Ev.GetParticipant(ESLEventRole::Patient));
+
+			//define Patient (Object2 which gets grasped)
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind2, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+
+			//define Agent (Object1)
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind1, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+
+			//define Time Interval
+			TimeIntervalOfSomething(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.StartTime, Ev.EndTime);
+			break;
+		}
+		case ESLEventKind::Reach: {
+			//-----------REACH------------------
+						// ---------- GRASPING ----------------
+			//define Individual
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Reaching"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Reaching"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
+
+			//define Individual for state
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
+
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Reaching"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies"), FSLTripleTerm(TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.Id));
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Reaching"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"), Ev.Id));
+
+			Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#executesTask"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Reaching"), Ev.Id));
+
+			//get the individuals from their roles
+			const FString ind1 = ParticipantName(Ev.GetParticipant(ESLEventRole::Agent));
+			const FString ind2 = ParticipantName(Ev.GetParticipant(ESLEventRole::Patient));
+
+			//define Patient (Object2 which gets grasped)
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind2, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+
+			//define Agent (Object1)
+			NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+			SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+			RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind1, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+
+			//define Time Interval
+			TimeIntervalOfSomething(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.StartTime, Ev.EndTime);
+			break;
+		}
+		case ESLEventKind::PreGrasp: {
+			////---------------PREGRASP---------------------------------
+			////define Individual
+			//NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"));
+			//SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"));
+			//SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
+
+			////define Individual for state
+			//NamedIndividual(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
+
+			//Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies"), FSLTripleTerm(TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.Id));
+			//Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"), Ev.Id));
+
+			//Writer.WriteTriple(FSLTripleTerm(TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#executesTask"), FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#Grasping"), Ev.Id));
+
+			////get the individuals from their roles
+			//const FString ind1 = ParticipantName(Ev.GetParticipant(ESLEventRole::Agent));
+			//const FString ind2 = ParticipantName(Ev.GetParticipant(ESLEventRole::Patient));
+
+			////define Patient (Object2 which gets grasped)
+			//NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			//SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+			//RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind2, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient"));
+
+			////define Agent (Object1)
+			//NamedIndividual(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+			//SubjectOfTypeObject(Writer, Ev.Id, TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+			//RoleIndividualClassifies(Writer, Ev.Id, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), ind1, TEXT("")), TEXT("http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
+
+			////define Time Interval
+			//TimeIntervalOfSomething(Writer, Ev.Id, TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"), Ev.StartTime, Ev.EndTime);
+			break;
+		}
+		default: {
+		//----DEBUGGING------
+			//UE_LOG(LogTemp, Log, TEXT("Rest: %s %s"), ISLEvent::GetKindName(Ev.Kind), *Ev.Context());
+			break;
+		}
+		}
+	});
+
+	Writer.Close();
+}
 
 //---------------End Building JSON Utils---------------------------
 
@@ -580,30 +754,86 @@ void ASLSymbolicLogger::FinishImpl(bool bForced)
 	//}
 	//ContainerMonitors.Empty();
 
-	// Create the experiment owl doc	
-	if (ExperimentDoc.IsValid())
+	// Close the event stream, all events are on disk at this point
+	EventStreamWriter.Finish(EpisodeEndTime);
+	EventLogWriter.Finish(EpisodeStartTime, EpisodeEndTime);
+
+	// The stored events are read by every output task as plain snapshots (the individual data was copied on the game thread),
+	// the tasks do not touch any UObject
+	const FSLEventStore& FinishedEvents = FinishedEventsStore;
+
+	//Episode ID is general so the Event does not matter
+	const FString TriplesEpisodeId = FinishedEvents.IsEmpty() ? LocationParameters.EpisodeId : FinishedEvents.Snapshot(0).EpisodeId;
+
+	// World access is game thread only, collect the individuals for the json triples beforehand
+	TArray<TPair<FString, FString>> WorldIndividuals;
+	if (GetWorld())
 	{
-		TArray<FString> SubActionIds;		
-		for (const auto& Ev : FinishedEvents)
+		GetWorldIndividuals(GetWorld(), WorldIndividuals);
+	}
+
+	// Each output is produced by a single task (in the store order), the files are byte-identical to a serial run
+	FGraphEventArray OutputTasks;
+
+	// Owl experiment
+	OutputTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([this, &FinishedEvents]()
+	{
+		WriteExperimentDoc(FinishedEvents);
+	}, TStatId(), nullptr, ENamedThreads::AnyThread));
+
+	// Json triples
+	OutputTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([this, &FinishedEvents, &WorldIndividuals, &TriplesEpisodeId]()
+	{
+		FString FullPath = GetOutputDirPath() + LocationParameters.EpisodeId + TEXT("_Triples.json");
+		FPaths::RemoveDuplicateSlashes(FullPath);
+		if (FPaths::FileExists(FullPath) && !LocationParameters.bOverwrite)
 		{
-			Ev->AddToOwlDoc(ExperimentDoc.Get());
-			SubActionIds.Add(Ev->Id);
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d %s already exists, the json triples are not written.."),
+				*FString(__FUNCTION__), __LINE__, *FullPath);
+			return;
 		}
+		WriteJsonTriples(FullPath, TriplesEpisodeId, WorldIndividuals, FinishedEvents);
+	}, TStatId(), nullptr, ENamedThreads::AnyThread));
 
-		// Add stored unique timepoints to doc
-		ExperimentDoc->AddTimepointIndividuals();
+	// Index the events for the temporal queries
+	if (LoggerParameters.bBuildEventIndex)
+	{
+		OutputTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([this, &FinishedEvents]()
+		{
+			EventIndex.Build(FinishedEvents);
+		}, TStatId(), nullptr, ENamedThreads::AnyThread));
+	}
 
-		// Add stored unique objects to doc
-		//ExperimentDoc->AddObjectIndividuals();
+	// Bulk insert the events into the database
+	if (EventsDBHandler.IsInit())
+	{
+		OutputTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([this, &FinishedEvents]()
+		{
+			EventsDBHandler.Write(FinishedEvents);
+			EventsDBHandler.Finish();
+		}, TStatId(), nullptr, ENamedThreads::AnyThread));
+	}
 
-		// Add experiment individual to doc	(metadata)	
-		ExperimentDoc->AddExperimentIndividual(SubActionIds, LocationParameters.SemanticMapId, LocationParameters.TaskId);
-	
-		
+	// Timelines (need all the events at once, the snapshots are released with the task)
+	if (LoggerParameters.bWriteTimelines)
+	{
+		OutputTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([this, &FinishedEvents]()
+		{
+			WriteTimelines(FinishedEvents);
+		}, TStatId(), nullptr, ENamedThreads::AnyThread));
 	}
 
-	// Write events to file
-	WriteToFile();
+	// The store and the collected data are read by the tasks, wait for all the outputs
+	FTaskGraphInterface::Get().WaitUntilTasksComplete(OutputTasks);
+	FinishedEventsStore.Reset();
+
+	// Detection latency report
+	if (LoggerParameters.bReportEventLatency)
+	{
+		EventLatencyStats.LogSummaries(GetName());
+		EventLatencyStats.WriteToFile(GetOutputDirPath() + LocationParameters.EpisodeId + TEXT("_EventLatency.csv"), LocationParameters.bOverwrite);
+		EventLatencyStats.Reset();
+	}
 
 #if SL_WITH_ROSBRIDGE
 	// Finish ROS Connection
@@ -616,218 +846,6 @@ void ASLSymbolicLogger::FinishImpl(bool bForced)
 
 	//UE_LOG(LogTemp, Warning, TEXT("%s::%d Symbolic logger (%s) succesfully finished at %.2f.."),
 	//	*FString(__FUNCTION__), __LINE__, *GetName(), GetWorld()->GetTimeSeconds());
-
-	//generate .json file
-	FString FullPath;
-	FullPath.Append(FPaths::ProjectDir() + "/" + "SL/Tasks/");
-	FullPath.Append("TestFile.json"); //Maybe replace with proper filename
-	FPaths::RemoveDuplicateSlashes(FullPath); //just in case
-
-	//generate string to write.
-	FString eventJson = "[";
-
-	//Define Episode and Episode ID at the beginning of the file
-	eventJson.Append("{\"s\": \"http://www.ease-crc.org/ont/SOMA.owl#Episode_");
-	eventJson.Append(FinishedEvents[0].Get()->EpisodeId); //Episode ID is general so the Event does not matter
-	eventJson.Append("\", \"p\": \"http://www.w3.org/1999/02/22-rdf-syntax-ns#type\",");
-	eventJson.Append("\"o\": \"http://www.ease-crc.org/ont/SOMA.owl#Episode\",");
-	eventJson.Append("\"graph\": \"user\" }, \n");
-
-	//Define Episode as an Individual of?
-	eventJson.Append("{\"s\": \"http://www.ease-crc.org/ont/SOMA.owl#Episode_");
-	eventJson.Append(FinishedEvents[0].Get()->EpisodeId);
-	eventJson.Append("\", \"p\": \"http://www.w3.org/1999/02/22-rdf-syntax-ns#type\",");
-	eventJson.Append("\"o\": \"http://www.w3.org/2002/07/owl#NamedIndividual\",");
-	eventJson.Append("\"graph\": \"user\" }, \n");
-
-	eventJson.Append(AllWorldIndividuals(GetWorld())); // add All Objects as named individuals and their respective classes
-
-	TArray<FString> SubActionIds;
-	for (const auto& Ev : FinishedEvents)
-	{	
-		Ev->AddToOwlDoc(ExperimentDoc.Get()); //TODO probably not needed?
-		SubActionIds.Add(Ev->Id); //TODO probably not needed?
-
-		///----------------Supported By-------------------------------------------------------
-		if (Ev->TypeName() == "SupportedBy") {
-			//----------------SUPPORTEDBY-----------------
-			//define Individual
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#SupportState"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#SupportState"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#State"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, FString("State_") + Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#SupportState"));
-
-			//define Individual for state
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#State"));
-			//define defines
-			GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#SupportState_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines", FString("http://www.ease-crc.org/ont/SOMA.owl#Supporter_") + Ev->Id);
-			//define defines
-			GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#SupportState_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines", FString("http://www.ease-crc.org/ont/SOMA.owl#SupportedObject_") + Ev->Id);
-
-			//parse string to get individuals
-			FString ind1, ind2, indc1, indc2;
-			GetIndividuals(Ev->ToString(), ind1, ind2, indc1, indc2);
-
-			//define Supporter
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Supporter"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Supporter"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, ind2, "http://www.ease-crc.org/ont/SOMA.owl#Supporter"));
-
-			//define Supported
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#SupportedObject"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#SupportedObject"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, ind1, "http://www.ease-crc.org/ont/SOMA.owl#SupportedObject"));
-
-			//define Time Interval
-			eventJson.Append(TimeIntervalOfSomething(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#State", Ev->StartTime, Ev->EndTime));
-		}
-		else if (Ev->TypeName() == "Contact") {
-			//---------CONTACT--------------------
-			//define Individual
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#ContactState"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#ContactState"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#State"));
-
-			//define Individual for state
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#State"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, FString("State_") + Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#ContactState"));
-
-			//define defines
-			GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#ContactState_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines", FString("http://www.ease-crc.org/ont/SOMA.owl#Patient_") + Ev->Id);
-
-			//parse string to get individuals
-			FString ind1, ind2, indc1, indc2;
-			GetIndividuals(Ev->ToString(), ind1, ind2, indc1, indc2);
-
-			//define Patient (Object2)
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, ind2, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-
-			//define Patient (Object1)
-			//eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			//eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, ind1, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-
-			//define Time Interval
-			eventJson.Append(TimeIntervalOfSomething(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#State", Ev->StartTime, Ev->EndTime));
-
-
-		} else if (Ev->TypeName() == "Grasp") {
-			// ---------- GRASPING ----------------
-			//define Individual
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Grasping"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Grasping"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
-
-			//define Individual for state
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
-
-			GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#Grasping_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies", FString("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action_") + Ev->Id);
-			GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#Grasping_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines", FString("http://www.ease-crc.org/ont/SOMA.owl#Patient_") + Ev->Id);
-
-			GenerateTriple(FString("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#executesTask", FString("http://www.ease-crc.org/ont/SOMA.owl#Grasping_") + Ev->Id);
-			
-			//parse string to get individuals
-			FString ind1, ind2, indc1, indc2;
-			GetIndividuals(Ev->ToString(), ind1, ind2, indc1, indc2);
-
-			//define Patient (Object2 which gets grasped)
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, ind2, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-
-			//define Agent (Object1)
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, ind1, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-
-			//define Time Interval
-			eventJson.Append(TimeIntervalOfSomething(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action", Ev->StartTime, Ev->EndTime));
-		
-		}
-		else if (Ev->TypeName() == "Reach") {
-			//-----------REACH------------------
-						// ---------- GRASPING ----------------
-			//define Individual
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Reaching"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Reaching"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
-
-			//define Individual for state
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
-
-			GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#Reaching_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies", FString("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action_") + Ev->Id);
-			GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#Reaching_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines", FString("http://www.ease-crc.org/ont/SOMA.owl#Patient_") + Ev->Id);
-
-			GenerateTriple(FString("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#executesTask", FString("http://www.ease-crc.org/ont/SOMA.owl#Reaching_") + Ev->Id);
-
-			//parse string to get individuals
-			FString ind1, ind2, indc1, indc2;
-			GetIndividuals(Ev->ToString(), ind1, ind2, indc1, indc2);
-
-			//define Patient (Object2 which gets grasped)
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, ind2, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-
-			//define Agent (Object1)
-			eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-			eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-			eventJson.Append(RoleIndividualClassifies(Ev->Id, ind1, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-
-			//define Time Interval
-			eventJson.Append(TimeIntervalOfSomething(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action", Ev->StartTime, Ev->EndTime));
-
-		}
-		else if (Ev->TypeName() == "PreGrasp") {
-			////---------------PREGRASP---------------------------------
-			////define Individual
-			//eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Grasping"));
-			//eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Grasping"));
-			//eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
-
-			////define Individual for state
-			//eventJson.Append(NamedIndividual(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action"));
-
-			//GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#Grasping_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies", FString("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action_") + Ev->Id);
-			//GenerateTriple(FString("http://www.ease-crc.org/ont/SOMA.owl#Grasping_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines", FString("http://www.ease-crc.org/ont/SOMA.owl#Patient_") + Ev->Id);
-
-			//GenerateTriple(FString("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action_") + Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#executesTask", FString("http://www.ease-crc.org/ont/SOMA.owl#Grasping_") + Ev->Id);
-
-			////parse string to get individuals
-			//FString ind1, ind2, indc1, indc2;
-			//GetIndividuals(Ev->ToString(), ind1, ind2, indc1, indc2);
-
-			////define Patient (Object2 which gets grasped)
-			//eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			//eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-			//eventJson.Append(RoleIndividualClassifies(Ev->Id, ind2, "http://www.ease-crc.org/ont/SOMA.owl#Patient"));
-
-			////define Agent (Object1)
-			//eventJson.Append(NamedIndividual(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-			//eventJson.Append(SubjectOfTypeObject(Ev->Id, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-			//eventJson.Append(RoleIndividualClassifies(Ev->Id, ind1, "http://www.ease-crc.org/ont/SOMA.owl#AgentRole"));
-
-			////define Time Interval
-			//eventJson.Append(TimeIntervalOfSomething(Ev->Id, "http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#Action", Ev->StartTime, Ev->EndTime));
-
-		}
-		else {
-		//----DEBUGGING------
-			//eventJson.Append("Rest: \n");
-			//eventJson.Append(Ev->TypeName());
-			//eventJson.Append("\n");
-			//eventJson.Append(Ev->ToString());
-		}
-	}
-	//eventJson.Append("\n \n \n \n");
-	//eventJson.Append(ExperimentDoc.Get()->ToString()); //ExperimentDoc->ToString()
-	
-
-	//this works
-	eventJson.Append("]");
-	FFileHelper::SaveStringToFile(eventJson, *FullPath);
 }
 
 // Bind user inputs
@@ -864,9 +882,21 @@ void ASLSymbolicLogger::UserInputToggleCallback()
 // Called when a semantic event is done
 void ASLSymbolicLogger::SemanticEventFinishedCallback(TSharedPtr<ISLEvent> Event)
 {
+	SL_SCOPE_CYCLE_COUNTER(STAT_SL_SymbolicLoggerEventFinished);
+	INC_DWORD_STAT(STAT_SL_NumEventsEmitted);
+
 	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("%s::%d %s"), *FString(__func__), __LINE__, *Event->ToString()));
 	//UE_LOG(LogTemp, Error, TEXT(">> %s::%d %s"), *FString(__func__), __LINE__, *Event->ToString());
-	FinishedEvents.Add(Event);
+	FinishedEventsStore.Add(Event);
+	EventStreamWriter.Add(Event);
+	if (Event.IsValid())
+	{
+		EventLogWriter.Add(*Event);
+		if (LoggerParameters.bReportEventLatency)
+		{
+			EventLatencyStats.Add(*Event, GetWorld()->GetTimeSeconds());
+		}
+	}
 
 #if SL_WITH_ROSBRIDGE
 	if (LoggerParameters.bPublishToROS)
@@ -876,28 +906,37 @@ void ASLSymbolicLogger::SemanticEventFinishedCallback(TSharedPtr<ISLEvent> Event
 #endif // SL_WITH_ROSBRIDGE
 }
 
-// Write data to file
-void ASLSymbolicLogger::WriteToFile()
+// Get the output directory of the episode
+FString ASLSymbolicLogger::GetOutputDirPath() const
 {
-	const FString DirPath = FPaths::ProjectDir() + "/SL/Tasks/" + LocationParameters.TaskId /*+ TEXT("/Episodes/")*/ + "/";
+	return FPaths::ProjectDir() + "/SL/Tasks/" + LocationParameters.TaskId /*+ TEXT("/Episodes/")*/ + "/";
+}
 
-	// Write events timelines to file
-	if (LoggerParameters.bWriteTimelines)
+// Create and write the experiment owl doc
+void ASLSymbolicLogger::WriteExperimentDoc(const FSLEventStore& InFinishedEvents)
+{
+	if (ExperimentDoc.IsValid())
 	{
-		FSLGoogleChartsParameters Params;
-		Params.bTooltips = true;
-		Params.StartTime = EpisodeStartTime;
-		Params.EndTime = EpisodeEndTime;
-		Params.TaskId = LocationParameters.TaskId;
-		Params.EpisodeId = LocationParameters.EpisodeId;
-		Params.bOverwrite = LocationParameters.bOverwrite;
-		Params.EventsSelection = LoggerParameters.TimelineEventsSelection;
-		FSLGoogleCharts::WriteTimelines(FinishedEvents, DirPath, LocationParameters.EpisodeId, Params);
-	}
+		TArray<FString> SubActionIds;
+		SubActionIds.Reserve(InFinishedEvents.Num());
+		InFinishedEvents.ForEachSnapshot([this, &SubActionIds](const FSLEventSnapshot& Ev)
+		{
+			Ev.AddToOwlDoc(ExperimentDoc.Get());
+			SubActionIds.Add(Ev.Id);
+		});
+
+		// Add stored unique timepoints to doc
+		ExperimentDoc->AddTimepointIndividuals();
+
+		// Add stored unique objects to doc
+		//ExperimentDoc->AddObjectIndividuals();
 
+		// Add experiment individual to doc	(metadata)	
+		ExperimentDoc->AddExperimentIndividual(SubActionIds, LocationParameters.SemanticMapId, LocationParameters.TaskId);
+	}
 
 	// Write experiment owl to file
-	FSLOwlExperimentStatics::WriteToFile(ExperimentDoc, DirPath, LocationParameters.bOverwrite);
+	FSLOwlExperimentStatics::WriteToFile(ExperimentDoc, GetOutputDirPath(), LocationParameters.bOverwrite, LoggerParameters.bWriteOwlNTriples);
 
 	//// Write owl data to file
 	//if (ExperimentDoc.IsValid())
@@ -912,6 +951,23 @@ void ASLSymbolicLogger::WriteToFile()
 	//}
 }
 
+// Write the events timelines
+void ASLSymbolicLogger::WriteTimelines(const FSLEventStore& InFinishedEvents) const
+{
+	TArray<FSLEventSnapshot> Events;
+	InFinishedEvents.SnapshotAll(Events);
+
+	FSLGoogleChartsParameters Params;
+	Params.bTooltips = true;
+	Params.StartTime = EpisodeStartTime;
+	Params.EndTime = EpisodeEndTime;
+	Params.TaskId = LocationParameters.TaskId;
+	Params.EpisodeId = LocationParameters.EpisodeId;
+	Params.bOverwrite = LocationParameters.bOverwrite;
+	Params.EventsSelection = LoggerParameters.TimelineEventsSelection;
+	FSLGoogleCharts::WriteTimelines(Events, GetOutputDirPath(), LocationParameters.EpisodeId, Params);
+}
+
 // Create events doc template
 TSharedPtr<FSLOwlExperiment> ASLSymbolicLogger::CreateEventsDocTemplate(ESLOwlExperimentTemplate TemplateType, const FString& InDocId)
 {
@@ -12,24 +12,20 @@
 
 #include "Misc/DateTime.h"
 
-// UUtils
-#if SL_WITH_ROS_CONVERSIONS
-#include "Conversions.h"
-#endif // SL_WITH_ROS_CONVERSIONS
-
 /* DB Write Async Task */
-// Init task
-
-//init seq
-int seq = 0;
-
 #if SL_WITH_LIBMONGO_C
-bool FSLWorldStateDBWriterAsyncTask::Init(mongoc_collection_t* in_collection, ASLIndividualManager* Manager, float PoseTolerance, bool bInWriteSparse)
+// Init task
+bool FSLWorldStateDBWriterAsyncTask::Init(mongoc_collection_t* in_collection, ASLIndividualManager* Manager, float PoseTolerance, bool bInWriteSparse, float InKeyframeInterval,
+	const FSLMongoSchema& InSchema)
 {
 	IndividualManager = Manager;
 	mongo_collection = in_collection;
 	MinPoseDiff = PoseTolerance;
 	bWriteSparse = bInWriteSparse;
+	KeyframeInterval = InKeyframeInterval;
+	PrevKeyframeTs = -BIG_NUMBER;
+	Schema = InSchema;
+	Seq = 0;
 
 	// Set the write function pointer (first write is without optimization, write all individuals)
 	WriteFunctionPtr = &FSLWorldStateDBWriterAsyncTask::FirstWrite;
@@ -58,28 +54,31 @@ int32 FSLWorldStateDBWriterAsyncTask::FirstWrite()
 	int32 Num = 0;
 
 #if SL_WITH_LIBMONGO_C
-	bson_t* ws_doc;
-	ws_doc = bson_new();
-
-	//AddTimestamp(ws_doc);
+	// One tf document per transform, sent in a single round trip
+	mongoc_bulk_operation_t* bulk;
+	bulk = mongoc_collection_create_bulk_operation_with_opts(mongo_collection, NULL);
 
-	Num += AddAllIndividuals(ws_doc);
-	Num += AddSkeletalIndividals(ws_doc);
+	Num += AddAllIndividuals(bulk);
+	Num += AddSkeletalIndividals(bulk);
 	//Num += AddRobotIndividuals(ws_doc);
 
-	// Write only if there are any entries in the document
+	// Write only if there are any entries in the bulk
 	if (Num > 0)
 	{
-		UploadDoc(ws_doc);
+		UploadBulk(bulk);
 	}
 
 	// Clean up
-	bson_destroy(ws_doc);
+	mongoc_bulk_operation_destroy(bulk);
 #endif //SL_WITH_LIBMONGO_C	
 
 	// Change the write function pointer to write only individuals that are moving
 	if (bWriteSparse)
 	{
+		if (KeyframeInterval > 0.f)
+		{
+			WriteKeyframe();
+		}
 		WriteFunctionPtr = &FSLWorldStateDBWriterAsyncTask::WriteSparse;
 	}
 	else
@@ -97,23 +96,27 @@ int32 FSLWorldStateDBWriterAsyncTask::WriteSparse()
 	int32 Num = 0;
 
 #if SL_WITH_LIBMONGO_C
-	bson_t* ws_doc;
-	ws_doc = bson_new();
+	mongoc_bulk_operation_t* bulk;
+	bulk = mongoc_collection_create_bulk_operation_with_opts(mongo_collection, NULL);
 
-	//AddTimestamp(ws_doc);
-
-	Num += AddIndividualsThatMoved(ws_doc);
-	Num += AddSkeletalIndividals(ws_doc);
+	Num += AddIndividualsThatMoved(bulk);
+	Num += AddSkeletalIndividals(bulk);
 	//Num += AddRobotIndividuals(ws_doc);
 
-	// Write only if there are any entries in the document
+	// Write only if there are any entries in the bulk
 	if (Num > 0)
 	{
-		UploadDoc(ws_doc);
+		UploadBulk(bulk);
 	}
 
 	// Clean up
-	bson_destroy(ws_doc);
+	mongoc_bulk_operation_destroy(bulk);
+
+	// Periodic full snapshot, bounds the number of sparse documents needed to rebuild a frame
+	if (KeyframeInterval > 0.f && Timestamp - PrevKeyframeTs >= KeyframeInterval)
+	{
+		Num += WriteKeyframe();
+	}
 #endif //SL_WITH_LIBMONGO_C
 
 	return Num;
@@ -126,254 +129,139 @@ int32 FSLWorldStateDBWriterAsyncTask::WriteAll()
 	int32 Num = 0;
 
 #if SL_WITH_LIBMONGO_C
-	bson_t* ws_doc;
-	ws_doc = bson_new();
+	mongoc_bulk_operation_t* bulk;
+	bulk = mongoc_collection_create_bulk_operation_with_opts(mongo_collection, NULL);
 
-	//AddTimestamp(ws_doc);
-
-	Num += AddAllIndividuals(ws_doc);
-	Num += AddSkeletalIndividals(ws_doc);
+	Num += AddAllIndividuals(bulk);
+	Num += AddSkeletalIndividals(bulk);
 	//Num += AddRobotIndividuals(ws_doc);
 
-	// Write only if there are any entries in the document
+	// Write only if there are any entries in the bulk
 	if (Num > 0)
 	{
-		UploadDoc(ws_doc);
+		UploadBulk(bulk);
 	}
 
 	// Clean up
-	bson_destroy(ws_doc);
+	mongoc_bulk_operation_destroy(bulk);
 #endif //SL_WITH_LIBMONGO_C
 
 	return Num;
 }
 
-#if SL_WITH_LIBMONGO_C
-// Add timestamp to the bson doc
-void FSLWorldStateDBWriterAsyncTask::AddTimestamp(bson_t* doc)
-{
-	//BSON_APPEND_DOUBLE(doc, "timestamp", Timestamp);
-	bson_append_now_utc(doc, "stamp", -1);
-}
-
-// Add all individuals (return the number of individuals added)
-int32 FSLWorldStateDBWriterAsyncTask::AddAllIndividuals(bson_t* doc)
+// Write a full snapshot of the individuals (keyframe) used as the starting point when rebuilding sparse frames
+int32 FSLWorldStateDBWriterAsyncTask::WriteKeyframe()
 {
 	int32 Num = 0;
-	//bson_t arr_obj;
-	uint32_t arr_idx = 0;
-
-	//BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &arr_obj);
-	for (const auto& Individual : IndividualManager->GetIndividuals())
-	{
-		//Individual->UpdateCachedPose(0.0);
-
-		//// TODO workaround
-		//Individual->SetHasMovedFlag(true);
 
-		//add header
-
-		bson_t header;
+#if SL_WITH_LIBMONGO_C
+	bson_t* kf_doc;
+	kf_doc = bson_new();
 
-		BSON_APPEND_DOCUMENT_BEGIN(doc, "header", &header);
-			
-			BSON_APPEND_INT32(&header, "seq", seq);
-			seq = seq + 1;
-			bson_append_now_utc(&header, "stamp", -1);
-			BSON_APPEND_UTF8(&header, "frame_id", "map");
-			
-		bson_append_document_end(doc, &header);
-		//end header
+	Schema.AppendTfHeader(kf_doc, Seq++, Timestamp);
+	BSON_APPEND_BOOL(kf_doc, "keyframe", true);
 
-		//bson_t individual_obj;
-		//char idx_str[16];
-		//const char* idx_key;
-		//for tf
-		BSON_APPEND_UTF8(doc, "child_frame_id", TCHAR_TO_UTF8(*Individual->GetParentActor()->GetHumanReadableName()));	//was GetIdValue	
+	bson_t arr_obj;
+	bson_t individual_obj;
+	char idx_str[16];
+	const char* idx_key;
+	uint32_t arr_idx = 0;
 
-		//bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
-		//BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &individual_obj);
-			// Id
-			//BSON_APPEND_UTF8(&individual_obj, "child_frame_id", TCHAR_TO_UTF8(*Individual->GetParentActor()->GetHumanReadableName()));	//was GetIdValue		
+	BSON_APPEND_ARRAY_BEGIN(kf_doc, "transforms", &arr_obj);
+	for (const auto& Individual : IndividualManager->GetIndividuals())
+	{
+		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &individual_obj);
+			// Id (same as the child frame id of the tf documents)
+			BSON_APPEND_UTF8(&individual_obj, "child_frame_id", TCHAR_TO_UTF8(*Individual->GetParentActor()->GetHumanReadableName()));
 			// Pose
-		AddPose(Individual->GetCachedPose(), doc);
-		//bson_append_document_end(&arr_obj, &individual_obj);
-
-		bson_append_now_utc(doc, "__recorded", -1);
-		BSON_APPEND_UTF8(doc, "topic", "tf");
+			FSLMongoSchema::AppendTfPose(&individual_obj, Individual->GetCachedPose());
+		bson_append_document_end(&arr_obj, &individual_obj);
 		arr_idx++;
 		Num++;
+	}
+	bson_append_array_end(kf_doc, &arr_obj);
 
-		//bson_append_document_end(doc, &arr_obj);
+	if (Num > 0)
+	{
+		UploadDoc(kf_doc);
 	}
-	//bson_append_array_end(doc, &arr_obj);
+	bson_destroy(kf_doc);
+	PrevKeyframeTs = Timestamp;
+#endif //SL_WITH_LIBMONGO_C
+
 	return Num;
 }
 
-// Add only the individuals that moved (return the number of individuals added)
-int32 FSLWorldStateDBWriterAsyncTask::AddIndividualsThatMoved(bson_t* doc)
+#if SL_WITH_LIBMONGO_C
+// Add all individuals (return the number of individuals added)
+int32 FSLWorldStateDBWriterAsyncTask::AddAllIndividuals(mongoc_bulk_operation_t* bulk)
 {
 	int32 Num = 0;
+	for (const auto& Individual : IndividualManager->GetIndividuals())
+	{
+		bson_t* doc = Schema.CreateTfDoc(Seq++, Timestamp, Individual->GetParentActor()->GetHumanReadableName(), Individual->GetCachedPose());	//was GetIdValue
+		mongoc_bulk_operation_insert(bulk, doc);
+		bson_destroy(doc);
+		Num++;
+	}
+	return Num;
+}
 
-	//bson_t individuals_arr;
-	uint32_t arr_idx = 0;
-
-	//BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &individuals_arr);
+// Add only the individuals that moved (return the number of individuals added)
+int32 FSLWorldStateDBWriterAsyncTask::AddIndividualsThatMoved(mongoc_bulk_operation_t* bulk)
+{
+	int32 Num = 0;
 	for (const auto& Individual : IndividualManager->GetIndividuals())
 	{
 		if (Individual->UpdateCachedPose(MinPoseDiff))
 		{
-			//// TODO workaround
-			//Individual->SetHasMovedFlag(true);
-
-			//add header
-			bson_t header;
-
-				BSON_APPEND_DOCUMENT_BEGIN(doc, "header", &header);
-					BSON_APPEND_INT32(&header, "seq", seq);
-					seq = seq + 1;
-					bson_append_now_utc(&header, "stamp", -1);
-					BSON_APPEND_UTF8(&header, "frame_id", "map");
-				bson_append_document_end(doc, &header);
-			//end header
-
-			//bson_t individual_obj;
-			//char idx_str[16];
-			//const char* idx_key;
-
-			//bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
-			//BSON_APPEND_DOCUMENT_BEGIN(&individual, idx_key, &individual_obj);
-				// Id
-			BSON_APPEND_UTF8(doc, "child_frame_id", TCHAR_TO_UTF8(*Individual->GetParentActor()->GetHumanReadableName())); //GetIdValue
-				// Pose
-			AddPose(Individual->GetCachedPose(), doc);
-
-			//bson_append_document_end(&individual, &individual_obj);
-
-			bson_append_now_utc(doc, "__recorded", -1);
-			BSON_APPEND_UTF8(doc, "topic", "tf");
-			//bson_append_document_end(doc, &individual);
-			arr_idx++;
+			bson_t* doc = Schema.CreateTfDoc(Seq++, Timestamp, Individual->GetParentActor()->GetHumanReadableName(), Individual->GetCachedPose()); //GetIdValue
+			mongoc_bulk_operation_insert(bulk, doc);
+			bson_destroy(doc);
 			Num++;
 		}
 	}
-	//bson_append_array_end(doc, &individuals_arr);
 	return Num;
 }
 
 // Add skeletal individuals (return the number of individuals added)
-int32 FSLWorldStateDBWriterAsyncTask::AddSkeletalIndividals(bson_t* doc)
+int32 FSLWorldStateDBWriterAsyncTask::AddSkeletalIndividals(mongoc_bulk_operation_t* bulk)
 {
 	int32 Num = 0;
-	//bson_t arr_obj;
-	uint32_t arr_idx = 0;
-
-	//BSON_APPEND_ARRAY_BEGIN(doc, "skeletal_individuals", &arr_obj);
 	for (const auto& SkelIndividual : IndividualManager->GetSkeletalIndividuals())
 	{
-		//// Check if it was marked as "moved" by the previous iterator function
-		//if (SkelIndividual->HasMovedFlagSet())
-		//{
-		//	SkelIndividual->SetHasMovedFlag(false);
-			//bson_t individual_obj;
-			//char idx_str[16];
-			//const char* idx_key;
-			bson_t header;
-			//bson_t individual;
-
-			//BSON_APPEND_DOCUMENT_BEGIN(doc, "", &individual);
-
-			BSON_APPEND_DOCUMENT_BEGIN(doc, "header", &header);
-				BSON_APPEND_INT32(&header, "seq", seq);
-				seq = seq + 1;
-				bson_append_now_utc(&header, "stamp", -1);
-				BSON_APPEND_UTF8(&header, "frame_id", "map");
-			bson_append_document_end(doc, &header);
+		const FString SkelId = SkelIndividual->GetParentActor()->GetHumanReadableName(); // was GetIdValue
+		bson_t* doc = Schema.CreateTfDoc(Seq++, Timestamp, SkelId, SkelIndividual->GetCachedPose());
+		mongoc_bulk_operation_insert(bulk, doc);
+		bson_destroy(doc);
 
-
-			//bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
-			//BSON_APPEND_DOCUMENT_BEGIN(&individual, idx_key, &individual_obj);
-				// Id
-			BSON_APPEND_UTF8(doc, "child_frame_id", TCHAR_TO_UTF8(*SkelIndividual->GetParentActor()->GetHumanReadableName())); // was GetIdValue
-				// Pose
-			AddPose(SkelIndividual->GetCachedPose(), doc);
-				// Bones
-				//AddSkeletalBoneIndividuals(SkelIndividual->GetBoneIndividuals(), SkelIndividual->GetVirtualBoneIndividuals(),
-				//	&individual_obj);
-				// Constraints
-				//AddSkeletalConstraintIndividuals(SkelIndividual->GetBoneConstraintIndividuals(), &individual_obj);
-			bson_append_now_utc(doc, "__recorded", -1);
-			BSON_APPEND_UTF8(doc, "topic", "tf");
-			//bson_append_document_end(doc, &individual);
-
-			AddSkeletalBoneIndividuals(SkelIndividual->GetBoneIndividuals(), SkelIndividual->GetVirtualBoneIndividuals(),
-				doc);
-			arr_idx++;
-			Num++;
-		//}
+		// Bones
+		AddSkeletalBoneIndividuals(SkelId, SkelIndividual->GetBoneIndividuals(), SkelIndividual->GetVirtualBoneIndividuals(), bulk);
+		// Constraints
+		//AddSkeletalConstraintIndividuals(SkelIndividual->GetBoneConstraintIndividuals(), &individual_obj);
+		Num++;
 	}
-	//bson_append_array_end(doc, &arr_obj);
 	return Num;
 }
 
-// Add skeletal bones to the document
-void FSLWorldStateDBWriterAsyncTask::AddSkeletalBoneIndividuals(
+// Add skeletal bones to the bulk, one tf document per bone linked to its skeletal individual
+void FSLWorldStateDBWriterAsyncTask::AddSkeletalBoneIndividuals(const FString& SkelId,
 	const TArray<USLBoneIndividual*>& BoneIndividuals,
 	const TArray<USLVirtualBoneIndividual*>& VirtualBoneIndividuals,
-	bson_t* doc)
+	mongoc_bulk_operation_t* bulk)
 {
-	//bson_t bones_arr;
-	//bson_t arr_obj;
-	//char idx_str[16];
-	//const char* idx_key;
-	uint32_t arr_idx = 0;
-
-	//BSON_APPEND_ARRAY_BEGIN(doc, "bones", &bones_arr);
-
 	for (const auto& BI : BoneIndividuals)
-	{	
-
-		bson_t header;
-
-		//BSON_APPEND_DOCUMENT_BEGIN(doc, "", &bone);
-		
-		BSON_APPEND_DOCUMENT_BEGIN(doc, "header", &header);
-			BSON_APPEND_INT32(&header, "seq", seq);
-			seq = seq + 1;
-			bson_append_now_utc(&header, "stamp", -1);
-			BSON_APPEND_UTF8(&header, "frame_id", "map");
-		bson_append_document_end(doc, &header);
-
-		//bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
-		//BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &arr_obj);
-			// Bone index
-			//BSON_APPEND_INT32(doc, "bone_index", BI->GetBoneIndex());
-			// Bone Name
-		BSON_APPEND_UTF8(doc, "child_frame_id", TCHAR_TO_UTF8(*BI->GetParentActor()->GetHumanReadableName()));
-			// Bone world pose
-		AddPose(BI->GetCachedPose(), doc);
-		//bson_append_document_end(&bones_arr, &arr_obj);
-		//bson_append_document_end(doc, &bone);
-		arr_idx++;
+	{
+		// Bone frame name (unique within the skeleton)
+		bson_t* doc = Schema.CreateTfDoc(Seq++, Timestamp, SkelId + TEXT("/") + BI->GetAttachmentLocationName().ToString(), BI->GetCachedPose());
+		// Skeletal individual and bone index, used to rebuild the skeletal poses
+		Schema.AppendTfBone(doc, SkelId, BI->GetBoneIndex());
+		mongoc_bulk_operation_insert(bulk, doc);
+		bson_destroy(doc);
 	}
 
 	//Ignoring virtual Bones for now. 
-	//for (const auto& VBI : VirtualBoneIndividuals)
-	//{
-	//	bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
-	//	BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &arr_obj);
-	//		// Bone index
-	//		BSON_APPEND_INT32(&arr_obj, "virtual_bone_index", VBI->GetBoneIndex());
-	//		// Bone Name
-	//		BSON_APPEND_UTF8(&arr_obj, "child_frame_id", TCHAR_TO_UTF8(*VBI->GetParentActor()->GetHumanReadableName()));
-	//		// Bone world pose
-	//		AddPose(VBI->GetCachedPose(), &arr_obj);
-	//	bson_append_document_end(&bones_arr, &arr_obj);
-	//	arr_idx++;
-	//}
-
-
-	//bson_append_array_end(doc, &bones_arr);
 }
 
 // Add skeletal bone constraints to the document
@@ -406,7 +294,7 @@ int32 FSLWorldStateDBWriterAsyncTask::AddRobotIndividuals(bson_t* doc)
 				// Id
 				BSON_APPEND_UTF8(&individual_obj, "id", TCHAR_TO_UTF8(*RoboIndividual->GetParentActor()->GetHumanReadableName())); //GetIdValue
 				// Pose
-				AddPose(RoboIndividual->GetCachedPose(), &individual_obj);
+				FSLMongoSchema::AppendTfPose(&individual_obj, RoboIndividual->GetCachedPose());
 
 				// Links				
 
@@ -422,69 +310,24 @@ int32 FSLWorldStateDBWriterAsyncTask::AddRobotIndividuals(bson_t* doc)
 	return Num;
 }
 
-// Add pose document
-void FSLWorldStateDBWriterAsyncTask::AddPose(FTransform Pose, bson_t* doc)
+// Write the bson doc to the collection
+bool FSLWorldStateDBWriterAsyncTask::UploadDoc(bson_t* doc)
 {
-#if SL_WITH_ROS_CONVERSIONS
-	FConversions::UToROS(Pose);
-#endif // SL_WITH_ROS_CONVERSIONS
-
-	bson_t child_obj_loc;
-	bson_t child_obj_rot;
-	bson_t child_obj_trans;
-
-	BSON_APPEND_DOCUMENT_BEGIN(doc, "transform", &child_obj_trans);
-
-	BSON_APPEND_DOCUMENT_BEGIN(&child_obj_trans, "translation", &child_obj_loc);
-	BSON_APPEND_DOUBLE(&child_obj_loc, "x", Pose.GetLocation().X);
-	BSON_APPEND_DOUBLE(&child_obj_loc, "y", Pose.GetLocation().Y);
-	BSON_APPEND_DOUBLE(&child_obj_loc, "z", Pose.GetLocation().Z);
-	bson_append_document_end(&child_obj_trans, &child_obj_loc);
-
-	BSON_APPEND_DOCUMENT_BEGIN(&child_obj_trans, "rotation", &child_obj_rot);
-	BSON_APPEND_DOUBLE(&child_obj_rot, "x", Pose.GetRotation().X);
-	BSON_APPEND_DOUBLE(&child_obj_rot, "y", Pose.GetRotation().Y);
-	BSON_APPEND_DOUBLE(&child_obj_rot, "z", Pose.GetRotation().Z);
-	BSON_APPEND_DOUBLE(&child_obj_rot, "w", Pose.GetRotation().W);
-	bson_append_document_end(&child_obj_trans, &child_obj_rot);
-
-	//bson_t child_pose;
-	//char buf[16];
-	//const char* key;
-	//size_t keylen;
-
-	bson_append_document_end(doc, &child_obj_trans);
-	// Write pose as array of [x y z qx qy qz qw]
-	//BSON_APPEND_ARRAY_BEGIN(doc, "pose", &child_pose);
-	//	// x
-	//	keylen = bson_uint32_to_string(0, &key, buf, sizeof buf);
-	//	bson_append_double(&child_pose, key, (int)keylen, Pose.GetLocation().X);
-	//	// y
-	//	keylen = bson_uint32_to_string(1, &key, buf, sizeof buf);
-	//	bson_append_double(&child_pose, key, (int)keylen, Pose.GetLocation().Y);
-	//	// z
-	//	keylen = bson_uint32_to_string(2, &key, buf, sizeof buf);
-	//	bson_append_double(&child_pose, key, (int)keylen, Pose.GetLocation().Z);
-	//	// qx
-	//	keylen = bson_uint32_to_string(3, &key, buf, sizeof buf);
-	//	bson_append_double(&child_pose, key, (int)keylen, Pose.GetRotation().X);
-	//	// qy
-	//	keylen = bson_uint32_to_string(4, &key, buf, sizeof buf);
-	//	bson_append_double(&child_pose, key, (int)keylen, Pose.GetRotation().Y);
-	//	// qz
-	//	keylen = bson_uint32_to_string(5, &key, buf, sizeof buf);
-	//	bson_append_double(&child_pose, key, (int)keylen, Pose.GetRotation().Z);
-	//	// qw
-	//	keylen = bson_uint32_to_string(6, &key, buf, sizeof buf);
-	//	bson_append_double(&child_pose, key, (int)keylen, Pose.GetRotation().W);
-	//bson_append_array_end(doc, &child_pose);
+	bson_error_t error;
+	if (!mongoc_collection_insert_one(mongo_collection, doc, NULL, NULL, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		return false;
+	}
+	return true;
 }
 
-// Write the bson doc to the meta_coll
-bool FSLWorldStateDBWriterAsyncTask::UploadDoc(bson_t* doc)
+// Write the bulk documents to the collection
+bool FSLWorldStateDBWriterAsyncTask::UploadBulk(mongoc_bulk_operation_t* bulk)
 {
 	bson_error_t error;
-	if (!mongoc_collection_insert_one(mongo_collection, doc, NULL, NULL, &error))
+	if (!mongoc_bulk_operation_execute(bulk, NULL, &error))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
 			*FString(__func__), __LINE__, *FString(error.message));
@@ -529,6 +372,13 @@ bool FSLWorldStateDBHandler::Init(ASLIndividualManager* IndividualManager,
 		return false;
 	}
 
+	// Layout of the written documents, the dates are the episode start shifted by the simulation time
+	const int64 TimeOriginMs = (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalMilliseconds();
+	Schema = FSLMongoSchema::Tf(TimeOriginMs);
+
+	// The schema is always stored, the query layer generates its pipelines from it
+	WriteSchemaMetadata(InLocationParameters.TaskId + ".meta", InLocationParameters.EpisodeId);
+
 	// Write metadata if needed
 	if (InLoggerParameters.bIncludeMetadata)
 	{
@@ -548,7 +398,8 @@ bool FSLWorldStateDBHandler::Init(ASLIndividualManager* IndividualManager,
 
 #if SL_WITH_LIBMONGO_C
 	// Set worker parameters
-	if (!DBWriterTask->GetTask().Init(collection, IndividualManager, InLoggerParameters.PoseTolerance, InLoggerParameters.bWriteSparse))
+	if (!DBWriterTask->GetTask().Init(collection, IndividualManager, InLoggerParameters.PoseTolerance, InLoggerParameters.bWriteSparse, InLoggerParameters.KeyframeInterval,
+		Schema))
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d World state async writer could not be initialized.."),
 			*FString(__FUNCTION__), __LINE__);
@@ -801,6 +652,39 @@ bool FSLWorldStateDBHandler::WriteMetadata(ASLIndividualManager* IndividualManag
 #endif //SL_WITH_LIBMONGO_C
 }
 
+// Write the schema of the episode documents (replaces any previous one of the episode)
+bool FSLWorldStateDBHandler::WriteSchemaMetadata(const FString& MetaCollName, const FString& EpisodeId)
+{
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	mongoc_collection_t* meta_coll;
+	meta_coll = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*MetaCollName));
+
+	bson_t* filter = FSLMongoSchema::CreateMetadataFilter(EpisodeId);
+	bson_t* schema_doc = Schema.CreateMetadataDoc(EpisodeId);
+	bson_t* opts = BCON_NEW("upsert", BCON_BOOL(true));
+
+	bool RetVal = true;
+	if (!mongoc_collection_replace_one(meta_coll, filter, schema_doc, opts, NULL, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		RetVal = false;
+	}
+
+	// Clean up
+	bson_destroy(opts);
+	bson_destroy(schema_doc);
+	bson_destroy(filter);
+	mongoc_collection_destroy(meta_coll);
+	return RetVal;
+#else
+	UE_LOG(LogTemp, Error, TEXT("%s::%d SL_WITH_LIBMONGO_C flag is 0, aborting.."),
+		*FString(__func__), __LINE__);
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
 #if SL_WITH_LIBMONGO_C
 int32 FSLWorldStateDBHandler::AddIndividualsMetadata(ASLIndividualManager* IndividualManager, bson_t* doc)
 {
@@ -867,44 +751,10 @@ bool FSLWorldStateDBHandler::CreateIndexes() const
 	}
 
 #if SL_WITH_LIBMONGO_C
-	bson_t* index_command;
 	bson_error_t error;
-	
-	bson_t idx_ts;
-	bson_init(&idx_ts);
-	BSON_APPEND_INT32(&idx_ts, "stamp", 1);
-	char* idx_ts_chr = mongoc_collection_keys_to_index_string(&idx_ts);
-
-	bson_t idx_individuals_id;
-	bson_init(&idx_individuals_id);
-	BSON_APPEND_INT32(&idx_individuals_id, "individuals.id", 1);
-	char* idx_individuals_id_chr = mongoc_collection_keys_to_index_string(&idx_individuals_id);
-
-	bson_t idx_skel_individuals_id;
-	bson_init(&idx_skel_individuals_id);
-	BSON_APPEND_INT32(&idx_skel_individuals_id, "skeletal_individuals.id", 1);
-	char* idx_skel_individuals_id_chr = mongoc_collection_keys_to_index_string(&idx_skel_individuals_id);
-
-	index_command = BCON_NEW("createIndexes",
-			BCON_UTF8(mongoc_collection_get_name(collection)),
-			"indexes",
-			"[",
-				"{",
-					"key", BCON_DOCUMENT(&idx_ts),
-					"name", BCON_UTF8(idx_ts_chr),
-					"unique", BCON_BOOL(true),
-				"}",
-				"{",
-					"key", BCON_DOCUMENT(&idx_individuals_id),
-					"name",	BCON_UTF8(idx_individuals_id_chr),
-					//"unique", //BCON_BOOL(false),
-				"}",
-				"{",
-					"key", BCON_DOCUMENT(&idx_skel_individuals_id),
-					"name", BCON_UTF8(idx_skel_individuals_id_chr),
-					//"unique", //BCON_BOOL(false),
-				"}",
-			"]");
+
+	// Indexes used by the query pipelines of the schema
+	bson_t* index_command = Schema.CreateIndexesCommand(mongoc_collection_get_name(collection));
 
 	bool bRetVal = true;
 	if (!mongoc_collection_write_command_with_opts(collection, index_command, NULL/*opts*/, NULL/*reply*/, &error))
@@ -916,8 +766,6 @@ bool FSLWorldStateDBHandler::CreateIndexes() const
 
 	// Clean up
 	bson_destroy(index_command);
-	bson_free(idx_ts_chr);
-	bson_free(idx_individuals_id_chr);
 	return bRetVal;
 #endif //SL_WITH_LIBMONGO_C
 
@@ -0,0 +1,147 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Events/SLEventIntervalIndex.h"
+
+namespace
+{
+	// Interval counts of the randomized rounds (empty, single, below and above the node sizes)
+	const int32 NumRoundIntervals[] = { 0, 1, 2, 7, 64, 500, 3000 };
+
+	// Queries per round and query kind
+	constexpr int32 NumRoundQueries = 300;
+
+	// Interval bounds are snapped to this grid, so queries often hit the bounds and the node centers exactly
+	constexpr float GridStep = 0.25f;
+
+	// Episode length of the random intervals
+	constexpr float EpisodeLength = 100.f;
+
+	// Random time on the grid, slightly outside of the episode as well
+	float RandomGridTime(FRandomStream& Rand)
+	{
+		return FMath::RoundToFloat(Rand.FRandRange(-2.f, EpisodeLength + 2.f) / GridStep) * GridStep;
+	}
+
+	// Random intervals, a part of them zero length or spanning most of the episode
+	TArray<FSLEventIntervalTree::FInterval> CreateRandomIntervals(FRandomStream& Rand, int32 Num)
+	{
+		TArray<FSLEventIntervalTree::FInterval> Intervals;
+		Intervals.Reserve(Num);
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			const float Start = RandomGridTime(Rand);
+			const float Roll = Rand.FRand();
+			float Length = FMath::RoundToFloat(Rand.FRandRange(0.f, 5.f) / GridStep) * GridStep;
+			if (Roll < 0.1f)
+			{
+				Length = 0.f;
+			}
+			else if (Roll > 0.95f)
+			{
+				Length = Rand.FRandRange(0.5f, 1.f) * EpisodeLength;
+			}
+			Intervals.Add({ Start, Start + Length, Idx });
+		}
+		return Intervals;
+	}
+
+	// Compare the query result with the expected (sorted, unique) indexes
+	bool TestSameIndexes(FAutomationTestBase& Test, const FString& What, TArray<int32> Result, const TArray<int32>& Expected)
+	{
+		Result.Sort();
+		if (Result == Expected)
+		{
+			return true;
+		}
+		int32 NumMatching = 0;
+		while (NumMatching < Result.Num() && NumMatching < Expected.Num() && Result[NumMatching] == Expected[NumMatching])
+		{
+			NumMatching++;
+		}
+		Test.AddError(FString::Printf(TEXT("%s: %d results, expected %d (first difference at %d: %d vs %d)"),
+			*What, Result.Num(), Expected.Num(), NumMatching,
+			Result.IsValidIndex(NumMatching) ? Result[NumMatching] : INDEX_NONE,
+			Expected.IsValidIndex(NumMatching) ? Expected[NumMatching] : INDEX_NONE));
+		return false;
+	}
+}
+
+/**
+* Builds the interval tree from random intervals and compares the stabbing and overlap queries
+* with a brute force scan of the intervals (duplicates or missing indexes fail the test)
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSLEventIntervalTreeRandomizedTest,
+	"USemLog.Events.IntervalTree.Randomized", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FSLEventIntervalTreeRandomizedTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Rand(0x51E7);
+	FSLEventIntervalTree Tree;
+	TArray<int32> Result;
+	TArray<int32> Expected;
+	for (const int32 NumIntervals : NumRoundIntervals)
+	{
+		const TArray<FSLEventIntervalTree::FInterval> Intervals = CreateRandomIntervals(Rand, NumIntervals);
+		Tree.Build(Intervals);
+		TestEqual(FString::Printf(TEXT("[%d] Number of intervals"), NumIntervals), Tree.Num(), NumIntervals);
+
+		for (int32 QueryIdx = 0; QueryIdx < NumRoundQueries; ++QueryIdx)
+		{
+			// Stab, every third query exactly at an interval bound
+			float T = RandomGridTime(Rand);
+			if (NumIntervals > 0 && QueryIdx % 3 == 0)
+			{
+				const auto& Bound = Intervals[Rand.RandHelper(NumIntervals)];
+				T = Rand.FRand() < 0.5f ? Bound.Start : Bound.End;
+			}
+			Expected.Reset();
+			for (const auto& Interval : Intervals)
+			{
+				if (Interval.Start <= T && T <= Interval.End)
+				{
+					Expected.Add(Interval.Idx);
+				}
+			}
+			Result.Reset();
+			Tree.Stab(T, Result);
+			if (!TestSameIndexes(*this, FString::Printf(TEXT("[%d] Stab(%.2f)"), NumIntervals, T), Result, Expected))
+			{
+				return false;
+			}
+
+			// Overlap, also empty and reversed ranges
+			float T0 = RandomGridTime(Rand);
+			float T1 = QueryIdx % 5 == 0 ? T0 : RandomGridTime(Rand);
+			const float Lo = FMath::Min(T0, T1);
+			const float Hi = FMath::Max(T0, T1);
+			Expected.Reset();
+			for (const auto& Interval : Intervals)
+			{
+				if (Interval.Start <= Hi && Lo <= Interval.End)
+				{
+					Expected.Add(Interval.Idx);
+				}
+			}
+			Result.Reset();
+			Tree.Overlap(T0, T1, Result);
+			if (!TestSameIndexes(*this, FString::Printf(TEXT("[%d] Overlap(%.2f, %.2f)"), NumIntervals, T0, T1), Result, Expected))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Reset leaves an empty tree
+	Tree.Reset();
+	Result.Reset();
+	Tree.Stab(1.f, Result);
+	Tree.Overlap(-EpisodeLength, EpisodeLength, Result);
+	TestEqual(TEXT("Empty tree after reset"), Result.Num() + Tree.Num(), 0);
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS
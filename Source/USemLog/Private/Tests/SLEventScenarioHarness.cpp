@@ -0,0 +1,314 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Tests/SLEventScenarioHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Monitors/SLContactMonitorBox.h"
+#include "Monitors/SLManipulatorMonitor.h"
+#include "Monitors/SLBoneContactMonitor.h"
+#include "Events/SLContactEventHandler.h"
+#include "Events/SLGraspEventHandler.h"
+#include "Individuals/SLIndividualUtils.h"
+#include "Individuals/SLIndividualComponent.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "HAL/PlatformTime.h"
+#include "Algo/BinarySearch.h"
+
+// Ctor
+FSLEventScenarioHarness::FSLEventScenarioHarness(float InDeltaTime) :
+	DeltaTime(InDeltaTime),
+	World(nullptr),
+	NumTicks(0),
+	TickSeconds(0.0),
+	MaxTickSeconds(0.0),
+	bIsFinished(false)
+{
+}
+
+// Dtor, finishes the handlers and destroys the world
+FSLEventScenarioHarness::~FSLEventScenarioHarness()
+{
+	// The handlers are bound raw to the monitors, finish them before the world (and the monitors) go away
+	Finish();
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		World = nullptr;
+	}
+	Handlers.Empty();
+}
+
+// Create the world
+bool FSLEventScenarioHarness::Init()
+{
+	if (!GEngine)
+	{
+		return false;
+	}
+	World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+	return true;
+}
+
+// Spawn a semantically annotated cube (movable), optionally with a contact monitor box
+AStaticMeshActor* FSLEventScenarioHarness::SpawnItem(const FString& Name, const FVector& Location, bool bWithContactMonitor)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Name = FName(*Name);
+	AStaticMeshActor* SMA = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, SpawnParams);
+	if (!SMA)
+	{
+		return nullptr;
+	}
+	SMA->SetMobility(EComponentMobility::Movable);
+	SMA->GetStaticMeshComponent()->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")));
+
+	// Generates the id, class and visual mask
+	USLIndividualComponent* IC = FSLIndividualUtils::AddNewIndividualComponent(SMA, true);
+	if (!IC || !IC->IsLoaded())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not load the individual of %s.."), *FString(__FUNCTION__), __LINE__, *Name);
+		return nullptr;
+	}
+
+	if (bWithContactMonitor)
+	{
+		USLContactMonitorBox* Box = NewObject<USLContactMonitorBox>(SMA);
+		Box->SetupAttachment(SMA->GetRootComponent());
+		Box->RegisterComponent();
+		ContactMonitors.Add(Box);
+	}
+	Velocities.Add(SMA, FVector::ZeroVector);
+	return SMA;
+}
+
+// Spawn a non skeletal gripper with two fingers
+FSLScenarioGripper FSLEventScenarioHarness::SpawnGripper(const FString& Name, const FVector& Location)
+{
+	FSLScenarioGripper Gripper;
+	Gripper.Hand = SpawnItem(Name, Location, false);
+	AStaticMeshActor* FingerActorA = SpawnItem(Name + TEXT("_FingerA"), Location + FVector(0.f, -50.f, -100.f), false);
+	AStaticMeshActor* FingerActorB = SpawnItem(Name + TEXT("_FingerB"), Location + FVector(0.f, 50.f, -100.f), false);
+	if (!Gripper.Hand || !FingerActorA || !FingerActorB)
+	{
+		return Gripper;
+	}
+
+	const auto AddFingerMonitor = [](AStaticMeshActor* Finger, ESLBoneContactGroup Group)
+	{
+		USLBoneContactMonitor* BoneMonitor = NewObject<USLBoneContactMonitor>(Finger);
+		BoneMonitor->SetGroup(Group);
+		BoneMonitor->SetIsNotSkeletal(true);
+		BoneMonitor->SetupAttachment(Finger->GetRootComponent());
+		BoneMonitor->RegisterComponent();
+		return BoneMonitor;
+	};
+	Gripper.FingerA = AddFingerMonitor(FingerActorA, ESLBoneContactGroup::A);
+	Gripper.FingerB = AddFingerMonitor(FingerActorB, ESLBoneContactGroup::B);
+
+	Gripper.Monitor = NewObject<USLManipulatorMonitor>(Gripper.Hand);
+	Gripper.Monitor->SetFingers({ FingerActorA, FingerActorB });
+	Gripper.Monitor->RegisterComponent();
+	Grippers.Add(Gripper);
+	return Gripper;
+}
+
+// Init and start the monitors and their handlers
+bool FSLEventScenarioHarness::Start()
+{
+	for (USLContactMonitorBox* Box : ContactMonitors)
+	{
+		Box->Init(true);
+		if (!Box->IsInit())
+		{
+			return false;
+		}
+		TSharedPtr<ISLEventHandler> Handler = MakeShareable(new FSLContactEventHandler());
+		Handler->Init(Box);
+		Handler->OnSemanticEvent.BindRaw(this, &FSLEventScenarioHarness::OnSemanticEvent);
+		Handler->Start();
+		Box->Start();
+		Handlers.Add(Handler);
+	}
+
+	for (const auto& Gripper : Grippers)
+	{
+		Gripper.Monitor->Init(true, false);
+		if (!Gripper.Monitor->IsInit())
+		{
+			return false;
+		}
+		TSharedPtr<ISLEventHandler> Handler = MakeShareable(new FSLGraspEventHandler());
+		Handler->Init(Gripper.Monitor);
+		Handler->OnSemanticEvent.BindRaw(this, &FSLEventScenarioHarness::OnSemanticEvent);
+		Handler->Start();
+		Gripper.Monitor->Start();
+		Handlers.Add(Handler);
+	}
+
+	for (const auto& Handler : Handlers)
+	{
+		if (!Handler->IsStarted())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Run the step at the given world time
+void FSLEventScenarioHarness::At(float Time, TFunction<void()> Step)
+{
+	// Keep the insertion order of steps with the same time
+	const int32 Idx = Algo::UpperBoundBy(Steps, Time, [](const FStep& S) { return S.Time; });
+	Steps.Insert(FStep{ Time, MoveTemp(Step) }, Idx);
+}
+
+// Script a contact begin/end between the monitor boxes of the two items
+void FSLEventScenarioHarness::AtContact(float Time, AStaticMeshActor* A, AStaticMeshActor* B, bool bBegin)
+{
+	At(Time, [A, B, bBegin]()
+	{
+		USLContactMonitorBox* BoxA = A->FindComponentByClass<USLContactMonitorBox>();
+		USLContactMonitorBox* BoxB = B->FindComponentByClass<USLContactMonitorBox>();
+		BroadcastOverlap(BoxA, BoxB, bBegin);
+		BroadcastOverlap(BoxB, BoxA, bBegin);
+	});
+}
+
+// Script a grasp overlap begin/end between the finger and the item mesh
+void FSLEventScenarioHarness::AtFingerContact(float Time, USLBoneContactMonitor* Finger, AStaticMeshActor* Item, bool bBegin)
+{
+	At(Time, [Finger, Item, bBegin]()
+	{
+		BroadcastOverlap(Finger, Item->GetStaticMeshComponent(), bBegin);
+	});
+}
+
+// Set the (kinematic) velocity of the item, the location is integrated every tick
+void FSLEventScenarioHarness::AtVelocity(float Time, AStaticMeshActor* Item, const FVector& Velocity)
+{
+	At(Time, [this, Item, Velocity]()
+	{
+		Velocities.Add(Item, Velocity);
+		Item->GetStaticMeshComponent()->ComponentVelocity = Velocity;
+	});
+}
+
+// Tick the world until the given time, running the due steps before each tick
+void FSLEventScenarioHarness::RunUntil(float Time)
+{
+	while (World->GetTimeSeconds() < Time)
+	{
+		const double TickStart = FPlatformTime::Seconds();
+
+		// Trigger samples of this frame
+		const float CurrTime = World->GetTimeSeconds();
+		int32 NumDue = 0;
+		while (NumDue < Steps.Num() && Steps[NumDue].Time <= CurrTime)
+		{
+			Steps[NumDue].Fn();
+			NumDue++;
+		}
+		Steps.RemoveAt(0, NumDue, false);
+
+		// Kinematic motion
+		for (const auto& Pair : Velocities)
+		{
+			if (!Pair.Value.IsZero())
+			{
+				Pair.Key->SetActorLocation(Pair.Key->GetActorLocation() + Pair.Value * DeltaTime);
+				Pair.Key->GetStaticMeshComponent()->ComponentVelocity = Pair.Value;
+			}
+		}
+
+		World->Tick(LEVELTICK_All, DeltaTime);
+
+		const double Elapsed = FPlatformTime::Seconds() - TickStart;
+		TickSeconds += Elapsed;
+		MaxTickSeconds = FMath::Max(MaxTickSeconds, Elapsed);
+		NumTicks++;
+	}
+}
+
+// Finish the handlers (publishes the still open events at the current time)
+void FSLEventScenarioHarness::Finish()
+{
+	if (!bIsFinished && World)
+	{
+		const float EndTime = World->GetTimeSeconds();
+		for (const auto& Handler : Handlers)
+		{
+			Handler->Finish(EndTime);
+		}
+		bIsFinished = true;
+	}
+}
+
+// Get the world time
+float FSLEventScenarioHarness::GetTime() const
+{
+	return World ? World->GetTimeSeconds() : 0.f;
+}
+
+// Get the individual of the actor
+USLBaseIndividual* FSLEventScenarioHarness::GetIndividual(AActor* Actor)
+{
+	return FSLIndividualUtils::GetIndividualObject(Actor);
+}
+
+// Get the recorded events of the given kind between the two individuals (in any role)
+TArray<FSLScenarioEvent> FSLEventScenarioHarness::FindEvents(ESLEventKind Kind, AActor* A, AActor* B) const
+{
+	USLBaseIndividual* IndividualA = GetIndividual(A);
+	USLBaseIndividual* IndividualB = GetIndividual(B);
+	TArray<FSLScenarioEvent> Found;
+	for (const auto& Ev : Events)
+	{
+		if (Ev.Event->Kind() != Kind)
+		{
+			continue;
+		}
+		FSLEventParticipants Participants;
+		Ev.Event->GetParticipants(Participants);
+		const bool bHasA = Participants.ContainsByPredicate([IndividualA](const FSLEventParticipant& P) { return P.Individual == IndividualA; });
+		const bool bHasB = Participants.ContainsByPredicate([IndividualB](const FSLEventParticipant& P) { return P.Individual == IndividualB; });
+		if (bHasA && bHasB)
+		{
+			Found.Add(Ev);
+		}
+	}
+	return Found;
+}
+
+// Record the finished event
+void FSLEventScenarioHarness::OnSemanticEvent(TSharedPtr<ISLEvent> Event)
+{
+	const float BroadcastTime = World->GetTimeSeconds();
+	Events.Add(FSLScenarioEvent{ Event, BroadcastTime });
+	LatencyStats.Add(*Event, BroadcastTime);
+}
+
+// Broadcast the overlap begin/end on the component
+void FSLEventScenarioHarness::BroadcastOverlap(UPrimitiveComponent* Comp, UPrimitiveComponent* OtherComp, bool bBegin)
+{
+	if (bBegin)
+	{
+		Comp->OnComponentBeginOverlap.Broadcast(Comp, OtherComp->GetOwner(), OtherComp, 0, false, FHitResult());
+	}
+	else
+	{
+		Comp->OnComponentEndOverlap.Broadcast(Comp, OtherComp->GetOwner(), OtherComp, 0);
+	}
+}
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,264 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Tests/SLEventScenarioHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Engine/StaticMeshActor.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "Events/SLEventStore.h"
+
+namespace
+{
+	// Contact end publishing delay (merge window of jittering contacts + extra delay, see SLContactMonitorInterface.h)
+	constexpr float ContactEndDelay = 0.21f + 0.05f;
+
+	// Supported by check period (see SLContactMonitorInterface.h)
+	constexpr float SupportedByCheckRate = 0.11f;
+
+	// Grasp contact end publishing delay of the bone monitors (see SLBoneContactMonitor.h)
+	constexpr float BoneGraspEndDelay = 0.26f * 1.1f;
+
+	// Grasp end publishing delay of the manipulator monitor (see SLManipulatorMonitor.cpp)
+	constexpr float GraspEndDelay = 0.11f + 0.05f;
+
+	// Cpu budget of a tick (monitors, handlers and scripted steps of a handful of items), in milliseconds
+	constexpr double MeanTickBudgetMs = 2.0;
+
+	// Expected event between two items
+	struct FExpectedEvent
+	{
+		ESLEventKind Kind;
+		AActor* A;
+		AActor* B;
+		// Expected start and end interval
+		float StartMin;
+		float StartMax;
+		float EndMin;
+		float EndMax;
+		// Max delay between the end of the event and its broadcast
+		float EndToBroadcastBudget;
+	};
+
+	// Check that exactly one event matches, with its times, its end to broadcast and its onset to broadcast latency in budget
+	const ISLEvent* TestExpectedEvent(FAutomationTestBase& Test, const FSLEventScenarioHarness& Harness, const FExpectedEvent& Expected)
+	{
+		const FString What = FString::Printf(TEXT("%s(%s, %s)"), ISLEvent::GetKindName(Expected.Kind),
+			*Expected.A->GetName(), *Expected.B->GetName());
+		TArray<FSLScenarioEvent> Found = Harness.FindEvents(Expected.Kind, Expected.A, Expected.B);
+		if (!Test.TestEqual(What + TEXT(" number of events"), Found.Num(), 1))
+		{
+			return nullptr;
+		}
+
+		const ISLEvent& Ev = *Found[0].Event;
+		const float BroadcastTime = Found[0].BroadcastTime;
+		Test.TestTrue(FString::Printf(TEXT("%s start=%.3f expected in [%.3f, %.3f]"), *What, Ev.StartTime, Expected.StartMin, Expected.StartMax),
+			Ev.StartTime >= Expected.StartMin && Ev.StartTime <= Expected.StartMax);
+		Test.TestTrue(FString::Printf(TEXT("%s end=%.3f expected in [%.3f, %.3f]"), *What, Ev.EndTime, Expected.EndMin, Expected.EndMax),
+			Ev.EndTime >= Expected.EndMin && Ev.EndTime <= Expected.EndMax);
+		Test.TestTrue(FString::Printf(TEXT("%s end to broadcast=%.3f expected <= %.3f"), *What, BroadcastTime - Ev.EndTime, Expected.EndToBroadcastBudget),
+			BroadcastTime - Ev.EndTime <= Expected.EndToBroadcastBudget);
+
+		// Onset latency, the detection is known only after the event ended and its end delay passed
+		const float OnsetBudget = Expected.EndMax - Expected.StartMin + Expected.EndToBroadcastBudget;
+		Test.TestTrue(FString::Printf(TEXT("%s onset to broadcast=%.3f expected <= %.3f"), *What, BroadcastTime - Ev.StartTime, OnsetBudget),
+			BroadcastTime - Ev.StartTime <= OnsetBudget);
+		return &Ev;
+	}
+
+	// Check the total number of events, the latency report and the cpu budget
+	void TestScenarioTotals(FAutomationTestBase& Test, const FSLEventScenarioHarness& Harness, int32 ExpectedNumEvents)
+	{
+		Test.TestEqual(TEXT("Total number of events"), Harness.GetEvents().Num(), ExpectedNumEvents);
+
+		TArray<FSLEventLatencySummary> Summaries;
+		Harness.GetLatencyStats().GetSummaries(Summaries);
+		int32 NumReported = 0;
+		for (const auto& Summary : Summaries)
+		{
+			NumReported += Summary.Num;
+			Test.AddInfo(FString::Printf(TEXT("%s onset latency num=%d mean=%.3f p95=%.3f max=%.3f"),
+				ISLEvent::GetKindName(Summary.Kind), Summary.Num, Summary.Mean, Summary.P95, Summary.Max));
+		}
+		Test.TestEqual(TEXT("Events in the latency report"), NumReported, ExpectedNumEvents);
+
+		Test.AddInfo(FString::Printf(TEXT("Tick cpu mean=%.4fms max=%.4fms"), Harness.GetMeanTickMs(), Harness.GetMaxTickMs()));
+		Test.TestTrue(FString::Printf(TEXT("Mean tick cpu=%.4fms expected <= %.4fms"), Harness.GetMeanTickMs(), MeanTickBudgetMs),
+			Harness.GetMeanTickMs() <= MeanTickBudgetMs);
+	}
+
+	// Check that the stored snapshots serialize the same as the events (the finalization tasks only read the snapshots)
+	void TestEventSnapshots(FAutomationTestBase& Test, const FSLEventScenarioHarness& Harness)
+	{
+		FSLEventStore Store;
+		for (const auto& Ev : Harness.GetEvents())
+		{
+			Store.Add(Ev.Event);
+		}
+		for (int32 Idx = 0; Idx < Harness.GetEvents().Num(); ++Idx)
+		{
+			const ISLEvent& Ev = *Harness.GetEvents()[Idx].Event;
+			const FSLEventSnapshot Snapshot = Store.Snapshot(Idx);
+			const FString What = FString::Printf(TEXT("%s snapshot %s"), ISLEvent::GetKindName(Ev.Kind()), *Ev.Id);
+			FString EvIndent, SnapshotIndent;
+			Test.TestEqual(What + TEXT(" owl"), Snapshot.ToOwlNode().ToString(SnapshotIndent), Ev.ToOwlNode().ToString(EvIndent));
+			Test.TestEqual(What + TEXT(" context"), Snapshot.Context(), Ev.Context());
+			Test.TestEqual(What + TEXT(" tooltip"), Snapshot.Tooltip(), Ev.Tooltip());
+
+			FSLEventParticipants Participants;
+			Ev.GetParticipants(Participants);
+			if (Test.TestEqual(What + TEXT(" participants"), Snapshot.Participants.Num(), Participants.Num()))
+			{
+				for (int32 PIdx = 0; PIdx < Participants.Num(); ++PIdx)
+				{
+					const FSLIndividualSnapshot* Individual = Snapshot.Participants[PIdx].Individual;
+					Test.TestTrue(What + TEXT(" participant id"), Individual && Individual->Id == Participants[PIdx].Individual->GetIdValue());
+					Test.TestTrue(What + TEXT(" participant actor"), Individual && Individual->ActorName == Participants[PIdx].Individual->GetParentActor()->GetName());
+					Test.TestTrue(What + TEXT(" participant role"), Snapshot.Participants[PIdx].Role == Participants[PIdx].Role);
+				}
+			}
+		}
+	}
+}
+
+/**
+* Box A rests on the table, box B is lowered on box A, comes to rest, and is lifted off;
+* expects one contact and one supported by event for each pair, no contact between B and the table
+*/
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FSLStackedObjectsScenarioTest, FSLEventScenarioTestBase,
+	"USemLog.Events.Scenario.StackedObjects", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FSLStackedObjectsScenarioTest::RunTest(const FString& Parameters)
+{
+	FSLEventScenarioHarness Harness;
+	if (!TestTrue(TEXT("World created"), Harness.Init()))
+	{
+		return false;
+	}
+	AStaticMeshActor* Table = Harness.SpawnItem(TEXT("Table"), FVector(0.f, 0.f, 0.f));
+	AStaticMeshActor* BoxA = Harness.SpawnItem(TEXT("BoxA"), FVector(0.f, 0.f, 100.f));
+	AStaticMeshActor* BoxB = Harness.SpawnItem(TEXT("BoxB"), FVector(0.f, 0.f, 210.f));
+	if (!TestTrue(TEXT("Items spawned"), Table && BoxA && BoxB) || !TestTrue(TEXT("Monitors started"), Harness.Start()))
+	{
+		return false;
+	}
+
+	Harness.AtContact(0.2f, BoxA, Table, true);
+	Harness.AtVelocity(0.8f, BoxB, FVector(0.f, 0.f, -10.f));
+	Harness.AtContact(1.0f, BoxB, BoxA, true);
+	Harness.AtVelocity(1.2f, BoxB, FVector::ZeroVector);
+	Harness.AtVelocity(2.9f, BoxB, FVector(0.f, 0.f, 10.f));
+	Harness.AtContact(3.0f, BoxB, BoxA, false);
+	Harness.RunUntil(4.f);
+	Harness.Finish();
+
+	const float Dt = Harness.GetDeltaTime();
+	const float FinishTime = Harness.GetTime();
+	TestExpectedEvent(*this, Harness, { ESLEventKind::Contact, BoxA, Table,
+		0.2f, 0.2f + Dt, FinishTime, FinishTime, 0.f });
+	TestExpectedEvent(*this, Harness, { ESLEventKind::Contact, BoxB, BoxA,
+		1.0f, 1.0f + Dt, 3.0f, 3.0f + Dt, ContactEndDelay + Dt });
+	if (const ISLEvent* Ev = TestExpectedEvent(*this, Harness, { ESLEventKind::SupportedBy, BoxA, Table,
+		0.2f, 0.2f + SupportedByCheckRate + Dt, FinishTime, FinishTime, 0.f }))
+	{
+		TestTrue(TEXT("BoxA is the supported one"), Ev->GetParticipant(ESLEventRole::Supported) == Harness.GetIndividual(BoxA));
+	}
+	// Supported only after B came to rest (relative vertical speed)
+	if (const ISLEvent* Ev = TestExpectedEvent(*this, Harness, { ESLEventKind::SupportedBy, BoxB, BoxA,
+		1.2f, 1.2f + SupportedByCheckRate + Dt, 3.0f, 3.0f + Dt, ContactEndDelay + Dt }))
+	{
+		TestTrue(TEXT("BoxB is the supported one"), Ev->GetParticipant(ESLEventRole::Supported) == Harness.GetIndividual(BoxB));
+	}
+	TestEqual(TEXT("Contacts between BoxB and the table"), Harness.FindEvents(ESLEventKind::Contact, BoxB, Table).Num(), 0);
+	TestScenarioTotals(*this, Harness, 4);
+	TestEventSnapshots(*this, Harness);
+	return true;
+}
+
+/**
+* The cup slides over the table, its contact area loses the table for a moment, then the cup is lifted off;
+* expects the jitter to be merged in one contact and one uninterrupted supported by event
+*/
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FSLSlidingCupScenarioTest, FSLEventScenarioTestBase,
+	"USemLog.Events.Scenario.SlidingCup", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FSLSlidingCupScenarioTest::RunTest(const FString& Parameters)
+{
+	FSLEventScenarioHarness Harness;
+	if (!TestTrue(TEXT("World created"), Harness.Init()))
+	{
+		return false;
+	}
+	AStaticMeshActor* Table = Harness.SpawnItem(TEXT("Table"), FVector(1000.f, 0.f, 0.f));
+	AStaticMeshActor* Cup = Harness.SpawnItem(TEXT("Cup"), FVector(1000.f, 0.f, 100.f));
+	if (!TestTrue(TEXT("Items spawned"), Table && Cup) || !TestTrue(TEXT("Monitors started"), Harness.Start()))
+	{
+		return false;
+	}
+
+	Harness.AtContact(0.2f, Cup, Table, true);
+	Harness.AtVelocity(1.0f, Cup, FVector(50.f, 0.f, 0.f));
+	// Gap shorter than the merge window
+	Harness.AtContact(1.5f, Cup, Table, false);
+	Harness.AtContact(1.6f, Cup, Table, true);
+	Harness.AtVelocity(2.5f, Cup, FVector::ZeroVector);
+	Harness.AtVelocity(2.8f, Cup, FVector(0.f, 0.f, 20.f));
+	Harness.AtContact(3.0f, Cup, Table, false);
+	Harness.RunUntil(4.f);
+	Harness.Finish();
+
+	const float Dt = Harness.GetDeltaTime();
+	TestExpectedEvent(*this, Harness, { ESLEventKind::Contact, Cup, Table,
+		0.2f, 0.2f + Dt, 3.0f, 3.0f + Dt, ContactEndDelay + Dt });
+	if (const ISLEvent* Ev = TestExpectedEvent(*this, Harness, { ESLEventKind::SupportedBy, Cup, Table,
+		0.2f, 0.2f + SupportedByCheckRate + Dt, 3.0f, 3.0f + Dt, ContactEndDelay + Dt }))
+	{
+		TestTrue(TEXT("Cup is the supported one"), Ev->GetParticipant(ESLEventRole::Supported) == Harness.GetIndividual(Cup));
+	}
+	TestScenarioTotals(*this, Harness, 2);
+	TestEventSnapshots(*this, Harness);
+	return true;
+}
+
+/**
+* The gripper closes on the mug, both fingers lose it for a few frames, close again, then release it;
+* expects one grasp event, the end is known after the bone and the manipulator merge windows
+*/
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FSLJitteryGraspScenarioTest, FSLEventScenarioTestBase,
+	"USemLog.Events.Scenario.JitteryGrasp", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FSLJitteryGraspScenarioTest::RunTest(const FString& Parameters)
+{
+	FSLEventScenarioHarness Harness;
+	if (!TestTrue(TEXT("World created"), Harness.Init()))
+	{
+		return false;
+	}
+	const FSLScenarioGripper Gripper = Harness.SpawnGripper(TEXT("Gripper"), FVector(2000.f, 0.f, 300.f));
+	AStaticMeshActor* Mug = Harness.SpawnItem(TEXT("Mug"), FVector(2000.f, 0.f, 0.f), false);
+	if (!TestTrue(TEXT("Items spawned"), Gripper.Monitor && Mug) || !TestTrue(TEXT("Monitors started"), Harness.Start()))
+	{
+		return false;
+	}
+
+	Harness.AtFingerContact(1.0f, Gripper.FingerA, Mug, true);
+	Harness.AtFingerContact(1.05f, Gripper.FingerB, Mug, true);
+	// Gap shorter than the bone merge window
+	Harness.AtFingerContact(2.0f, Gripper.FingerA, Mug, false);
+	Harness.AtFingerContact(2.0f, Gripper.FingerB, Mug, false);
+	Harness.AtFingerContact(2.08f, Gripper.FingerA, Mug, true);
+	Harness.AtFingerContact(2.08f, Gripper.FingerB, Mug, true);
+	Harness.AtFingerContact(3.0f, Gripper.FingerA, Mug, false);
+	Harness.AtFingerContact(3.0f, Gripper.FingerB, Mug, false);
+	Harness.RunUntil(4.f);
+	Harness.Finish();
+
+	const float Dt = Harness.GetDeltaTime();
+	if (const ISLEvent* Ev = TestExpectedEvent(*this, Harness, { ESLEventKind::Grasp, Gripper.Hand, Mug,
+		1.05f, 1.05f + Dt, 3.0f, 3.0f + BoneGraspEndDelay + 2 * Dt, GraspEndDelay + Dt }))
+	{
+		TestTrue(TEXT("The gripper is the agent"), Ev->GetParticipant(ESLEventRole::Agent) == Harness.GetIndividual(Gripper.Hand));
+	}
+	TestScenarioTotals(*this, Harness, 1);
+	TestEventSnapshots(*this, Harness);
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,109 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Runtime/SLJsonTripleWriter.h"
+#include "Utils/SLUuid.h"
+
+namespace
+{
+	// Number of written events
+	constexpr int32 NumBenchmarkEvents = 100000;
+
+	// Triples written per event by WriteContactTriples
+	constexpr int32 NumTriplesPerEvent = 12;
+
+	// Write the triples of a contact state (same terms as the json triples of the symbolic logger)
+	void WriteContactTriples(FSLJsonTripleWriter& Writer, const FString& Id, const FString& Ind1, const FString& Ind2, float Start, float End)
+	{
+		const TCHAR* Type = TEXT("http://www.w3.org/1999/02/22-rdf-syntax-ns#type");
+		const TCHAR* NamedIndividual = TEXT("http://www.w3.org/2002/07/owl#NamedIndividual");
+		const TCHAR* ContactState = TEXT("http://www.ease-crc.org/ont/SOMA.owl#ContactState");
+		const TCHAR* State = TEXT("http://www.ease-crc.org/ont/SOMA.owl#State");
+		const TCHAR* Patient = TEXT("http://www.ease-crc.org/ont/SOMA.owl#Patient");
+		const TCHAR* TimeInterval = TEXT("http://www.ease-crc.org/ont/SOMA.owl#TimeInterval");
+		const TCHAR* Classifies = TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#classifies");
+
+		Writer.WriteTriple(FSLTripleTerm(ContactState, Id), Type, NamedIndividual);
+		Writer.WriteTriple(FSLTripleTerm(ContactState, Id), Type, ContactState);
+		Writer.WriteTriple(FSLTripleTerm(State, Id), Type, State);
+		Writer.WriteTriple(FSLTripleTerm(ContactState, Id), Classifies, FSLTripleTerm(State, Id));
+		Writer.WriteTriple(FSLTripleTerm(ContactState, Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#defines"), FSLTripleTerm(Patient, Id));
+		Writer.WriteTriple(FSLTripleTerm(Patient, Id), Classifies, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), Ind2, TEXT("")));
+		Writer.WriteTriple(FSLTripleTerm(Patient, Id), Classifies, FSLTripleTerm(TEXT("http://www.ease-crc.org/ont/SOMA.owl#"), Ind1, TEXT("")));
+		Writer.WriteTriple(FSLTripleTerm(TimeInterval, Id), Type, NamedIndividual);
+		Writer.WriteTriple(FSLTripleTerm(TimeInterval, Id), Type, TimeInterval);
+		Writer.WriteTriple(FSLTripleTerm(State, Id), TEXT("http://www.ontologydesignpatterns.org/ont/dul/DUL.owl#hasTimeInterval"), FSLTripleTerm(TimeInterval, Id));
+		Writer.WriteDecimalTriple(FSLTripleTerm(TimeInterval, Id), TEXT("http://www.ease-crc.org/ont/SOMA.owl#hasIntervalBegin"), Start);
+		Writer.WriteDecimalTriple(FSLTripleTerm(TimeInterval, Id), TEXT("http://www.ease-crc.org/ont/SOMA.owl#hasIntervalEnd"), End);
+	}
+}
+
+/**
+* Writes the json triples of 100k contact events to a file, checks the json array framing
+* and reports the throughput (the triples are written at the end of every episode)
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSLJsonTripleWriterBenchmark,
+	"USemLog.Runtime.JsonTripleWriter.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FSLJsonTripleWriterBenchmark::RunTest(const FString& Parameters)
+{
+	// Event ids are generated beforehand, only the writing is measured
+	TArray<FString> Ids;
+	Ids.Reserve(NumBenchmarkEvents);
+	for (int32 Idx = 0; Idx < NumBenchmarkEvents; ++Idx)
+	{
+		Ids.Add(FSLUuid::NewGuidInBase64Url());
+	}
+	const FString Ind1(TEXT("SM_Table_2"));
+	const FString Ind2(TEXT("SM_SoupSpoon_41"));
+
+	const FString FilePath = FPaths::AutomationTransientDir() / TEXT("SLJsonTripleWriterBenchmark.json");
+	const double StartSeconds = FPlatformTime::Seconds();
+	int64 NumTriples = 0;
+	{
+		FSLJsonTripleWriter Writer;
+		if (!TestTrue(TEXT("File opened"), Writer.Open(FilePath)))
+		{
+			return false;
+		}
+		for (int32 Idx = 0; Idx < NumBenchmarkEvents; ++Idx)
+		{
+			WriteContactTriples(Writer, Ids[Idx], Ind1, Ind2, Idx * 0.1f, Idx * 0.1f + 0.05f);
+		}
+		NumTriples = Writer.Num();
+		Writer.Close();
+	}
+	const double WriteSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+	const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+	TestEqual(TEXT("Number of triples"), NumTriples, (int64)NumBenchmarkEvents * NumTriplesPerEvent);
+	TestTrue(TEXT("File written"), FileSize > 0);
+
+	// Json array framing, without a trailing separator
+	TArray<uint8> Head;
+	TArray<uint8> Tail;
+	if (TUniquePtr<FArchive> Reader = TUniquePtr<FArchive>(IFileManager::Get().CreateFileReader(*FilePath)))
+	{
+		Head.SetNumUninitialized(2);
+		Tail.SetNumUninitialized(4);
+		Reader->Serialize(Head.GetData(), 2);
+		Reader->Seek(FileSize - 4);
+		Reader->Serialize(Tail.GetData(), 4);
+		TestEqual(TEXT("Array begin"), FString(2, (const ANSICHAR*)Head.GetData()), FString(TEXT("[\n")));
+		TestEqual(TEXT("Last triple and array end"), FString(4, (const ANSICHAR*)Tail.GetData()), FString(TEXT("}\n]\n")));
+	}
+	IFileManager::Get().Delete(*FilePath);
+
+	AddInfo(FString::Printf(TEXT("%d events, %lld triples, %.1f MB in %.3fs (%.1f MB/s, %.0f events/s)"),
+		NumBenchmarkEvents, NumTriples, FileSize / (1024.0 * 1024.0), WriteSeconds,
+		WriteSeconds > 0.0 ? FileSize / (1024.0 * 1024.0) / WriteSeconds : 0.0,
+		WriteSeconds > 0.0 ? NumBenchmarkEvents / WriteSeconds : 0.0));
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,171 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && SL_WITH_LIBMONGO_C
+#include "Misc/AutomationTest.h"
+#include "Mongo/SLMongoFrameDecoder.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+	// Individuals in the synthetic frame
+	constexpr int32 NumFrameIndividuals = 256;
+
+	// Number of decodings of the frame
+	constexpr int32 NumDecodeRuns = 2000;
+
+	// Append the pose fields (values as stored, no conversion)
+	void AppendPose(bson_t* doc, int32 Seed)
+	{
+		bson_t loc;
+		bson_t quat;
+		BSON_APPEND_DOCUMENT_BEGIN(doc, "loc", &loc);
+			BSON_APPEND_DOUBLE(&loc, "x", Seed * 0.1);
+			BSON_APPEND_DOUBLE(&loc, "y", Seed * 0.2);
+			BSON_APPEND_DOUBLE(&loc, "z", Seed * 0.3);
+		bson_append_document_end(doc, &loc);
+		BSON_APPEND_DOCUMENT_BEGIN(doc, "quat", &quat);
+			BSON_APPEND_DOUBLE(&quat, "x", 0.0);
+			BSON_APPEND_DOUBLE(&quat, "y", 0.0);
+			BSON_APPEND_DOUBLE(&quat, "z", FMath::Sin(Seed * 0.01));
+			BSON_APPEND_DOUBLE(&quat, "w", FMath::Cos(Seed * 0.01));
+		bson_append_document_end(doc, &quat);
+	}
+
+	// Create a frame document (timestamp, individuals array of id / loc / quat)
+	bson_t* CreateSyntheticFrameDoc(int32 NumIndividuals)
+	{
+		bson_t* doc = bson_new();
+		BSON_APPEND_DOUBLE(doc, "timestamp", 1.5);
+
+		bson_t arr;
+		char idx_str[16];
+		const char* idx_key;
+		BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &arr);
+		for (int32 Idx = 0; Idx < NumIndividuals; ++Idx)
+		{
+			bson_t entry_obj;
+			bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_DOCUMENT_BEGIN(&arr, idx_key, &entry_obj);
+			BSON_APPEND_UTF8(&entry_obj, "id", TCHAR_TO_UTF8(*FString::Printf(TEXT("Individual%03d"), Idx)));
+			AppendPose(&entry_obj, Idx);
+			bson_append_document_end(&arr, &entry_obj);
+		}
+		bson_append_array_end(doc, &arr);
+		return doc;
+	}
+
+	// Read the value at the dotted path, searched from the beginning of the document (previous decoding)
+	double FindDouble(const bson_t* doc, const char* Path)
+	{
+		bson_iter_t iter;
+		bson_iter_t child;
+		if (bson_iter_init(&iter, doc) && bson_iter_find_descendant(&iter, Path, &child))
+		{
+			return FSLMongoFrameDecoder::GetDouble(&child);
+		}
+		return 0.0;
+	}
+
+	// Decode the frame with one search per field (the previous decoding, used as baseline)
+	int32 DecodeFramePerField(const bson_t* doc, double& OutTs, TArray<FTransform>& OutPoses)
+	{
+		OutTs = FindDouble(doc, "timestamp");
+		bson_iter_t iter;
+		bson_iter_t arr_iter;
+		if (!bson_iter_init(&iter, doc) || !bson_iter_find(&iter, "individuals") || !bson_iter_recurse(&iter, &arr_iter))
+		{
+			return 0;
+		}
+		int32 Num = 0;
+		while (bson_iter_next(&arr_iter))
+		{
+			uint32_t len = 0;
+			const uint8_t* data = nullptr;
+			bson_iter_document(&arr_iter, &len, &data);
+			bson_t sub_doc;
+			if (!data || !bson_init_static(&sub_doc, data, len))
+			{
+				continue;
+			}
+
+			bson_iter_t id_iter;
+			if (!bson_iter_init(&id_iter, &sub_doc) || !bson_iter_find(&id_iter, "id"))
+			{
+				continue;
+			}
+			const FString Id(UTF8_TO_TCHAR(bson_iter_utf8(&id_iter, nullptr)));
+
+			const FVector Loc(FindDouble(&sub_doc, "loc.x"), FindDouble(&sub_doc, "loc.y"), FindDouble(&sub_doc, "loc.z"));
+			FQuat Quat(FindDouble(&sub_doc, "quat.x"), FindDouble(&sub_doc, "quat.y"), FindDouble(&sub_doc, "quat.z"), FindDouble(&sub_doc, "quat.w"));
+			Quat.Normalize();
+			OutPoses[Num++] = FTransform(Quat, Loc);
+		}
+		return Num;
+	}
+}
+
+/**
+* Decodes a synthetic frame document many times with the single-pass decoder and with one search per field,
+* reports the timings (the decoding dominates the client side of the episode loads)
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSLMongoFrameDecoderBenchmark,
+	"USemLog.Mongo.FrameDecoder.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FSLMongoFrameDecoderBenchmark::RunTest(const FString& Parameters)
+{
+	bson_t* doc = CreateSyntheticFrameDoc(NumFrameIndividuals);
+	TArray<FTransform> Poses;
+	Poses.SetNum(NumFrameIndividuals);
+	TArray<FTransform> BaselinePoses;
+	BaselinePoses.SetNum(NumFrameIndividuals);
+
+	// Single pass
+	double Ts = 0.0;
+	int32 NumDecoded = 0;
+	double StartSeconds = FPlatformTime::Seconds();
+	for (int32 Run = 0; Run < NumDecodeRuns; ++Run)
+	{
+		int32 Idx = 0;
+		NumDecoded = FSLMongoFrameDecoder::DecodeFrame(doc, "individuals", Ts,
+			[&Poses, &Idx](FString&& Id, const FTransform& Pose) { Poses[Idx++] = Pose; });
+	}
+	const double SinglePassSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+	// One search per field
+	double BaselineTs = 0.0;
+	int32 NumBaselineDecoded = 0;
+	StartSeconds = FPlatformTime::Seconds();
+	for (int32 Run = 0; Run < NumDecodeRuns; ++Run)
+	{
+		NumBaselineDecoded = DecodeFramePerField(doc, BaselineTs, BaselinePoses);
+	}
+	const double PerFieldSeconds = FPlatformTime::Seconds() - StartSeconds;
+	bson_destroy(doc);
+
+	TestEqual(TEXT("Decoded individuals"), NumDecoded, NumFrameIndividuals);
+	TestEqual(TEXT("Baseline decoded individuals"), NumBaselineDecoded, NumFrameIndividuals);
+	TestEqual(TEXT("Timestamp"), Ts, BaselineTs);
+#if !SL_WITH_ROS_CONVERSIONS
+	// The baseline does not convert the poses
+	for (int32 Idx = 0; Idx < NumFrameIndividuals; ++Idx)
+	{
+		if (!Poses[Idx].Equals(BaselinePoses[Idx], KINDA_SMALL_NUMBER))
+		{
+			AddError(FString::Printf(TEXT("Pose %d differs from the baseline: %s vs %s"),
+				Idx, *Poses[Idx].ToString(), *BaselinePoses[Idx].ToString()));
+			break;
+		}
+	}
+#endif // !SL_WITH_ROS_CONVERSIONS
+
+	const double NumIndividuals = double(NumDecodeRuns) * NumFrameIndividuals;
+	AddInfo(FString::Printf(TEXT("Single pass: %.3fms total, %.1fns per individual"),
+		SinglePassSeconds * 1000.0, SinglePassSeconds * 1e9 / NumIndividuals));
+	AddInfo(FString::Printf(TEXT("Per field search: %.3fms total, %.1fns per individual (x%.2f)"),
+		PerFieldSeconds * 1000.0, PerFieldSeconds * 1e9 / NumIndividuals,
+		SinglePassSeconds > 0.0 ? PerFieldSeconds / SinglePassSeconds : 0.0));
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS && SL_WITH_LIBMONGO_C
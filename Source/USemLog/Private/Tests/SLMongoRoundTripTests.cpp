@@ -0,0 +1,530 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Tests/SLEventScenarioHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && SL_WITH_LIBMONGO_C
+#include "Engine/World.h"
+#include "Engine/StaticMeshActor.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/Guid.h"
+#include "Individuals/SLIndividualManager.h"
+#include "Runtime/SLWorldStateDBHandler.h"
+#include "Mongo/SLMongoQueryDBHandler.h"
+#include "Mongo/SLMongoQueryManager.h"
+
+// UUtils
+#if SL_WITH_ROS_CONVERSIONS
+#include "Conversions.h"
+#endif // SL_WITH_ROS_CONVERSIONS
+
+namespace
+{
+	// Local test server
+	const FString ServerIp = TEXT("127.0.0.1");
+	constexpr uint16 ServerPort = 27017;
+
+	// Tolerance of the round-tripped locations (cm, the ros conversion goes through meters)
+	constexpr float LocTolerance = 0.01f;
+
+	// Check (with a short server selection timeout) if the local server answers
+	bool IsServerReachable()
+	{
+		mongoc_init();
+		bson_error_t error;
+		const FString Uri = FString::Printf(TEXT("mongodb://%s:%d/?serverSelectionTimeoutMS=500"), *ServerIp, ServerPort);
+		mongoc_client_t* client = mongoc_client_new(TCHAR_TO_UTF8(*Uri));
+		if (!client)
+		{
+			return false;
+		}
+		bson_t* ping_cmd = BCON_NEW("ping", BCON_INT32(1));
+		const bool bReachable = mongoc_client_command_simple(client, "admin", ping_cmd, NULL, NULL, &error);
+		bson_destroy(ping_cmd);
+		mongoc_client_destroy(client);
+		return bReachable;
+	}
+
+	// Run the function with a client of the local server
+	bool WithClient(TFunctionRef<bool(mongoc_client_t* client)> Fn)
+	{
+		const FString Uri = FString::Printf(TEXT("mongodb://%s:%d"), *ServerIp, ServerPort);
+		mongoc_client_t* client = mongoc_client_new(TCHAR_TO_UTF8(*Uri));
+		if (!client)
+		{
+			return false;
+		}
+		const bool bRetVal = Fn(client);
+		mongoc_client_destroy(client);
+		return bRetVal;
+	}
+
+	// Insert the documents into the collection (takes ownership of the documents)
+	bool InsertDocs(const FString& DBName, const FString& CollName, TArray<bson_t*>& Docs)
+	{
+		const bool bInserted = WithClient([&](mongoc_client_t* client)
+		{
+			bson_error_t error;
+			mongoc_collection_t* collection = mongoc_client_get_collection(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*CollName));
+			const bool bRetVal = mongoc_collection_insert_many(collection, const_cast<const bson_t**>(Docs.GetData()), Docs.Num(), NULL, NULL, &error);
+			if (!bRetVal)
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"), *FString(__FUNCTION__), __LINE__, *FString(error.message));
+			}
+			mongoc_collection_destroy(collection);
+			return bRetVal;
+		});
+		for (bson_t* doc : Docs)
+		{
+			bson_destroy(doc);
+		}
+		Docs.Empty();
+		return bInserted;
+	}
+
+	// Remove the test database
+	void DropDatabase(const FString& DBName)
+	{
+		WithClient([&](mongoc_client_t* client)
+		{
+			mongoc_database_t* database = mongoc_client_get_database(client, TCHAR_TO_UTF8(*DBName));
+			const bool bRetVal = mongoc_database_drop_with_opts(database, NULL, NULL);
+			mongoc_database_destroy(database);
+			return bRetVal;
+		});
+	}
+
+	// Unique database name of a test run
+	FString CreateTestTaskId(const TCHAR* Name)
+	{
+		return FString::Printf(TEXT("SLTest_%s_%s"), Name, *FGuid::NewGuid().ToString(EGuidFormats::Digits));
+	}
+
+	// Pose along the x axis
+	FTransform MakePose(float X)
+	{
+		return FTransform(FVector(X, 0.f, 0.f));
+	}
+
+	// Append the pose as loc and quat (frames layout)
+	void AppendFramesPose(bson_t* doc, FTransform Pose)
+	{
+#if SL_WITH_ROS_CONVERSIONS
+		FConversions::UToROS(Pose);
+#endif // SL_WITH_ROS_CONVERSIONS
+		bson_t loc;
+		bson_t quat;
+		BSON_APPEND_DOCUMENT_BEGIN(doc, "loc", &loc);
+			BSON_APPEND_DOUBLE(&loc, "x", Pose.GetLocation().X);
+			BSON_APPEND_DOUBLE(&loc, "y", Pose.GetLocation().Y);
+			BSON_APPEND_DOUBLE(&loc, "z", Pose.GetLocation().Z);
+		bson_append_document_end(doc, &loc);
+		BSON_APPEND_DOCUMENT_BEGIN(doc, "quat", &quat);
+			BSON_APPEND_DOUBLE(&quat, "x", Pose.GetRotation().X);
+			BSON_APPEND_DOUBLE(&quat, "y", Pose.GetRotation().Y);
+			BSON_APPEND_DOUBLE(&quat, "z", Pose.GetRotation().Z);
+			BSON_APPEND_DOUBLE(&quat, "w", Pose.GetRotation().W);
+		bson_append_document_end(doc, &quat);
+	}
+
+	// Individual entry of a frames layout document
+	struct FFramesEntry
+	{
+		FString Id;
+		float X;
+		// Bone index to x (skeletal entries only)
+		TMap<int32, float> Bones;
+	};
+
+	// Append the entries as array (frames layout)
+	void AppendFramesEntries(bson_t* doc, const char* Key, const TArray<FFramesEntry>& Entries)
+	{
+		bson_t arr;
+		char idx_str[16];
+		const char *idx_key;
+		uint32_t arr_idx = 0;
+		BSON_APPEND_ARRAY_BEGIN(doc, Key, &arr);
+		for (const auto& Entry : Entries)
+		{
+			bson_t entry_obj;
+			bson_uint32_to_string(arr_idx++, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_DOCUMENT_BEGIN(&arr, idx_key, &entry_obj);
+			BSON_APPEND_UTF8(&entry_obj, "id", TCHAR_TO_UTF8(*Entry.Id));
+			AppendFramesPose(&entry_obj, MakePose(Entry.X));
+			if (Entry.Bones.Num() > 0)
+			{
+				bson_t bones_arr;
+				uint32_t bone_arr_idx = 0;
+				BSON_APPEND_ARRAY_BEGIN(&entry_obj, "bones", &bones_arr);
+				for (const auto& Pair : Entry.Bones)
+				{
+					bson_t bone_obj;
+					bson_uint32_to_string(bone_arr_idx++, &idx_key, idx_str, sizeof idx_str);
+					BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &bone_obj);
+					BSON_APPEND_INT32(&bone_obj, "idx", Pair.Key);
+					AppendFramesPose(&bone_obj, MakePose(Pair.Value));
+					bson_append_document_end(&bones_arr, &bone_obj);
+				}
+				bson_append_array_end(&entry_obj, &bones_arr);
+			}
+			bson_append_document_end(&arr, &entry_obj);
+		}
+		bson_append_array_end(doc, &arr);
+	}
+
+	// Create a frames layout document
+	bson_t* CreateFramesDoc(double Ts, const TArray<FFramesEntry>& Individuals, const TArray<FFramesEntry>& SkelIndividuals, bool bKeyframe = false)
+	{
+		bson_t* doc = bson_new();
+		BSON_APPEND_DOUBLE(doc, "timestamp", Ts);
+		if (bKeyframe)
+		{
+			BSON_APPEND_BOOL(doc, "keyframe", true);
+		}
+		if (Individuals.Num() > 0)
+		{
+			AppendFramesEntries(doc, "individuals", Individuals);
+		}
+		if (SkelIndividuals.Num() > 0)
+		{
+			AppendFramesEntries(doc, "skel_individuals", SkelIndividuals);
+		}
+		return doc;
+	}
+
+	// Check the x location of the pose
+	void TestX(FAutomationTestBase& Test, const FString& What, const FTransform& Pose, float ExpectedX)
+	{
+		Test.TestEqual(What, Pose.GetLocation().X, ExpectedX, LocTolerance);
+	}
+
+	// Check a skeletal pose (actor and bones)
+	void TestSkeletalPose(FAutomationTestBase& Test, const FString& What, const TPair<FTransform, TMap<int32, FTransform>>& Pose,
+		float ExpectedX, const TMap<int32, float>& ExpectedBonesX)
+	{
+		TestX(Test, What + TEXT(" actor"), Pose.Key, ExpectedX);
+		if (Test.TestEqual(What + TEXT(" number of bones"), Pose.Value.Num(), ExpectedBonesX.Num()))
+		{
+			for (const auto& Pair : ExpectedBonesX)
+			{
+				if (const FTransform* BonePose = Pose.Value.Find(Pair.Key))
+				{
+					TestX(Test, FString::Printf(TEXT("%s bone %d"), *What, Pair.Key), *BonePose, Pair.Value);
+				}
+				else
+				{
+					Test.AddError(FString::Printf(TEXT("%s bone %d is missing"), *What, Pair.Key));
+				}
+			}
+		}
+	}
+
+	// Check the skeletal queries against the skeletal episode written by the tests:
+	// Hand at x=0,100,200 (t=0,0.5,1) with the bones 0,1 at +10,+20, OtherHand at x=1000 (t=0) with the bones at +30,+40
+	void TestSkeletalQueries(FAutomationTestBase& Test, const FSLMongoQueryDBHandler& Handler)
+	{
+		TestSkeletalPose(Test, TEXT("Hand at 0.75"), Handler.GetSkeletalIndividualPoseAt(TEXT("Hand"), 0.75f), 100.f, { {0, 110.f}, {1, 120.f} });
+		TestSkeletalPose(Test, TEXT("OtherHand at 0.75"), Handler.GetSkeletalIndividualPoseAt(TEXT("OtherHand"), 0.75f), 1000.f, { {0, 1030.f}, {1, 1040.f} });
+
+		const auto Trajectory = Handler.GetSkeletalIndividualTrajectory(TEXT("Hand"), 0.f, 1.f);
+		if (Test.TestEqual(TEXT("Hand trajectory samples"), Trajectory.Num(), 3))
+		{
+			for (int32 Idx = 0; Idx < 3; ++Idx)
+			{
+				const float X = 100.f * Idx;
+				TestSkeletalPose(Test, FString::Printf(TEXT("Hand trajectory sample %d"), Idx), Trajectory[Idx], X, { {0, X + 10.f}, {1, X + 20.f} });
+			}
+		}
+
+		const auto Tracks = Handler.GetSkeletalIndividualsTrajectories({ TEXT("Hand"), TEXT("OtherHand") }, 0.f, 1.f);
+		const FSLMongoSkeletalPoseTrack* HandTrack = Tracks.Find(TEXT("Hand"));
+		const FSLMongoSkeletalPoseTrack* OtherHandTrack = Tracks.Find(TEXT("OtherHand"));
+		if (Test.TestTrue(TEXT("Batched skeletal tracks found"), HandTrack && OtherHandTrack))
+		{
+			Test.TestEqual(TEXT("Batched Hand samples"), HandTrack->Num(), 3);
+			Test.TestEqual(TEXT("Batched Hand bone tracks"), HandTrack->BoneTracks.Num(), 2);
+			if (const FSLMongoPoseTrack* BoneTrack = HandTrack->BoneTracks.Find(1))
+			{
+				if (Test.TestEqual(TEXT("Batched Hand bone 1 samples"), BoneTrack->Num(), 3))
+				{
+					Test.TestEqual(TEXT("Batched Hand bone 1 last x"), BoneTrack->Locations[2].X, 220.f, LocTolerance);
+				}
+			}
+			Test.TestEqual(TEXT("Batched OtherHand samples"), OtherHandTrack->Num(), 1);
+		}
+	}
+
+	// Check the rigid queries against the rigid episode written by the tests:
+	// Cup at x=0,10,20,30 (t=0,0.5,1,1.5), Plate at x=500 (t=0), keyframes at t=0 and t=1
+	void TestRigidQueries(FAutomationTestBase& Test, const FSLMongoQueryDBHandler& Handler)
+	{
+		TestX(Test, TEXT("Cup at 0.75"), Handler.GetIndividualPoseAt(TEXT("Cup"), 0.75f), 10.f);
+		TestX(Test, TEXT("Cup at 1.5"), Handler.GetIndividualPoseAt(TEXT("Cup"), 1.5f), 30.f);
+		TestX(Test, TEXT("Plate at 0.75"), Handler.GetIndividualPoseAt(TEXT("Plate"), 0.75f), 500.f);
+
+		const TArray<FTransform> Trajectory = Handler.GetIndividualTrajectory(TEXT("Cup"), 0.f, 1.5f);
+		if (Test.TestEqual(TEXT("Cup trajectory samples"), Trajectory.Num(), 4))
+		{
+			for (int32 Idx = 0; Idx < 4; ++Idx)
+			{
+				TestX(Test, FString::Printf(TEXT("Cup trajectory sample %d"), Idx), Trajectory[Idx], 10.f * Idx);
+			}
+		}
+		Test.TestEqual(TEXT("Cup trajectory samples in [0.25, 1.0]"), Handler.GetIndividualTrajectory(TEXT("Cup"), 0.25f, 1.f).Num(), 2);
+
+		const auto Tracks = Handler.GetIndividualsTrajectories({ TEXT("Cup"), TEXT("Plate") }, 0.f, 1.5f);
+		const FSLMongoPoseTrack* CupTrack = Tracks.Find(TEXT("Cup"));
+		const FSLMongoPoseTrack* PlateTrack = Tracks.Find(TEXT("Plate"));
+		if (Test.TestTrue(TEXT("Batched tracks found"), CupTrack && PlateTrack))
+		{
+			if (Test.TestEqual(TEXT("Batched Cup samples"), CupTrack->Num(), 4))
+			{
+				Test.TestEqual(TEXT("Batched Cup sample 2 time"), CupTrack->Timestamps[2], 1.f, KINDA_SMALL_NUMBER);
+				Test.TestEqual(TEXT("Batched Cup sample 2 x"), CupTrack->Locations[2].X, 20.f, LocTolerance);
+			}
+			Test.TestEqual(TEXT("Batched Plate samples"), PlateTrack->Num(), 1);
+		}
+
+		// Rebuilt from the keyframe at t=1 and the following sparse documents
+		const TMap<FString, FTransform> Frame = Handler.GetFrameData(1.25f);
+		if (Test.TestTrue(TEXT("Frame at 1.25 has Cup and Plate"), Frame.Contains(TEXT("Cup")) && Frame.Contains(TEXT("Plate"))))
+		{
+			TestX(Test, TEXT("Frame at 1.25 Cup"), Frame[TEXT("Cup")], 20.f);
+			TestX(Test, TEXT("Frame at 1.25 Plate"), Frame[TEXT("Plate")], 500.f);
+		}
+		const TMap<FString, FTransform> LastFrame = Handler.GetFrameData(1.5f);
+		if (Test.TestTrue(TEXT("Frame at 1.5 has Cup"), LastFrame.Contains(TEXT("Cup"))))
+		{
+			TestX(Test, TEXT("Frame at 1.5 Cup"), LastFrame[TEXT("Cup")], 30.f);
+		}
+
+		// The keyframes are not part of the episode frames
+		const auto EpisodeData = Handler.GetEpisodeData();
+		if (Test.TestEqual(TEXT("Episode frames"), EpisodeData.Num(), 4))
+		{
+			Test.TestEqual(TEXT("Episode frame 1 time"), EpisodeData[1].Key, 0.5f, KINDA_SMALL_NUMBER);
+			if (const FTransform* CupPose = EpisodeData[1].Value.Find(TEXT("Cup")))
+			{
+				TestX(Test, TEXT("Episode frame 1 Cup"), *CupPose, 10.f);
+			}
+			else
+			{
+				Test.AddError(TEXT("Episode frame 1 has no Cup"));
+			}
+		}
+	}
+
+	// Connect the handler to the episode
+	bool ConnectHandler(FAutomationTestBase& Test, FSLMongoQueryDBHandler& Handler, const FString& TaskId, const FString& EpisodeId)
+	{
+		return Test.TestTrue(TEXT("Query handler connected"), Handler.Connect(ServerIp, ServerPort)
+			&& Handler.SetDatabase(TaskId) && Handler.SetCollection(EpisodeId));
+	}
+}
+
+/**
+* Round trip tests base, skips (with info) if no local server is reachable
+*/
+class FSLMongoRoundTripTestBase : public FSLEventScenarioTestBase
+{
+public:
+	FSLMongoRoundTripTestBase(const FString& InName, const bool bInComplexTask)
+		: FSLEventScenarioTestBase(InName, bInComplexTask) {};
+
+	// Check the server, adds the skip info if not reachable
+	bool CanRun()
+	{
+		if (!IsServerReachable())
+		{
+			AddInfo(FString::Printf(TEXT("Skipped, no mongo server reachable at %s:%d"), *ServerIp, ServerPort));
+			return false;
+		}
+		return true;
+	}
+};
+
+/**
+* Cup moved by the world state writer (sparse with keyframes, tf layout), Plate at rest;
+* the episode is read back with the query handler and the query manager
+*/
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FSLMongoRoundTripTfTest, FSLMongoRoundTripTestBase,
+	"USemLog.Mongo.RoundTrip.Tf", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FSLMongoRoundTripTfTest::RunTest(const FString& Parameters)
+{
+	if (!CanRun())
+	{
+		return true;
+	}
+
+	FSLEventScenarioHarness Harness;
+	if (!TestTrue(TEXT("World created"), Harness.Init()))
+	{
+		return false;
+	}
+	AStaticMeshActor* Cup = Harness.SpawnItem(TEXT("Cup"), FVector(0.f, 0.f, 0.f), false);
+	AStaticMeshActor* Plate = Harness.SpawnItem(TEXT("Plate"), FVector(500.f, 0.f, 0.f), false);
+	ASLIndividualManager* IndividualManager = ASLIndividualManager::GetExistingOrSpawnNew(Harness.GetWorld());
+	if (!TestTrue(TEXT("Items spawned"), Cup && Plate) || !TestTrue(TEXT("Individuals loaded"), IndividualManager && IndividualManager->Load(false)))
+	{
+		return false;
+	}
+
+	const FString TaskId = CreateTestTaskId(TEXT("Tf"));
+	const FString EpisodeId = TEXT("Episode");
+
+	FSLWorldStateLoggerParams LoggerParams;
+	LoggerParams.PoseTolerance = 0.5f;
+	LoggerParams.bWriteSparse = true;
+	LoggerParams.KeyframeInterval = 1.f;
+	LoggerParams.bIncludeMetadata = false;
+	FSLLoggerLocationParams LocationParams;
+	LocationParams.TaskId = TaskId;
+	LocationParams.EpisodeId = EpisodeId;
+	LocationParams.bOverwrite = true;
+	FSLLoggerDBServerParams ServerParams;
+	ServerParams.Ip = ServerIp;
+	ServerParams.Port = ServerPort;
+
+	FSLWorldStateDBHandler Writer;
+	if (!TestTrue(TEXT("Writer init"), Writer.Init(IndividualManager, LoggerParams, LocationParams, ServerParams)))
+	{
+		DropDatabase(TaskId);
+		return false;
+	}
+
+	// The async job reads the poses, move the Cup only after the previous job is done
+	const auto WaitForWrite = [&Writer]()
+	{
+		while (!Writer.IsWriteDone())
+		{
+			FPlatformProcess::Sleep(0.005f);
+		}
+	};
+	Writer.FirstWrite(0.f);
+	for (int32 Step = 1; Step <= 3; ++Step)
+	{
+		WaitForWrite();
+		Cup->SetActorLocation(FVector(10.f * Step, 0.f, 0.f));
+		Writer.Write(0.5f * Step);
+	}
+	WaitForWrite();
+	Writer.Finish();
+
+	FSLMongoQueryDBHandler Handler;
+	if (ConnectHandler(*this, Handler, TaskId, EpisodeId))
+	{
+		TestTrue(TEXT("Episode uses the tf layout"), Handler.GetSchema().Layout == ESLMongoSchemaLayout::Tf);
+		TestRigidQueries(*this, Handler);
+	}
+	Handler.Disconnect();
+
+	// Same answers through the query manager (pose index and query cache)
+	ASLMongoQueryManager* QueryManager = Harness.GetWorld()->SpawnActor<ASLMongoQueryManager>();
+	if (TestTrue(TEXT("Query manager connected"), QueryManager && QueryManager->Connect(ServerIp, ServerPort)))
+	{
+		TestX(*this, TEXT("Manager Cup at 0.75"), QueryManager->GetIndividualPoseAt(TaskId, EpisodeId, TEXT("Cup"), 0.75f), 10.f);
+		TestEqual(TEXT("Manager Cup trajectory samples"), QueryManager->GetIndividualTrajectory(TaskId, EpisodeId, TEXT("Cup"), 0.f, 1.5f).Num(), 4);
+		const TMap<FString, FTransform> Frame = QueryManager->GetFrameData(TaskId, EpisodeId, 1.25f);
+		if (TestTrue(TEXT("Manager frame at 1.25 has Cup"), Frame.Contains(TEXT("Cup"))))
+		{
+			TestX(*this, TEXT("Manager frame at 1.25 Cup"), Frame[TEXT("Cup")], 20.f);
+		}
+		QueryManager->Disconnect();
+	}
+
+	DropDatabase(TaskId);
+	return true;
+}
+
+/**
+* Skeletal episode in the tf layout (skeleton and bone documents built with the writer's schema),
+* two skeletal individuals with the same bone indexes, the bones are joined by skeleton and time
+*/
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FSLMongoRoundTripTfSkeletalTest, FSLMongoRoundTripTestBase,
+	"USemLog.Mongo.RoundTrip.TfSkeletal", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FSLMongoRoundTripTfSkeletalTest::RunTest(const FString& Parameters)
+{
+	if (!CanRun())
+	{
+		return true;
+	}
+
+	const FString TaskId = CreateTestTaskId(TEXT("TfSkeletal"));
+	const FString EpisodeId = TEXT("Episode");
+	const FSLMongoSchema Schema = FSLMongoSchema::Tf((FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalMilliseconds());
+
+	TArray<bson_t*> MetaDocs{ Schema.CreateMetadataDoc(EpisodeId) };
+	TestTrue(TEXT("Schema metadata written"), InsertDocs(TaskId, TaskId + TEXT(".meta"), MetaDocs));
+
+	int32 Seq = 0;
+	TArray<bson_t*> Docs;
+	const auto AddSkeletal = [&](const FString& SkelId, double Ts, float X, float BoneOffset)
+	{
+		Docs.Add(Schema.CreateTfDoc(Seq++, Ts, SkelId, MakePose(X)));
+		for (int32 BoneIdx = 0; BoneIdx < 2; ++BoneIdx)
+		{
+			bson_t* doc = Schema.CreateTfDoc(Seq++, Ts, FString::Printf(TEXT("%s/Bone%d"), *SkelId, BoneIdx), MakePose(X + BoneOffset + 10.f * BoneIdx));
+			Schema.AppendTfBone(doc, SkelId, BoneIdx);
+			Docs.Add(doc);
+		}
+	};
+	AddSkeletal(TEXT("OtherHand"), 0.0, 1000.f, 30.f);
+	for (int32 Step = 0; Step < 3; ++Step)
+	{
+		AddSkeletal(TEXT("Hand"), 0.5 * Step, 100.f * Step, 10.f);
+	}
+	TestTrue(TEXT("Skeletal documents written"), InsertDocs(TaskId, EpisodeId, Docs));
+
+	FSLMongoQueryDBHandler Handler;
+	if (ConnectHandler(*this, Handler, TaskId, EpisodeId))
+	{
+		TestTrue(TEXT("Episode uses the tf layout"), Handler.GetSchema().Layout == ESLMongoSchemaLayout::Tf);
+		TestSkeletalQueries(*this, Handler);
+		// The skeletal individual is also a rigid transform
+		TestX(*this, TEXT("Hand rigid at 0.75"), Handler.GetIndividualPoseAt(TEXT("Hand"), 0.75f), 100.f);
+	}
+	Handler.Disconnect();
+
+	DropDatabase(TaskId);
+	return true;
+}
+
+/**
+* Episode in the legacy frames layout (no stored schema), same data as the tf tests:
+* rigid and skeletal frames and keyframes at t=0 and t=1
+*/
+IMPLEMENT_CUSTOM_SIMPLE_AUTOMATION_TEST(FSLMongoRoundTripFramesTest, FSLMongoRoundTripTestBase,
+	"USemLog.Mongo.RoundTrip.Frames", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FSLMongoRoundTripFramesTest::RunTest(const FString& Parameters)
+{
+	if (!CanRun())
+	{
+		return true;
+	}
+
+	const FString TaskId = CreateTestTaskId(TEXT("Frames"));
+	const FString EpisodeId = TEXT("Episode");
+
+	TArray<bson_t*> Docs;
+	Docs.Add(CreateFramesDoc(0.0, { {TEXT("Cup"), 0.f}, {TEXT("Plate"), 500.f} }, {}, true));
+	Docs.Add(CreateFramesDoc(0.0, { {TEXT("Cup"), 0.f}, {TEXT("Plate"), 500.f} },
+		{ {TEXT("Hand"), 0.f, { {0, 10.f}, {1, 20.f} }}, {TEXT("OtherHand"), 1000.f, { {0, 1030.f}, {1, 1040.f} }} }));
+	Docs.Add(CreateFramesDoc(0.5, { {TEXT("Cup"), 10.f} }, { {TEXT("Hand"), 100.f, { {0, 110.f}, {1, 120.f} }} }));
+	Docs.Add(CreateFramesDoc(1.0, { {TEXT("Cup"), 20.f}, {TEXT("Plate"), 500.f} }, {}, true));
+	Docs.Add(CreateFramesDoc(1.0, { {TEXT("Cup"), 20.f} }, { {TEXT("Hand"), 200.f, { {0, 210.f}, {1, 220.f} }} }));
+	Docs.Add(CreateFramesDoc(1.5, { {TEXT("Cup"), 30.f} }, {}));
+	TestTrue(TEXT("Frames documents written"), InsertDocs(TaskId, EpisodeId, Docs));
+
+	FSLMongoQueryDBHandler Handler;
+	if (ConnectHandler(*this, Handler, TaskId, EpisodeId))
+	{
+		TestTrue(TEXT("Episode uses the frames layout"), Handler.GetSchema().Layout == ESLMongoSchemaLayout::Frames);
+		TestRigidQueries(*this, Handler);
+		TestSkeletalQueries(*this, Handler);
+	}
+	Handler.Disconnect();
+
+	DropDatabase(TaskId);
+	return true;
+}
+#endif // WITH_DEV_AUTOMATION_TESTS && SL_WITH_LIBMONGO_C
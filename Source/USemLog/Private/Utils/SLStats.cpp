@@ -0,0 +1,40 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Utils/SLStats.h"
+
+/* Monitors */
+DEFINE_STAT(STAT_SL_ContactMonitorOverlap);
+DEFINE_STAT(STAT_SL_ContactMonitorDelayedEnd);
+DEFINE_STAT(STAT_SL_ContactMonitorSupportedBy);
+DEFINE_STAT(STAT_SL_BoneContactMonitorOverlap);
+DEFINE_STAT(STAT_SL_BoneContactMonitorDelayedEnd);
+DEFINE_STAT(STAT_SL_ManipulatorMonitorContact);
+DEFINE_STAT(STAT_SL_ManipulatorMonitorGrasp);
+DEFINE_STAT(STAT_SL_ManipulatorMonitorDelayedEnd);
+DEFINE_STAT(STAT_SL_ReachMonitorUpdate);
+DEFINE_STAT(STAT_SL_ReachMonitorOverlap);
+DEFINE_STAT(STAT_SL_ReachMonitorCallbacks);
+DEFINE_STAT(STAT_SL_PickAndPlaceMonitorUpdate);
+DEFINE_STAT(STAT_SL_PickAndPlaceMonitorCallbacks);
+DEFINE_STAT(STAT_SL_ContainerMonitorCallbacks);
+
+/* Event handlers */
+DEFINE_STAT(STAT_SL_ContactEventHandler);
+DEFINE_STAT(STAT_SL_ManipulatorContactEventHandler);
+DEFINE_STAT(STAT_SL_GraspEventHandler);
+DEFINE_STAT(STAT_SL_FixationGraspEventHandler);
+DEFINE_STAT(STAT_SL_ReachAndPreGraspEventHandler);
+DEFINE_STAT(STAT_SL_PickAndPlaceEventsHandler);
+DEFINE_STAT(STAT_SL_ContainerEventHandler);
+DEFINE_STAT(STAT_SL_SlicingEventHandler);
+DEFINE_STAT(STAT_SL_SymbolicLoggerEventFinished);
+
+/* Counters */
+DEFINE_STAT(STAT_SL_NumOverlapCallbacks);
+DEFINE_STAT(STAT_SL_NumTimersArmed);
+DEFINE_STAT(STAT_SL_NumReachCandidatesUpdated);
+
+/* Accumulators */
+DEFINE_STAT(STAT_SL_NumReachCandidates);
+DEFINE_STAT(STAT_SL_NumEventsEmitted);
@@ -0,0 +1,102 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Utils/SLUtf8FileWriter.h"
+#include "HAL/FileManager.h"
+#include "Serialization/Archive.h"
+
+// Ctor
+FSLUtf8FileWriter::FSLUtf8FileWriter(int32 InBufferSize)
+{
+	Ar = nullptr;
+	BufferNum = 0;
+	Buffer.SetNumUninitialized(FMath::Max(InBufferSize, 256));
+}
+
+// Dtor, closes the file
+FSLUtf8FileWriter::~FSLUtf8FileWriter()
+{
+	Close();
+}
+
+// Open the file for writing
+bool FSLUtf8FileWriter::Open(const FString& FilePath)
+{
+	if (Ar)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d A file is already open.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	Ar = IFileManager::Get().CreateFileWriter(*FilePath);
+	if (Ar == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+	BufferNum = 0;
+	return true;
+}
+
+// Flush the buffer and close the file, returns false if any write failed
+bool FSLUtf8FileWriter::Close()
+{
+	if (!Ar)
+	{
+		return false;
+	}
+	Flush();
+	const bool bSuccess = !Ar->IsError();
+	Ar->Close();
+	delete Ar;
+	Ar = nullptr;
+	return bSuccess;
+}
+
+// Append a range of characters as utf8
+void FSLUtf8FileWriter::Append(const TCHAR* Str, int32 Len)
+{
+	if (Len > 0)
+	{
+		FTCHARToUTF8 Converter(Str, Len);
+		AppendBytes((const ANSICHAR*)Converter.Get(), Converter.Length());
+	}
+}
+
+// Append raw ascii
+void FSLUtf8FileWriter::AppendRaw(const ANSICHAR* Str)
+{
+	AppendBytes(Str, FCStringAnsi::Strlen(Str));
+}
+
+// Append raw utf8 bytes
+void FSLUtf8FileWriter::AppendBytes(const ANSICHAR* Bytes, int32 Num)
+{
+	if (Num <= 0 || !Ar)
+	{
+		return;
+	}
+
+	if (BufferNum + Num > Buffer.Num())
+	{
+		Flush();
+		if (Num > Buffer.Num())
+		{
+			// Larger than the buffer, write directly
+			Ar->Serialize((void*)Bytes, Num);
+			return;
+		}
+	}
+	FMemory::Memcpy(Buffer.GetData() + BufferNum, Bytes, Num);
+	BufferNum += Num;
+}
+
+// Write the buffer to the archive
+void FSLUtf8FileWriter::Flush()
+{
+	if (Ar && BufferNum > 0)
+	{
+		Ar->Serialize(Buffer.GetData(), BufferNum);
+	}
+	BufferNum = 0;
+}
@@ -0,0 +1,72 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "SLEventLogConvertCommandlet.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+// SL
+#include "Events/SLEventLogConverter.h"
+
+// Ctor
+USLEventLogConvertCommandlet::USLEventLogConvertCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+// Convert the logs given as a file or directory
+int32 USLEventLogConvertCommandlet::Main(const FString& Params)
+{
+	FString InputPath;
+	if (!FParse::Value(*Params, TEXT("Input="), InputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Usage: -run=SLEventLogConvert -Input=<file|dir> [-Output=<dir>] [-Formats=owl,nt,json,timeline|all] [-Overwrite]"),
+			*FString(__FUNCTION__), __LINE__);
+		return 1;
+	}
+
+	FString OutputPath;
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString FormatsStr = TEXT("all");
+	FParse::Value(*Params, TEXT("Formats="), FormatsStr);
+	const ESLEventLogOutput Outputs = FSLEventLogConverter::ParseOutputs(FormatsStr);
+	if (Outputs == ESLEventLogOutput::None)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d No valid output formats in %s.."),
+			*FString(__FUNCTION__), __LINE__, *FormatsStr);
+		return 1;
+	}
+
+	const bool bOverwrite = FParse::Param(*Params, TEXT("Overwrite"));
+
+	// Collect the logs
+	TArray<FString> LogFilePaths;
+	IFileManager& FileManager = IFileManager::Get();
+	if (FileManager.DirectoryExists(*InputPath))
+	{
+		FileManager.FindFilesRecursive(LogFilePaths, *InputPath, TEXT("*.slev"), true, false);
+		LogFilePaths.Sort();
+	}
+	else if (FileManager.FileExists(*InputPath))
+	{
+		LogFilePaths.Add(InputPath);
+	}
+
+	if (LogFilePaths.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d No event logs found at %s.."),
+			*FString(__FUNCTION__), __LINE__, *InputPath);
+		return 1;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 NumConverted = FSLEventLogConverter::ConvertAll(LogFilePaths, OutputPath, Outputs, bOverwrite);
+	UE_LOG(LogTemp, Display, TEXT("%s::%d Converted %d/%d event logs in %.3f seconds.."),
+		*FString(__FUNCTION__), __LINE__, NumConverted, LogFilePaths.Num(), FPlatformTime::Seconds() - StartTime);
+
+	return NumConverted == LogFilePaths.Num() ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SLEventLogConvertCommandlet.generated.h"
+
+/**
+ * Converts binary event logs (*.slev) to owl, n-triples, json and timeline outputs without running the episode
+ * Usage: -run=SLEventLogConvert -Input=<file|dir> [-Output=<dir>] [-Formats=owl,nt,json,timeline|all] [-Overwrite]
+ */
+UCLASS()
+class USEMLOGED_API USLEventLogConvertCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Ctor
+	USLEventLogConvertCommandlet();
+
+	// Begin UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End UCommandlet interface
+};